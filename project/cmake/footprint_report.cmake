@@ -0,0 +1,67 @@
+# Run a native_sim build of the application and turn its last footprint report into a
+# Kconfig fragment.
+#
+# cmake -DEXE=<zephyr.exe> -DRUN_S=<seconds> -DOUT=<footprint.conf> [-DARGS=<exe options>]
+#       -P footprint_report.cmake
+
+if(NOT EXISTS "${EXE}")
+    message(FATAL_ERROR "footprint: ${EXE} not found, build for native_sim first")
+endif()
+
+separate_arguments(exe_args UNIX_COMMAND "${ARGS}")
+
+execute_process(
+    COMMAND "${EXE}" --stop_at=${RUN_S} ${exe_args}
+    OUTPUT_VARIABLE log
+    ERROR_VARIABLE log
+    RESULT_VARIABLE rc
+)
+
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "footprint: ${EXE} exited with ${rc}\n${log}")
+endif()
+
+# The scenario thread reports once more after its last burst
+if(NOT log MATCHES "footprint: scenarios done")
+    message(FATAL_ERROR "footprint: the scenarios did not finish, is "
+                        "CONFIG_APP_FOOTPRINT_SCENARIOS set and CONFIG_APP_FOOTPRINT_RUN_S "
+                        "long enough?\n${log}")
+endif()
+
+# The application reports periodically; later reports overwrite earlier values
+string(REGEX MATCHALL "footprint: [^\n]*" lines "${log}")
+if(NOT lines)
+    message(FATAL_ERROR "footprint: no report in the log, is CONFIG_APP_FOOTPRINT set and "
+                        "CONFIG_APP_FOOTPRINT_RUN_S above CONFIG_APP_FOOTPRINT_REPORT_S?")
+endif()
+
+set(items)
+set(options)
+foreach(line IN LISTS lines)
+    if(line MATCHES "override (CONFIG_[A-Z0-9_]+)=([0-9]+)")
+        list(APPEND options ${CMAKE_MATCH_1})
+        set(value_${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+    elseif(line MATCHES "footprint: ([a-z]+ [^ ]+) ([0-9]+/[0-9]+)")
+        string(MAKE_C_IDENTIFIER "${CMAKE_MATCH_1}" key)
+        list(APPEND items ${key})
+        set(label_${key} "${CMAKE_MATCH_1}")
+        set(usage_${key} ${CMAKE_MATCH_2})
+    endif()
+endforeach()
+list(REMOVE_DUPLICATES items)
+list(REMOVE_DUPLICATES options)
+
+foreach(key IN LISTS items)
+    message(STATUS "footprint: ${label_${key}} ${usage_${key}}")
+endforeach()
+
+set(conf "# Generated by the footprint_report target from a ${RUN_S} s native_sim run.\n")
+string(APPEND conf "# Queue and pool sizes only: take stack sizes from a run on the target board.\n")
+string(APPEND conf "# Peaks only cover what the run exercised; review before use.\n")
+foreach(option IN LISTS options)
+    string(APPEND conf "${option}=${value_${option}}\n")
+    message(STATUS "footprint: ${option}=${value_${option}}")
+endforeach()
+
+file(WRITE "${OUT}" "${conf}")
+message(STATUS "footprint: wrote ${OUT}")
@@ -5,4 +5,12 @@
 
 void actuator_led_toggle(uint8_t led_id);
 
+int actuator_leds_set(uint32_t mask, uint32_t state);
+
+int actuator_leds_toggle(uint32_t mask);
+
+uint32_t actuator_leds_get(void);
+
+uint8_t actuator_led_count(void);
+
 #endif /* ACTUATOR_H */
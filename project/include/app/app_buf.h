@@ -0,0 +1,43 @@
+#ifndef APP_BUF_H
+#define APP_BUF_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Payload capacity of one buffer; covers a full 251-byte BLE ACL frame
+#define APP_BUF_SIZE 256
+
+// Number of buffers in the fixed-block pool
+#define APP_BUF_COUNT CONFIG_APP_BUF_COUNT
+
+/*
+Reference-counted, fixed-size message buffer:
+Publishers fill `data` in place and publish the pointer; every holder releases its
+reference with app_buf_unref() and the block returns to the pool on the last release.
+*/
+struct app_buf {
+    atomic_t ref;
+    uint16_t len;
+    uint8_t data[APP_BUF_SIZE];
+};
+
+struct app_buf *app_buf_alloc(k_timeout_t timeout);
+
+struct app_buf *app_buf_ref(struct app_buf *buf);
+
+void app_buf_unref(struct app_buf *buf);
+
+uint32_t app_buf_free_count(void);
+
+uint32_t app_buf_max_used(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_BUF_H */
@@ -2,21 +2,301 @@
 #define APP_BUS_H
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/spinlock.h>
 #include <app/app_msg.h>
+#include <app/app_buf.h>
+#include <app/spsc_ring.h>
 
 #ifdef __cplusplus
 
 extern "C" {
 #endif
 
+// Default per-subscriber queue depth (entries of struct app_msg)
+#define APP_BUS_LEN 64
+
+// Maximum number of subscribers that can be registered on the bus
+#define APP_BUS_MAX_SUBS 8
+
+// Filter mask helpers: one bit per enum value, APP_BUS_ANY matches everything
+#define APP_BUS_TYPE(t) BIT(t)
+#define APP_BUS_SRC(s)  BIT(s)
+#define APP_BUS_CMD(c)  BIT(c)
+#define APP_BUS_ANY     UINT32_MAX
+
+/*
+Subscriber filter:
+A message is delivered when its type bit is in `types` and its source bit is in `sources`.
+For APP_MSG_COMMAND messages the command_id bit must also be in `commands`.
+*/
+struct app_bus_filter {
+    uint32_t types;
+    uint32_t sources;
+    uint32_t commands;
+};
+
+/*
+Priority classes:
+Every message belongs to one class (see app_bus_msg_class()): commands are critical,
+button events normal, status and data blocks best-effort telemetry.
+*/
+enum app_bus_class {
+    APP_BUS_CLASS_CRITICAL,
+    APP_BUS_CLASS_NORMAL,
+    APP_BUS_CLASS_TELEMETRY,
+    APP_BUS_CLASS_COUNT,
+};
+
+// What a full lane does with a new message
+enum app_bus_policy {
+    APP_BUS_REJECT_NEW,         // drop the new message
+    APP_BUS_OVERWRITE_OLDEST,   // drop the oldest pending message
+    APP_BUS_COALESCE,           // replace a pending message with the same key, else reject
+};
+
+// How a consumer picks the next lane
+enum app_bus_drain {
+    APP_BUS_DRAIN_STRICT,       // always the highest non-empty class
+    APP_BUS_DRAIN_WEIGHTED,     // up to `weight` messages per class per round
+};
+
+// Default per-class drain weights for APP_BUS_DRAIN_WEIGHTED
+#define APP_BUS_WEIGHT_CRITICAL  4
+#define APP_BUS_WEIGHT_NORMAL    2
+#define APP_BUS_WEIGHT_TELEMETRY 1
+
+// One class of a subscriber: a reserved ring of messages with its own overflow policy
+struct app_bus_lane {
+    struct app_msg *buf;
+    uint16_t cap;
+    uint16_t head;
+    uint16_t count;
+    uint16_t peak;              // most messages ever pending
+    uint8_t policy;
+    uint8_t weight;
+    atomic_t drops;
+    atomic_t overwritten;
+    atomic_t coalesced;
+};
+
+// Per-subscriber set of class lanes, shared by all publishers under one spinlock
+struct app_bus_lanes {
+    struct app_bus_lane lane[APP_BUS_CLASS_COUNT];
+    struct k_spinlock lock;
+    uint8_t drain;
+    uint8_t credit[APP_BUS_CLASS_COUNT];
+};
+
+/*
+Latest-value table:
+For the message types in `types`, a subscriber keeps at most one pending message per key
+(type, source, button/command id). A publish whose key is already pending overwrites the
+pending message in place instead of queueing another one. Open addressing, `size` slots
+(power of two). APP_MSG_DATA is never coalesced.
+*/
+struct app_bus_latest_slot {
+    uint32_t key;
+    bool used;
+    struct app_msg msg;
+};
+
+struct app_bus_latest {
+    struct app_bus_latest_slot *slots;
+    uint32_t mask;
+    uint32_t types;
+    struct k_spinlock lock;
+    atomic_t coalesced;
+};
+
+#define APP_BUS_LATEST_DEFINE(_name, _size, _types)                             \
+    BUILD_ASSERT(((_size) > 0) && (((_size) & ((_size) - 1)) == 0),            \
+                 "latest-value table size must be a power of two");             \
+    static struct app_bus_latest_slot _name##_slots[_size];                     \
+    static struct app_bus_latest _name = {                                      \
+        .slots = _name##_slots,                                                 \
+        .mask = (_size) - 1,                                                    \
+        .types = (_types) & ~APP_BUS_TYPE(APP_MSG_DATA),                        \
+    }
+
+struct app_bus_lane_stats {
+    uint32_t depth;
+    uint32_t peak;
+    uint32_t drops;
+    uint32_t overwritten;
+    uint32_t coalesced;
+};
+
+/*
+A bus consumer: owns a private queue (or a set of class lanes) and receives only messages
+matching its filter. Optionally, messages from one single-producer source bypass the
+queue through a lock-free SPSC ring; the consumer is woken only when that ring goes
+non-empty.
+*/
+struct app_bus_sub {
+    const char *name;
+    struct k_msgq *q;
+    struct app_bus_filter filter;
+    atomic_t drop_count;
+
+    struct spsc_ring *ring;
+    uint32_t ring_sources;
+    struct k_sem *wake_sem;     // SPSC ring and lanes wake-up
+
+    struct app_bus_lanes *lanes;
+    struct app_bus_latest *latest;
+
+    atomic_t paused;            // non-zero: skipped by broadcast publishes (see app_bus_sub_pause())
+    atomic_t high_water;        // most messages ever pending (CONFIG_APP_FOOTPRINT)
+    uint32_t ring_high_water;   // most messages ever in the SPSC ring (CONFIG_APP_FOOTPRINT)
+};
+
+typedef void (*app_bus_sub_cb_t)(struct app_bus_sub *sub, void *user_data);
+
+/*
+Define a subscriber with its own queue of `_len` messages.
+Register it with app_bus_subscribe() from the consuming thread before reading from it.
+*/
+#define APP_BUS_SUBSCRIBER_DEFINE(_name, _len, _types, _sources, _commands)     \
+    K_MSGQ_DEFINE(_name##_q, sizeof(struct app_msg), _len, 4);                  \
+    static struct app_bus_sub _name = {                                         \
+        .name = #_name,                                                         \
+        .q = &_name##_q,                                                        \
+        .filter = {                                                             \
+            .types = (_types),                                                  \
+            .sources = (_sources),                                              \
+            .commands = (_commands),                                            \
+        },                                                                      \
+    }
+
+/*
+Define a subscriber whose messages from `_ring_src` take the SPSC fast path.
+Only valid when exactly one thread ever publishes from `_ring_src`.
+Requires CONFIG_POLL, the consumer waits on the ring and the queue together.
+*/
+#define APP_BUS_SUBSCRIBER_DEFINE_SPSC(_name, _len, _types, _sources, _commands, \
+                                       _ring_src, _ring_len)                    \
+    K_MSGQ_DEFINE(_name##_q, sizeof(struct app_msg), _len, 4);                  \
+    SPSC_RING_DEFINE(_name##_ring, sizeof(struct app_msg), _ring_len);          \
+    K_SEM_DEFINE(_name##_sem, 0, 1);                                            \
+    static struct app_bus_sub _name = {                                         \
+        .name = #_name,                                                         \
+        .q = &_name##_q,                                                        \
+        .filter = {                                                             \
+            .types = (_types),                                                  \
+            .sources = (_sources),                                              \
+            .commands = (_commands),                                            \
+        },                                                                      \
+        .ring = &_name##_ring,                                                  \
+        .ring_sources = APP_BUS_SRC(_ring_src),                                 \
+        .wake_sem = &_name##_sem,                                               \
+    }
+
+/*
+Define the class lanes of a subscriber: capacity (at least 1) and overflow policy per class.
+Each class owns its capacity, so a flood in one class never takes space from another.
+*/
+#define APP_BUS_LANES_DEFINE(_name, _drain, _crit_len, _crit_policy,            \
+                             _norm_len, _norm_policy, _tel_len, _tel_policy)    \
+    BUILD_ASSERT((_crit_len) > 0 && (_norm_len) > 0 && (_tel_len) > 0,         \
+                 "every lane needs at least one slot");                         \
+    static struct app_msg _name##_crit_buf[_crit_len];                          \
+    static struct app_msg _name##_norm_buf[_norm_len];                          \
+    static struct app_msg _name##_tel_buf[_tel_len];                            \
+    static struct app_bus_lanes _name = {                                       \
+        .drain = (_drain),                                                      \
+        .lane = {                                                               \
+            [APP_BUS_CLASS_CRITICAL] = {                                        \
+                .buf = _name##_crit_buf, .cap = (_crit_len),                    \
+                .policy = (_crit_policy), .weight = APP_BUS_WEIGHT_CRITICAL,    \
+            },                                                                  \
+            [APP_BUS_CLASS_NORMAL] = {                                          \
+                .buf = _name##_norm_buf, .cap = (_norm_len),                    \
+                .policy = (_norm_policy), .weight = APP_BUS_WEIGHT_NORMAL,      \
+            },                                                                  \
+            [APP_BUS_CLASS_TELEMETRY] = {                                       \
+                .buf = _name##_tel_buf, .cap = (_tel_len),                      \
+                .policy = (_tel_policy), .weight = APP_BUS_WEIGHT_TELEMETRY,    \
+            },                                                                  \
+        },                                                                      \
+    }
+
+/*
+Define a subscriber whose queue is a set of class lanes (see APP_BUS_LANES_DEFINE).
+Does not need CONFIG_POLL: lanes wake the consumer through one binary semaphore.
+*/
+#define APP_BUS_SUBSCRIBER_DEFINE_LANES(_name, _types, _sources, _commands, _lanes) \
+    K_SEM_DEFINE(_name##_sem, 0, 1);                                            \
+    static struct app_bus_sub _name = {                                         \
+        .name = #_name,                                                         \
+        .filter = {                                                             \
+            .types = (_types),                                                  \
+            .sources = (_sources),                                              \
+            .commands = (_commands),                                            \
+        },                                                                      \
+        .wake_sem = &_name##_sem,                                               \
+        .lanes = &(_lanes),                                                     \
+    }
+
+/*
+Lanes plus an SPSC fast path for `_ring_src` (see APP_BUS_SUBSCRIBER_DEFINE_SPSC).
+With strict drain the ring is served after the critical lane and before the other
+classes; with weighted drain, whenever the lanes are empty.
+*/
+#define APP_BUS_SUBSCRIBER_DEFINE_SPSC_LANES(_name, _types, _sources, _commands, \
+                                             _lanes, _ring_src, _ring_len)      \
+    SPSC_RING_DEFINE(_name##_ring, sizeof(struct app_msg), _ring_len);          \
+    K_SEM_DEFINE(_name##_sem, 0, 1);                                            \
+    static struct app_bus_sub _name = {                                         \
+        .name = #_name,                                                         \
+        .filter = {                                                             \
+            .types = (_types),                                                  \
+            .sources = (_sources),                                              \
+            .commands = (_commands),                                            \
+        },                                                                      \
+        .ring = &_name##_ring,                                                  \
+        .ring_sources = APP_BUS_SRC(_ring_src),                                 \
+        .wake_sem = &_name##_sem,                                               \
+        .lanes = &(_lanes),                                                     \
+    }
+
+int app_bus_subscribe(struct app_bus_sub *sub);
+
+int app_bus_latest_attach(struct app_bus_sub *sub, struct app_bus_latest *latest);
+
+uint32_t app_bus_sub_coalesced_count(const struct app_bus_sub *sub);
+
+void app_bus_sub_pause(struct app_bus_sub *sub, bool paused);
+
 int app_bus_publish(const struct app_msg *msg);
 
-int app_bus_get(struct app_msg *out, k_timeout_t timeout);
+int app_bus_publish_batch(const struct app_msg *msgs, size_t count);
+
+int app_bus_publish_buf(enum app_msg_source source, struct app_buf *buf);
+
+int app_bus_sub_get(struct app_bus_sub *sub, struct app_msg *out, k_timeout_t timeout);
+
+void app_bus_msg_release(struct app_msg *msg);
+
+uint32_t app_bus_sub_drop_count(const struct app_bus_sub *sub);
+
+int app_bus_lane_stats_get(struct app_bus_sub *sub, enum app_bus_class cls,
+                           struct app_bus_lane_stats *out);
+
+enum app_bus_class app_bus_msg_class(const struct app_msg *msg);
 
 uint32_t app_bus_drop_count(void);
 
+uint32_t app_bus_sub_capacity(const struct app_bus_sub *sub);
+
+uint32_t app_bus_sub_high_water(const struct app_bus_sub *sub);
+
+uint32_t app_bus_sub_ring_high_water(const struct app_bus_sub *sub);
+
+void app_bus_sub_foreach(app_bus_sub_cb_t cb, void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#ifndef APP_CMD_H
+#define APP_CMD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <app/app_msg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Command ids must fit the 32-bit APP_BUS_CMD() filter mask
+#define APP_CMD_ID_MAX 32
+
+struct app_bus_sub;
+
+// Runs in the owner's thread for every accepted command
+typedef void (*app_cmd_handler_t)(const struct app_msg *msg);
+
+// Returns true if the command value is acceptable
+typedef bool (*app_cmd_validator_t)(uint32_t value);
+
+/*
+Command descriptor:
+Declares, at compile time, which subscriber owns a command id, how the owner handles it,
+which values are valid and which sources may send it. The bus routes registered commands
+straight to the owner's queue; nobody else sees them.
+*/
+struct app_cmd_desc {
+    uint8_t id;
+    const char *name;
+    struct app_bus_sub *owner;
+    app_cmd_handler_t handler;
+    app_cmd_validator_t validate;   // NULL accepts any value
+    uint32_t allowed_sources;       // APP_BUS_SRC() mask
+};
+
+/*
+Register a command from the module that owns it, next to its handler:
+APP_CMD_DEFINE(cmd_led_set, APP_CMD_LED_SET, &actuator_sub, on_led_set, led_set_valid,
+               APP_BUS_SRC(APP_SRC_COMMS));
+*/
+#define APP_CMD_DEFINE(_name, _id, _owner, _handler, _validate, _sources)       \
+    BUILD_ASSERT((_id) > 0 && (_id) < APP_CMD_ID_MAX, "command id out of range"); \
+    static const STRUCT_SECTION_ITERABLE(app_cmd_desc, _name) = {               \
+        .id = (_id),                                                            \
+        .name = #_id,                                                           \
+        .owner = (_owner),                                                      \
+        .handler = (_handler),                                                  \
+        .validate = (_validate),                                                \
+        .allowed_sources = (_sources),                                          \
+    }
+
+const struct app_cmd_desc *app_cmd_find(uint8_t id);
+
+int app_cmd_check(const struct app_cmd_desc *desc, enum app_msg_source source, uint32_t value);
+
+int app_cmd_dispatch(const struct app_msg *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_CMD_H */
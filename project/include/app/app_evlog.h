@@ -0,0 +1,121 @@
+#ifndef APP_EVLOG_H
+#define APP_EVLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <app/spsc_ring.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Binary event log:
+Hot paths write fixed-size records (event id, up to three arguments, cycle stamp) into a
+lock-free ring owned by the producing context. A low-priority drain thread formats them
+with the logging subsystem later, so the producer never pays for formatting or console I/O.
+Format strings live in one table in app_evlog.c, indexed by event id.
+*/
+enum app_ev_id {
+    APP_EV_SENSOR_EDGE,         // a0 = button id, a1 = pressed
+    APP_EV_SENSOR_BUS_FULL,     // a0 = total bus drops
+    APP_EV_CTRL_MSG,            // a0 = message type
+    APP_EV_CTRL_BUTTON,         // a0 = button id, a1 = pressed
+    APP_EV_CTRL_PUBLISH_CMD,    // a0 = command id, a1 = value, a2 = publish rc
+    APP_EV_CTRL_MODE,           // a0 = new mode
+    APP_EV_CTRL_STATS_RESET,    // no args
+    APP_EV_CTRL_BTN_COUNT,      // a0 = button id, a1 = press count
+    APP_EV_CTRL_FEATURE,        // a0 = channel << 8 | axis, a1 = kind << 8 | index, a2 = value
+    APP_EV_CTRL_HEALTH,         // a0 = health channel, a1 = max loop time (us), a2 = unused stack
+    APP_EV_ACT_LED_TOGGLE,      // a0 = LED id
+    APP_EV_ACT_LED_SET,         // a0 = LED id, a1 = on
+    APP_EV_ACT_MODE,            // a0 = mode shown
+    APP_EV_ACT_RESET_ACK,       // no args
+    APP_EV_ACT_LED_FX,          // a0 = LED id, a1 = effect, a2 = rc
+    APP_EV_BLE_CMD,             // a0 = command id, a1 = value, a2 = publish rc
+    APP_EV_BLE_CMD_BATCH,       // a0 = commands, a1 = publish rc
+    APP_EV_COUNT,
+};
+
+#define APP_EVLOG_ARGS 3
+
+struct app_ev_rec {
+    uint32_t cycles;
+    uint16_t id;
+    uint16_t reserved;
+    uint32_t args[APP_EVLOG_ARGS];
+};
+
+/*
+One producer's ring. Exactly one thread (or work item) may write to a given ring;
+the drain thread is its only reader.
+*/
+struct app_evlog_ring {
+    const char *name;
+    struct spsc_ring *ring;
+    atomic_t dropped;   // records lost because the ring was full
+    atomic_t limited;   // records suppressed by a rate limiter
+};
+
+/*
+Per-call-site rate limiter: at most `burst` records per `interval_ms` window.
+Each call site owns one instance (see APP_EVLOG_RATELIMITED).
+*/
+struct app_evlog_rl {
+    uint32_t window_start_ms;
+    uint32_t count;
+};
+
+#if defined(CONFIG_APP_EVLOG)
+
+// Define a producer ring of `_len` records (power of two); register it with app_evlog_register()
+#define APP_EVLOG_RING_DEFINE(_name, _len)                                      \
+    SPSC_RING_DEFINE(_name##_spsc, sizeof(struct app_ev_rec), _len);            \
+    static struct app_evlog_ring _name = {                                      \
+        .name = #_name,                                                         \
+        .ring = &_name##_spsc,                                                  \
+    }
+
+int app_evlog_register(struct app_evlog_ring *r);
+
+void app_evlog_write(struct app_evlog_ring *r, enum app_ev_id id,
+                     uint32_t a0, uint32_t a1, uint32_t a2);
+
+bool app_evlog_rl_allow(struct app_evlog_rl *rl, uint32_t interval_ms, uint32_t burst);
+
+#define APP_EVLOG(_ring, _id, _a0, _a1, _a2)                                    \
+    app_evlog_write((_ring), (_id), (uint32_t)(_a0), (uint32_t)(_a1), (uint32_t)(_a2))
+
+#define APP_EVLOG_RATELIMITED(_ring, _interval_ms, _burst, _id, _a0, _a1, _a2)  \
+    do {                                                                        \
+        static struct app_evlog_rl _rl;                                         \
+        if (app_evlog_rl_allow(&_rl, (_interval_ms), (_burst))) {               \
+            APP_EVLOG(_ring, _id, _a0, _a1, _a2);                               \
+        } else {                                                                \
+            atomic_inc(&(_ring)->limited);                                      \
+        }                                                                       \
+    } while (0)
+
+#else
+
+#define APP_EVLOG_RING_DEFINE(_name, _len)                                      \
+    static struct app_evlog_ring _name = { .name = #_name }
+
+static inline int app_evlog_register(struct app_evlog_ring *r) {
+    ARG_UNUSED(r);
+    return 0;
+}
+
+// Event log disabled: records vanish and their arguments are never evaluated
+#define APP_EVLOG(_ring, _id, _a0, _a1, _a2)                                    do { } while (0)
+#define APP_EVLOG_RATELIMITED(_ring, _interval_ms, _burst, _id, _a0, _a1, _a2)  do { } while (0)
+
+#endif /* CONFIG_APP_EVLOG */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_EVLOG_H */
@@ -0,0 +1,27 @@
+#ifndef APP_FOOTPRINT_H
+#define APP_FOOTPRINT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Footprint report (CONFIG_APP_FOOTPRINT), one log line per allocation:
+  footprint: stack <thread> <peak>/<size>                (not on native_sim)
+  footprint: queue <subscriber> <peak>/<capacity>
+  footprint: queue <subscriber>/ring <peak>/<length>      (SPSC ring ahead of the queue)
+  footprint: queue <subscriber>/<class> <peak>/<depth>    (one per class lane)
+  footprint: pool app_buf <peak>/<count>
+  footprint: heap <peak>/<size>
+followed by one line per allocation that has a Kconfig option and was used by the run:
+  footprint: override CONFIG_<option>=<measured peak + CONFIG_APP_FOOTPRINT_MARGIN_PCT>
+The BLE queues only get one once frames went out to a central. The footprint_report build
+target collects the override lines into footprint.conf.
+*/
+void app_footprint_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_FOOTPRINT_H */
@@ -0,0 +1,87 @@
+#ifndef APP_HEALTH_H
+#define APP_HEALTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Health channel:
+One per application thread, registered next to the thread. The thread binds itself with
+APP_HEALTH_START() and brackets each loop iteration (the work after its wait returns) with
+APP_HEALTH_BEGIN()/APP_HEALTH_END(). A thread waiting between iterations is healthy; one
+that stays inside an iteration longer than its budget has stalled. Threads that never
+iterate (they only sleep) still bind, for the stack report.
+*/
+struct app_health_state {
+    k_tid_t tid;                // bound thread, NULL until APP_HEALTH_START()
+    int wdt_ch;                 // task watchdog channel, negative if none
+    atomic_t busy;              // inside an iteration
+    uint32_t begin_cycles;      // k_cycle_get_32() at the start of the iteration
+    uint32_t loops;
+    uint32_t last_us;           // duration of the last iteration
+    uint32_t max_us;            // longest iteration since boot
+    uint32_t stalls;            // iterations that overran the budget
+    bool stalled;               // the current iteration overran the budget
+};
+
+struct app_health_chan {
+    const char *name;
+    uint32_t budget_ms;         // longest acceptable iteration
+    struct app_health_state *state;
+};
+
+struct app_health_stats {
+    const char *name;
+    uint32_t budget_ms;
+    uint32_t loops;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t stalls;
+    bool stalled;
+    uint32_t stack_size;
+    uint32_t stack_unused;      // high-water mark (CONFIG_INIT_STACKS), else 0
+};
+
+#if defined(CONFIG_APP_HEALTH)
+
+#define APP_HEALTH_DEFINE(_name, _label, _budget_ms)                            \
+    static struct app_health_state _name##_state = { .wdt_ch = -1 };            \
+    static const STRUCT_SECTION_ITERABLE(app_health_chan, _name) = {            \
+        .name = (_label),                                                       \
+        .budget_ms = (_budget_ms),                                              \
+        .state = &_name##_state,                                                \
+    }
+
+void app_health_start(const struct app_health_chan *ch);
+
+void app_health_begin(const struct app_health_chan *ch);
+
+void app_health_end(const struct app_health_chan *ch);
+
+int app_health_stats_get(size_t idx, struct app_health_stats *out);
+
+#define APP_HEALTH_START(_name) app_health_start(&(_name))
+#define APP_HEALTH_BEGIN(_name) app_health_begin(&(_name))
+#define APP_HEALTH_END(_name)   app_health_end(&(_name))
+
+#else
+
+#define APP_HEALTH_DEFINE(_name, _label, _budget_ms)
+#define APP_HEALTH_START(_name) do { } while (0)
+#define APP_HEALTH_BEGIN(_name) do { } while (0)
+#define APP_HEALTH_END(_name)   do { } while (0)
+
+#endif /* CONFIG_APP_HEALTH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_HEALTH_H */
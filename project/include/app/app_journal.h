@@ -0,0 +1,103 @@
+#ifndef APP_JOURNAL_H
+#define APP_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <app/app_msg.h>
+#if defined(CONFIG_APP_JOURNAL_FCB)
+#include <zephyr/fs/fcb.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Journal record (variable length, 2-11 bytes):
+  header   u8       bits 7-5 kind, bits 4-0 kind argument
+  delta    varint   ms since the previous record (LEB128: 7 bits per byte, bit 7 = more)
+  payload  varint   COMMAND: command value, DROP: number of lost deliveries; absent otherwise
+Segment (one per flash entry, plus one for the records still in RAM):
+  base     u32 LE   uptime (ms) the first record's delta is relative to
+  records  ...      PAD bytes (0xFF) may follow the last record of a flash entry
+*/
+enum app_journal_kind {
+    APP_JOURNAL_BUTTON,         // arg: button id << 1 | pressed
+    APP_JOURNAL_COMMAND,        // arg: command id, payload: value
+    APP_JOURNAL_MODE,           // arg: new app_mode
+    APP_JOURNAL_DROP,           // arg: enum app_journal_drop_src, payload: count
+    APP_JOURNAL_BOOT,           // first record after a reset
+    APP_JOURNAL_PAD = 7,        // filler byte (0xFF), no delta
+};
+
+// Where lost deliveries were counted
+enum app_journal_drop_src {
+    APP_JOURNAL_DROP_BUS,       // a bus subscriber's queue was full
+    APP_JOURNAL_DROP_BLE_TX,    // the BLE event TX queue or a notification dropped a record
+    APP_JOURNAL_DROP_SRC_COUNT,
+};
+
+// Longest encoded record
+#define APP_JOURNAL_RECORD_MAX 11
+
+/*
+Reader: a snapshot of the journal taken by app_journal_open(), read back as a byte stream
+of segments, each prefixed with its length (u16 LE). Flash entries come first, oldest
+first, then the RAM segment. Only one reader can be open at a time.
+*/
+struct app_journal_reader {
+    uint32_t end_total;         // stream position (bytes ever written) covered by the snapshot
+    uint32_t ram_len;           // bytes of the RAM segment (base + records)
+    uint32_t seg_len;           // length of the segment being read
+    uint32_t seg_off;           // bytes of the current segment (length prefix included) read
+    bool in_ram;                // flash entries done, reading the RAM segment
+    bool done;
+#if defined(CONFIG_APP_JOURNAL_FCB)
+    struct fcb_entry loc;       // current flash entry
+#endif
+};
+
+struct app_journal_stats {
+    uint32_t records;           // records written since boot
+    uint32_t bytes;             // encoded bytes of those records
+    uint32_t bytes_per_event_x100;
+    uint32_t overwritten;       // oldest records lost to a full RAM ring
+    uint32_t ram_used;          // bytes waiting in RAM
+    uint32_t flash_entries;     // entries appended to flash (CONFIG_APP_JOURNAL_FCB)
+    uint32_t flash_errors;
+};
+
+#if defined(CONFIG_APP_JOURNAL)
+
+void app_journal_bus(const struct app_msg *msg);
+
+void app_journal_mode(uint8_t mode);
+
+void app_journal_drop(enum app_journal_drop_src src);
+
+int app_journal_open(struct app_journal_reader *rd);
+
+size_t app_journal_read(struct app_journal_reader *rd, uint8_t *dst, size_t max);
+
+void app_journal_close(struct app_journal_reader *rd, bool commit);
+
+void app_journal_stats_get(struct app_journal_stats *out);
+
+#define APP_JOURNAL_BUS(msg)    app_journal_bus(msg)
+#define APP_JOURNAL_MODE(mode)  app_journal_mode(mode)
+#define APP_JOURNAL_DROP(src)   app_journal_drop(src)
+
+#else
+
+#define APP_JOURNAL_BUS(msg)    do { } while (0)
+#define APP_JOURNAL_MODE(mode)  do { } while (0)
+#define APP_JOURNAL_DROP(src)   do { } while (0)
+
+#endif /* CONFIG_APP_JOURNAL */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_JOURNAL_H */
@@ -8,6 +8,8 @@ enum app_msg_type {
     APP_MSG_BUTTON_EVENT,
     APP_MSG_COMMAND,
     APP_MSG_STATUS,
+    APP_MSG_DATA,
+    APP_MSG_FEATURE,
 };
 
 // Messages Sources
@@ -18,6 +20,8 @@ enum app_msg_source {
     APP_SRC_BUTTONS,
     APP_SRC_CONTROLLER,
     APP_SRC_ACTUATOR,
+    APP_SRC_SAMPLER,
+    APP_SRC_DSP,
 };
 
 // System Modes
@@ -34,6 +38,36 @@ enum app_command_id {
     APP_CMD_LED_SET,
     APP_CMD_SET_MODE,
     APP_CMD_RESET_STATS,
+    APP_CMD_LED_FX,
+    APP_CMD_STREAM,
+
+    // Internal commands between modules, never accepted from COMMS
+    APP_CMD_INTERNAL_BASE = 16,
+    APP_CMD_MODE_INDICATOR = APP_CMD_INTERNAL_BASE, // controller -> actuator: show the mode
+};
+
+// Effects selectable with APP_CMD_LED_FX (value byte 1)
+enum app_led_fx {
+    APP_LED_FX_STOP,
+    APP_LED_FX_PULSE,
+    APP_LED_FX_BLINK,
+    APP_LED_FX_BREATHE,
+    APP_LED_FX_HEARTBEAT,
+};
+
+// Signal features computed by the DSP stage (see app/dsp.h)
+enum app_feature_kind {
+    APP_FEATURE_RMS,            // value = RMS over the window, in sample units
+    APP_FEATURE_PEAK,           // value = largest |sample| over the window
+    APP_FEATURE_ZERO_CROSSINGS, // value = sign changes over the window
+    APP_FEATURE_BAND_ENERGY,    // value = spectral energy of band `index`
+};
+
+// Status reports (APP_MSG_STATUS from APP_SRC_SYSTEM, see app/app_health.h)
+enum app_status_kind {
+    APP_STATUS_HEALTH,          // periodic: index = health channel, arg = unused stack bytes,
+                                // value = longest loop iteration since boot (us)
+    APP_STATUS_STALL,           // index = health channel, value = time in the iteration (ms)
 };
 
 // Payloads
@@ -48,22 +82,46 @@ struct app_command_payload {
 };
 
 struct app_status_payload {
-    uint32_t uptime_ms;
+    uint8_t kind;               // enum app_status_kind
+    uint8_t index;
+    uint16_t arg;
+    uint32_t value;
+};
+
+struct app_feature_payload {
+    uint8_t channel;            // sampler channel
+    uint8_t axis;               // value index within a sample (ADC input or x/y/z)
+    uint8_t kind;               // enum app_feature_kind
+    uint8_t index;              // band number for APP_FEATURE_BAND_ENERGY, else 0
+    int32_t value;
+};
+
+struct app_buf;
+
+// Zero-copy payload: a reference-counted buffer (see app/app_buf.h) owned by the receiver
+struct app_data_payload {
+    struct app_buf *buf;
 };
 
 /*
 Main Message:
-32-bit layout: type 4B, source 4B, timestamp 4B, union 8B 
+32-bit layout: type 4B, source 4B, timestamp 4B, trace_cycles 4B (CONFIG_APP_TRACE only),
+union 8B (command and feature payloads are the largest members)
 */
 struct app_msg {
     enum app_msg_type type;
     enum app_msg_source source;
     uint32_t timestamp_ms;
+#if defined(CONFIG_APP_TRACE)
+    uint32_t trace_cycles;  // k_cycle_get_32() at the origin of the event (see app/app_trace.h)
+#endif
 
     union {
         struct app_button_payload button;
         struct app_command_payload command;
         struct app_status_payload status;
+        struct app_data_payload block;
+        struct app_feature_payload feature;
     } data;
 };
 
@@ -74,6 +132,8 @@ static inline const char *app_msg_type_str(enum app_msg_type t) {
         case APP_MSG_BUTTON_EVENT:  return "BUTTON";
         case APP_MSG_COMMAND:       return "COMMAND";
         case APP_MSG_STATUS:        return "STATUS";
+        case APP_MSG_DATA:          return "DATA";
+        case APP_MSG_FEATURE:       return "FEATURE";
         default:                    return "UNKNOWN";
     }
 }
@@ -82,10 +142,12 @@ static inline const char *app_msg_type_str(enum app_msg_type t) {
 static inline const char *app_msg_source_str(enum app_msg_source s) {
 
     switch(s) {
-        case APP_SRC_SENSOR: return "SENSOR";
-        case APP_SRC_COMMS:  return "COMMS";
-        case APP_SRC_SYSTEM: return "SYSTEM";
-        default:             return "UNKNOWN";
+        case APP_SRC_SENSOR:  return "SENSOR";
+        case APP_SRC_COMMS:   return "COMMS";
+        case APP_SRC_SYSTEM:  return "SYSTEM";
+        case APP_SRC_SAMPLER: return "SAMPLER";
+        case APP_SRC_DSP:     return "DSP";
+        default:              return "UNKNOWN";
     }
 }
 
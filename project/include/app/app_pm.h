@@ -0,0 +1,88 @@
+#ifndef APP_PM_H
+#define APP_PM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <app/app_msg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Power budgets, deepest first:
+DEEP lets the PM policy pick any state, LIGHT locks out the states that stop high-speed
+clocks and peripherals (standby, suspend-to-RAM/disk), RUN also locks out the idle states.
+Each app_mode has a budget; busy sources and recent user activity cap it at a shallower one.
+*/
+enum app_pm_budget {
+    APP_PM_BUDGET_DEEP,
+    APP_PM_BUDGET_LIGHT,
+    APP_PM_BUDGET_RUN,
+};
+
+// Sources that keep the system out of deep sleep while set
+enum app_pm_busy {
+    APP_PM_BUSY_BLE_LINK,       // a central is connected (LIGHT: connection events need the radio clock)
+    APP_PM_BUSY_BLE_STREAM,     // streaming mode (RUN)
+    APP_PM_BUSY_LED_FX,         // an LED effect is running (LIGHT)
+    APP_PM_BUSY_COUNT,
+};
+
+// PM states counted in app_pm_stats (indexed by enum pm_state, ACTIVE unused)
+#define APP_PM_STATES 7
+
+struct app_pm_stats {
+    uint8_t budget;                         // current enum app_pm_budget
+    uint8_t mode;                           // current enum app_mode
+    uint32_t busy;                          // BIT(enum app_pm_busy) of set sources
+    uint32_t budget_changes;
+    uint32_t idle_entries;                  // CPU idle entries (CONFIG_APP_PM_WAKE_STATS)
+    uint32_t idle_ms;                       // time in the idle thread (CONFIG_APP_PM_WAKE_STATS)
+    uint32_t wakeups_per_s;                 // idle entries per second since the previous call
+    uint32_t state_entries[APP_PM_STATES];  // PM state entries (CONFIG_PM)
+    uint32_t state_ms[APP_PM_STATES];       // residency per PM state (CONFIG_PM)
+};
+
+#if defined(CONFIG_APP_PM)
+
+void app_pm_busy_set(enum app_pm_busy src, bool busy);
+
+void app_pm_mode_set(enum app_mode mode);
+
+void app_pm_activity(void);
+
+void app_pm_stats_get(struct app_pm_stats *out);
+
+/**
+ * @brief Note bus activity that should postpone deep sleep
+ *
+ * Only button events and commands count: sampler blocks and features flow continuously
+ * and would keep the system awake forever.
+ *
+ * @param msg Message being published
+ */
+static inline void app_pm_bus_activity(const struct app_msg *msg) {
+    if (msg->type == APP_MSG_BUTTON_EVENT || msg->type == APP_MSG_COMMAND) {
+        app_pm_activity();
+    }
+}
+
+#define APP_PM_BUSY(src, busy)  app_pm_busy_set((src), (busy))
+#define APP_PM_MODE(mode)       app_pm_mode_set(mode)
+#define APP_PM_BUS_ACTIVITY(msg) app_pm_bus_activity(msg)
+
+#else
+
+#define APP_PM_BUSY(src, busy)      do { } while (0)
+#define APP_PM_MODE(mode)           do { } while (0)
+#define APP_PM_BUS_ACTIVITY(msg)    do { } while (0)
+
+#endif /* CONFIG_APP_PM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_PM_H */
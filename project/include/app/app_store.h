@@ -0,0 +1,75 @@
+#ifndef APP_STORE_H
+#define APP_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Persisted item:
+A variable owned by a module, saved under "app/<key>" in the settings subsystem. Items are
+restored at boot before any application thread runs. Changes are only marked; marked items
+are written together once per CONFIG_APP_STORE_FLUSH_INTERVAL_S, so a burst of updates
+costs one flash write per item. They are also written early before the system may lose
+power or reset: when the power budget drops to DEEP, before the health monitor lets the
+watchdog reset a stalled system, and on APP_CMD_RESET_STATS. The flush copies the variable from
+the system workqueue, so owners must update it with single-word stores.
+*/
+struct app_store_item {
+    const char *key;
+    void *data;
+    size_t len;
+};
+
+struct app_store_stats {
+    uint32_t restored;      // items loaded at boot
+    uint32_t marks;         // app_store_mark() calls
+    uint32_t flushes;       // flush runs that wrote at least one item
+    uint32_t writes;        // settings_save_one() calls
+    uint32_t errors;        // failed loads and writes
+};
+
+#if defined(CONFIG_APP_STORE)
+
+/*
+Register a variable next to its owner:
+static uint32_t g_counts[4];
+APP_STORE_ITEM_DEFINE(ctrl_counts, "counts", g_counts);
+*/
+#define APP_STORE_ITEM_DEFINE(_name, _key, _var)                                \
+    static const STRUCT_SECTION_ITERABLE(app_store_item, _name) = {             \
+        .key = (_key),                                                          \
+        .data = &(_var),                                                        \
+        .len = sizeof(_var),                                                    \
+    }
+
+void app_store_mark(const struct app_store_item *item);
+
+int app_store_flush(void);
+
+void app_store_flush_async(void);
+
+void app_store_stats_get(struct app_store_stats *out);
+
+#define APP_STORE_MARK(_name)   app_store_mark(&(_name))
+#define APP_STORE_FLUSH()       (void)app_store_flush()
+#define APP_STORE_FLUSH_ASYNC() app_store_flush_async()
+
+#else
+
+#define APP_STORE_ITEM_DEFINE(_name, _key, _var)
+#define APP_STORE_MARK(_name)   do { } while (0)
+#define APP_STORE_FLUSH()       do { } while (0)
+#define APP_STORE_FLUSH_ASYNC() do { } while (0)
+
+#endif /* CONFIG_APP_STORE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_STORE_H */
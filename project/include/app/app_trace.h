@@ -0,0 +1,68 @@
+#ifndef APP_TRACE_H
+#define APP_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Hot-path latency stages:
+Each stage records the cycles elapsed since the event's origin, i.e. when the message
+that triggered it was first published (for SENSOR_PUBLISH: since the input edge).
+*/
+enum app_trace_stage {
+    APP_TRACE_SENSOR_PUBLISH,       // input edge -> app_bus_publish in the sensor module
+    APP_TRACE_CTRL_DEQUEUE,         // publish -> dequeue in controller_thread
+    APP_TRACE_BLE_NOTIFY_ENTER,     // publish -> comms_ble_notify_button entry
+    APP_TRACE_BLE_NOTIFY_EXIT,      // publish -> comms_ble_notify_button exit
+    APP_TRACE_ACT_HANDLE,           // publish -> app_cmd_dispatch in the actuator
+    APP_TRACE_LED_APPLY,            // publish -> led_apply
+    APP_TRACE_STAGE_COUNT,
+};
+
+// log2 histogram: bucket b counts latencies in [2^b, 2^(b+1)) cycles, bucket 0 also holds 0
+#define APP_TRACE_BUCKETS 32
+
+#if defined(CONFIG_APP_TRACE)
+
+void app_trace_record(enum app_trace_stage stage, uint32_t origin_cycles);
+
+void app_trace_snapshot(uint32_t out[APP_TRACE_STAGE_COUNT][APP_TRACE_BUCKETS]);
+
+void app_trace_reset(void);
+
+const char *app_trace_stage_str(enum app_trace_stage stage);
+
+// Per-thread origin of the event being handled, kept in the thread's custom data slot
+static inline void app_trace_origin_set(uint32_t origin_cycles) {
+    k_thread_custom_data_set((void *)(uintptr_t)origin_cycles);
+}
+
+static inline uint32_t app_trace_origin_get(void) {
+    return (uint32_t)(uintptr_t)k_thread_custom_data_get();
+}
+
+#define APP_TRACE(stage, origin)    app_trace_record((stage), (origin))
+#define APP_TRACE_POINT(stage)      app_trace_record((stage), app_trace_origin_get())
+#define APP_TRACE_BEGIN(origin)     app_trace_origin_set(origin)
+#define APP_TRACE_MSG_STAMP(msg, origin) ((msg)->trace_cycles = (origin))
+
+#else
+
+// Tracing disabled: trace points vanish and their arguments are never evaluated
+#define APP_TRACE(stage, origin)            do { } while (0)
+#define APP_TRACE_POINT(stage)              do { } while (0)
+#define APP_TRACE_BEGIN(origin)             do { } while (0)
+#define APP_TRACE_MSG_STAMP(msg, origin)    do { } while (0)
+
+#endif /* CONFIG_APP_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_TRACE_H */
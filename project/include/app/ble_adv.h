@@ -0,0 +1,55 @@
+#ifndef BLE_ADV_H
+#define BLE_ADV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct bt_conn;
+struct bt_data;
+
+/*
+Advertising phases, entered in order after every (re)start:
+directed (only when the last bonded central is known and no central is connected),
+fast (high duty, CONFIG_APP_BLE_ADV_FAST_MS), then slow until a central connects.
+*/
+enum ble_adv_phase {
+    BLE_ADV_OFF,
+    BLE_ADV_DIRECTED,
+    BLE_ADV_FAST,
+    BLE_ADV_SLOW,
+};
+
+struct ble_adv_stats {
+    uint8_t phase;              // enum ble_adv_phase
+    uint32_t starts;            // phases started
+    uint32_t adv_ms;            // time spent advertising
+    uint32_t fast_ms;           // of which in the directed or fast phase
+    uint32_t duty_permille;     // adv_ms per 1000 ms of uptime
+    uint32_t reconnects;        // connections that followed a disconnect
+    uint32_t reconnect_last_ms; // disconnect -> next connection
+    uint32_t reconnect_avg_ms;
+    uint32_t reconnect_max_ms;
+};
+
+int ble_adv_init(const struct bt_data *ad, size_t ad_len, const struct bt_data *sd, size_t sd_len);
+
+void ble_adv_start(void);
+
+void ble_adv_resume(void);
+
+void ble_adv_connected(struct bt_conn *conn, bool has_free);
+
+void ble_adv_disconnected(struct bt_conn *conn, size_t remaining);
+
+void ble_adv_stats_get(struct ble_adv_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_ADV_H */
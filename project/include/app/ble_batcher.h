@@ -0,0 +1,67 @@
+#ifndef BLE_BATCHER_H
+#define BLE_BATCHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Notification framing:
+Single-event frame (legacy, 7 bytes): [msg type][button id][pressed][timestamp LE32].
+Batched frame: [BLE_FRAME_BATCH][record count][count x 7-byte single-event records].
+Single-event frames start with an app_msg_type (< 0x80), so bit 7 of byte 0 tells them apart.
+*/
+#define BLE_FRAME_BATCH         0x80
+#define BLE_BATCH_HDR_LEN       2
+#define BLE_BATCH_RECORD_LEN    7
+
+// Largest notification payload handled: 247-byte ATT MTU minus the 3-byte notify header
+#define BLE_BATCH_MAX_FRAME     244
+
+/*
+Packs 7-byte event records into one notification frame.
+Pure data structure with no Bluetooth dependency; the caller owns locking and timing.
+*/
+struct ble_batcher {
+    uint8_t buf[BLE_BATCH_MAX_FRAME];
+    uint16_t capacity;      // usable frame length, ATT MTU - 3 (clamped to the buffer)
+    uint16_t len;           // bytes in buf, header included
+    uint8_t count;          // pending records
+    uint32_t first_ms;      // time the oldest pending record was added
+};
+
+// ble_batcher_wait_ms() result when nothing is pending
+#define BLE_BATCHER_WAIT_FOREVER UINT32_MAX
+
+// Sends every pending record, typically with ble_batcher_take() until the batcher is empty
+typedef void (*ble_batcher_flush_t)(struct ble_batcher *b, void *user_data);
+
+void ble_batcher_init(struct ble_batcher *b, uint16_t capacity);
+
+void ble_batcher_set_capacity(struct ble_batcher *b, uint16_t capacity);
+
+int ble_batcher_add(struct ble_batcher *b, const uint8_t *rec, uint32_t now_ms);
+
+bool ble_batcher_full(const struct ble_batcher *b);
+
+uint16_t ble_batcher_take(struct ble_batcher *b, uint8_t *out, size_t out_size);
+
+void ble_batcher_push(struct ble_batcher *b, const uint8_t *rec, uint32_t now_ms,
+                      ble_batcher_flush_t flush, void *user_data);
+
+uint32_t ble_batcher_wait_ms(const struct ble_batcher *b, uint32_t max_latency_ms,
+                             uint32_t interval_ms, uint32_t now_ms);
+
+static inline bool ble_batcher_empty(const struct ble_batcher *b) {
+    return b->count == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_BATCHER_H */
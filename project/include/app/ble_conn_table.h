@@ -0,0 +1,62 @@
+#ifndef BLE_CONN_TABLE_H
+#define BLE_CONN_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One slot per simultaneous connection the stack can hold
+#if defined(CONFIG_BT_MAX_CONN)
+#define BLE_CONN_TABLE_SIZE CONFIG_BT_MAX_CONN
+#else
+#define BLE_CONN_TABLE_SIZE 1
+#endif
+
+struct bt_conn;
+
+// Per-connection notification state
+struct ble_conn_slot {
+    struct bt_conn *conn;       // NULL when the slot is free; the caller owns the reference
+    bool notify;                // client enabled notifications on the event characteristic
+    bool stream;                // client enabled notifications on the stream characteristic
+    uint16_t mtu;               // negotiated ATT MTU
+    uint16_t interval_ms;       // connection interval
+    uint8_t backlog;            // notifications handed to the stack, not yet completed
+};
+
+/*
+Fixed-size connection table:
+Only compares and stores connection pointers, never calls into the Bluetooth stack,
+so it can run against stub handles. The caller provides locking.
+*/
+struct ble_conn_table {
+    struct ble_conn_slot slots[BLE_CONN_TABLE_SIZE];
+};
+
+struct ble_conn_slot *ble_conn_table_add(struct ble_conn_table *t, struct bt_conn *conn);
+
+struct ble_conn_slot *ble_conn_table_find(struct ble_conn_table *t, const struct bt_conn *conn);
+
+int ble_conn_table_remove(struct ble_conn_table *t, const struct bt_conn *conn);
+
+size_t ble_conn_table_count(const struct ble_conn_table *t);
+
+size_t ble_conn_table_subscribed(const struct ble_conn_table *t);
+
+uint16_t ble_conn_table_min_mtu(const struct ble_conn_table *t);
+
+uint16_t ble_conn_table_min_interval_ms(const struct ble_conn_table *t);
+
+static inline bool ble_conn_table_has_free(const struct ble_conn_table *t) {
+    return ble_conn_table_count(t) < BLE_CONN_TABLE_SIZE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_CONN_TABLE_H */
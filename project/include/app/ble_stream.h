@@ -0,0 +1,76 @@
+#ifndef BLE_STREAM_H
+#define BLE_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <app/comms_ble.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Stream frame (one notification on the stream characteristic):
+frame seq (u16 LE, +1 per frame), block seq (u8, low byte of the sampler block seq),
+fragment (u8: bit 7 = last fragment of the block, bits 0-6 = fragment index), then the
+next bytes of the sampler block (struct sampler_block_hdr + samples, see app/sampler.h).
+*/
+#define BLE_STREAM_FRAME_HDR    4
+#define BLE_STREAM_FRAG_LAST    0x80
+#define BLE_STREAM_FRAG_MAX     0x80
+
+/*
+Splits one sampler block into stream frames.
+Pure data structure with no Bluetooth dependency; the caller owns the frame sequence
+counter, sending and timing.
+*/
+struct ble_stream_framer {
+    const uint8_t *block;
+    uint16_t len;           // block length, header included
+    uint16_t off;           // next block byte to send
+    uint16_t chunk;         // block bytes per frame
+    uint8_t block_seq;
+    uint8_t frag;           // index of the next fragment
+};
+
+/*
+Streaming counters.
+Plain fields: the caller serializes updates and reads (the stream thread counts frames
+and blocks, the stack's completion callback counts latencies).
+*/
+struct ble_stream_counters {
+    uint32_t start_ms;      // uptime when streaming was entered
+    uint32_t blocks;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t lat_sum_us;
+    uint32_t lat_count;
+    uint32_t lat_max_us;
+};
+
+int ble_stream_framer_init(struct ble_stream_framer *f, const uint8_t *block, uint16_t len,
+                           uint8_t block_seq, uint16_t frame_max);
+
+uint16_t ble_stream_framer_next(struct ble_stream_framer *f, uint16_t frame_seq, uint8_t *out,
+                                bool *last);
+
+void ble_stream_counters_reset(struct ble_stream_counters *c, uint32_t now_ms);
+
+void ble_stream_count_frame(struct ble_stream_counters *c, uint32_t sent, uint16_t len);
+
+void ble_stream_count_block(struct ble_stream_counters *c);
+
+void ble_stream_count_latency(struct ble_stream_counters *c, uint32_t us);
+
+void ble_stream_counters_read(const struct ble_stream_counters *c, uint32_t now_ms,
+                              struct comms_ble_stream_stats *out);
+
+static inline bool ble_stream_framer_done(const struct ble_stream_framer *f) {
+    return f->off >= f->len;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_STREAM_H */
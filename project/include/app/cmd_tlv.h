@@ -0,0 +1,27 @@
+#ifndef CMD_TLV_H
+#define CMD_TLV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <app/app_msg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Batched command encoding, one record per command:
+[command id][value length L (0-4)][L value bytes, little-endian]
+Missing high value bytes are zero, so a one-byte value costs 3 bytes on air.
+*/
+#define CMD_TLV_HDR_LEN         2
+#define CMD_TLV_MAX_VALUE_LEN   4
+
+int cmd_tlv_decode(const uint8_t *buf, size_t len,
+                   struct app_command_payload *out, size_t max_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMD_TLV_H */
@@ -1,9 +1,45 @@
 #ifndef COMMS_BLE_H
 #define COMMS_BLE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+// BLE TX pipeline counters
+struct comms_ble_tx_stats {
+    uint32_t queued;        // event records accepted into the TX queue
+    uint32_t in_flight;     // notifications handed to the stack, not yet completed
+    uint32_t completed;     // notifications confirmed sent
+    uint32_t dropped;       // event records lost (queue overflow, send failure, no link)
+    uint32_t queue_peak;    // most records ever queued (CONFIG_APP_FOOTPRINT)
+};
+
+// Streaming mode counters, reset when the mode is entered
+struct comms_ble_stream_stats {
+    uint32_t blocks;        // sampler blocks sent
+    uint32_t frames;        // notifications sent (per connection)
+    uint32_t bytes;         // notification payload bytes sent (per connection)
+    uint32_t dropped;       // frames lost (backlog cap, send failure)
+    uint32_t bps;           // payload throughput since the mode was entered, bits/s
+    uint32_t latency_avg_us; // end of block sampling -> last frame sent
+    uint32_t latency_max_us;
+};
+
+// Journal download counters (CONFIG_APP_JOURNAL_BLE)
+struct comms_ble_journal_stats {
+    uint32_t downloads;     // downloads sent up to the last frame
+    uint32_t cleared;       // downloads the client confirmed with CLEAR
+    uint32_t frames;        // data frames sent
+    uint32_t last_bytes;    // frame bytes of the last download
+    uint32_t last_ms;       // START to last frame of the last download
+    uint32_t last_bps;      // throughput of the last download, bits/s
+};
+
 int comms_ble_start(void);
 void comms_ble_notify_button(uint8_t button_id, uint8_t pressed, uint32_t timestamp_ms);
+void comms_ble_tx_stats_get(struct comms_ble_tx_stats *out);
+int comms_ble_stream_set(bool on);
+bool comms_ble_streaming(void);
+void comms_ble_stream_stats_get(struct comms_ble_stream_stats *out);
+void comms_ble_journal_stats_get(struct comms_ble_journal_stats *out);
 
 #endif /* COMMS_BLE_H */
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+#if defined(CONFIG_APP_DSP_CMSIS)
+#include <arm_math.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Fixed-point (q15) signal kernels:
+Built on CMSIS-DSP when CONFIG_APP_DSP_CMSIS is set (SIMD paths on Cortex-M4/M33), with a
+portable C implementation of the same arithmetic otherwise (native_sim, other cores).
+Instances are initialised once and owned by a single thread.
+*/
+
+// State length (in samples) needed by a FIR/decimator for `taps` taps and blocks up to `block`
+#define DSP_FIR_STATE_LEN(taps, block) ((taps) + (block) - 1)
+
+// State length (in samples) of a biquad cascade
+#define DSP_BIQUAD_STATE_LEN(stages) (4 * (stages))
+
+// Coefficients per biquad stage: b0, 0, b1, b2, a1, a2 (CMSIS DF1 layout, a1/a2 negated)
+#define DSP_BIQUAD_COEFFS 6
+
+/*
+FIR filter followed by keep-one-in-`factor` decimation (factor 1 = plain FIR).
+Each run takes a multiple of `factor` inputs; output n is computed at input n * factor +
+factor - 1. Coefficients are q15; use symmetric (linear-phase) designs so tap order does
+not matter between the two implementations.
+*/
+struct dsp_fir {
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_fir_decimate_instance_q15 inst;
+#else
+    const int16_t *coeffs;
+    int16_t *state;         // taps - 1 history samples, then the current block
+    uint16_t taps;
+    uint8_t factor;
+#endif
+    uint16_t max_block;
+};
+
+/*
+Biquad cascade, direct form I. Per stage:
+y[n] = (b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]) << post_shift
+Coefficients are q15 scaled down by 2^post_shift so that |coef| < 1.
+*/
+struct dsp_biquad {
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_biquad_casd_df1_inst_q15 inst;
+#else
+    const int16_t *coeffs;
+    int16_t *state;         // x[n-1], x[n-2], y[n-1], y[n-2] per stage
+    uint8_t stages;
+    int8_t post_shift;
+#endif
+};
+
+// Real FFT used for band energies
+struct dsp_fft {
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_rfft_instance_q15 inst;
+#else
+    const int16_t *twiddle; // cos/sin pairs, len / 2 entries
+#endif
+    uint16_t len;
+};
+
+int dsp_fir_init(struct dsp_fir *f, const int16_t *coeffs, uint16_t taps, uint8_t factor,
+                 int16_t *state, uint16_t max_block);
+
+uint16_t dsp_fir_run(struct dsp_fir *f, const int16_t *in, int16_t *out, uint16_t count);
+
+int dsp_biquad_init(struct dsp_biquad *b, const int16_t *coeffs, uint8_t stages,
+                    int8_t post_shift, int16_t *state);
+
+void dsp_biquad_run(struct dsp_biquad *b, const int16_t *in, int16_t *out, uint16_t count);
+
+int64_t dsp_power(const int16_t *in, uint16_t count);
+
+int16_t dsp_peak(const int16_t *in, uint16_t count);
+
+uint16_t dsp_zero_crossings(const int16_t *in, uint16_t count, int16_t *prev);
+
+uint16_t dsp_isqrt(uint32_t v);
+
+void dsp_fir_design_lowpass(int16_t *coeffs, uint16_t taps, uint8_t factor);
+
+void dsp_biquad_design_highpass(int16_t *coeffs, uint32_t fs_hz, uint32_t fc_hz);
+
+int dsp_fft_init(struct dsp_fft *f, uint16_t len);
+
+int dsp_band_energy(struct dsp_fft *f, int16_t *in, uint32_t *bands, uint8_t band_count);
+
+/*
+Feature stage (CONFIG_APP_DSP):
+Consumes sampler blocks, runs DC removal -> low-pass/decimation -> RMS, peak, zero
+crossings and optional band energies per axis, and publishes one APP_MSG_FEATURE
+message per feature and axis at the output rate.
+*/
+struct dsp_stage_stats {
+    uint32_t blocks;        // sampler blocks processed
+    uint32_t windows;       // feature windows published
+    uint32_t skipped;       // blocks ignored (unknown channel or too many axes)
+};
+
+int dsp_stage_set_output_rate(uint32_t rate_hz);
+
+void dsp_stage_stats_get(struct dsp_stage_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_H */
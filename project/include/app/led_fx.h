@@ -0,0 +1,59 @@
+#ifndef LED_FX_H
+#define LED_FX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of LEDs the engine can drive
+#define LED_FX_MAX_LEDS 8
+
+// Brightness levels: on/off LEDs treat anything >= LED_FX_LEVEL_HALF as on
+#define LED_FX_LEVEL_OFF  0
+#define LED_FX_LEVEL_HALF 128
+#define LED_FX_LEVEL_FULL 255
+
+// Breathe ramp resolution (one level update per step)
+#define LED_FX_BREATHE_STEP_MS 20
+
+// One step of a pattern: hold `level` for `ms` milliseconds
+struct led_fx_step {
+    uint8_t level;
+    uint16_t ms;
+};
+
+/*
+Backend supplied by the LED owner:
+`set` drives one LED to a brightness level (PWM duty or on/off), `done` is called when an
+effect ends or is cancelled so the owner can restore the LED's steady state.
+Both run in the system workqueue or in the caller of led_fx_*().
+*/
+struct led_fx_ops {
+    void (*set)(uint8_t led, uint8_t level);
+    void (*done)(uint8_t led);
+};
+
+int led_fx_init(const struct led_fx_ops *ops, uint8_t led_count);
+
+int led_fx_pulse(uint8_t led, uint16_t on_ms);
+
+int led_fx_blink(uint8_t led, uint8_t count, uint16_t on_ms, uint16_t off_ms);
+
+int led_fx_breathe(uint8_t led, uint16_t period_ms, uint8_t cycles);
+
+int led_fx_pattern(uint8_t led, const struct led_fx_step *steps, uint8_t count, uint8_t repeat);
+
+void led_fx_cancel(uint8_t led);
+
+bool led_fx_active(uint8_t led);
+
+uint32_t led_fx_active_mask(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LED_FX_H */
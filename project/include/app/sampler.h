@@ -0,0 +1,58 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include <app/app_buf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sample formats carried in a block
+enum sampler_fmt {
+    SAMPLER_FMT_ADC_RAW,        // int16 raw ADC codes, one per sample
+    SAMPLER_FMT_ACCEL_MMS2_XYZ, // int16 x, y, z acceleration in mm/s^2, three per sample
+};
+
+/*
+Sample block:
+Published as the payload of an APP_MSG_DATA app_buf from APP_SRC_SAMPLER. The header is
+followed by `count` samples of `width` int16 values each; sample n was taken at
+t0_cycles + n * period_us.
+*/
+struct sampler_block_hdr {
+    uint8_t channel;
+    uint8_t fmt;
+    uint8_t width;
+    uint8_t reserved;
+    uint16_t count;
+    uint16_t seq;           // per-channel block counter, gaps mean dropped blocks
+    uint32_t t0_cycles;
+    uint32_t period_us;
+} __packed;
+
+// Maximum int16 values per block
+#define SAMPLER_BLOCK_VALUES ((APP_BUF_SIZE - sizeof(struct sampler_block_hdr)) / sizeof(int16_t))
+
+struct sampler_stats {
+    uint32_t samples;
+    uint32_t blocks;
+    uint32_t overruns;      // blocks lost because no buffer was free or the bus dropped them
+};
+
+// Access the samples of a received block
+static inline const int16_t *sampler_block_data(const struct app_buf *buf) {
+    return (const int16_t *)(buf->data + sizeof(struct sampler_block_hdr));
+}
+
+int sampler_set_rate(uint8_t channel, uint32_t rate_hz);
+
+uint8_t sampler_channel_count(void);
+
+int sampler_stats_get(uint8_t channel, struct sampler_stats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAMPLER_H */
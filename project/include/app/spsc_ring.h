@@ -0,0 +1,56 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Index alignment so producer and consumer never write the same cache line
+#if defined(CONFIG_DCACHE_LINE_SIZE) && (CONFIG_DCACHE_LINE_SIZE > 0)
+#define SPSC_RING_CACHE_LINE CONFIG_DCACHE_LINE_SIZE
+#else
+#define SPSC_RING_CACHE_LINE 32
+#endif
+
+/*
+Lock-free single-producer/single-consumer ring of fixed-size elements:
+`head` is written only by the producer and `tail` only by the consumer. Both are
+free-running counters; the slot index is counter & mask, so the length must be a
+power of two. Exactly one thread may put and exactly one thread may get.
+*/
+struct spsc_ring {
+    atomic_t head __aligned(SPSC_RING_CACHE_LINE);
+    atomic_t tail __aligned(SPSC_RING_CACHE_LINE);
+    uint8_t *buf __aligned(SPSC_RING_CACHE_LINE);
+    uint32_t mask;
+    size_t elem_size;
+};
+
+#define SPSC_RING_DEFINE(_name, _elem_size, _len)                               \
+    BUILD_ASSERT(((_len) > 0) && (((_len) & ((_len) - 1)) == 0),               \
+                 "SPSC ring length must be a power of two");                    \
+    static uint8_t __aligned(4) _name##_buf[(_elem_size) * (_len)];             \
+    static struct spsc_ring _name = {                                           \
+        .buf = _name##_buf,                                                     \
+        .mask = (_len) - 1,                                                     \
+        .elem_size = (_elem_size),                                              \
+    }
+
+int spsc_ring_put(struct spsc_ring *ring, const void *elem, bool *was_empty);
+
+int spsc_ring_get(struct spsc_ring *ring, void *out);
+
+uint32_t spsc_ring_count(const struct spsc_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPSC_RING_H */
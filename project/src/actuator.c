@@ -1,158 +1,519 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/math_extras.h>
+#if defined(CONFIG_APP_LED_FX_PWM)
+#include <zephyr/drivers/pwm.h>
+#endif
 #include <zephyr/logging/log.h>
 
 #include <app/app_bus.h>
 #include <app/app_msg.h>
+#include <app/app_cmd.h>
+#include <app/app_evlog.h>
+#include <app/app_health.h>
+#include <app/app_store.h>
+#include <app/app_trace.h>
+#include <app/actuator.h>
+#include <app/led_fx.h>
 
 LOG_MODULE_REGISTER(actuator, LOG_LEVEL_INF); // Enable logging
 
-// Get device tree node handles for LEDS led0-led3 from device tree aliases
+// LEDs are the children of the gpio-leds node holding the led0 alias, in devicetree order
 #define LED0_NODE DT_ALIAS(led0)
-#define LED1_NODE DT_ALIAS(led1)
-#define LED2_NODE DT_ALIAS(led2)
-#define LED3_NODE DT_ALIAS(led3)
 
-#if !DT_NODE_HAS_STATUS(LED0_NODE, okay) || !DT_NODE_HAS_STATUS(LED1_NODE, okay) || \
-    !DT_NODE_HAS_STATUS(LED2_NODE, okay) || !DT_NODE_HAS_STATUS(LED3_NODE, okay)
-#error "One or more LED aliases are missing/disabled in the devicetree."
+#if !DT_NODE_HAS_STATUS(LED0_NODE, okay)
+#error "led0 alias is missing/disabled in the devicetree."
 #endif
 
-// GPIO descriptors for LEDS led0-led3 (pulled from device tree aliases)
-static const struct gpio_dt_spec leds[4] = {
-    GPIO_DT_SPEC_GET(LED0_NODE, gpios),
-    GPIO_DT_SPEC_GET(LED1_NODE, gpios),
-    GPIO_DT_SPEC_GET(LED2_NODE, gpios),
-    GPIO_DT_SPEC_GET(LED3_NODE, gpios),
+#define LEDS_NODE DT_PARENT(LED0_NODE)
+#define LED_SPEC(node) GPIO_DT_SPEC_GET(node, gpios),
+
+// GPIO descriptors for every LED (led0 first)
+static const struct gpio_dt_spec leds[] = {
+    DT_FOREACH_CHILD_STATUS_OKAY(LEDS_NODE, LED_SPEC)
+};
+
+#define LED_COUNT ARRAY_SIZE(leds)
+
+BUILD_ASSERT(ARRAY_SIZE(leds) >= 4, "The application needs at least four LEDs (led0-led3).");
+BUILD_ASSERT(ARRAY_SIZE(leds) <= 32, "LED state bitmaps are 32 bits wide.");
+
+/*
+LED ports: one entry per GPIO controller that drives LEDs, with the LED pins of that
+controller and which of them are active-low. A bitmap update costs one
+gpio_port_set_masked_raw() per port.
+*/
+struct led_port {
+    const struct device *port;
+    gpio_port_pins_t mask;
+    gpio_port_pins_t invert;
 };
 
-static uint8_t led_state[4];
+static struct led_port led_ports[LED_COUNT];
+static uint8_t led_port_count;
+static uint8_t port_of_led[LED_COUNT];
+static uint32_t led_ready;      // LEDs whose pin was configured at init
+
+#if defined(CONFIG_APP_LED_FX_PWM)
+// Optional PWM channels (pwm-led0..3 aliases) for dimmable effects; zeroed where absent
+#define PWM_LED_OR_NONE(n)                                                      \
+    COND_CODE_1(DT_NODE_HAS_STATUS(DT_ALIAS(pwm_led##n), okay),                 \
+                (PWM_DT_SPEC_GET(DT_ALIAS(pwm_led##n))), ({0}))
+
+static const struct pwm_dt_spec pwm_leds[LED_COUNT] = {
+    PWM_LED_OR_NONE(0),
+    PWM_LED_OR_NONE(1),
+    PWM_LED_OR_NONE(2),
+    PWM_LED_OR_NONE(3),
+};
+
+static uint32_t pwm_ready;      // LEDs driven through a ready PWM channel
+#endif
+
+// Commands are critical and keep a reserved lane of their own
+APP_BUS_LANES_DEFINE(actuator_lanes, APP_BUS_DRAIN_STRICT,
+                     CONFIG_APP_ACTUATOR_CMD_LANE_LEN, APP_BUS_REJECT_NEW,
+                     CONFIG_APP_ACTUATOR_EVENT_LANE_LEN, APP_BUS_OVERWRITE_OLDEST,
+                     CONFIG_APP_ACTUATOR_TELEMETRY_LANE_LEN, APP_BUS_OVERWRITE_OLDEST);
+
+// Actuator only receives the commands it owns, routed by the command registry below
+APP_BUS_SUBSCRIBER_DEFINE_LANES(actuator_sub, 0, 0, 0, actuator_lanes);
+
+// Per-command diagnostics go to the deferred event log (actuator thread only)
+APP_EVLOG_RING_DEFINE(act_evlog, 16);
+
+static uint32_t led_state;      // steady state bitmap, shown whenever no effect runs on an LED
+static uint32_t led_fx_owned;   // LEDs an effect is driving (first step until done)
+static K_MUTEX_DEFINE(led_lock);
 
 /**
- * @brief Apply LED state change
- * 
- * Sets the specified LED to the requested on/off state and updates the internal state tracking.
- * 
- * @param id LED identifier (0-3)
- * @param on Desired state: 1 for on, 0 for off
- * @return 0 on success, -EINVAL if id invalid, -ENODEV if device not ready
+ * @brief Group LEDs by GPIO port, configure them as outputs and cache readiness
  */
-static int led_apply(uint8_t id, uint8_t on) {
+static void leds_init(void) {
+
+    for (int i = 0; i < LED_COUNT; i++) {
+
+        if (!device_is_ready(leds[i].port)) {
+            LOG_ERR("LED%d device not ready", i);
+            continue;
+        }
+
+        int rc = gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE);
 
-    // Validate LED id is in range [0, 3]
-    if (id >= 4) {
-        return -EINVAL;
+        if (rc != 0) {
+            LOG_ERR("LED%d configure failed (%d)", i, rc);
+            continue;
+        }
+
+        int p;
+
+        // Find the slot for this LED's controller, or open a new one
+        for (p = 0; p < led_port_count; p++) {
+            if (led_ports[p].port == leds[i].port) {
+                break;
+            }
+        }
+
+        if (p == led_port_count) {
+            led_ports[p].port = leds[i].port;
+            led_port_count++;
+        }
+
+        led_ports[p].mask |= BIT(leds[i].pin);
+        if (leds[i].dt_flags & GPIO_ACTIVE_LOW) {
+            led_ports[p].invert |= BIT(leds[i].pin);
+        }
+        port_of_led[i] = (uint8_t)p;
+        led_ready |= BIT(i);
+
+#if defined(CONFIG_APP_LED_FX_PWM)
+        if (pwm_leds[i].dev != NULL && pwm_is_ready_dt(&pwm_leds[i])) {
+            pwm_ready |= BIT(i);
+        }
+#endif
     }
+}
 
-    // Validate GPIO device is initialized and ready
-    if (!device_is_ready(leds[id].port)) {
-        return -ENODEV;
+#if defined(CONFIG_APP_LED_FX_PWM)
+/**
+ * @brief Set the duty cycle of an LED's PWM channel
+ *
+ * @param id LED identifier with a ready PWM channel
+ * @param level Brightness, LED_FX_LEVEL_OFF..LED_FX_LEVEL_FULL
+ */
+static void led_pwm_set(uint8_t id, uint8_t level) {
+
+    uint32_t pulse = (uint32_t)(((uint64_t)pwm_leds[id].period * level) / LED_FX_LEVEL_FULL);
+
+    (void)pwm_set_pulse_dt(&pwm_leds[id], pulse);
+}
+#endif
+
+/**
+ * @brief Drive a set of LEDs on or off
+ *
+ * All GPIO LEDs of one port change in a single gpio_port_set_masked_raw() call, so a
+ * multi-LED update never shows intermediate states on that port.
+ *
+ * @param mask LEDs to drive
+ * @param on Bitmap of the LEDs in mask to turn on
+ * @return 0 on success, or the last GPIO driver error
+ */
+static int leds_write(uint32_t mask, uint32_t on) {
+
+    gpio_port_pins_t pins[LED_COUNT] = {0};
+    gpio_port_value_t vals[LED_COUNT] = {0};
+    uint32_t touched = 0;
+    int rc = 0;
+
+    mask &= led_ready;
+
+    while (mask != 0) {
+        int i = u32_count_trailing_zeros(mask);
+
+        mask &= mask - 1;
+
+#if defined(CONFIG_APP_LED_FX_PWM)
+        if (pwm_ready & BIT(i)) {
+            led_pwm_set(i, (on & BIT(i)) ? LED_FX_LEVEL_FULL : LED_FX_LEVEL_OFF);
+            continue;
+        }
+#endif
+
+        uint8_t p = port_of_led[i];
+
+        pins[p] |= BIT(leds[i].pin);
+        if (on & BIT(i)) {
+            vals[p] |= BIT(leds[i].pin);
+        }
+        touched |= BIT(p);
     }
 
-    // Set GPIO pin to the requested level (1=on, 0=off)
-    int rc = gpio_pin_set_dt(&leds[id], on ? 1 : 0);
+    while (touched != 0) {
+        int p = u32_count_trailing_zeros(touched);
+
+        touched &= touched - 1;
+
+        // Logical to physical level: flip the active-low pins
+        int port_rc = gpio_port_set_masked_raw(led_ports[p].port, pins[p],
+                                               vals[p] ^ (led_ports[p].invert & pins[p]));
+        if (port_rc != 0) {
+            rc = port_rc;
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Update several LEDs at once
+ *
+ * Records the requested steady state for every LED in mask and commits it with one
+ * port write per GPIO controller. LEDs that currently run an effect keep running it;
+ * the effect engine restores their steady state when it ends. Effect ownership is tracked
+ * under led_lock, so an effect ending concurrently either sees the new state or lets
+ * this call write it.
+ *
+ * @param mask LEDs to update (bit n = LED n)
+ * @param state New on/off state for the LEDs in mask
+ * @return 0 on success, or the last GPIO driver error
+ */
+int actuator_leds_set(uint32_t mask, uint32_t state) {
+
+    mask &= BIT_MASK(LED_COUNT);
+
+    k_mutex_lock(&led_lock, K_FOREVER);
+
+    led_state = (led_state & ~mask) | (state & mask);
+
+    int rc = leds_write(mask & ~led_fx_owned, led_state);
+
+    k_mutex_unlock(&led_lock);
+
+    if (rc == 0) {
+        APP_TRACE_POINT(APP_TRACE_LED_APPLY);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Invert several LEDs at once
+ *
+ * Same as actuator_leds_set() with the inverted state, read and written under led_lock so
+ * concurrent toggles from different threads are never lost.
+ *
+ * @param mask LEDs to toggle (bit n = LED n)
+ * @return 0 on success, or the last GPIO driver error
+ */
+int actuator_leds_toggle(uint32_t mask) {
+
+    mask &= BIT_MASK(LED_COUNT);
+
+    k_mutex_lock(&led_lock, K_FOREVER);
+
+    led_state ^= mask;
+
+    int rc = leds_write(mask & ~led_fx_owned, led_state);
+
+    k_mutex_unlock(&led_lock);
 
     if (rc == 0) {
-        led_state[id] = on ? 1 : 0;
+        APP_TRACE_POINT(APP_TRACE_LED_APPLY);
     }
 
     return rc;
 }
 
+/**
+ * @brief Get the steady on/off state of all LEDs
+ *
+ * @return Bitmap, bit n set if LED n is on
+ */
+uint32_t actuator_leds_get(void) {
+    return led_state;
+}
+
+/**
+ * @brief Get the number of LEDs driven by the actuator
+ *
+ * @return LED count from the devicetree
+ */
+uint8_t actuator_led_count(void) {
+    return (uint8_t)LED_COUNT;
+}
+
+/**
+ * @brief Effect engine callback: restore an LED's steady state after an effect
+ *
+ * @param id LED identifier
+ */
+static void fx_done(uint8_t id) {
+
+    k_mutex_lock(&led_lock, K_FOREVER);
+    led_fx_owned &= ~BIT(id);
+    (void)leds_write(BIT(id), led_state);
+    k_mutex_unlock(&led_lock);
+}
+
+/**
+ * @brief Effect engine callback: drive an LED for one effect step
+ *
+ * Uses the LED's PWM channel when one is available, otherwise the GPIO (on at half level
+ * and above). Marks the LED as owned by the effect until fx_done().
+ *
+ * @param id LED identifier
+ * @param level Brightness for the step
+ */
+static void fx_set(uint8_t id, uint8_t level) {
+
+    k_mutex_lock(&led_lock, K_FOREVER);
+
+    led_fx_owned |= BIT(id);
+
+#if defined(CONFIG_APP_LED_FX_PWM)
+    if (pwm_ready & BIT(id)) {
+        led_pwm_set(id, level);
+        k_mutex_unlock(&led_lock);
+        return;
+    }
+#endif
+
+    (void)leds_write(BIT(id), (level >= LED_FX_LEVEL_HALF) ? BIT(id) : 0);
+
+    k_mutex_unlock(&led_lock);
+}
+
+static const struct led_fx_ops fx_ops = {
+    .set = fx_set,
+    .done = fx_done,
+};
+
+// Built-in pattern for APP_CMD_LED_FX: double beat, then rest
+static const struct led_fx_step heartbeat[] = {
+    { LED_FX_LEVEL_FULL, 80 },
+    { LED_FX_LEVEL_OFF, 120 },
+    { LED_FX_LEVEL_FULL, 80 },
+    { LED_FX_LEVEL_OFF, 720 },
+};
+
 /**
  * @brief Toggle the state of the specified LED
  * 
  * Public interface for toggling LEDs. Can be called directly from other modules
  * to control LEDs without using the message bus.
  * 
- * @param led_id LED identifier (0-3)
+ * @param led_id LED identifier (0 to actuator_led_count() - 1)
  */
 void actuator_led_toggle(uint8_t led_id)
 {
-    if (led_id < 4) {
-        (void)led_apply(led_id, (uint8_t)!led_state[led_id]);
-        LOG_INF("LED%u toggle -> %u", led_id, led_state[led_id]);
+    if (led_id < LED_COUNT) {
+        (void)actuator_leds_toggle(BIT(led_id));
+        LOG_DBG("LED%u toggle", led_id);
     }
 }
 
 /**
- * @brief Handle incoming command messages
- * 
- * Processes command messages from the message bus and executes the appropriate action.
- * Supports LED control, mode changes, and statistics reset.
- * 
- * @param cmd Pointer to the command payload
+ * @brief Validate an LED_TOGGLE value: LED id in the lower byte
+ *
+ * @param value Command value
+ * @return true if the LED exists
  */
-static void handle_cmd(const struct app_command_payload *cmd) {
+static bool led_toggle_valid(uint32_t value) {
+    return value < LED_COUNT;
+}
 
-    uint8_t id;
-    uint8_t on;
+/**
+ * @brief Handle APP_CMD_LED_TOGGLE: toggle the LED given in the lower byte of value
+ *
+ * @param msg Command message
+ */
+static void on_led_toggle(const struct app_msg *msg) {
 
-    switch (cmd->command_id) {
+    uint8_t id = (uint8_t)msg->data.command.value;
 
-        case APP_CMD_LED_TOGGLE:
-            // Toggle the specified LED: extract ID from lower byte of value
-            id = (uint8_t)cmd->value;
+    actuator_led_toggle(id);
+    APP_EVLOG_RATELIMITED(&act_evlog, 1000, 8, APP_EV_ACT_LED_TOGGLE, id, 0, 0);
+}
 
-            if (id < 4) {
-                (void)led_apply(id, (uint8_t)!led_state[id]);
-                LOG_INF("LED%u toggle -> %u", id, led_state[id]);
-            }
-            break;
+/**
+ * @brief Validate an LED_SET value: upper byte = LED id, lower byte = on/off
+ *
+ * @param value Command value
+ * @return true if the LED exists
+ */
+static bool led_set_valid(uint32_t value) {
+    return ((value >> 8) & 0xFF) < LED_COUNT;
+}
 
-        case APP_CMD_LED_SET:
-            // Set LED state explicitly: upper byte = ID, lower byte = on/off state
-            id = (uint8_t)((cmd->value >> 8) & 0xFF);
-            on = (uint8_t)(cmd->value & 0xFF);
-            
-            if (id < 4) {
-                (void)led_apply(id, on ? 1 : 0);
-                LOG_INF("LED%u toggle -> %u", id, led_state[id]);
-            }
-            break;
+/**
+ * @brief Handle APP_CMD_LED_SET: set an LED explicitly
+ *
+ * @param msg Command message
+ */
+static void on_led_set(const struct app_msg *msg) {
 
-        case APP_CMD_SET_MODE:
-            // Change mode indicator: turn off all LEDs, then turn on the one matching the mode
-            for (uint8_t i = 0; i < 4; i++) {
-                (void)led_apply(i, 0);
-            }
+    uint8_t id = (uint8_t)((msg->data.command.value >> 8) & 0xFF);
+    uint8_t on = (uint8_t)(msg->data.command.value & 0xFF);
 
-            switch ((enum app_mode)cmd->value) {
+    (void)actuator_leds_set(BIT(id), on ? BIT(id) : 0);
+    APP_EVLOG_RATELIMITED(&act_evlog, 1000, 8, APP_EV_ACT_LED_SET, id, on ? 1 : 0, 0);
+}
 
-                case APP_MODE_IDLE:
-                    (void)led_apply(0, 1);
-                    break;
+/**
+ * @brief Validate a MODE_INDICATOR value
+ *
+ * @param value Command value
+ * @return true if the value is a known mode
+ */
+static bool mode_valid(uint32_t value) {
+    return value < APP_MODE_MAX;
+}
 
-                case APP_MODE_ACTIVE:
-                    (void)led_apply(1, 1);
-                    break;
-                
-                case APP_MODE_DIAG:
-                    (void)led_apply(2, 1);
-                    break;
+/**
+ * @brief Handle APP_CMD_MODE_INDICATOR: light the LED matching the mode
+ *
+ * Lights LED0 (IDLE), LED1 (ACTIVE) or LED2 (DIAG) and turns every other LED off,
+ * in one update so no intermediate state is ever visible.
+ *
+ * @param msg Command message
+ */
+static void on_mode_indicator(const struct app_msg *msg) {
 
-                default:
-                    (void)led_apply(3, 1);
-                    break;
-            }
+    (void)actuator_leds_set(BIT_MASK(LED_COUNT), BIT(msg->data.command.value));
+
+    APP_EVLOG(&act_evlog, APP_EV_ACT_MODE, msg->data.command.value, 0, 0);
+}
+
+/**
+ * @brief Handle APP_CMD_RESET_STATS: flash LED 3 briefly as acknowledgment (80 ms pulse)
+ *
+ * The pulse runs in the effects engine, so the actuator goes straight back to its queue.
+ * Persisted state (the cleared counters) is written from the system workqueue.
+ *
+ * @param msg Command message
+ */
+static void on_reset_stats(const struct app_msg *msg) {
+
+    ARG_UNUSED(msg);
+
+    (void)led_fx_pulse(3, 80);
+    APP_STORE_FLUSH_ASYNC();
+    APP_EVLOG(&act_evlog, APP_EV_ACT_RESET_ACK, 0, 0, 0);
+}
+
+/**
+ * @brief Validate an LED_FX value: byte 0 = LED id, byte 1 = effect
+ *
+ * @param value Command value
+ * @return true if the LED and effect exist
+ */
+static bool led_fx_valid(uint32_t value) {
+    return (value & 0xFF) < LED_COUNT && ((value >> 8) & 0xFF) <= APP_LED_FX_HEARTBEAT;
+}
+
+/**
+ * @brief Handle APP_CMD_LED_FX: start or stop an effect on one LED
+ *
+ * Value layout: byte 0 = LED id, byte 1 = effect (enum app_led_fx), byte 2 = count
+ * (0 = until stopped), byte 3 = time in 10 ms units (pulse length, blink half-period,
+ * breathe period).
+ *
+ * @param msg Command message
+ */
+static void on_led_fx(const struct app_msg *msg) {
 
-            LOG_INF("mode indicator -> %u", (unsigned)cmd->value);
+    uint32_t v = msg->data.command.value;
+    uint8_t id = (uint8_t)(v & 0xFF);
+    uint8_t count = (uint8_t)((v >> 16) & 0xFF);
+    uint16_t ms = (uint16_t)(((v >> 24) & 0xFF) * 10);
+    int rc;
+
+    switch ((v >> 8) & 0xFF) {
+
+        case APP_LED_FX_PULSE:
+            rc = led_fx_pulse(id, ms);
+            break;
+
+        case APP_LED_FX_BLINK:
+            rc = led_fx_blink(id, count, ms, ms);
+            break;
+
+        case APP_LED_FX_BREATHE:
+            rc = led_fx_breathe(id, ms, count);
             break;
 
-        case APP_CMD_RESET_STATS:
-            // Flash LED 3 briefly as reset acknowledgment (80 ms pulse)
-            (void)led_apply(3, 1);
-            k_sleep(K_MSEC(80));
-            (void)led_apply(3, 0);
-            LOG_INF("reset ack");
+        case APP_LED_FX_HEARTBEAT:
+            rc = led_fx_pattern(id, heartbeat, ARRAY_SIZE(heartbeat), count);
             break;
 
         default:
+            led_fx_cancel(id);
+            rc = 0;
             break;
     }
+
+    if (rc != 0) {
+        LOG_WRN("LED%u fx %u rejected (%d)", id, (unsigned)((v >> 8) & 0xFF), rc);
+    }
+    APP_EVLOG_RATELIMITED(&act_evlog, 1000, 8, APP_EV_ACT_LED_FX, id, (v >> 8) & 0xFF, rc);
 }
 
+APP_HEALTH_DEFINE(act_health, "actuator", 500);
+
+// Commands owned by the actuator
+APP_CMD_DEFINE(cmd_led_toggle, APP_CMD_LED_TOGGLE, &actuator_sub, on_led_toggle, led_toggle_valid,
+               APP_BUS_SRC(APP_SRC_COMMS) | APP_BUS_SRC(APP_SRC_CONTROLLER));
+APP_CMD_DEFINE(cmd_led_set, APP_CMD_LED_SET, &actuator_sub, on_led_set, led_set_valid,
+               APP_BUS_SRC(APP_SRC_COMMS) | APP_BUS_SRC(APP_SRC_CONTROLLER));
+APP_CMD_DEFINE(cmd_reset_stats, APP_CMD_RESET_STATS, &actuator_sub, on_reset_stats, NULL,
+               APP_BUS_SRC(APP_SRC_COMMS) | APP_BUS_SRC(APP_SRC_CONTROLLER));
+APP_CMD_DEFINE(cmd_led_fx, APP_CMD_LED_FX, &actuator_sub, on_led_fx, led_fx_valid,
+               APP_BUS_SRC(APP_SRC_COMMS) | APP_BUS_SRC(APP_SRC_CONTROLLER));
+APP_CMD_DEFINE(cmd_mode_indicator, APP_CMD_MODE_INDICATOR, &actuator_sub, on_mode_indicator,
+               mode_valid, APP_BUS_SRC(APP_SRC_CONTROLLER));
+
 /**
  * @brief Actuator thread main function
  * 
@@ -163,22 +524,20 @@ static void handle_cmd(const struct app_command_payload *cmd) {
  */
 static void actuator_thread(void) {
 
-    // Initialize all 4 LED GPIO pins as outputs, initially off
-    for (int i = 0; i < 4; i++) {
-        if(!device_is_ready(leds[i].port)) {
-            LOG_ERR("LED%d device not ready", i);
-            continue;
-        }
+    // Configure every LED as an output, initially off, grouped by port
+    leds_init();
 
-        int rc = gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE);
+    (void)led_fx_init(&fx_ops, MIN(LED_COUNT, LED_FX_MAX_LEDS));
 
-        if (rc != 0) {
-            LOG_ERR("LED%d configure failed (%d)", i, rc);
-        } else {
-            led_state[i] = 0;
-        }
+    int sub_rc = app_bus_subscribe(&actuator_sub);
+
+    if (sub_rc != 0) {
+        LOG_ERR("app_bus_subscribe failed: %d", sub_rc);
+        return;
     }
 
+    (void)app_evlog_register(&act_evlog);
+    APP_HEALTH_START(act_health);
     LOG_INF("actuator start");
 
     // Main event loop: wait for and process command messages from the bus
@@ -186,20 +545,24 @@ static void actuator_thread(void) {
         struct app_msg msg;
 
         LOG_DBG("actuator waiting for message");
-        int rc = app_bus_get(&msg, K_FOREVER);
+        int rc = app_bus_sub_get(&actuator_sub, &msg, K_FOREVER);
 
         if (rc != 0) {
-            LOG_ERR("app_bus_get failed: %d", rc);
+            LOG_ERR("app_bus_sub_get failed: %d", rc);
             continue;
         }
 
         LOG_DBG("actuator got msg type=%d", msg.type);
-        // Only process command messages; ignore other message types
-        if (msg.type == APP_MSG_COMMAND) {
-            handle_cmd(&msg.data.command);
-        }
+
+        APP_HEALTH_BEGIN(act_health);
+        APP_TRACE_BEGIN(msg.trace_cycles);
+        APP_TRACE_POINT(APP_TRACE_ACT_HANDLE);
+
+        (void)app_cmd_dispatch(&msg);
+        APP_HEALTH_END(act_health);
     }
 }
 
-// Create and start the actuator thread with 1024-byte stack, priority 8 (higher priority than sensors)
-K_THREAD_DEFINE(actuator_tid, 1024, actuator_thread, NULL, NULL, NULL, 8, 0, 0);
\ No newline at end of file
+// Create and start the actuator thread with priority 8 (higher priority than sensors)
+K_THREAD_DEFINE(actuator_tid, CONFIG_APP_ACTUATOR_STACK_SIZE,
+                actuator_thread, NULL, NULL, NULL, 8, 0, 0);
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/__assert.h>
+#include <app/app_buf.h>
+
+// Fixed-block pool backing every app_buf, 4-byte aligned
+K_MEM_SLAB_DEFINE(app_buf_slab, sizeof(struct app_buf), APP_BUF_COUNT, 4);
+
+/**
+ * @brief Allocate a message buffer from the pool
+ *
+ * The returned buffer holds one reference owned by the caller and has zero length.
+ *
+ * @param timeout Maximum time to wait for a free block (K_NO_WAIT from ISRs)
+ * @return Buffer pointer, or NULL if the pool stayed empty until timeout
+ */
+struct app_buf *app_buf_alloc(k_timeout_t timeout) {
+
+    void *block;
+
+    if (k_mem_slab_alloc(&app_buf_slab, &block, timeout) != 0) {
+        return NULL;
+    }
+
+    struct app_buf *buf = block;
+
+    atomic_set(&buf->ref, 1);
+    buf->len = 0;
+
+    return buf;
+}
+
+/**
+ * @brief Take an additional reference on a buffer
+ *
+ * @param buf Buffer already referenced by the caller
+ * @return The same buffer, for call chaining
+ */
+struct app_buf *app_buf_ref(struct app_buf *buf) {
+
+    __ASSERT(atomic_get(&buf->ref) > 0, "ref on released buffer");
+    atomic_inc(&buf->ref);
+
+    return buf;
+}
+
+/**
+ * @brief Release a reference on a buffer
+ *
+ * Returns the block to the pool when the last reference is dropped. NULL is ignored.
+ *
+ * @param buf Buffer to release
+ */
+void app_buf_unref(struct app_buf *buf) {
+
+    if (buf == NULL) {
+        return;
+    }
+
+    // atomic_dec returns the previous value: 1 means this was the last holder
+    if (atomic_dec(&buf->ref) == 1) {
+        k_mem_slab_free(&app_buf_slab, (void *)buf);
+    }
+}
+
+/**
+ * @brief Get the number of free buffers left in the pool
+ *
+ * @return Free block count
+ */
+uint32_t app_buf_free_count(void) {
+    return k_mem_slab_num_free_get(&app_buf_slab);
+}
+
+/**
+ * @brief Get the most buffers ever allocated at once
+ *
+ * @return Peak allocated block count, 0 without CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+ */
+uint32_t app_buf_max_used(void) {
+
+#if defined(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION)
+    return k_mem_slab_max_used_get(&app_buf_slab);
+#else
+    return 0;
+#endif
+}
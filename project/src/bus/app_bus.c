@@ -1,54 +1,945 @@
 #include <zephyr/kernel.h>
 #include <zephyr/sys/atomic.h>
+#include <zephyr/spinlock.h>
 #include <app/app_bus.h>
+#include <app/app_cmd.h>
+#include <app/app_journal.h>
+#include <app/app_pm.h>
+#include <app/app_trace.h>
 
-#define APP_BUS_LEN 128
+// Registered subscribers; entries are only appended, never removed
+static struct app_bus_sub *g_subs[APP_BUS_MAX_SUBS];
+static atomic_t g_sub_count;
+static struct k_spinlock g_sub_lock;
 
-// Static app message queue: APP_BUS_LEN entries of struct app_msg, 4-byte aligned
-K_MSGQ_DEFINE(app_bus_q, sizeof(struct app_msg), APP_BUS_LEN, 4);
+/**
+ * @brief Check whether a message passes a subscriber filter
+ *
+ * @param f Subscriber filter
+ * @param msg Message being published
+ * @return true if the subscriber wants the message
+ */
+static bool filter_match(const struct app_bus_filter *f, const struct app_msg *msg) {
+
+    if (!(f->types & APP_BUS_TYPE(msg->type)) || !(f->sources & APP_BUS_SRC(msg->source))) {
+        return false;
+    }
+
+    if (msg->type == APP_MSG_COMMAND) {
+        // Ids past the 32-bit command mask match no filter (and must not be shifted)
+        if (msg->data.command.command_id >= APP_CMD_ID_MAX) {
+            return false;
+        }
+        return (f->commands & APP_BUS_CMD(msg->data.command.command_id)) != 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the priority class of a message
+ *
+ * @param msg Message being published
+ * @return Class whose lane the message uses in subscribers with lanes
+ */
+enum app_bus_class app_bus_msg_class(const struct app_msg *msg) {
+
+    switch (msg->type) {
+        case APP_MSG_COMMAND:       return APP_BUS_CLASS_CRITICAL;
+        case APP_MSG_BUTTON_EVENT:  return APP_BUS_CLASS_NORMAL;
+        default:                    return APP_BUS_CLASS_TELEMETRY;
+    }
+}
+
+/**
+ * @brief Coalescing key of a message: type, source and button/command/feature/status id
+ *
+ * @param msg Message
+ * @return Key; messages with equal keys carry successive values of the same state
+ */
+static uint32_t msg_key(const struct app_msg *msg) {
+
+    uint32_t id = 0;
+
+    if (msg->type == APP_MSG_BUTTON_EVENT) {
+        id = msg->data.button.button_id;
+    } else if (msg->type == APP_MSG_COMMAND) {
+        id = msg->data.command.command_id;
+    } else if (msg->type == APP_MSG_FEATURE) {
+        const struct app_feature_payload *f = &msg->data.feature;
+
+        id = ((f->channel & 0xFU) << 12) | ((f->axis & 0x3U) << 10) | ((f->kind & 0x3U) << 8) |
+             f->index;
+    } else if (msg->type == APP_MSG_STATUS) {
+        id = ((uint32_t)msg->data.status.kind << 8) | msg->data.status.index;
+    }
+
+    return ((uint32_t)msg->type << 24) | ((uint32_t)msg->source << 16) | id;
+}
+
+/**
+ * @brief Mix a coalescing key into a table index
+ *
+ * @param key Message key
+ * @return Hash, masked by the caller
+ */
+static uint32_t latest_hash(uint32_t key) {
+
+    key ^= key >> 16;
+    key *= 0x45d9f3bU;
+    key ^= key >> 16;
+
+    return key;
+}
+
+/**
+ * @brief Find the slot holding a key (caller holds the table lock)
+ *
+ * @param t Latest-value table
+ * @param key Message key
+ * @return Slot index, or -1 if the key has no pending message
+ */
+static int latest_find(const struct app_bus_latest *t, uint32_t key) {
+
+    uint32_t pos = latest_hash(key) & t->mask;
+
+    for (uint32_t i = 0; i <= t->mask; i++, pos = (pos + 1) & t->mask) {
+        if (!t->slots[pos].used) {
+            return -1;
+        }
+        if (t->slots[pos].key == key) {
+            return (int)pos;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Free a slot, shifting later probe-chain entries back (caller holds the lock)
+ *
+ * Backward-shift deletion keeps every chain contiguous, so lookups never need tombstones.
+ *
+ * @param t Latest-value table
+ * @param pos Slot to free
+ */
+static void latest_remove(struct app_bus_latest *t, uint32_t pos) {
+
+    uint32_t hole = pos;
+    uint32_t next = (hole + 1) & t->mask;
+
+    t->slots[hole].used = false;
+
+    while (t->slots[next].used) {
+        uint32_t home = latest_hash(t->slots[next].key) & t->mask;
+
+        // The entry may fill the hole if the hole lies between its home slot and its position
+        if (((next - home) & t->mask) >= ((next - hole) & t->mask)) {
+            t->slots[hole] = t->slots[next];
+            t->slots[next].used = false;
+            hole = next;
+        }
+
+        next = (next + 1) & t->mask;
+    }
+}
+
+/**
+ * @brief Offer a message to a subscriber's latest-value table
+ *
+ * @param t Latest-value table
+ * @param msg Message being published
+ * @return -EALREADY if it replaced a pending message (nothing to queue), 0 if it opened
+ *         a new slot (queue it), -ENOSPC if the table is full (queue it uncoalesced)
+ */
+static int latest_offer(struct app_bus_latest *t, const struct app_msg *msg) {
+
+    uint32_t key = msg_key(msg);
+    int rc = -ENOSPC;
+
+    k_spinlock_key_t lock_key = k_spin_lock(&t->lock);
+
+    int pos = latest_find(t, key);
+
+    if (pos >= 0) {
+        t->slots[pos].msg = *msg;
+        atomic_inc(&t->coalesced);
+        rc = -EALREADY;
+        goto out;
+    }
+
+    uint32_t p = latest_hash(key) & t->mask;
+
+    for (uint32_t i = 0; i <= t->mask; i++, p = (p + 1) & t->mask) {
+        if (!t->slots[p].used) {
+            t->slots[p].used = true;
+            t->slots[p].key = key;
+            t->slots[p].msg = *msg;
+            rc = 0;
+            break;
+        }
+    }
 
-static atomic_t g_drop_count; // Atomic such that incrementation is thread-safe
+out:
+    k_spin_unlock(&t->lock, lock_key);
+    return rc;
+}
+
+/**
+ * @brief Replace a dequeued message with the latest value of its key
+ *
+ * Frees the key's slot, so the next publish with that key queues a new entry.
+ *
+ * @param t Latest-value table
+ * @param msg Message just dequeued, updated in place
+ */
+static void latest_take(struct app_bus_latest *t, struct app_msg *msg) {
+
+    uint32_t key = msg_key(msg);
+    k_spinlock_key_t lock_key = k_spin_lock(&t->lock);
+
+    int pos = latest_find(t, key);
+
+    if (pos >= 0) {
+        *msg = t->slots[pos].msg;
+        latest_remove(t, (uint32_t)pos);
+    }
+
+    k_spin_unlock(&t->lock, lock_key);
+}
+
+/**
+ * @brief Forget the pending slot of a message that could not be queued
+ *
+ * @param t Latest-value table
+ * @param msg Message whose queue put failed
+ */
+static void latest_cancel(struct app_bus_latest *t, const struct app_msg *msg) {
+
+    k_spinlock_key_t lock_key = k_spin_lock(&t->lock);
+
+    int pos = latest_find(t, msg_key(msg));
+
+    if (pos >= 0) {
+        latest_remove(t, (uint32_t)pos);
+    }
+
+    k_spin_unlock(&t->lock, lock_key);
+}
+
+/**
+ * @brief Drop the buffer reference of a message that leaves a lane undelivered
+ *
+ * @param msg Message being discarded
+ */
+static void msg_discard(struct app_msg *msg) {
+
+    if (msg->type == APP_MSG_DATA) {
+        app_buf_unref(msg->data.block.buf);
+    }
+}
+
+/**
+ * @brief Append a message to its class lane, applying the lane's overflow policy
+ *
+ * @param lanes Subscriber lanes
+ * @param msg Message (its buffer reference, if any, is owned by the lane on success)
+ * @param was_empty Output: true if all lanes were empty before the put
+ * @param evicted Output: the message APP_BUS_OVERWRITE_OLDEST pushed out, if any (its
+ *                buffer reference already dropped; only its key fields are meaningful)
+ * @param did_evict Output: true if `evicted` was filled
+ * @return 0 if queued or coalesced, -ENOMSG if rejected
+ */
+static int lane_put(struct app_bus_lanes *lanes, const struct app_msg *msg, bool *was_empty,
+                    struct app_msg *evicted, bool *did_evict) {
+
+    struct app_bus_lane *lane = &lanes->lane[app_bus_msg_class(msg)];
+    int rc = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&lanes->lock);
+
+    *did_evict = false;
+    *was_empty = true;
+    for (int c = 0; c < APP_BUS_CLASS_COUNT; c++) {
+        if (lanes->lane[c].count != 0) {
+            *was_empty = false;
+            break;
+        }
+    }
+
+    if (lane->policy == APP_BUS_COALESCE) {
+        uint32_t k = msg_key(msg);
+
+        for (uint16_t i = 0; i < lane->count; i++) {
+            struct app_msg *pending = &lane->buf[(lane->head + i) % lane->cap];
+
+            if (msg_key(pending) == k) {
+                msg_discard(pending);
+                *pending = *msg;
+                atomic_inc(&lane->coalesced);
+                goto out;
+            }
+        }
+    }
+
+    if (lane->count == lane->cap) {
+        if (lane->policy != APP_BUS_OVERWRITE_OLDEST) {
+            atomic_inc(&lane->drops);
+            rc = -ENOMSG;
+            goto out;
+        }
+
+        *evicted = lane->buf[lane->head];
+        *did_evict = true;
+        msg_discard(&lane->buf[lane->head]);
+        lane->head = (lane->head + 1) % lane->cap;
+        lane->count--;
+        atomic_inc(&lane->overwritten);
+    }
+
+    lane->buf[(lane->head + lane->count) % lane->cap] = *msg;
+    lane->count++;
+    if (lane->count > lane->peak) {
+        lane->peak = lane->count;
+    }
+
+out:
+    k_spin_unlock(&lanes->lock, key);
+    return rc;
+}
+
+/**
+ * @brief Pop the oldest message of one lane (caller holds the lanes lock)
+ *
+ * @param lane Lane to pop from
+ * @param out Destination
+ * @return true if a message was popped
+ */
+static bool lane_pop(struct app_bus_lane *lane, struct app_msg *out) {
+
+    if (lane->count == 0) {
+        return false;
+    }
+
+    *out = lane->buf[lane->head];
+    lane->head = (lane->head + 1) % lane->cap;
+    lane->count--;
+
+    return true;
+}
+
+/**
+ * @brief Take the next message from a subscriber's lanes
+ *
+ * Strict drain always serves the highest non-empty class. Weighted drain serves up to
+ * `weight` messages per class and refills every class once the non-empty ones have
+ * spent their credit, so lower classes keep making progress under load.
+ *
+ * @param lanes Subscriber lanes
+ * @param out Destination
+ * @param max_class Lowest-priority class to consider
+ * @return 0 on success, -EAGAIN if the considered lanes are empty
+ */
+static int lanes_get(struct app_bus_lanes *lanes, struct app_msg *out, enum app_bus_class max_class) {
+
+    int rc = -EAGAIN;
+
+    k_spinlock_key_t key = k_spin_lock(&lanes->lock);
+
+    if (lanes->drain == APP_BUS_DRAIN_STRICT) {
+        for (int c = 0; c <= max_class; c++) {
+            if (lane_pop(&lanes->lane[c], out)) {
+                rc = 0;
+                break;
+            }
+        }
+    } else {
+        for (int pass = 0; pass < 2 && rc != 0; pass++) {
+            for (int c = 0; c <= max_class; c++) {
+                if (lanes->credit[c] != 0 && lane_pop(&lanes->lane[c], out)) {
+                    lanes->credit[c]--;
+                    rc = 0;
+                    break;
+                }
+            }
+
+            // Round over: every non-empty class has spent its credit
+            if (rc != 0) {
+                for (int c = 0; c < APP_BUS_CLASS_COUNT; c++) {
+                    lanes->credit[c] = lanes->lane[c].weight;
+                }
+            }
+        }
+    }
+
+    k_spin_unlock(&lanes->lock, key);
+    return rc;
+}
+
+/**
+ * @brief Register a subscriber on the application message bus
+ *
+ * After registration, every published message matching the subscriber filter is copied
+ * into the subscriber's private queue. Registering the same subscriber twice is a no-op.
+ *
+ * @param sub Subscriber defined with APP_BUS_SUBSCRIBER_DEFINE
+ * @return 0 on success, -ENOMEM if the subscriber table is full
+ */
+int app_bus_subscribe(struct app_bus_sub *sub) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_sub_lock);
+    int count = (int)atomic_get(&g_sub_count);
+    int rc = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (g_subs[i] == sub) {
+            goto out;
+        }
+    }
+
+    if (count >= APP_BUS_MAX_SUBS) {
+        rc = -ENOMEM;
+        goto out;
+    }
+
+    // Publish the slot before the count so lock-free readers never see a NULL entry
+    g_subs[count] = sub;
+    atomic_set(&g_sub_count, count + 1);
+
+out:
+    k_spin_unlock(&g_sub_lock, key);
+    return rc;
+}
+
+/**
+ * @brief Messages pending for a subscriber in its queue, ring and lanes
+ *
+ * Lane counts are read without the lanes lock; the sum is a snapshot for statistics.
+ *
+ * @param sub Subscriber
+ * @return Pending messages
+ */
+static uint32_t sub_pending(const struct app_bus_sub *sub) {
+
+    uint32_t n = 0;
+
+    if (sub->q != NULL) {
+        n += k_msgq_num_used_get(sub->q);
+    }
+    if (sub->ring != NULL) {
+        n += spsc_ring_count(sub->ring);
+    }
+    if (sub->lanes != NULL) {
+        for (int c = 0; c < APP_BUS_CLASS_COUNT; c++) {
+            n += sub->lanes->lane[c].count;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief Raise a subscriber's high-water mark after a successful put
+ *
+ * @param sub Subscriber
+ */
+static inline void high_water_update(struct app_bus_sub *sub) {
+
+#if defined(CONFIG_APP_FOOTPRINT)
+    uint32_t n = sub_pending(sub);
+    atomic_val_t max;
+
+    do {
+        max = atomic_get(&sub->high_water);
+        if (n <= (uint32_t)max) {
+            break;
+        }
+    } while (!atomic_cas(&sub->high_water, max, n));
+#else
+    ARG_UNUSED(sub);
+#endif
+}
+
+/**
+ * @brief Queue one copy of a message for a subscriber
+ *
+ * @param sub Destination subscriber
+ * @param msg Message being published
+ * @return 0 on success, or the ring/queue error if the subscriber dropped it
+ */
+static int deliver(struct app_bus_sub *sub, const struct app_msg *msg) {
+
+    bool keyed = (sub->latest != NULL) && (sub->latest->types & APP_BUS_TYPE(msg->type));
+
+    if (keyed) {
+        int latest_rc = latest_offer(sub->latest, msg);
+
+        if (latest_rc == -EALREADY) {
+            return 0;
+        }
+
+        keyed = (latest_rc == 0);
+    }
+
+    // Every queued copy of a zero-copy message owns its own buffer reference
+    if (msg->type == APP_MSG_DATA) {
+        app_buf_ref(msg->data.block.buf);
+    }
+
+    int put_rc;
+    bool was_empty = false;
+
+    if (sub->ring != NULL && (sub->ring_sources & APP_BUS_SRC(msg->source))) {
+        // Single-producer fast path: wake the consumer only when the ring goes non-empty
+        put_rc = spsc_ring_put(sub->ring, msg, &was_empty);
+        if (put_rc == 0 && was_empty) {
+            k_sem_give(sub->wake_sem);
+        }
+#if defined(CONFIG_APP_FOOTPRINT)
+        // Only the ring's producer writes the mark, so a plain compare-and-store is enough
+        if (put_rc == 0) {
+            uint32_t n = spsc_ring_count(sub->ring);
+
+            if (n > sub->ring_high_water) {
+                sub->ring_high_water = n;
+            }
+        }
+#endif
+    } else if (sub->lanes != NULL) {
+        struct app_msg evicted;
+        bool did_evict;
+
+        put_rc = lane_put(sub->lanes, msg, &was_empty, &evicted, &did_evict);
+        if (put_rc == 0 && was_empty) {
+            k_sem_give(sub->wake_sem);
+        }
+
+        // The evicted message will never be dequeued, so nothing would free its key's slot
+        if (did_evict && sub->latest != NULL &&
+            (sub->latest->types & APP_BUS_TYPE(evicted.type))) {
+            latest_cancel(sub->latest, &evicted);
+        }
+    } else {
+        put_rc = k_msgq_put(sub->q, msg, K_NO_WAIT);
+    }
+
+    if (put_rc != 0) {
+        if (msg->type == APP_MSG_DATA) {
+            app_buf_unref(msg->data.block.buf);
+        }
+        if (keyed) {
+            latest_cancel(sub->latest, msg);
+        }
+        atomic_inc(&sub->drop_count);
+        APP_JOURNAL_DROP(APP_JOURNAL_DROP_BUS);
+    } else {
+        high_water_update(sub);
+    }
+
+    return put_rc;
+}
+
+/**
+ * @brief Give a subscriber a latest-value table
+ *
+ * Must be called before app_bus_subscribe(). From then on, messages of the table's types
+ * are coalesced per key while they wait in the subscriber's queue.
+ *
+ * @param sub Subscriber
+ * @param latest Table defined with APP_BUS_LATEST_DEFINE
+ * @return 0 on success
+ */
+int app_bus_latest_attach(struct app_bus_sub *sub, struct app_bus_latest *latest) {
+
+    sub->latest = latest;
+
+    return 0;
+}
+
+/**
+ * @brief Stop or resume broadcast delivery to a subscriber
+ *
+ * A paused subscriber stays registered but matches no broadcast publish, so producers do
+ * not spend buffer references or wake-ups on it. Commands routed to it as their owner are
+ * still delivered. Messages already queued stay queued.
+ *
+ * @param sub Registered subscriber
+ * @param paused true to pause, false to resume
+ */
+void app_bus_sub_pause(struct app_bus_sub *sub, bool paused) {
+    atomic_set(&sub->paused, paused ? 1 : 0);
+}
 
 /**
  * @brief Publish a message to the application message bus
- * 
- * Attempts to add a message to the shared message queue. If the queue is full,
- * the message is dropped and the drop counter is incremented.
- * 
+ *
+ * Commands registered with APP_CMD_DEFINE are checked against their descriptor and
+ * delivered only to the owning subscriber, with one table lookup. Every other message
+ * is copied to each subscriber whose filter matches. Each message reaches each matching
+ * subscriber exactly once; a subscriber with a full queue misses the message and its
+ * drop counter is incremented, other subscribers are unaffected.
+ *
  * @param msg Pointer to the message to publish
- * @return 0 on success, negative error code if queue is full
+ * @return 0 if delivered to all matching subscribers, -ENOENT if no subscriber matched,
+ *         -EPERM/-EINVAL if a registered command was rejected (see app_cmd_check()),
+ *         or the queue error of the last subscriber that dropped it
  */
 int app_bus_publish(const struct app_msg *msg) {
 
-    int rc = k_msgq_put(&app_bus_q, msg, K_NO_WAIT);
+    APP_PM_BUS_ACTIVITY(msg);
+    APP_JOURNAL_BUS(msg);
+
+    if (msg->type == APP_MSG_COMMAND) {
+        const struct app_cmd_desc *desc = app_cmd_find(msg->data.command.command_id);
+
+        if (desc != NULL) {
+            int rc = app_cmd_check(desc, msg->source, msg->data.command.value);
+
+            return (rc != 0) ? rc : deliver(desc->owner, msg);
+        }
+    }
+
+    int count = (int)atomic_get(&g_sub_count);
+    bool matched = false;
+    int rc = 0;
+
+    for (int i = 0; i < count; i++) {
+        struct app_bus_sub *sub = g_subs[i];
+
+        if (atomic_get(&sub->paused) || !filter_match(&sub->filter, msg)) {
+            continue;
+        }
+
+        matched = true;
+
+        int put_rc = deliver(sub, msg);
 
-    if(rc != 0) {
-        atomic_inc(&g_drop_count);
+        if (put_rc != 0) {
+            rc = put_rc;
+        }
     }
 
+    return matched ? rc : -ENOENT;
+}
+
+/**
+ * @brief Publish several messages as one batch
+ *
+ * The scheduler is locked while the batch is delivered, so no consumer runs (and no
+ * other thread publishes) until every message is queued. Consumers then wake once and
+ * see the batch back to back. Must not be called from an ISR.
+ *
+ * @param msgs Messages to publish, in order
+ * @param count Number of messages
+ * @return 0 if every message was delivered, otherwise the last app_bus_publish() error
+ */
+int app_bus_publish_batch(const struct app_msg *msgs, size_t count) {
+
+    int rc = 0;
+
+    k_sched_lock();
+
+    for (size_t i = 0; i < count; i++) {
+        int pub_rc = app_bus_publish(&msgs[i]);
+
+        if (pub_rc != 0) {
+            rc = pub_rc;
+        }
+    }
+
+    k_sched_unlock();
+
     return rc;
 }
 
 /**
- * @brief Retrieve a message from the application message bus
- * 
- * Blocks until a message is available in the queue or timeout expires.
- * 
+ * @brief Publish a zero-copy buffer to the application message bus
+ *
+ * Wraps the buffer in an APP_MSG_DATA message and publishes it. Only the buffer pointer
+ * is queued; each matching subscriber receives its own reference. The caller's reference
+ * is consumed whether or not the message was delivered.
+ *
+ * @param source Publishing module
+ * @param buf Buffer allocated with app_buf_alloc() and filled in place
+ * @return Same as app_bus_publish()
+ */
+int app_bus_publish_buf(enum app_msg_source source, struct app_buf *buf) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_DATA;
+    msg.source = source;
+    msg.timestamp_ms = k_uptime_get_32();
+    msg.data.block.buf = buf;
+    APP_TRACE_MSG_STAMP(&msg, k_cycle_get_32());
+
+    int rc = app_bus_publish(&msg);
+
+    app_buf_unref(buf);
+
+    return rc;
+}
+
+/**
+ * @brief Retrieve a message from a subscriber queue with lanes
+ *
+ * With strict drain, critical messages come first, then the SPSC ring (if any), then
+ * the remaining classes. With weighted drain, the lanes share the consumer by weight
+ * and the ring is served whenever they are empty. Every producer gives the same wake semaphore on an empty -> non-empty
+ * transition, so one k_sem_take() covers the ring and all lanes.
+ *
+ * @param sub Subscriber defined with APP_BUS_SUBSCRIBER_DEFINE_LANES / _SPSC_LANES
+ * @param out Destination
+ * @param timeout Maximum time to wait
+ * @return 0 on success, negative error code on timeout
+ */
+static int sub_get_lanes(struct app_bus_sub *sub, struct app_msg *out, k_timeout_t timeout) {
+
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+
+    while (1) {
+        if (sub->lanes->drain == APP_BUS_DRAIN_STRICT &&
+            lanes_get(sub->lanes, out, APP_BUS_CLASS_CRITICAL) == 0) {
+            return 0;
+        }
+
+        if (sub->lanes->drain == APP_BUS_DRAIN_WEIGHTED &&
+            lanes_get(sub->lanes, out, APP_BUS_CLASS_TELEMETRY) == 0) {
+            return 0;
+        }
+
+        if (sub->ring != NULL && spsc_ring_get(sub->ring, out) == 0) {
+            return 0;
+        }
+
+        if (lanes_get(sub->lanes, out, APP_BUS_CLASS_TELEMETRY) == 0) {
+            return 0;
+        }
+
+        int rc = k_sem_take(sub->wake_sem, sys_timepoint_timeout(end));
+
+        if (rc != 0) {
+            return rc;
+        }
+    }
+}
+
+/**
+ * @brief Retrieve a message from a subscriber queue
+ *
+ * Blocks until a message is available in the subscriber's queue or timeout expires.
+ * Subscribers with an SPSC fast lane drain the ring first, then the queue, and otherwise
+ * sleep on both at once. Subscribers with class lanes are served in priority order.
+ * Ordering is FIFO per source within a class.
+ *
+ * @param sub Subscriber to read from
+ * @param out Pointer to buffer where the message will be copied
+ * @param timeout Maximum time to wait for a message (K_FOREVER, K_NO_WAIT, or specific timeout)
+ * @return 0 on success, negative error code on failure or timeout
+ */
+static int sub_get_queued(struct app_bus_sub *sub, struct app_msg *out, k_timeout_t timeout) {
+
+    if (sub->lanes != NULL) {
+        return sub_get_lanes(sub, out, timeout);
+    }
+
+    if (sub->ring == NULL) {
+        return k_msgq_get(sub->q, out, timeout);
+    }
+
+    k_timepoint_t end = sys_timepoint_calc(timeout);
+
+    while (1) {
+        if (spsc_ring_get(sub->ring, out) == 0) {
+            return 0;
+        }
+
+        if (k_msgq_get(sub->q, out, K_NO_WAIT) == 0) {
+            return 0;
+        }
+
+        struct k_poll_event events[] = {
+            K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE,
+                                     K_POLL_MODE_NOTIFY_ONLY, sub->wake_sem),
+            K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE,
+                                     K_POLL_MODE_NOTIFY_ONLY, sub->q),
+        };
+
+        int rc = k_poll(events, ARRAY_SIZE(events), sys_timepoint_timeout(end));
+
+        if (rc != 0) {
+            return rc;
+        }
+
+        // Consume the wake-up; a stale token only costs one extra empty pass
+        (void)k_sem_take(sub->wake_sem, K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Retrieve a message from a subscriber queue
+ *
+ * Same as the underlying queue read; for keyed messages of a subscriber with a
+ * latest-value table, the returned message carries the most recent value published
+ * for its key while it was waiting.
+ *
+ * @param sub Subscriber to read from
  * @param out Pointer to buffer where the message will be copied
  * @param timeout Maximum time to wait for a message (K_FOREVER, K_NO_WAIT, or specific timeout)
  * @return 0 on success, negative error code on failure or timeout
  */
-int app_bus_get(struct app_msg *out, k_timeout_t timeout) {
-    return k_msgq_get(&app_bus_q, out, timeout);
+int app_bus_sub_get(struct app_bus_sub *sub, struct app_msg *out, k_timeout_t timeout) {
+
+    int rc = sub_get_queued(sub, out, timeout);
+
+    if (rc == 0 && sub->latest != NULL && (sub->latest->types & APP_BUS_TYPE(out->type))) {
+        latest_take(sub->latest, out);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Release resources held by a received message
+ *
+ * Drops the buffer reference carried by APP_MSG_DATA messages; a no-op for plain
+ * copied messages. Call once a received message is no longer needed.
+ *
+ * @param msg Message obtained from app_bus_sub_get()
+ */
+void app_bus_msg_release(struct app_msg *msg) {
+
+    if (msg->type == APP_MSG_DATA) {
+        app_buf_unref(msg->data.block.buf);
+        msg->data.block.buf = NULL;
+    }
+}
+
+/**
+ * @brief Get the number of messages a subscriber missed because its queue was full
+ *
+ * @param sub Subscriber to query
+ * @return Dropped messages for this subscriber since boot
+ */
+uint32_t app_bus_sub_drop_count(const struct app_bus_sub *sub) {
+    return (uint32_t)atomic_get(&sub->drop_count);
+}
+
+/**
+ * @brief Get the number of publishes merged into an already pending message
+ *
+ * @param sub Subscriber to query
+ * @return Coalesced updates since boot, 0 without a latest-value table
+ */
+uint32_t app_bus_sub_coalesced_count(const struct app_bus_sub *sub) {
+    return (sub->latest != NULL) ? (uint32_t)atomic_get(&sub->latest->coalesced) : 0;
+}
+
+/**
+ * @brief Get occupancy and overflow counters of one class lane
+ *
+ * @param sub Subscriber with lanes
+ * @param cls Class to query
+ * @param out Destination
+ * @return 0 on success, -EINVAL if the subscriber has no lanes or cls is invalid
+ */
+int app_bus_lane_stats_get(struct app_bus_sub *sub, enum app_bus_class cls,
+                           struct app_bus_lane_stats *out) {
+
+    if (sub->lanes == NULL || cls >= APP_BUS_CLASS_COUNT) {
+        return -EINVAL;
+    }
+
+    struct app_bus_lane *lane = &sub->lanes->lane[cls];
+    k_spinlock_key_t key = k_spin_lock(&sub->lanes->lock);
+
+    out->depth = lane->count;
+    out->peak = lane->peak;
+
+    k_spin_unlock(&sub->lanes->lock, key);
+
+    out->drops = (uint32_t)atomic_get(&lane->drops);
+    out->overwritten = (uint32_t)atomic_get(&lane->overwritten);
+    out->coalesced = (uint32_t)atomic_get(&lane->coalesced);
+
+    return 0;
 }
 
 /**
  * @brief Get the total number of dropped messages
- * 
- * Returns the count of messages that could not be published due to queue being full.
- * 
- * @return Total number of dropped messages since boot
+ *
+ * Returns the sum of the per-subscriber drop counters.
+ *
+ * @return Total number of dropped deliveries since boot
  */
 uint32_t app_bus_drop_count(void) {
-    return (uint32_t)atomic_get(&g_drop_count);
-}
\ No newline at end of file
+
+    int count = (int)atomic_get(&g_sub_count);
+    uint32_t total = 0;
+
+    for (int i = 0; i < count; i++) {
+        total += app_bus_sub_drop_count(g_subs[i]);
+    }
+
+    return total;
+}
+
+/**
+ * @brief Get the number of messages a subscriber can hold
+ *
+ * @param sub Subscriber to query
+ * @return Queue, ring and lane slots together
+ */
+uint32_t app_bus_sub_capacity(const struct app_bus_sub *sub) {
+
+    uint32_t n = 0;
+
+    if (sub->q != NULL) {
+        n += sub->q->max_msgs;
+    }
+    if (sub->ring != NULL) {
+        n += sub->ring->mask + 1;
+    }
+    if (sub->lanes != NULL) {
+        for (int c = 0; c < APP_BUS_CLASS_COUNT; c++) {
+            n += sub->lanes->lane[c].cap;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief Get the most messages ever pending for a subscriber
+ *
+ * @param sub Subscriber to query
+ * @return High-water mark since boot, 0 without CONFIG_APP_FOOTPRINT
+ */
+uint32_t app_bus_sub_high_water(const struct app_bus_sub *sub) {
+    return (uint32_t)atomic_get(&sub->high_water);
+}
+
+/**
+ * @brief Get the most messages ever pending in a subscriber's SPSC ring
+ *
+ * @param sub Subscriber to query
+ * @return High-water mark since boot, 0 without a ring or CONFIG_APP_FOOTPRINT
+ */
+uint32_t app_bus_sub_ring_high_water(const struct app_bus_sub *sub) {
+    return sub->ring_high_water;
+}
+
+/**
+ * @brief Call a function for every registered subscriber
+ *
+ * @param cb Callback
+ * @param user_data Passed to cb
+ */
+void app_bus_sub_foreach(app_bus_sub_cb_t cb, void *user_data) {
+
+    int count = (int)atomic_get(&g_sub_count);
+
+    for (int i = 0; i < count; i++) {
+        cb(g_subs[i], user_data);
+    }
+}
@@ -0,0 +1,94 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <app/app_bus.h>
+#include <app/app_cmd.h>
+
+LOG_MODULE_REGISTER(app_cmd, LOG_LEVEL_INF); // Enable logging
+
+// Command id -> descriptor, filled once from the iterable section before any thread runs
+static const struct app_cmd_desc *g_cmd_table[APP_CMD_ID_MAX];
+
+/**
+ * @brief Look up the descriptor of a command id
+ *
+ * @param id Command identifier
+ * @return Descriptor, or NULL if no module registered the id
+ */
+const struct app_cmd_desc *app_cmd_find(uint8_t id) {
+    return (id < APP_CMD_ID_MAX) ? g_cmd_table[id] : NULL;
+}
+
+/**
+ * @brief Check a command against its descriptor
+ *
+ * @param desc Descriptor from app_cmd_find()
+ * @param source Publishing module
+ * @param value Command value
+ * @return 0 if accepted, -ENOENT if desc is NULL, -EPERM if the source may not send it,
+ *         -EINVAL if the value is rejected by the validator
+ */
+int app_cmd_check(const struct app_cmd_desc *desc, enum app_msg_source source, uint32_t value) {
+
+    if (desc == NULL) {
+        return -ENOENT;
+    }
+
+    if (!(desc->allowed_sources & APP_BUS_SRC(source))) {
+        return -EPERM;
+    }
+
+    if (desc->validate != NULL && !desc->validate(value)) {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Run the handler of a received command
+ *
+ * Called by the owning module for each APP_MSG_COMMAND it dequeues. Values were already
+ * validated when the command was published.
+ *
+ * @param msg Command message obtained from app_bus_sub_get()
+ * @return 0 on success, -ENOENT if the command is not registered
+ */
+int app_cmd_dispatch(const struct app_msg *msg) {
+
+    const struct app_cmd_desc *desc = app_cmd_find(msg->data.command.command_id);
+
+    if (desc == NULL || desc->handler == NULL) {
+        return -ENOENT;
+    }
+
+    desc->handler(msg);
+
+    return 0;
+}
+
+/**
+ * @brief Build the command lookup table from the registered descriptors
+ *
+ * @return 0 on success, -EEXIST if two modules registered the same command id
+ */
+static int app_cmd_init(void) {
+
+    int rc = 0;
+
+    STRUCT_SECTION_FOREACH(app_cmd_desc, desc) {
+
+        if (g_cmd_table[desc->id] != NULL) {
+            LOG_ERR("command %u registered twice (%s, %s)", desc->id,
+                    g_cmd_table[desc->id]->name, desc->name);
+            rc = -EEXIST;
+            continue;
+        }
+
+        g_cmd_table[desc->id] = desc;
+    }
+
+    return rc;
+}
+
+SYS_INIT(app_cmd_init, APPLICATION, 0);
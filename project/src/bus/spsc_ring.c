@@ -0,0 +1,70 @@
+#include <errno.h>
+#include <string.h>
+#include <app/spsc_ring.h>
+
+/**
+ * @brief Append an element to the ring (producer side)
+ *
+ * Copies the element into the next free slot and publishes it by advancing `head`.
+ * `was_empty` reports whether the consumer may have seen the ring empty, i.e. whether
+ * it needs a wake-up. The tail is re-read after publishing the head; together with the
+ * consumer advancing `tail` before re-reading `head`, this guarantees that either the
+ * consumer sees the new element or the producer sees the ring as drained.
+ *
+ * @param ring Ring to write
+ * @param elem Element of ring->elem_size bytes
+ * @param was_empty Set to true on an empty -> non-empty transition (may be NULL)
+ * @return 0 on success, -ENOMSG if the ring is full
+ */
+int spsc_ring_put(struct spsc_ring *ring, const void *elem, bool *was_empty) {
+
+    uint32_t head = (uint32_t)atomic_get(&ring->head);
+    uint32_t tail = (uint32_t)atomic_get(&ring->tail);
+
+    if ((head - tail) > ring->mask) {
+        return -ENOMSG;
+    }
+
+    memcpy(&ring->buf[(head & ring->mask) * ring->elem_size], elem, ring->elem_size);
+    atomic_set(&ring->head, (atomic_val_t)(head + 1));
+
+    if (was_empty != NULL) {
+        *was_empty = ((uint32_t)atomic_get(&ring->tail) == head);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Remove the oldest element from the ring (consumer side)
+ *
+ * @param ring Ring to read
+ * @param out Buffer of ring->elem_size bytes receiving the element
+ * @return 0 on success, -EAGAIN if the ring is empty
+ */
+int spsc_ring_get(struct spsc_ring *ring, void *out) {
+
+    uint32_t tail = (uint32_t)atomic_get(&ring->tail);
+    uint32_t head = (uint32_t)atomic_get(&ring->head);
+
+    if (head == tail) {
+        return -EAGAIN;
+    }
+
+    memcpy(out, &ring->buf[(tail & ring->mask) * ring->elem_size], ring->elem_size);
+    atomic_set(&ring->tail, (atomic_val_t)(tail + 1));
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of elements currently queued
+ *
+ * Exact when called from the producer or consumer; a snapshot from anywhere else.
+ *
+ * @param ring Ring to query
+ * @return Queued element count
+ */
+uint32_t spsc_ring_count(const struct spsc_ring *ring) {
+    return (uint32_t)atomic_get(&ring->head) - (uint32_t)atomic_get(&ring->tail);
+}
@@ -1,15 +1,59 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <app/app_bus.h>
+#include <app/app_cmd.h>
+#include <app/app_health.h>
+#include <app/app_journal.h>
 #include <app/app_msg.h>
+#include <app/app_pm.h>
+#include <app/app_store.h>
 #include <app/comms_ble.h>
 #include <app/actuator.h>
+#include <app/app_trace.h>
+#include <app/app_evlog.h>
 
 LOG_MODULE_REGISTER(controller, LOG_LEVEL_INF); // Enable logging
 
+// Commands (SET_MODE from BLE) get their own reserved lane and are served before button events
+APP_BUS_LANES_DEFINE(controller_lanes, APP_BUS_DRAIN_STRICT,
+                     CONFIG_APP_CONTROLLER_CMD_LANE_LEN, APP_BUS_REJECT_NEW,
+                     CONFIG_APP_CONTROLLER_EVENT_LANE_LEN, APP_BUS_OVERWRITE_OLDEST,
+                     CONFIG_APP_CONTROLLER_TELEMETRY_LANE_LEN, APP_BUS_COALESCE);
+
+// Controller consumes button events, DSP features and health reports; the commands it owns
+// (SET_MODE) are routed by the registry. APP_SRC_SENSOR is only published by
+// publish_button() in sensor_module.c, which runs in exactly one context per build: the
+// sensor thread when polling, or the scan work item (one item, never concurrent with
+// itself) with CONFIG_APP_SENSOR_IRQ. That single producer lets button events use the SPSC
+// lane. Features and status reports share the telemetry lane, one pending value per
+// feature or health channel.
+APP_BUS_SUBSCRIBER_DEFINE_SPSC_LANES(controller_sub,
+                                     APP_BUS_TYPE(APP_MSG_BUTTON_EVENT) |
+                                     APP_BUS_TYPE(APP_MSG_FEATURE) |
+                                     APP_BUS_TYPE(APP_MSG_STATUS),
+                                     APP_BUS_SRC(APP_SRC_SENSOR) | APP_BUS_SRC(APP_SRC_DSP) |
+                                     APP_BUS_SRC(APP_SRC_SYSTEM),
+                                     0,
+                                     controller_lanes, APP_SRC_SENSOR,
+                                     CONFIG_APP_CONTROLLER_BUTTON_RING_LEN);
+
+#if defined(CONFIG_APP_CONTROLLER_COALESCE_BUTTONS)
+// At most one pending event per button: bursts collapse to the latest level
+APP_BUS_LATEST_DEFINE(controller_latest, 16, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT));
+#endif
+
+// Per-message diagnostics go to the deferred event log, never straight to the console
+APP_EVLOG_RING_DEFINE(ctrl_evlog, 32);
+
+APP_HEALTH_DEFINE(ctrl_health, "controller", 500);
+
 static enum app_mode g_mode = APP_MODE_IDLE;
 static uint32_t g_button_press_count[16];
 
+// Mode and press counters survive reboots (CONFIG_APP_STORE); restored before this thread runs
+APP_STORE_ITEM_DEFINE(ctrl_store_mode, "mode", g_mode);
+APP_STORE_ITEM_DEFINE(ctrl_store_presses, "presses", g_button_press_count);
+
 /**
  * @brief Publish a command to the message bus
  * 
@@ -21,8 +65,6 @@ static uint32_t g_button_press_count[16];
  */
 static void publish_cmd(uint8_t cmd_id, uint32_t value) {
 
-    LOG_INF("publish_cmd: id=%u val=%u", cmd_id, value);
-    
     struct app_msg out = {0};
 
     out.type = APP_MSG_COMMAND;
@@ -30,14 +72,11 @@ static void publish_cmd(uint8_t cmd_id, uint32_t value) {
     out.timestamp_ms = (uint32_t)k_uptime_get();
     out.data.command.command_id = cmd_id;
     out.data.command.value = value;
+    APP_TRACE_MSG_STAMP(&out, app_trace_origin_get()); // inherit the triggering event's origin
 
     int rc = app_bus_publish(&out);
 
-    if (rc != 0) {
-        LOG_ERR("cmd publish failed! drops=%u", app_bus_drop_count());
-    } else {
-        LOG_INF("publish_cmd succeeded");
-    }
+    APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 8, APP_EV_CTRL_PUBLISH_CMD, cmd_id, value, rc);
 }
 
 /**
@@ -55,11 +94,61 @@ static void set_mode(enum app_mode new_mode) {
 
     if (new_mode != g_mode) {
         g_mode = new_mode;
-        LOG_INF("mode -> %d", g_mode);
-        publish_cmd(APP_CMD_SET_MODE, (uint32_t)g_mode);
+        APP_EVLOG(&ctrl_evlog, APP_EV_CTRL_MODE, g_mode, 0, 0);
+        APP_PM_MODE(g_mode);
+        APP_JOURNAL_MODE(g_mode);
+        APP_STORE_MARK(ctrl_store_mode);
+        publish_cmd(APP_CMD_MODE_INDICATOR, (uint32_t)g_mode);
     }
 }
 
+/**
+ * @brief Validate a SET_MODE value
+ *
+ * @param value Command value
+ * @return true if the value is a known mode
+ */
+static bool set_mode_valid(uint32_t value) {
+    return value < APP_MODE_MAX;
+}
+
+/**
+ * @brief Handle APP_CMD_SET_MODE received from BLE
+ *
+ * @param msg Command message
+ */
+static void on_set_mode(const struct app_msg *msg) {
+    set_mode((enum app_mode)msg->data.command.value);
+}
+
+// Commands owned by the controller
+APP_CMD_DEFINE(cmd_set_mode, APP_CMD_SET_MODE, &controller_sub, on_set_mode, set_mode_valid,
+               APP_BUS_SRC(APP_SRC_COMMS));
+
+#if defined(CONFIG_APP_BLE_STREAM)
+/**
+ * @brief Validate a STREAM value
+ *
+ * @param value Command value
+ * @return true for 0 (leave streaming) or 1 (enter streaming)
+ */
+static bool stream_valid(uint32_t value) {
+    return value <= 1;
+}
+
+/**
+ * @brief Handle APP_CMD_STREAM received from BLE: enter or leave streaming mode
+ *
+ * @param msg Command message
+ */
+static void on_stream(const struct app_msg *msg) {
+    (void)comms_ble_stream_set(msg->data.command.value != 0);
+}
+
+APP_CMD_DEFINE(cmd_stream, APP_CMD_STREAM, &controller_sub, on_stream, stream_valid,
+               APP_BUS_SRC(APP_SRC_COMMS));
+#endif
+
 /**
  * @brief Handle button press/release events
  * 
@@ -71,12 +160,10 @@ static void set_mode(enum app_mode new_mode) {
  */
 static void handle_button_event(const struct app_button_payload *b) {
 
-    LOG_INF("handle_button_event: id=%u pressed=%u", b->button_id, b->pressed);
-    
+    APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 16, APP_EV_CTRL_BUTTON, b->button_id, b->pressed, 0);
+
     // Send BLE notification for both press and release
     comms_ble_notify_button(b->button_id, b->pressed, (uint32_t)k_uptime_get());
-    
-    LOG_INF("BLE notify returned");
 
     // Ignore button release events; only process presses
     if (!b ->pressed) {
@@ -84,21 +171,20 @@ static void handle_button_event(const struct app_button_payload *b) {
     }
 
     // Track button press count (if button ID is in range)
-    if (b->pressed < 16) {
+    if (b->button_id < 16) {
         g_button_press_count[b->button_id]++;
+        APP_STORE_MARK(ctrl_store_presses);
     }
 
     switch(b->button_id) {
 
         case 0:
             // Button 0: toggle LED 0
-            LOG_INF("button 0: toggling LED");
             actuator_led_toggle(0);
             break;
 
         case 1:
             // Button 1: toggle LED 1
-            LOG_INF("button 1: toggling LED");
             actuator_led_toggle(1);
             break;
         
@@ -114,16 +200,41 @@ static void handle_button_event(const struct app_button_payload *b) {
             for (int i = 0; i < 16; i++) {
                 g_button_press_count[i] = 0;
             }
+            APP_STORE_MARK(ctrl_store_presses);
 
             publish_cmd(APP_CMD_RESET_STATS, 0);
-            LOG_INF("stats reset");
+            APP_EVLOG(&ctrl_evlog, APP_EV_CTRL_STATS_RESET, 0, 0, 0);
             break;
         
         default:
             // Any other button: just log the press event with its counter
-            LOG_INF("btn %u pressed (count=%u)", 
-                    b->button_id,
-                    (b->button_id < 16) ? g_button_press_count[b->button_id] : 0);
+            APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 8, APP_EV_CTRL_BTN_COUNT, b->button_id,
+                                  (b->button_id < 16) ? g_button_press_count[b->button_id] : 0, 0);
+            break;
+    }
+}
+
+/**
+ * @brief Handle a health status report
+ *
+ * Periodic reports go to the event log; a stall is logged right away.
+ *
+ * @param s Pointer to the status payload
+ */
+static void handle_status(const struct app_status_payload *s) {
+
+    switch (s->kind) {
+
+        case APP_STATUS_HEALTH:
+            APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 16, APP_EV_CTRL_HEALTH, s->index, s->value,
+                                  s->arg);
+            break;
+
+        case APP_STATUS_STALL:
+            LOG_WRN("health channel %u stalled for %u ms", s->index, s->value);
+            break;
+
+        default:
             break;
     }
 }
@@ -138,22 +249,49 @@ static void handle_button_event(const struct app_button_payload *b) {
  */
 static void controller_thread(void) {
 
-    LOG_INF("controller start");
+#if defined(CONFIG_APP_CONTROLLER_COALESCE_BUTTONS)
+    (void)app_bus_latest_attach(&controller_sub, &controller_latest);
+#endif
+
+    int sub_rc = app_bus_subscribe(&controller_sub);
+
+    if (sub_rc != 0) {
+        LOG_ERR("app_bus_subscribe failed: %d", sub_rc);
+        return;
+    }
+
+    (void)app_evlog_register(&ctrl_evlog);
+    APP_HEALTH_START(ctrl_health);
+
+    // A restored mode is applied like a mode change: power budget and indicator LEDs
+    if (g_mode >= APP_MODE_MAX) {
+        g_mode = APP_MODE_IDLE;
+    }
+    if (g_mode != APP_MODE_IDLE) {
+        APP_PM_MODE(g_mode);
+        APP_JOURNAL_MODE(g_mode);
+        publish_cmd(APP_CMD_MODE_INDICATOR, (uint32_t)g_mode);
+    }
+
+    LOG_INF("controller start (mode %d)", g_mode);
 
     // Main event loop: wait for and dispatch button events and commands
     while (1) {
         
         struct app_msg msg;
 
-        LOG_INF("controller waiting for message");
-        int rc = app_bus_get(&msg, K_FOREVER);
+        int rc = app_bus_sub_get(&controller_sub, &msg, K_FOREVER);
 
         if (rc != 0) {
-            LOG_ERR("app_bus_get failed: %d", rc);
+            LOG_ERR("app_bus_sub_get failed: %d", rc);
             continue;
         }
 
-        LOG_INF("controller got msg type=%d", msg.type);
+        APP_HEALTH_BEGIN(ctrl_health);
+        APP_TRACE_BEGIN(msg.trace_cycles);
+        APP_TRACE_POINT(APP_TRACE_CTRL_DEQUEUE);
+
+        APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 16, APP_EV_CTRL_MSG, msg.type, 0, 0);
 
         switch (msg.type) {
 
@@ -163,25 +301,31 @@ static void controller_thread(void) {
                 break;
 
             case APP_MSG_COMMAND:
-                // Handle SET_MODE commands from BLE (comms), pass others to actuator
-                if (msg.source == APP_SRC_COMMS && 
-                    msg.data.command.command_id == APP_CMD_SET_MODE) {
-                        set_mode((enum app_mode)msg.data.command.value);
-                } else {
-                    // Re-publish commands that are not handled so actuator can process them
-                    app_bus_publish(&msg);
-                }
+                // Only commands registered with the controller as owner are routed here
+                (void)app_cmd_dispatch(&msg);
+                break;
+
+            case APP_MSG_FEATURE:
+                // Latest signal features from the DSP stage
+                APP_EVLOG_RATELIMITED(&ctrl_evlog, 1000, 8, APP_EV_CTRL_FEATURE,
+                                      (msg.data.feature.channel << 8) | msg.data.feature.axis,
+                                      (msg.data.feature.kind << 8) | msg.data.feature.index,
+                                      msg.data.feature.value);
                 break;
 
             case APP_MSG_STATUS:
-                // Status messages not yet implemented
+                // Thread health reports from the monitor
+                handle_status(&msg.data.status);
                 break;
 
             default:
                 break;
         }
+
+        APP_HEALTH_END(ctrl_health);
     }
 }
 
-// Create and start the controller thread with 1024-byte stack, priority 7 (between sensor and actuator)
-K_THREAD_DEFINE(controller_tid, 1024, controller_thread, NULL, NULL, NULL, 7, 0, 0);
\ No newline at end of file
+// Create and start the controller thread with priority 7 (between sensor and actuator)
+K_THREAD_DEFINE(controller_tid, CONFIG_APP_CONTROLLER_STACK_SIZE,
+                controller_thread, NULL, NULL, NULL, 7, 0, 0);
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <app/app_evlog.h>
+#include <app/app_health.h>
+
+LOG_MODULE_REGISTER(evlog, LOG_LEVEL_INF); // Enable logging
+
+// Maximum number of producer rings that can be registered
+#define APP_EVLOG_MAX_RINGS 8
+
+// Format string per event id; unused trailing arguments are ignored by the formatter
+static const char *const ev_fmt[APP_EV_COUNT] = {
+    [APP_EV_SENSOR_EDGE]      = "button event: id=%u pressed=%u",
+    [APP_EV_SENSOR_BUS_FULL]  = "bus full (drops=%u)",
+    [APP_EV_CTRL_MSG]         = "controller got msg type=%u",
+    [APP_EV_CTRL_BUTTON]      = "handle_button_event: id=%u pressed=%u",
+    [APP_EV_CTRL_PUBLISH_CMD] = "publish_cmd: id=%u val=%u rc=%d",
+    [APP_EV_CTRL_MODE]        = "mode -> %u",
+    [APP_EV_CTRL_STATS_RESET] = "stats reset",
+    [APP_EV_CTRL_BTN_COUNT]   = "btn %u pressed (count=%u)",
+    [APP_EV_CTRL_FEATURE]     = "feature: ch/axis=%04x kind/idx=%04x value=%d",
+    [APP_EV_CTRL_HEALTH]      = "health: ch=%u max=%u us stack free=%u",
+    [APP_EV_ACT_LED_TOGGLE]   = "LED%u toggle",
+    [APP_EV_ACT_LED_SET]      = "LED%u set -> %u",
+    [APP_EV_ACT_MODE]         = "mode indicator -> %u",
+    [APP_EV_ACT_RESET_ACK]    = "reset ack",
+    [APP_EV_ACT_LED_FX]       = "LED%u fx %u -> %d",
+    [APP_EV_BLE_CMD]          = "cmd write id=%u val=%u publish_rc=%d",
+    [APP_EV_BLE_CMD_BATCH]    = "cmd batch write n=%u publish_rc=%d",
+};
+
+// Registered rings; entries are only appended, never removed
+static struct app_evlog_ring *g_rings[APP_EVLOG_MAX_RINGS];
+static atomic_t g_ring_count;
+static struct k_spinlock g_ring_lock;
+
+APP_HEALTH_DEFINE(evlog_health, "evlog", 1000);
+
+// Given on a ring's empty -> non-empty transition
+static K_SEM_DEFINE(evlog_sem, 0, 1);
+
+/**
+ * @brief Register a producer ring with the drain thread
+ *
+ * Registering the same ring twice is a no-op.
+ *
+ * @param r Ring defined with APP_EVLOG_RING_DEFINE
+ * @return 0 on success, -ENOMEM if the ring table is full
+ */
+int app_evlog_register(struct app_evlog_ring *r) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_ring_lock);
+    int count = (int)atomic_get(&g_ring_count);
+    int rc = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (g_rings[i] == r) {
+            goto out;
+        }
+    }
+
+    if (count >= APP_EVLOG_MAX_RINGS) {
+        rc = -ENOMEM;
+        goto out;
+    }
+
+    // Publish the slot before the count so the drain thread never sees a NULL entry
+    g_rings[count] = r;
+    atomic_set(&g_ring_count, count + 1);
+
+out:
+    k_spin_unlock(&g_ring_lock, key);
+    return rc;
+}
+
+/**
+ * @brief Append one record to a producer ring
+ *
+ * Never blocks and never formats. A full ring drops the record and counts it.
+ * Must only be called from the ring's single producer.
+ *
+ * @param r Producer ring
+ * @param id Event id, selects the format string
+ * @param a0 First argument
+ * @param a1 Second argument
+ * @param a2 Third argument
+ */
+void app_evlog_write(struct app_evlog_ring *r, enum app_ev_id id,
+                     uint32_t a0, uint32_t a1, uint32_t a2) {
+
+    struct app_ev_rec rec = {
+        .cycles = k_cycle_get_32(),
+        .id = (uint16_t)id,
+        .args = { a0, a1, a2 },
+    };
+    bool was_empty = false;
+
+    if (spsc_ring_put(r->ring, &rec, &was_empty) != 0) {
+        atomic_inc(&r->dropped);
+        return;
+    }
+
+    if (was_empty) {
+        k_sem_give(&evlog_sem);
+    }
+}
+
+/**
+ * @brief Fixed-window rate limiter check
+ *
+ * @param rl Call-site limiter state
+ * @param interval_ms Window length
+ * @param burst Records allowed per window
+ * @return true if the record may be written
+ */
+bool app_evlog_rl_allow(struct app_evlog_rl *rl, uint32_t interval_ms, uint32_t burst) {
+
+    uint32_t now = k_uptime_get_32();
+
+    if ((now - rl->window_start_ms) >= interval_ms) {
+        rl->window_start_ms = now;
+        rl->count = 0;
+    }
+
+    if (rl->count >= burst) {
+        return false;
+    }
+
+    rl->count++;
+    return true;
+}
+
+/**
+ * @brief Format one record through the logging subsystem
+ *
+ * @param r Ring the record came from
+ * @param rec Record to print
+ */
+static void evlog_emit(const struct app_evlog_ring *r, const struct app_ev_rec *rec) {
+
+    if (rec->id >= APP_EV_COUNT || ev_fmt[rec->id] == NULL) {
+        LOG_WRN("%s: unknown event %u", r->name, rec->id);
+        return;
+    }
+
+    char line[64];
+
+    snprintf(line, sizeof(line), ev_fmt[rec->id], rec->args[0], rec->args[1], rec->args[2]);
+    LOG_INF("[%u us] %s: %s", k_cyc_to_us_floor32(rec->cycles), r->name, line);
+}
+
+/**
+ * @brief Event log drain thread
+ *
+ * Sleeps until a ring goes non-empty (or the periodic report is due), then drains
+ * every registered ring. Lost and rate-limited record counts are reported when they change.
+ * With CONFIG_APP_PM there is no periodic report, so an idle system is not woken every
+ * second; the counts then come out with the next drained record.
+ *
+ * Thread priority: CONFIG_APP_EVLOG_DRAIN_PRIORITY (lowest in the application)
+ */
+static void evlog_thread(void) {
+
+    uint32_t last_dropped[APP_EVLOG_MAX_RINGS] = {0};
+    uint32_t last_limited[APP_EVLOG_MAX_RINGS] = {0};
+
+    APP_HEALTH_START(evlog_health);
+
+    while (1) {
+
+        (void)k_sem_take(&evlog_sem, IS_ENABLED(CONFIG_APP_PM) ? K_FOREVER : K_MSEC(1000));
+
+        APP_HEALTH_BEGIN(evlog_health);
+
+        int count = (int)atomic_get(&g_ring_count);
+
+        for (int i = 0; i < count; i++) {
+            struct app_evlog_ring *r = g_rings[i];
+            struct app_ev_rec rec;
+
+            while (spsc_ring_get(r->ring, &rec) == 0) {
+                evlog_emit(r, &rec);
+            }
+
+            uint32_t dropped = (uint32_t)atomic_get(&r->dropped);
+            uint32_t limited = (uint32_t)atomic_get(&r->limited);
+
+            if (dropped != last_dropped[i] || limited != last_limited[i]) {
+                LOG_WRN("%s: %u records lost, %u rate-limited", r->name,
+                        dropped - last_dropped[i], limited - last_limited[i]);
+                last_dropped[i] = dropped;
+                last_limited[i] = limited;
+            }
+        }
+
+        APP_HEALTH_END(evlog_health);
+    }
+}
+
+// Create and start the drain thread at the lowest application priority
+K_THREAD_DEFINE(evlog_tid, CONFIG_APP_EVLOG_STACK_SIZE, evlog_thread, NULL, NULL, NULL,
+                CONFIG_APP_EVLOG_DRAIN_PRIORITY, 0, 0);
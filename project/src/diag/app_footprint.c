@@ -0,0 +1,301 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <app/app_buf.h>
+#include <app/app_bus.h>
+#include <app/app_footprint.h>
+#include <app/comms_ble.h>
+
+LOG_MODULE_REGISTER(footprint, LOG_LEVEL_INF); // Enable logging
+
+/*
+Only allocations a run actually exercised get a suggestion: a peak of 0 says nothing about
+the size a busier run needs. The BLE queues also need a central on the other end, since
+without one their consumers drain them at memory speed. Stacks are only measured on
+hardware: native_sim runs every thread on a host stack, so painted stacks there say
+nothing about a target's.
+*/
+
+// Suggested stack sizes are rounded up to this many bytes
+#define STACK_ROUND 64
+
+// Kconfig option sizing each named allocation
+struct size_option {
+    const char *name;           // thread or subscriber name
+    const char *option;         // without the CONFIG_ prefix
+};
+
+static const struct size_option stack_options[] = {
+    { "sensor_tid",     "APP_SENSOR_STACK_SIZE" },
+    { "sampler_tid",    "APP_SAMPLER_STACK_SIZE" },
+    { "comms_tid",      "APP_COMMS_STACK_SIZE" },
+    { "controller_tid", "APP_CONTROLLER_STACK_SIZE" },
+    { "actuator_tid",   "APP_ACTUATOR_STACK_SIZE" },
+    { "dsp_tid",        "APP_DSP_STACK_SIZE" },
+    { "evlog_tid",      "APP_EVLOG_STACK_SIZE" },
+    { "ble_tx",         "APP_BLE_TX_STACK_SIZE" },
+    { "ble_stream",     "APP_BLE_STREAM_STACK_SIZE" },
+};
+
+static const struct size_option queue_options[] = {
+    { "dsp_sub",        "APP_DSP_QUEUE_LEN" },
+    { "ble_stream_sub", "APP_BLE_STREAM_QUEUE_LEN" },
+};
+
+static const struct size_option ring_options[] = {
+    { "controller_sub", "APP_CONTROLLER_BUTTON_RING_LEN" },
+};
+
+// Subscribers with class lanes: one option per lane, indexed by enum app_bus_class
+static const struct {
+    const char *name;
+    const char *option[APP_BUS_CLASS_COUNT];
+} lane_options[] = {
+    { "controller_sub", { "APP_CONTROLLER_CMD_LANE_LEN", "APP_CONTROLLER_EVENT_LANE_LEN",
+                          "APP_CONTROLLER_TELEMETRY_LANE_LEN" } },
+    { "actuator_sub",   { "APP_ACTUATOR_CMD_LANE_LEN", "APP_ACTUATOR_EVENT_LANE_LEN",
+                          "APP_ACTUATOR_TELEMETRY_LANE_LEN" } },
+};
+
+static const char *const class_names[APP_BUS_CLASS_COUNT] = {
+    [APP_BUS_CLASS_CRITICAL] = "critical",
+    [APP_BUS_CLASS_NORMAL] = "normal",
+    [APP_BUS_CLASS_TELEMETRY] = "telemetry",
+};
+
+static void report_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(g_report_work, report_work_handler);
+
+/**
+ * @brief Find the Kconfig option sizing a named allocation
+ *
+ * @param table Option table
+ * @param count Entries in table
+ * @param name Thread or subscriber name
+ * @return Option name, or NULL if the allocation is fixed
+ */
+static const char *option_find(const struct size_option *table, size_t count, const char *name) {
+
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(table[i].name, name) == 0) {
+            return table[i].option;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add the configured headroom to a measured peak
+ *
+ * @param peak Measured peak
+ * @return Peak plus CONFIG_APP_FOOTPRINT_MARGIN_PCT, rounded up
+ */
+static uint32_t with_margin(uint32_t peak) {
+    return DIV_ROUND_UP(peak * (100 + CONFIG_APP_FOOTPRINT_MARGIN_PCT), 100);
+}
+
+#if !defined(CONFIG_ARCH_POSIX)
+/**
+ * @brief Report one thread's peak stack use (k_thread_foreach_unlocked() callback)
+ *
+ * @param thread Thread
+ * @param user_data Unused
+ */
+static void stack_report(const struct k_thread *thread, void *user_data) {
+
+    ARG_UNUSED(user_data);
+
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    size_t size = thread->stack_info.size;
+    size_t unused;
+
+    if (name == NULL || name[0] == '\0') {
+        name = "?";
+    }
+
+    if (k_thread_stack_space_get(thread, &unused) != 0) {
+        return;
+    }
+
+    uint32_t used = (uint32_t)(size - unused);
+
+    LOG_INF("stack %s %u/%u", name, used, (uint32_t)size);
+
+    const char *option = option_find(stack_options, ARRAY_SIZE(stack_options), name);
+
+    if (option != NULL) {
+        LOG_INF("override CONFIG_%s=%u", option,
+                (uint32_t)ROUND_UP(with_margin(used), STACK_ROUND));
+    }
+}
+#endif /* !CONFIG_ARCH_POSIX */
+
+/**
+ * @brief Report the lanes of a subscriber that has them
+ *
+ * @param sub Subscriber with lanes
+ */
+static void lanes_report(struct app_bus_sub *sub) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(lane_options); i++) {
+
+        if (strcmp(lane_options[i].name, sub->name) != 0) {
+            continue;
+        }
+
+        for (int c = 0; c < APP_BUS_CLASS_COUNT; c++) {
+            struct app_bus_lane_stats st;
+
+            if (app_bus_lane_stats_get(sub, c, &st) != 0) {
+                continue;
+            }
+
+            LOG_INF("queue %s/%s %u/%u", sub->name, class_names[c], st.peak,
+                    sub->lanes->lane[c].cap);
+            if (st.peak > 0) {
+                LOG_INF("override CONFIG_%s=%u", lane_options[i].option[c],
+                        with_margin(st.peak));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check whether a queue's consumer had a central to send to
+ *
+ * @param name Subscriber name
+ * @return false for the BLE stream queue if no frame went out, true otherwise
+ */
+static bool consumer_exercised(const char *name) {
+
+#if defined(CONFIG_APP_BLE_STREAM)
+    if (strcmp(name, "ble_stream_sub") == 0) {
+        struct comms_ble_stream_stats st;
+
+        comms_ble_stream_stats_get(&st);
+
+        return st.frames > 0;
+    }
+#else
+    ARG_UNUSED(name);
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Report one subscriber's peak occupancy (app_bus_sub_foreach() callback)
+ *
+ * @param sub Subscriber
+ * @param user_data Unused
+ */
+static void queue_report(struct app_bus_sub *sub, void *user_data) {
+
+    ARG_UNUSED(user_data);
+
+    uint32_t peak = app_bus_sub_high_water(sub);
+
+    LOG_INF("queue %s %u/%u", sub->name, peak, app_bus_sub_capacity(sub));
+
+    const char *option = option_find(queue_options, ARRAY_SIZE(queue_options), sub->name);
+
+    if (option != NULL && peak > 0 && consumer_exercised(sub->name)) {
+        LOG_INF("override CONFIG_%s=%u", option, with_margin(peak));
+    }
+
+    if (sub->ring != NULL) {
+        uint32_t ring_peak = app_bus_sub_ring_high_water(sub);
+
+        LOG_INF("queue %s/ring %u/%u", sub->name, ring_peak, sub->ring->mask + 1);
+
+        option = option_find(ring_options, ARRAY_SIZE(ring_options), sub->name);
+        if (option != NULL && ring_peak > 0) {
+            // The ring length must be a power of two
+            LOG_INF("override CONFIG_%s=%u", option,
+                    MAX(1U << LOG2CEIL(with_margin(ring_peak)), 2));
+        }
+    }
+
+    if (sub->lanes != NULL) {
+        lanes_report(sub);
+    }
+}
+
+/**
+ * @brief Log peak stack, queue, pool and heap use with suggested Kconfig values
+ *
+ * Peaks are since boot, so run the scenarios of interest first.
+ */
+void app_footprint_report(void) {
+
+#if !defined(CONFIG_ARCH_POSIX)
+    k_thread_foreach_unlocked(stack_report, NULL);
+#endif
+    app_bus_sub_foreach(queue_report, NULL);
+
+#if defined(CONFIG_BT)
+    struct comms_ble_tx_stats tx;
+
+    comms_ble_tx_stats_get(&tx);
+    LOG_INF("queue ble_tx_q %u/%u", tx.queue_peak, CONFIG_APP_BLE_TX_QUEUE_LEN);
+
+    // Without a central nothing is queued, or the queue only ever holds records to drop
+    if (tx.queue_peak > 0 && tx.completed > 0) {
+        LOG_INF("override CONFIG_APP_BLE_TX_QUEUE_LEN=%u", with_margin(tx.queue_peak));
+    }
+#endif
+
+    uint32_t bufs = app_buf_max_used();
+
+    LOG_INF("pool app_buf %u/%u", bufs, APP_BUF_COUNT);
+    if (bufs > 0) {
+        LOG_INF("override CONFIG_APP_BUF_COUNT=%u", MAX(with_margin(bufs), 2));
+    }
+
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS) && (CONFIG_HEAP_MEM_POOL_SIZE > 0)
+    extern struct k_heap _system_heap;
+    struct sys_memory_stats heap;
+
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap) == 0) {
+        LOG_INF("heap %u/%u", (uint32_t)heap.max_allocated_bytes, CONFIG_HEAP_MEM_POOL_SIZE);
+
+        // An unused heap may still serve a path the run did not reach: no suggestion
+        if (heap.max_allocated_bytes > 0) {
+            LOG_INF("override CONFIG_HEAP_MEM_POOL_SIZE=%u",
+                    (uint32_t)ROUND_UP(with_margin((uint32_t)heap.max_allocated_bytes), 256));
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Periodic report (work item)
+ *
+ * @param work Work item (unused)
+ */
+static void report_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    app_footprint_report();
+    (void)k_work_schedule(&g_report_work, K_SECONDS(CONFIG_APP_FOOTPRINT_REPORT_S));
+}
+
+/**
+ * @brief Schedule the first report
+ *
+ * @return 0
+ */
+static int app_footprint_init(void) {
+
+    (void)k_work_schedule(&g_report_work, K_SECONDS(CONFIG_APP_FOOTPRINT_REPORT_S));
+
+    return 0;
+}
+
+SYS_INIT(app_footprint_init, APPLICATION, 1);
@@ -0,0 +1,167 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/sys/util.h>
+
+#include <app/app_bus.h>
+#include <app/app_footprint.h>
+#include <app/app_msg.h>
+#include <app/sampler.h>
+
+LOG_MODULE_DECLARE(footprint, LOG_LEVEL_INF);
+
+/*
+Load scenarios for the native_sim footprint run (CONFIG_APP_FOOTPRINT_SCENARIOS):
+Peaks only cover what a run exercised, and an idle native_sim run exercises nothing. This
+thread drives what a busy session would: button bursts on the emulated GPIO pins, command
+bursts the size of a full batched BLE write, and the sampler at a raised rate with
+streaming on. It then reports once and logs the line the footprint_report target waits for.
+The thread is cooperative like the BT RX thread, so a burst is on the bus before any
+consumer runs.
+*/
+
+// Settle time before the first scenario: boot, advertising and the first sampler blocks
+#define START_DELAY_MS 1000
+
+// Press/release cycles of all four buttons at once
+#define BUTTON_CYCLES 10
+
+// Command bursts, each one batched write of CONFIG_APP_BLE_CMD_BATCH_MAX commands
+#define CMD_BURSTS 4
+
+// Sampling rate multiplier and duration of the sampler scenario
+#define SAMPLER_RATE_MUL 4
+#define SAMPLER_MS 3000
+
+// Only built for native_sim, where threads run on host stacks
+#define SCENARIO_STACK_SIZE 2048
+
+static const struct gpio_dt_spec buttons[] = {
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios),
+};
+
+/**
+ * @brief Drive every button input to one level
+ *
+ * @param pressed true to press (the buttons are active low)
+ */
+static void buttons_set(bool pressed) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+        bool level = (buttons[i].dt_flags & GPIO_ACTIVE_LOW) ? !pressed : pressed;
+
+        (void)gpio_emul_input_set(buttons[i].port, buttons[i].pin, level);
+    }
+}
+
+/**
+ * @brief Press and release all buttons together, each edge held past the debounce window
+ */
+static void scenario_buttons(void) {
+
+    for (int i = 0; i < BUTTON_CYCLES; i++) {
+        buttons_set(true);
+        k_msleep(2 * CONFIG_APP_SENSOR_DEBOUNCE_MS);
+        buttons_set(false);
+        k_msleep(2 * CONFIG_APP_SENSOR_DEBOUNCE_MS);
+    }
+}
+
+/**
+ * @brief Publish a batch of commands as a batched BLE write would
+ *
+ * @param id Command id of every record
+ * @param value Value of record i is value + i % span
+ * @param span Number of distinct values
+ * @param count Records in the batch
+ */
+static void command_batch(uint8_t id, uint32_t value, uint32_t span, int count) {
+
+    static struct app_msg msgs[CONFIG_APP_BLE_CMD_BATCH_MAX];
+    uint32_t now = k_uptime_get_32();
+
+    count = MIN(count, (int)ARRAY_SIZE(msgs));
+    for (int i = 0; i < count; i++) {
+        msgs[i] = (struct app_msg){
+            .type = APP_MSG_COMMAND,
+            .source = APP_SRC_COMMS,
+            .timestamp_ms = now,
+            .data.command = { .command_id = id, .value = value + (uint32_t)i % span },
+        };
+    }
+
+    int rc = app_bus_publish_batch(msgs, count);
+
+    if (rc < 0) {
+        LOG_WRN("scenario: command %u batch failed (%d)", id, rc);
+    }
+}
+
+/**
+ * @brief Full batches of LED toggles across the four LEDs, then back to the start state
+ */
+static void scenario_commands(void) {
+
+    for (int i = 0; i < CMD_BURSTS; i++) {
+        command_batch(APP_CMD_LED_TOGGLE, 0, 4, CONFIG_APP_BLE_CMD_BATCH_MAX);
+        k_msleep(100);
+    }
+}
+
+/**
+ * @brief Sample at a raised rate with streaming on, then restore both
+ */
+static void scenario_sampler(void) {
+
+#if defined(CONFIG_APP_SAMPLER)
+    if (IS_ENABLED(CONFIG_APP_BLE_STREAM)) {
+        command_batch(APP_CMD_STREAM, 1, 1, 1);
+    }
+
+    for (uint8_t ch = 0; ch < sampler_channel_count(); ch++) {
+        (void)sampler_set_rate(ch, SAMPLER_RATE_MUL * CONFIG_APP_SAMPLER_ADC_RATE_HZ);
+    }
+
+    k_msleep(SAMPLER_MS);
+
+    for (uint8_t ch = 0; ch < sampler_channel_count(); ch++) {
+        (void)sampler_set_rate(ch, CONFIG_APP_SAMPLER_ADC_RATE_HZ);
+    }
+
+    if (IS_ENABLED(CONFIG_APP_BLE_STREAM)) {
+        command_batch(APP_CMD_STREAM, 0, 1, 1);
+    }
+#endif
+}
+
+/**
+ * @brief Scenario thread: run each scenario once, then report
+ *
+ * @param p1 Unused
+ * @param p2 Unused
+ * @param p3 Unused
+ */
+static void scenario_thread(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    k_msleep(START_DELAY_MS);
+
+    scenario_buttons();
+    scenario_commands();
+    scenario_sampler();
+
+    // Let the last bursts drain before the peaks are read
+    k_msleep(500);
+
+    app_footprint_report();
+    LOG_INF("scenarios done");
+}
+
+K_THREAD_DEFINE(footprint_scn, SCENARIO_STACK_SIZE, scenario_thread, NULL, NULL, NULL, K_PRIO_COOP(7), 0, 0);
@@ -0,0 +1,283 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/reboot.h>
+#include <zephyr/task_wdt/task_wdt.h>
+
+#include <app/app_bus.h>
+#include <app/app_health.h>
+#include <app/app_msg.h>
+#include <app/app_store.h>
+
+LOG_MODULE_REGISTER(app_health, LOG_LEVEL_INF); // Enable logging
+
+/*
+Health monitor:
+A work item checks every channel each CONFIG_APP_HEALTH_CHECK_MS. A thread that is waiting,
+or inside an iteration that is still within its budget, gets its task watchdog channel fed
+by the monitor; a thread that overruns its budget is reported once (APP_MSG_STATUS, kind
+APP_STATUS_STALL) and, with CONFIG_APP_HEALTH_RESET, its channel is starved so the task
+watchdog resets the system. Because the feeding is done by the monitor, a blocked system
+workqueue starves every channel too. Threads never feed anything themselves, so an idle
+thread blocked on its queue costs no wake-ups.
+*/
+
+// A channel expires this long after its last feed, past the budget
+#define WDT_SLACK_MS (2 * CONFIG_APP_HEALTH_CHECK_MS)
+
+static void check_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(g_check_work, check_work_handler);
+
+static uint32_t g_next_report_ms;
+
+STRUCT_SECTION_START_EXTERN(app_health_chan);
+
+/**
+ * @brief Task watchdog expiry: a channel went unfed for its whole reload period
+ *
+ * Runs in the watchdog timer's ISR. Either the thread stayed stalled (with
+ * CONFIG_APP_HEALTH_RESET) or the monitor itself stopped running.
+ *
+ * @param channel_id Task watchdog channel
+ * @param user_data Health channel
+ */
+static void wdt_expired(int channel_id, void *user_data) {
+
+    const struct app_health_chan *ch = user_data;
+
+    ARG_UNUSED(channel_id);
+
+    LOG_PANIC();
+    LOG_ERR("%s: watchdog expired, resetting", ch->name);
+
+    sys_reboot(SYS_REBOOT_COLD);
+}
+
+/**
+ * @brief Bind the calling thread to its health channel
+ *
+ * Call once at the start of the thread, before its loop.
+ *
+ * @param ch Channel defined with APP_HEALTH_DEFINE()
+ */
+void app_health_start(const struct app_health_chan *ch) {
+
+    struct app_health_state *st = ch->state;
+
+    st->wdt_ch = task_wdt_add(ch->budget_ms + WDT_SLACK_MS, wdt_expired, (void *)ch);
+    if (st->wdt_ch < 0) {
+        // Still timed and reported, just not watchdog-backed
+        LOG_ERR("%s: no task watchdog channel (%d), raise CONFIG_TASK_WDT_CHANNELS",
+                ch->name, st->wdt_ch);
+    }
+
+    st->tid = k_current_get();
+}
+
+/**
+ * @brief Mark the start of a loop iteration
+ *
+ * @param ch Channel of the calling thread
+ */
+void app_health_begin(const struct app_health_chan *ch) {
+
+    struct app_health_state *st = ch->state;
+
+    st->begin_cycles = k_cycle_get_32();
+    st->stalled = false;
+    atomic_set(&st->busy, 1);
+}
+
+/**
+ * @brief Mark the end of a loop iteration and record its duration
+ *
+ * @param ch Channel of the calling thread
+ */
+void app_health_end(const struct app_health_chan *ch) {
+
+    struct app_health_state *st = ch->state;
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - st->begin_cycles);
+
+    atomic_set(&st->busy, 0);
+
+    st->loops++;
+    st->last_us = us;
+    if (us > st->max_us) {
+        st->max_us = us;
+    }
+}
+
+/**
+ * @brief Unused stack bytes of a bound thread
+ *
+ * @param st Channel state
+ * @return High-water headroom in bytes, 0 without CONFIG_INIT_STACKS
+ */
+static uint32_t stack_unused(const struct app_health_state *st) {
+
+#if defined(CONFIG_INIT_STACKS)
+    size_t unused;
+
+    if (k_thread_stack_space_get(st->tid, &unused) == 0) {
+        return (uint32_t)unused;
+    }
+#else
+    ARG_UNUSED(st);
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Publish one health status message
+ *
+ * @param kind Report kind
+ * @param idx Channel index
+ * @param arg Kind argument
+ * @param value Kind value
+ */
+static void status_publish(enum app_status_kind kind, size_t idx, uint16_t arg, uint32_t value) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_STATUS;
+    msg.source = APP_SRC_SYSTEM;
+    msg.timestamp_ms = k_uptime_get_32();
+    msg.data.status.kind = (uint8_t)kind;
+    msg.data.status.index = (uint8_t)idx;
+    msg.data.status.arg = arg;
+    msg.data.status.value = value;
+
+    (void)app_bus_publish(&msg);
+}
+
+/**
+ * @brief Check every channel, feed the healthy ones and send the periodic report (work item)
+ *
+ * @param work Work item (unused)
+ */
+static void check_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    uint32_t now = k_cycle_get_32();
+    bool report = ((int32_t)(k_uptime_get_32() - g_next_report_ms) >= 0);
+
+    STRUCT_SECTION_FOREACH(app_health_chan, ch) {
+
+        struct app_health_state *st = ch->state;
+        size_t idx = ch - STRUCT_SECTION_START(app_health_chan);
+
+        if (st->tid == NULL) {
+            continue;
+        }
+
+        // begin_cycles is written before busy is set
+        if (atomic_get(&st->busy)) {
+            uint32_t ms = k_cyc_to_ms_floor32(now - st->begin_cycles);
+
+            if (ms > ch->budget_ms) {
+                if (!st->stalled) {
+                    st->stalled = true;
+                    st->stalls++;
+                    LOG_ERR("%s: stalled (%u ms in one iteration, budget %u ms)", ch->name,
+                            ms, ch->budget_ms);
+                    status_publish(APP_STATUS_STALL, idx, 0, ms);
+
+                    // The reset comes from the watchdog ISR, where flash cannot be written
+                    if (IS_ENABLED(CONFIG_APP_HEALTH_RESET)) {
+                        APP_STORE_FLUSH();
+                    }
+                }
+
+                if (IS_ENABLED(CONFIG_APP_HEALTH_RESET)) {
+                    continue;
+                }
+            }
+        }
+
+        if (st->wdt_ch >= 0) {
+            (void)task_wdt_feed(st->wdt_ch);
+        }
+
+        if (report) {
+            status_publish(APP_STATUS_HEALTH, idx, (uint16_t)MIN(stack_unused(st), UINT16_MAX),
+                           st->max_us);
+        }
+    }
+
+    if (report) {
+        g_next_report_ms += CONFIG_APP_HEALTH_REPORT_INTERVAL_S * MSEC_PER_SEC;
+    }
+
+    (void)k_work_schedule(&g_check_work, K_MSEC(CONFIG_APP_HEALTH_CHECK_MS));
+}
+
+/**
+ * @brief Get the counters of one channel
+ *
+ * @param idx Channel index (as in APP_MSG_STATUS reports)
+ * @param out Destination
+ * @return 0 on success, -ENOENT past the last channel
+ */
+int app_health_stats_get(size_t idx, struct app_health_stats *out) {
+
+    size_t count;
+
+    STRUCT_SECTION_COUNT(app_health_chan, &count);
+    if (idx >= count) {
+        return -ENOENT;
+    }
+
+    const struct app_health_chan *ch = &STRUCT_SECTION_START(app_health_chan)[idx];
+    const struct app_health_state *st = ch->state;
+
+    out->name = ch->name;
+    out->budget_ms = ch->budget_ms;
+    out->loops = st->loops;
+    out->last_us = st->last_us;
+    out->max_us = st->max_us;
+    out->stalls = st->stalls;
+    out->stalled = st->stalled;
+    out->stack_size = 0;
+    out->stack_unused = 0;
+
+    if (st->tid != NULL) {
+        out->stack_size = (uint32_t)st->tid->stack_info.size;
+        out->stack_unused = stack_unused(st);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Start the task watchdog and the monitor before the application threads run
+ *
+ * @return 0 on success, negative error code otherwise
+ */
+static int app_health_init(void) {
+
+    // The hardware watchdog, if any, backs up the kernel timer the task watchdog runs on
+    const struct device *hw_wdt = DEVICE_DT_GET_OR_NULL(DT_ALIAS(watchdog0));
+
+    if (hw_wdt != NULL && !device_is_ready(hw_wdt)) {
+        hw_wdt = NULL;
+    }
+
+    int rc = task_wdt_init(hw_wdt);
+
+    if (rc != 0) {
+        LOG_ERR("task_wdt_init failed (%d)", rc);
+        return rc;
+    }
+
+    g_next_report_ms = k_uptime_get_32() + CONFIG_APP_HEALTH_REPORT_INTERVAL_S * MSEC_PER_SEC;
+    (void)k_work_schedule(&g_check_work, K_MSEC(CONFIG_APP_HEALTH_CHECK_MS));
+
+    return 0;
+}
+
+SYS_INIT(app_health_init, APPLICATION, 1);
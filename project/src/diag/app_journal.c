@@ -0,0 +1,614 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#if defined(CONFIG_APP_JOURNAL_FCB)
+#include <zephyr/storage/flash_map.h>
+#endif
+
+#include <app/app_journal.h>
+
+LOG_MODULE_REGISTER(app_journal, LOG_LEVEL_INF); // Enable logging
+
+/*
+Event journal:
+Records are appended to a byte ring in RAM; when it is full the oldest whole records are
+dropped and their deltas folded into the ring's base time, so the remaining records still
+decode to absolute uptimes. With CONFIG_APP_JOURNAL_FCB the oldest records are moved to a
+flash circular buffer in chunks of CONFIG_APP_JOURNAL_FCB_CHUNK bytes, one FCB entry each.
+Byte positions are also tracked as a running total of bytes ever written, so a flush or a
+download can release exactly what it covered even if the ring moved on meanwhile.
+*/
+
+#define RING_SIZE CONFIG_APP_JOURNAL_RAM_SIZE
+
+// Segment base time in front of the records
+#define SEG_BASE_LEN 4
+
+static struct k_spinlock g_lock;
+static uint8_t g_ring[RING_SIZE];
+static uint32_t g_tail;             // ring index of the oldest byte
+static uint32_t g_used;
+static uint32_t g_tail_total;       // running byte position of the oldest byte
+static uint32_t g_base_ms;          // uptime the oldest record's delta is relative to
+static uint32_t g_last_ms;          // uptime of the newest record
+static struct app_journal_stats g_stats;
+
+// Lost deliveries not yet written as DROP records
+static atomic_t g_drops[APP_JOURNAL_DROP_SRC_COUNT];
+
+// Reader snapshot (base + linearised ring); bit 0 of g_reader_busy: a reader is open
+static uint8_t g_snap[SEG_BASE_LEN + RING_SIZE];
+static atomic_t g_reader_busy;
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+#if !FIXED_PARTITION_EXISTS(journal_partition)
+#error "CONFIG_APP_JOURNAL_FCB needs a fixed partition labelled journal_partition"
+#endif
+
+BUILD_ASSERT(CONFIG_APP_JOURNAL_FCB_CHUNK <= RING_SIZE, "flash chunk larger than the RAM ring");
+
+// Flash write blocks are at most this large; entries are padded to a multiple of one
+#define FCB_ALIGN_MAX 16
+
+static struct fcb g_fcb;
+static struct flash_sector g_fcb_sectors[CONFIG_APP_JOURNAL_FCB_SECTORS];
+static bool g_fcb_ok;
+static uint8_t g_chunk[SEG_BASE_LEN + CONFIG_APP_JOURNAL_FCB_CHUNK + FCB_ALIGN_MAX];
+
+// Held by a flush pass from its reader check to the release of what it wrote
+static K_MUTEX_DEFINE(g_flush_lock);
+
+static void fcb_work_handler(struct k_work *work);
+
+static K_WORK_DEFINE(g_fcb_work, fcb_work_handler);
+#endif
+
+/**
+ * @brief Byte of the ring at an offset from the oldest byte
+ *
+ * @param off Offset from the tail
+ * @return Byte value
+ */
+static inline uint8_t ring_at(uint32_t off) {
+    return g_ring[(g_tail + off) % RING_SIZE];
+}
+
+/**
+ * @brief Append an unsigned LEB128 varint
+ *
+ * @param dst Destination (up to 5 bytes)
+ * @param v Value
+ * @return Bytes written
+ */
+static size_t varint_put(uint8_t *dst, uint32_t v) {
+
+    size_t n = 0;
+
+    do {
+        uint8_t b = v & 0x7F;
+
+        v >>= 7;
+        dst[n++] = b | ((v != 0) ? 0x80 : 0);
+    } while (v != 0);
+
+    return n;
+}
+
+/**
+ * @brief Decode the length and delta of the record at a ring offset
+ *
+ * Caller holds g_lock.
+ *
+ * @param off Offset of the record from the tail
+ * @param delta Output: the record's time delta (ms)
+ * @return Encoded length in bytes
+ */
+static uint32_t record_decode(uint32_t off, uint32_t *delta) {
+
+    uint8_t hdr = ring_at(off);
+    uint8_t kind = hdr >> 5;
+    uint32_t n = 1;
+    uint32_t v = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+
+    do {
+        b = ring_at(off + n++);
+        v |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+
+    if (kind == APP_JOURNAL_COMMAND || kind == APP_JOURNAL_DROP) {
+        do {
+            b = ring_at(off + n++);
+        } while (b & 0x80);
+    }
+
+    *delta = v;
+
+    return n;
+}
+
+/**
+ * @brief Remove the oldest record, folding its delta into the base time
+ *
+ * Caller holds g_lock.
+ */
+static void drop_oldest(void) {
+
+    uint32_t delta;
+    uint32_t n = record_decode(0, &delta);
+
+    g_tail = (g_tail + n) % RING_SIZE;
+    g_used -= n;
+    g_tail_total += n;
+    g_base_ms += delta;
+}
+
+/**
+ * @brief Drop records until the tail reaches a running byte position
+ *
+ * Caller holds g_lock.
+ *
+ * @param total Running position to release up to
+ */
+static void release_to(uint32_t total) {
+
+    while (g_used > 0 && (int32_t)(total - g_tail_total) > 0) {
+        drop_oldest();
+    }
+}
+
+/**
+ * @brief Encode one record and append it, dropping the oldest records if needed
+ *
+ * Caller holds g_lock.
+ *
+ * @param kind Record kind
+ * @param arg Kind argument (5 bits)
+ * @param has_payload true for kinds with a payload varint
+ * @param payload Payload value
+ */
+static void record_put(enum app_journal_kind kind, uint8_t arg, bool has_payload,
+                       uint32_t payload) {
+
+    uint8_t rec[APP_JOURNAL_RECORD_MAX];
+    uint32_t now = k_uptime_get_32();
+    size_t n = 0;
+
+    rec[n++] = (uint8_t)((kind << 5) | (arg & 0x1F));
+    n += varint_put(&rec[n], now - g_last_ms);
+    if (has_payload) {
+        n += varint_put(&rec[n], payload);
+    }
+
+    while (RING_SIZE - g_used < n) {
+        drop_oldest();
+        g_stats.overwritten++;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        g_ring[(g_tail + g_used + i) % RING_SIZE] = rec[i];
+    }
+
+    g_used += n;
+    g_last_ms = now;
+    g_stats.records++;
+    g_stats.bytes += n;
+}
+
+/**
+ * @brief Write pending drop counts as DROP records
+ *
+ * Caller holds g_lock.
+ */
+static void drops_put(void) {
+
+    for (int src = 0; src < APP_JOURNAL_DROP_SRC_COUNT; src++) {
+
+        uint32_t count = (uint32_t)atomic_clear(&g_drops[src]);
+
+        if (count != 0) {
+            record_put(APP_JOURNAL_DROP, src, true, count);
+        }
+    }
+}
+
+/**
+ * @brief Start moving a chunk to flash once enough records are waiting
+ */
+static void flush_kick(void) {
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+    if (g_fcb_ok && g_used >= CONFIG_APP_JOURNAL_FCB_CHUNK && !atomic_get(&g_reader_busy)) {
+        k_work_submit(&g_fcb_work);
+    }
+#endif
+}
+
+/**
+ * @brief Append a record (and any pending drop counts before it)
+ *
+ * @param kind Record kind
+ * @param arg Kind argument
+ * @param has_payload true for kinds with a payload
+ * @param payload Payload value
+ */
+static void journal_write(enum app_journal_kind kind, uint8_t arg, bool has_payload,
+                          uint32_t payload) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_lock);
+
+    drops_put();
+    record_put(kind, arg, has_payload, payload);
+
+    k_spin_unlock(&g_lock, key);
+
+    flush_kick();
+}
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+/**
+ * @brief Append one entry to the flash circular buffer, erasing the oldest sector if full
+ *
+ * @param data Entry bytes
+ * @param len Entry length (multiple of the flash write block)
+ * @return 0 on success, negative error code otherwise
+ */
+static int chunk_append(const uint8_t *data, size_t len) {
+
+    struct fcb_entry loc;
+    int rc = fcb_append(&g_fcb, len, &loc);
+
+    if (rc == -ENOSPC) {
+        rc = fcb_rotate(&g_fcb);
+        if (rc == 0) {
+            rc = fcb_append(&g_fcb, len, &loc);
+        }
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = flash_area_write(g_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), data, len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return fcb_append_finish(&g_fcb, &loc);
+}
+
+/**
+ * @brief Move full chunks of the oldest records to flash (work item)
+ *
+ * Paused while a reader is open, so a download never sees a record twice. Each pass holds
+ * g_flush_lock, so a reader opening meanwhile waits until the chunk is in flash and out of
+ * the ring before taking its snapshot.
+ *
+ * @param work Work item (unused)
+ */
+static void fcb_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    while (1) {
+
+        k_mutex_lock(&g_flush_lock, K_FOREVER);
+
+        k_spinlock_key_t key = k_spin_lock(&g_lock);
+
+        if (atomic_get(&g_reader_busy) || g_used < CONFIG_APP_JOURNAL_FCB_CHUNK) {
+            k_spin_unlock(&g_lock, key);
+            k_mutex_unlock(&g_flush_lock);
+            return;
+        }
+
+        // Whole records only, up to one chunk
+        uint32_t len = 0;
+        uint32_t start_total = g_tail_total;
+
+        while (len < g_used) {
+            uint32_t delta;
+            uint32_t n = record_decode(len, &delta);
+
+            if (len + n > CONFIG_APP_JOURNAL_FCB_CHUNK) {
+                break;
+            }
+            len += n;
+        }
+
+        sys_put_le32(g_base_ms, g_chunk);
+        for (uint32_t i = 0; i < len; i++) {
+            g_chunk[SEG_BASE_LEN + i] = ring_at(i);
+        }
+
+        k_spin_unlock(&g_lock, key);
+
+        size_t total = SEG_BASE_LEN + len;
+
+        // PAD bytes up to the write block size
+        while (total % g_fcb.f_align) {
+            g_chunk[total++] = 0xFF;
+        }
+
+        int rc = chunk_append(g_chunk, total);
+
+        key = k_spin_lock(&g_lock);
+        if (rc == 0) {
+            release_to(start_total + len);
+            g_stats.flash_entries++;
+        } else {
+            g_stats.flash_errors++;
+        }
+        k_spin_unlock(&g_lock, key);
+
+        k_mutex_unlock(&g_flush_lock);
+
+        if (rc != 0) {
+            LOG_WRN("flash append failed (%d)", rc);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Set up the flash circular buffer on journal_partition
+ *
+ * @return 0 on success, negative error code otherwise
+ */
+static int fcb_setup(void) {
+
+    uint32_t count = ARRAY_SIZE(g_fcb_sectors);
+    int rc = flash_area_get_sectors(FIXED_PARTITION_ID(journal_partition), &count,
+                                    g_fcb_sectors);
+
+    if (rc != 0) {
+        return rc;
+    }
+
+    g_fcb.f_magic = 0x4a524e4c;     // "JRNL"
+    g_fcb.f_version = 1;
+    g_fcb.f_sectors = g_fcb_sectors;
+    g_fcb.f_sector_cnt = (uint8_t)count;
+    g_fcb.f_scratch_cnt = 0;
+
+    rc = fcb_init(FIXED_PARTITION_ID(journal_partition), &g_fcb);
+    if (rc == 0 && g_fcb.f_align > FCB_ALIGN_MAX) {
+        rc = -ENOTSUP;
+    }
+
+    return rc;
+}
+#endif /* CONFIG_APP_JOURNAL_FCB */
+
+/**
+ * @brief Journal a bus message
+ *
+ * Button events and commands from outside the application (BLE, UART) are recorded;
+ * commands the controller derives from them are not, they follow from the journal.
+ *
+ * @param msg Message being published
+ */
+void app_journal_bus(const struct app_msg *msg) {
+
+    if (msg->type == APP_MSG_BUTTON_EVENT) {
+        journal_write(APP_JOURNAL_BUTTON,
+                      ((msg->data.button.button_id & 0x0F) << 1) | (msg->data.button.pressed & 1),
+                      false, 0);
+    } else if (msg->type == APP_MSG_COMMAND && msg->source != APP_SRC_CONTROLLER) {
+        journal_write(APP_JOURNAL_COMMAND, msg->data.command.command_id, true,
+                      msg->data.command.value);
+    }
+}
+
+/**
+ * @brief Journal a mode change
+ *
+ * @param mode New app_mode
+ */
+void app_journal_mode(uint8_t mode) {
+    journal_write(APP_JOURNAL_MODE, mode, false, 0);
+}
+
+/**
+ * @brief Count a lost delivery
+ *
+ * Only increments a counter (safe from any context); the count is written as one DROP
+ * record in front of the next record or when a reader opens.
+ *
+ * @param src Where the delivery was lost
+ */
+void app_journal_drop(enum app_journal_drop_src src) {
+
+    if (src < APP_JOURNAL_DROP_SRC_COUNT) {
+        atomic_inc(&g_drops[src]);
+    }
+}
+
+/**
+ * @brief Open a reader on a snapshot of the journal
+ *
+ * Pauses flushing to flash until app_journal_close(), after waiting for a flush in
+ * progress to finish. Must not be called from an ISR.
+ *
+ * @param rd Reader
+ * @return 0 on success, -EBUSY if a reader is already open
+ */
+int app_journal_open(struct app_journal_reader *rd) {
+
+    if (atomic_test_and_set_bit(&g_reader_busy, 0)) {
+        return -EBUSY;
+    }
+
+    memset(rd, 0, sizeof(*rd));
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+    // Later flush passes see the busy bit; wait for one already past that check
+    k_mutex_lock(&g_flush_lock, K_FOREVER);
+    k_mutex_unlock(&g_flush_lock);
+#endif
+
+    k_spinlock_key_t key = k_spin_lock(&g_lock);
+
+    drops_put();
+    sys_put_le32(g_base_ms, g_snap);
+    for (uint32_t i = 0; i < g_used; i++) {
+        g_snap[SEG_BASE_LEN + i] = ring_at(i);
+    }
+    rd->ram_len = SEG_BASE_LEN + g_used;
+    rd->end_total = g_tail_total + g_used;
+
+    k_spin_unlock(&g_lock, key);
+
+    // No current segment: the first read moves to the first flash entry or to RAM
+    rd->seg_off = sizeof(uint16_t);
+
+    return 0;
+}
+
+/**
+ * @brief Advance a reader to its next segment
+ *
+ * @param rd Reader
+ */
+static void segment_next(struct app_journal_reader *rd) {
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+    if (!rd->in_ram && g_fcb_ok && fcb_getnext(&g_fcb, &rd->loc) == 0) {
+        rd->seg_len = rd->loc.fe_data_len;
+        rd->seg_off = 0;
+        return;
+    }
+#endif
+
+    if (!rd->in_ram) {
+        rd->in_ram = true;
+        rd->seg_len = rd->ram_len;
+        rd->seg_off = 0;
+        return;
+    }
+
+    rd->done = true;
+}
+
+/**
+ * @brief Read the next bytes of the journal stream
+ *
+ * The stream is a sequence of segments, each as a u16 LE length followed by that many
+ * bytes (base time, then records).
+ *
+ * @param rd Open reader
+ * @param dst Destination
+ * @param max Bytes wanted
+ * @return Bytes read; less than max only at the end of the stream
+ */
+size_t app_journal_read(struct app_journal_reader *rd, uint8_t *dst, size_t max) {
+
+    size_t n = 0;
+
+    while (n < max && !rd->done) {
+
+        if (rd->seg_off == sizeof(uint16_t) + rd->seg_len) {
+            segment_next(rd);
+            continue;
+        }
+
+        // Length prefix
+        if (rd->seg_off < sizeof(uint16_t)) {
+            dst[n++] = (uint8_t)(rd->seg_len >> (8 * rd->seg_off));
+            rd->seg_off++;
+            continue;
+        }
+
+        uint32_t off = rd->seg_off - sizeof(uint16_t);
+        size_t take = MIN(max - n, rd->seg_len - off);
+
+        if (rd->in_ram) {
+            memcpy(&dst[n], &g_snap[off], take);
+        } else {
+#if defined(CONFIG_APP_JOURNAL_FCB)
+            if (flash_area_read(g_fcb.fap, FCB_ENTRY_FA_DATA_OFF(rd->loc) + off,
+                                &dst[n], take) != 0) {
+                // The length is already out: keep the framing, the decoder skips PAD bytes
+                memset(&dst[n], 0xFF, take);
+                g_stats.flash_errors++;
+            }
+#endif
+        }
+
+        n += take;
+        rd->seg_off += take;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Close a reader
+ *
+ * @param rd Reader
+ * @param commit true to discard everything the snapshot covered (it was delivered)
+ */
+void app_journal_close(struct app_journal_reader *rd, bool commit) {
+
+    if (commit) {
+        k_spinlock_key_t key = k_spin_lock(&g_lock);
+        release_to(rd->end_total);
+        k_spin_unlock(&g_lock, key);
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+        // Flushing was paused, so flash holds nothing newer than the snapshot
+        if (g_fcb_ok) {
+            (void)fcb_clear(&g_fcb);
+        }
+#endif
+    }
+
+    atomic_clear_bit(&g_reader_busy, 0);
+    flush_kick();
+}
+
+/**
+ * @brief Get journal counters
+ *
+ * @param out Destination
+ */
+void app_journal_stats_get(struct app_journal_stats *out) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_lock);
+
+    *out = g_stats;
+    out->ram_used = g_used;
+    out->bytes_per_event_x100 = (g_stats.records > 0) ?
+                                (uint32_t)((uint64_t)g_stats.bytes * 100 / g_stats.records) : 0;
+
+    k_spin_unlock(&g_lock, key);
+}
+
+/**
+ * @brief Open the flash buffer and write the BOOT record
+ *
+ * @return 0
+ */
+static int app_journal_init(void) {
+
+#if defined(CONFIG_APP_JOURNAL_FCB)
+    int rc = fcb_setup();
+
+    g_fcb_ok = (rc == 0);
+    if (!g_fcb_ok) {
+        LOG_ERR("flash journal unavailable (%d), RAM only", rc);
+    }
+#endif
+
+    g_last_ms = k_uptime_get_32();
+    g_base_ms = g_last_ms;
+    journal_write(APP_JOURNAL_BOOT, 0, false, 0);
+
+    return 0;
+}
+
+SYS_INIT(app_journal_init, APPLICATION, 1);
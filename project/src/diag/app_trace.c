@@ -0,0 +1,125 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <app/app_trace.h>
+
+#if defined(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+// Per-stage log2 latency histograms, updated lock-free from any thread
+static atomic_t g_hist[APP_TRACE_STAGE_COUNT][APP_TRACE_BUCKETS];
+
+/**
+ * @brief Record one latency sample for a pipeline stage
+ *
+ * @param stage Stage that was reached
+ * @param origin_cycles k_cycle_get_32() value at the event's origin
+ */
+void app_trace_record(enum app_trace_stage stage, uint32_t origin_cycles) {
+
+    if (stage >= APP_TRACE_STAGE_COUNT) {
+        return;
+    }
+
+    uint32_t delta = k_cycle_get_32() - origin_cycles;
+    int bucket = (delta == 0) ? 0 : (31 - __builtin_clz(delta));
+
+    atomic_inc(&g_hist[stage][bucket]);
+}
+
+/**
+ * @brief Copy all histograms
+ *
+ * @param out Destination, one row of bucket counts per stage
+ */
+void app_trace_snapshot(uint32_t out[APP_TRACE_STAGE_COUNT][APP_TRACE_BUCKETS]) {
+
+    for (int s = 0; s < APP_TRACE_STAGE_COUNT; s++) {
+        for (int b = 0; b < APP_TRACE_BUCKETS; b++) {
+            out[s][b] = (uint32_t)atomic_get(&g_hist[s][b]);
+        }
+    }
+}
+
+/**
+ * @brief Clear all histograms
+ */
+void app_trace_reset(void) {
+
+    for (int s = 0; s < APP_TRACE_STAGE_COUNT; s++) {
+        for (int b = 0; b < APP_TRACE_BUCKETS; b++) {
+            atomic_clear(&g_hist[s][b]);
+        }
+    }
+}
+
+// Convert a stage enum to a short label for printing.
+const char *app_trace_stage_str(enum app_trace_stage stage) {
+
+    switch (stage) {
+        case APP_TRACE_SENSOR_PUBLISH:      return "sensor_publish";
+        case APP_TRACE_CTRL_DEQUEUE:        return "ctrl_dequeue";
+        case APP_TRACE_BLE_NOTIFY_ENTER:    return "ble_notify_enter";
+        case APP_TRACE_BLE_NOTIFY_EXIT:     return "ble_notify_exit";
+        case APP_TRACE_ACT_HANDLE:          return "act_handle";
+        case APP_TRACE_LED_APPLY:           return "led_apply";
+        default:                            return "unknown";
+    }
+}
+
+#if defined(CONFIG_SHELL)
+
+/**
+ * @brief Shell: print non-empty histogram buckets per stage
+ *
+ * Each line shows the bucket's lower bound in microseconds and its sample count.
+ */
+static int cmd_trace_show(const struct shell *sh, size_t argc, char **argv) {
+
+    static uint32_t snap[APP_TRACE_STAGE_COUNT][APP_TRACE_BUCKETS];
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    app_trace_snapshot(snap);
+
+    for (int s = 0; s < APP_TRACE_STAGE_COUNT; s++) {
+        uint32_t total = 0;
+
+        for (int b = 0; b < APP_TRACE_BUCKETS; b++) {
+            total += snap[s][b];
+        }
+
+        shell_print(sh, "%s: %u samples", app_trace_stage_str(s), total);
+
+        for (int b = 0; b < APP_TRACE_BUCKETS; b++) {
+            if (snap[s][b] != 0) {
+                shell_print(sh, "  >= %u us: %u",
+                            k_cyc_to_us_floor32((b == 0) ? 0 : BIT(b)), snap[s][b]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_trace_reset(const struct shell *sh, size_t argc, char **argv) {
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    app_trace_reset();
+    shell_print(sh, "trace histograms cleared");
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(trace_cmds,
+    SHELL_CMD(show, NULL, "Print per-stage latency histograms", cmd_trace_show),
+    SHELL_CMD(reset, NULL, "Clear latency histograms", cmd_trace_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(trace, &trace_cmds, "Pipeline latency tracing", NULL);
+
+#endif /* CONFIG_SHELL */
@@ -0,0 +1,543 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <app/dsp.h>
+
+#define DSP_PI 3.14159265358979323846
+
+/**
+ * @brief Saturate a value to the q15 range
+ *
+ * @param v Value
+ * @return v clamped to [INT16_MIN, INT16_MAX]
+ */
+static inline int16_t sat_q15(int64_t v) {
+    return (int16_t)CLAMP(v, INT16_MIN, INT16_MAX);
+}
+
+/**
+ * @brief Convert a real number in [-1, 1] to q15
+ *
+ * @param v Value
+ * @return Rounded, saturated q15 value
+ */
+static int16_t to_q15(double v) {
+    return sat_q15((int64_t)(v * 32768.0 + ((v >= 0) ? 0.5 : -0.5)));
+}
+
+/**
+ * @brief Sine without libm (coefficient design only, not on the sample path)
+ *
+ * Range-reduced to [-pi, pi], Taylor series to x^15: error < 1e-6, well below one q15 step.
+ *
+ * @param x Angle in radians
+ * @return sin(x)
+ */
+static double dsp_sin(double x) {
+
+    while (x > DSP_PI) {
+        x -= 2 * DSP_PI;
+    }
+    while (x < -DSP_PI) {
+        x += 2 * DSP_PI;
+    }
+
+    double term = x;
+    double sum = x;
+
+    for (int n = 1; n <= 7; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+
+    return sum;
+}
+
+static double dsp_cos(double x) {
+    return dsp_sin(x + DSP_PI / 2);
+}
+
+/**
+ * @brief Initialise a FIR decimator
+ *
+ * @param f Instance
+ * @param coeffs q15 coefficients, must stay valid
+ * @param taps Number of coefficients
+ * @param factor Decimation factor (1 = no decimation)
+ * @param state Buffer of DSP_FIR_STATE_LEN(taps, max_block) samples
+ * @param max_block Largest input block passed to dsp_fir_run(), a multiple of factor
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int dsp_fir_init(struct dsp_fir *f, const int16_t *coeffs, uint16_t taps, uint8_t factor,
+                 int16_t *state, uint16_t max_block) {
+
+    if (coeffs == NULL || state == NULL || taps == 0 || factor == 0 ||
+        max_block == 0 || (max_block % factor) != 0) {
+        return -EINVAL;
+    }
+
+    memset(state, 0, DSP_FIR_STATE_LEN(taps, max_block) * sizeof(int16_t));
+    f->max_block = max_block;
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    if (arm_fir_decimate_init_q15(&f->inst, taps, factor, coeffs, state, max_block) !=
+        ARM_MATH_SUCCESS) {
+        return -EINVAL;
+    }
+#else
+    f->coeffs = coeffs;
+    f->state = state;
+    f->taps = taps;
+    f->factor = factor;
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Filter and decimate one block
+ *
+ * @param f Instance
+ * @param in Input samples
+ * @param out Output, count / factor samples (may alias in)
+ * @param count Number of inputs, a multiple of the factor and at most max_block
+ * @return Number of outputs written, 0 if count is not acceptable
+ */
+uint16_t dsp_fir_run(struct dsp_fir *f, const int16_t *in, int16_t *out, uint16_t count) {
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    uint8_t factor = f->inst.M;
+#else
+    uint8_t factor = f->factor;
+#endif
+
+    if (count == 0 || count > f->max_block || (count % factor) != 0) {
+        return 0;
+    }
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_fir_decimate_q15(&f->inst, in, out, count);
+#else
+    // Same layout as CMSIS: history first, then the new block, one linear window per output
+    int16_t *hist = f->state;
+    int16_t *cur = hist + f->taps - 1;
+
+    memcpy(cur, in, count * sizeof(int16_t));
+
+    for (uint16_t o = 0; o < count / factor; o++) {
+        const int16_t *x = cur + (o + 1) * factor - f->taps;
+        int64_t acc = 0;
+
+        for (uint16_t k = 0; k < f->taps; k++) {
+            acc += (int32_t)x[k] * f->coeffs[f->taps - 1 - k];
+        }
+        out[o] = sat_q15(acc >> 15);
+    }
+
+    memmove(hist, hist + count, (f->taps - 1) * sizeof(int16_t));
+#endif
+
+    return count / factor;
+}
+
+/**
+ * @brief Initialise a biquad cascade
+ *
+ * @param b Instance
+ * @param coeffs DSP_BIQUAD_COEFFS q15 coefficients per stage, must stay valid
+ * @param stages Number of stages
+ * @param post_shift Coefficient scaling (see struct dsp_biquad)
+ * @param state Buffer of DSP_BIQUAD_STATE_LEN(stages) samples
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int dsp_biquad_init(struct dsp_biquad *b, const int16_t *coeffs, uint8_t stages,
+                    int8_t post_shift, int16_t *state) {
+
+    if (coeffs == NULL || state == NULL || stages == 0 || post_shift < 0 || post_shift > 15) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_biquad_cascade_df1_init_q15(&b->inst, stages, coeffs, state, post_shift);
+#else
+    memset(state, 0, DSP_BIQUAD_STATE_LEN(stages) * sizeof(int16_t));
+    b->coeffs = coeffs;
+    b->state = state;
+    b->stages = stages;
+    b->post_shift = post_shift;
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Run a block through a biquad cascade
+ *
+ * @param b Instance
+ * @param in Input samples
+ * @param out Output samples (may alias in)
+ * @param count Number of samples
+ */
+void dsp_biquad_run(struct dsp_biquad *b, const int16_t *in, int16_t *out, uint16_t count) {
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_biquad_cascade_df1_q15(&b->inst, in, out, count);
+#else
+    const int16_t *src = in;
+
+    for (uint8_t s = 0; s < b->stages; s++) {
+
+        const int16_t *c = &b->coeffs[s * DSP_BIQUAD_COEFFS];
+        int16_t *st = &b->state[s * 4];
+
+        for (uint16_t n = 0; n < count; n++) {
+            int16_t x = src[n];
+            int64_t acc = (int32_t)c[0] * x + (int32_t)c[2] * st[0] + (int32_t)c[3] * st[1] +
+                          (int32_t)c[4] * st[2] + (int32_t)c[5] * st[3];
+            int16_t y = sat_q15(acc >> (15 - b->post_shift));
+
+            st[1] = st[0];
+            st[0] = x;
+            st[3] = st[2];
+            st[2] = y;
+            out[n] = y;
+        }
+
+        src = out;
+    }
+#endif
+}
+
+/**
+ * @brief Sum of squares of a block
+ *
+ * @param in Samples
+ * @param count Number of samples
+ * @return Sum of x[n]^2 (raw q30 products)
+ */
+int64_t dsp_power(const int16_t *in, uint16_t count) {
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    q63_t result;
+
+    arm_power_q15(in, count, &result);
+    return result;
+#else
+    int64_t acc = 0;
+
+    for (uint16_t n = 0; n < count; n++) {
+        acc += (int32_t)in[n] * in[n];
+    }
+
+    return acc;
+#endif
+}
+
+/**
+ * @brief Largest absolute value of a block
+ *
+ * @param in Samples
+ * @param count Number of samples (at least 1)
+ * @return max |x[n]|, saturated to INT16_MAX
+ */
+int16_t dsp_peak(const int16_t *in, uint16_t count) {
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    q15_t result;
+    uint32_t index;
+
+    arm_absmax_q15(in, count, &result, &index);
+    return result;
+#else
+    int32_t peak = 0;
+
+    for (uint16_t n = 0; n < count; n++) {
+        int32_t a = (in[n] < 0) ? -(int32_t)in[n] : in[n];
+
+        peak = MAX(peak, a);
+    }
+
+    return sat_q15(peak);
+#endif
+}
+
+/**
+ * @brief Count sign changes, continuing from the previous block
+ *
+ * Zero counts as positive. No CMSIS kernel exists for this, both builds use this loop.
+ *
+ * @param in Samples
+ * @param count Number of samples
+ * @param prev In: last sample of the previous block, out: last sample of this block
+ * @return Number of sign changes
+ */
+uint16_t dsp_zero_crossings(const int16_t *in, uint16_t count, int16_t *prev) {
+
+    uint16_t crossings = 0;
+    bool neg = (*prev < 0);
+
+    for (uint16_t n = 0; n < count; n++) {
+        bool cur = (in[n] < 0);
+
+        crossings += (cur != neg);
+        neg = cur;
+    }
+
+    if (count > 0) {
+        *prev = in[count - 1];
+    }
+
+    return crossings;
+}
+
+/**
+ * @brief Integer square root
+ *
+ * @param v Value
+ * @return floor(sqrt(v))
+ */
+uint16_t dsp_isqrt(uint32_t v) {
+
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)res;
+}
+
+/**
+ * @brief One coefficient of a windowed-sinc (Hamming) low-pass
+ *
+ * @param n Tap index
+ * @param taps Number of coefficients
+ * @param fc Cut-off as a fraction of the sampling rate
+ * @return Unnormalised coefficient
+ */
+static double lowpass_tap(uint16_t n, uint16_t taps, double fc) {
+
+    double t = n - (taps - 1) / 2.0;
+    double sinc = (t == 0) ? 2 * fc : dsp_sin(2 * DSP_PI * fc * t) / (DSP_PI * t);
+    double win = (taps > 1) ? 0.54 - 0.46 * dsp_cos(2 * DSP_PI * n / (taps - 1)) : 1.0;
+
+    return sinc * win;
+}
+
+/**
+ * @brief Design a windowed-sinc low-pass FIR for decimation
+ *
+ * Cut-off at the output Nyquist frequency, unity DC gain.
+ *
+ * @param coeffs Output, taps q15 coefficients (symmetric)
+ * @param taps Number of coefficients
+ * @param factor Decimation factor the filter is for
+ */
+void dsp_fir_design_lowpass(int16_t *coeffs, uint16_t taps, uint8_t factor) {
+
+    double fc = 0.5 / MAX(factor, 1);
+    double sum = 0;
+
+    for (uint16_t n = 0; n < taps; n++) {
+        sum += lowpass_tap(n, taps, fc);
+    }
+
+    for (uint16_t n = 0; n < taps; n++) {
+        coeffs[n] = to_q15(lowpass_tap(n, taps, fc) / sum);
+    }
+}
+
+/**
+ * @brief Design a second-order Butterworth high-pass (DC blocker) for one biquad stage
+ *
+ * @param coeffs Output, DSP_BIQUAD_COEFFS q15 coefficients for post_shift 1
+ * @param fs_hz Sampling rate
+ * @param fc_hz Cut-off frequency
+ */
+void dsp_biquad_design_highpass(int16_t *coeffs, uint32_t fs_hz, uint32_t fc_hz) {
+
+    double w0 = 2 * DSP_PI * fc_hz / fs_hz;
+    double cw = dsp_cos(w0);
+    double alpha = dsp_sin(w0) / 1.4142135623730951;    // Q = 1/sqrt(2)
+    double a0 = 1 + alpha;
+
+    // Halved for post_shift 1; a1/a2 negated for the DF1 recursion sign
+    coeffs[0] = to_q15((1 + cw) / 2 / a0 / 2);
+    coeffs[1] = 0;
+    coeffs[2] = -2 * coeffs[0];     // exact zero at DC despite rounding
+    coeffs[3] = coeffs[0];
+    coeffs[4] = to_q15(2 * cw / a0 / 2);
+    coeffs[5] = to_q15(-(1 - alpha) / a0 / 2);
+}
+
+#if defined(CONFIG_APP_DSP_FFT)
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+static q15_t fft_out[2 * CONFIG_APP_DSP_FFT_LEN];
+static q15_t fft_mag[CONFIG_APP_DSP_FFT_LEN / 2];
+#else
+static int16_t fft_twiddle[CONFIG_APP_DSP_FFT_LEN];     // cos, sin of 2*pi*k/len, k < len/2
+static int32_t fft_re[CONFIG_APP_DSP_FFT_LEN];
+static int32_t fft_im[CONFIG_APP_DSP_FFT_LEN];
+static uint32_t fft_mag[CONFIG_APP_DSP_FFT_LEN / 2];
+
+/**
+ * @brief In-place radix-2 FFT of a real block, scaled by 1/len like the CMSIS q15 transforms
+ *
+ * @param len Transform length (power of two)
+ * @param in Input samples
+ */
+static void fft_run(uint16_t len, const int16_t *in) {
+
+    for (uint16_t i = 0; i < len; i++) {
+
+        uint16_t j = 0;
+
+        for (uint16_t bit = 1, rev = len >> 1; bit < len; bit <<= 1, rev >>= 1) {
+            if (i & bit) {
+                j |= rev;
+            }
+        }
+
+        fft_re[j] = in[i];
+        fft_im[j] = 0;
+    }
+
+    for (uint16_t size = 2; size <= len; size <<= 1) {
+
+        uint16_t half = size / 2;
+        uint16_t step = len / size;
+
+        for (uint16_t start = 0; start < len; start += size) {
+            for (uint16_t k = 0; k < half; k++) {
+
+                int32_t wr = fft_twiddle[2 * k * step];
+                int32_t wi = -fft_twiddle[2 * k * step + 1];
+                uint16_t a = start + k;
+                uint16_t b = a + half;
+                int32_t tr = (int32_t)(((int64_t)fft_re[b] * wr - (int64_t)fft_im[b] * wi) >> 15);
+                int32_t ti = (int32_t)(((int64_t)fft_re[b] * wi + (int64_t)fft_im[b] * wr) >> 15);
+
+                // Halve every stage so values stay within q15
+                fft_re[b] = (fft_re[a] - tr) >> 1;
+                fft_im[b] = (fft_im[a] - ti) >> 1;
+                fft_re[a] = (fft_re[a] + tr) >> 1;
+                fft_im[a] = (fft_im[a] + ti) >> 1;
+            }
+        }
+    }
+
+    // Squared magnitude in the CMSIS 3.13 format
+    for (uint16_t k = 0; k < len / 2; k++) {
+        int64_t sq = (int64_t)fft_re[k] * fft_re[k] + (int64_t)fft_im[k] * fft_im[k];
+
+        fft_mag[k] = (uint32_t)(sq >> 17);
+    }
+}
+#endif
+
+/**
+ * @brief Initialise the band energy transform
+ *
+ * @param f Instance
+ * @param len Transform length, power of two between 32 and CONFIG_APP_DSP_FFT_LEN
+ * @return 0 on success, -EINVAL on an unsupported length
+ */
+int dsp_fft_init(struct dsp_fft *f, uint16_t len) {
+
+    if (len < 32 || len > CONFIG_APP_DSP_FFT_LEN || (len & (len - 1)) != 0) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    if (arm_rfft_init_q15(&f->inst, len, 0, 1) != ARM_MATH_SUCCESS) {
+        return -EINVAL;
+    }
+#else
+    for (uint16_t k = 0; k < len / 2; k++) {
+        fft_twiddle[2 * k] = to_q15(dsp_cos(2 * DSP_PI * k / len));
+        fft_twiddle[2 * k + 1] = to_q15(dsp_sin(2 * DSP_PI * k / len));
+    }
+    f->twiddle = fft_twiddle;
+#endif
+
+    f->len = len;
+
+    return 0;
+}
+
+/**
+ * @brief Split the spectrum of one block into equal-width band energies
+ *
+ * Bins 1 to len/2 - 1 (DC excluded) are divided into band_count contiguous bands; each
+ * band reports the sum of its squared magnitudes. The two builds scale the transform
+ * slightly differently, so energies are comparable within one build only.
+ * Uses file-level scratch buffers: only one thread may call it.
+ *
+ * @param f Instance
+ * @param in len samples, overwritten by the CMSIS transform
+ * @param bands Output, band_count energies
+ * @param band_count Number of bands (at least 1, at most len/2 - 1)
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int dsp_band_energy(struct dsp_fft *f, int16_t *in, uint32_t *bands, uint8_t band_count) {
+
+    uint16_t bins = f->len / 2 - 1;
+
+    if (band_count == 0 || band_count > bins) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_APP_DSP_CMSIS)
+    arm_rfft_q15(&f->inst, in, fft_out);
+    arm_cmplx_mag_squared_q15(fft_out, fft_mag, f->len / 2);
+#else
+    fft_run(f->len, in);
+#endif
+
+    uint16_t per_band = bins / band_count;
+
+    for (uint8_t b = 0; b < band_count; b++) {
+
+        uint16_t first = 1 + b * per_band;
+        uint16_t last = (b == band_count - 1) ? bins : first + per_band - 1;
+        uint32_t sum = 0;
+
+        for (uint16_t k = first; k <= last; k++) {
+            sum += (uint32_t)fft_mag[k];
+        }
+        bands[b] = sum;
+    }
+
+    return 0;
+}
+
+#else /* CONFIG_APP_DSP_FFT */
+
+int dsp_fft_init(struct dsp_fft *f, uint16_t len) {
+    ARG_UNUSED(f);
+    ARG_UNUSED(len);
+    return -ENOTSUP;
+}
+
+int dsp_band_energy(struct dsp_fft *f, int16_t *in, uint32_t *bands, uint8_t band_count) {
+    ARG_UNUSED(f);
+    ARG_UNUSED(in);
+    ARG_UNUSED(bands);
+    ARG_UNUSED(band_count);
+    return -ENOTSUP;
+}
+
+#endif /* CONFIG_APP_DSP_FFT */
@@ -0,0 +1,345 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <app/app_bus.h>
+#include <app/app_health.h>
+#include <app/app_msg.h>
+#include <app/dsp.h>
+#include <app/sampler.h>
+
+LOG_MODULE_REGISTER(dsp_stage, LOG_LEVEL_INF); // Enable logging
+
+// Sampler channels and values per sample analysed; further axes are passed over
+#define DSP_MAX_CHANNELS 2
+#define DSP_MAX_AXES 3
+
+#define DECIM CONFIG_APP_DSP_DECIMATION
+#define TAPS CONFIG_APP_DSP_FIR_TAPS
+
+// Per-axis input: up to DECIM - 1 leftover samples plus one full block
+#define IN_MAX (SAMPLER_BLOCK_VALUES + DECIM - 1)
+#define FIR_MAX_BLOCK ROUND_DOWN(IN_MAX, DECIM)
+
+#if defined(CONFIG_APP_DSP_FFT)
+#define BANDS CONFIG_APP_DSP_FFT_BANDS
+#else
+#define BANDS 0
+#endif
+
+// Largest number of feature messages per channel window
+#define FEATURES_MAX (DSP_MAX_AXES * (3 + BANDS))
+
+BUILD_ASSERT(FIR_MAX_BLOCK > 0, "decimation factor larger than a sampler block");
+
+// Sampler blocks only; a full queue drops blocks (counted by the bus), never stalls the sampler
+APP_BUS_SUBSCRIBER_DEFINE(dsp_sub, CONFIG_APP_DSP_QUEUE_LEN,
+                          APP_BUS_TYPE(APP_MSG_DATA),
+                          APP_BUS_SRC(APP_SRC_SAMPLER),
+                          0);
+
+struct axis_state {
+    struct dsp_biquad hp;
+    int16_t hp_state[DSP_BIQUAD_STATE_LEN(1)];
+    struct dsp_fir lp;
+    int16_t lp_state[DSP_FIR_STATE_LEN(TAPS, FIR_MAX_BLOCK)];
+    int16_t in[IN_MAX];
+    uint16_t in_len;
+
+    // Window accumulators (decimated samples)
+    int64_t power;
+    uint32_t count;
+    int16_t peak;
+    uint16_t crossings;
+    int16_t zc_prev;
+#if defined(CONFIG_APP_DSP_FFT)
+    int16_t fft_in[CONFIG_APP_DSP_FFT_LEN];
+    uint16_t fft_fill;
+#endif
+};
+
+struct chan_state {
+    uint32_t period_us;         // input sample period the filters were set up for, 0 = none
+    uint32_t window_us;         // input time accumulated in the current window
+    uint8_t axes;
+    int16_t hp_coeffs[DSP_BIQUAD_COEFFS];
+    struct axis_state axis[DSP_MAX_AXES];
+};
+
+static struct chan_state g_chan[DSP_MAX_CHANNELS];
+static int16_t g_lp_coeffs[TAPS];
+static int16_t g_out[FIR_MAX_BLOCK / DECIM];
+static struct app_msg g_features[FEATURES_MAX];
+static atomic_t g_window_us = ATOMIC_INIT(USEC_PER_SEC / CONFIG_APP_DSP_OUTPUT_RATE_HZ);
+static struct dsp_stage_stats g_stats;
+
+APP_HEALTH_DEFINE(dsp_health, "dsp", 500);
+
+#if defined(CONFIG_APP_DSP_FFT)
+static struct dsp_fft g_fft;
+#endif
+
+/**
+ * @brief Set up (or reset) a channel's filters for a new input rate and width
+ *
+ * @param ch Channel state
+ * @param hdr Header of the block that triggered the setup
+ */
+static void chan_setup(struct chan_state *ch, const struct sampler_block_hdr *hdr) {
+
+    uint32_t fs_hz = USEC_PER_SEC / hdr->period_us;
+    // q15 poles closer to DC than fs/100 turn output rounding into a large offset
+    uint32_t hp_hz = MAX(CONFIG_APP_DSP_HIGHPASS_HZ, fs_hz / 100);
+    bool hp = (CONFIG_APP_DSP_HIGHPASS_HZ > 0) && (hp_hz < fs_hz / 2);
+
+    memset(ch, 0, sizeof(*ch));
+    ch->period_us = hdr->period_us;
+    ch->axes = MIN(hdr->width, DSP_MAX_AXES);
+
+    // Pass-through biquad (b0 = 0.5, post_shift 1) when the high-pass cannot be used at this rate
+    if (hp) {
+        dsp_biquad_design_highpass(ch->hp_coeffs, fs_hz, hp_hz);
+    } else {
+        ch->hp_coeffs[0] = 1 << 14;
+    }
+
+    for (uint8_t a = 0; a < ch->axes; a++) {
+        struct axis_state *ax = &ch->axis[a];
+
+        (void)dsp_biquad_init(&ax->hp, ch->hp_coeffs, 1, 1, ax->hp_state);
+        (void)dsp_fir_init(&ax->lp, g_lp_coeffs, TAPS, DECIM, ax->lp_state, FIR_MAX_BLOCK);
+    }
+
+    LOG_INF("channel %u: %u Hz x%u, high-pass %u Hz", hdr->channel, fs_hz, hdr->width,
+            hp ? hp_hz : 0);
+}
+
+/**
+ * @brief Run one axis of a block through the filters and into the window accumulators
+ *
+ * @param ax Axis state
+ * @param data Interleaved samples of the block
+ * @param width Values per sample
+ * @param count Number of samples
+ */
+static void axis_process(struct axis_state *ax, const int16_t *data, uint8_t width,
+                         uint16_t count) {
+
+    int16_t *dst = &ax->in[ax->in_len];
+
+    for (uint16_t n = 0; n < count; n++) {
+        dst[n] = data[n * width];
+    }
+
+    dsp_biquad_run(&ax->hp, dst, dst, count);
+    ax->in_len += count;
+
+    // Decimate whole groups only; the remainder waits for the next block
+    uint16_t run = ROUND_DOWN(ax->in_len, DECIM);
+    uint16_t out_n = dsp_fir_run(&ax->lp, ax->in, g_out, run);
+
+    ax->in_len -= run;
+    memmove(ax->in, &ax->in[run], ax->in_len * sizeof(int16_t));
+
+    if (out_n == 0) {
+        return;
+    }
+
+    ax->power += dsp_power(g_out, out_n);
+    ax->count += out_n;
+    ax->peak = MAX(ax->peak, dsp_peak(g_out, out_n));
+    ax->crossings += dsp_zero_crossings(g_out, out_n, &ax->zc_prev);
+
+#if defined(CONFIG_APP_DSP_FFT)
+    uint16_t take = MIN(out_n, CONFIG_APP_DSP_FFT_LEN - ax->fft_fill);
+
+    memcpy(&ax->fft_in[ax->fft_fill], g_out, take * sizeof(int16_t));
+    ax->fft_fill += take;
+#endif
+}
+
+/**
+ * @brief Append one feature message to the window batch
+ *
+ * @param n In/out: number of messages in g_features
+ * @param channel Sampler channel
+ * @param axis Axis index
+ * @param kind Feature kind
+ * @param index Band number (APP_FEATURE_BAND_ENERGY), else 0
+ * @param value Feature value
+ */
+static void feature_add(size_t *n, uint8_t channel, uint8_t axis, enum app_feature_kind kind,
+                        uint8_t index, int32_t value) {
+
+    struct app_msg *m = &g_features[(*n)++];
+
+    m->type = APP_MSG_FEATURE;
+    m->source = APP_SRC_DSP;
+    m->timestamp_ms = (uint32_t)k_uptime_get();
+    m->data.feature.channel = channel;
+    m->data.feature.axis = axis;
+    m->data.feature.kind = kind;
+    m->data.feature.index = index;
+    m->data.feature.value = value;
+}
+
+/**
+ * @brief Close a channel's window: publish its features as one batch and reset the accumulators
+ *
+ * @param idx Channel index
+ */
+static void window_publish(uint8_t idx) {
+
+    struct chan_state *ch = &g_chan[idx];
+    size_t n = 0;
+
+    for (uint8_t a = 0; a < ch->axes; a++) {
+
+        struct axis_state *ax = &ch->axis[a];
+
+        if (ax->count == 0) {
+            continue;
+        }
+
+        uint16_t rms = dsp_isqrt((uint32_t)(ax->power / ax->count));
+
+        feature_add(&n, idx, a, APP_FEATURE_RMS, 0, rms);
+        feature_add(&n, idx, a, APP_FEATURE_PEAK, 0, ax->peak);
+        feature_add(&n, idx, a, APP_FEATURE_ZERO_CROSSINGS, 0, ax->crossings);
+
+#if defined(CONFIG_APP_DSP_FFT)
+        uint32_t bands[BANDS];
+
+        if (ax->fft_fill == g_fft.len && dsp_band_energy(&g_fft, ax->fft_in, bands, BANDS) == 0) {
+            for (uint8_t b = 0; b < BANDS; b++) {
+                feature_add(&n, idx, a, APP_FEATURE_BAND_ENERGY, b,
+                            (int32_t)MIN(bands[b], INT32_MAX));
+            }
+        }
+        ax->fft_fill = 0;
+#endif
+
+        ax->power = 0;
+        ax->count = 0;
+        ax->peak = 0;
+        ax->crossings = 0;
+    }
+
+    ch->window_us = 0;
+
+    if (n > 0) {
+        (void)app_bus_publish_batch(g_features, n);
+        g_stats.windows++;
+    }
+}
+
+/**
+ * @brief Process one sampler block
+ *
+ * @param buf Block (header + samples)
+ */
+static void block_process(const struct app_buf *buf) {
+
+    const struct sampler_block_hdr *hdr = (const struct sampler_block_hdr *)buf->data;
+
+    if (hdr->channel >= DSP_MAX_CHANNELS || hdr->width == 0 || hdr->period_us == 0 ||
+        hdr->count > SAMPLER_BLOCK_VALUES / hdr->width) {
+        g_stats.skipped++;
+        return;
+    }
+
+    struct chan_state *ch = &g_chan[hdr->channel];
+
+    // Rate changes (sampler_set_rate) restart the channel's filters
+    if (ch->period_us != hdr->period_us || ch->axes != MIN(hdr->width, DSP_MAX_AXES)) {
+        chan_setup(ch, hdr);
+    }
+
+    const int16_t *data = sampler_block_data(buf);
+
+    for (uint8_t a = 0; a < ch->axes; a++) {
+        axis_process(&ch->axis[a], &data[a], hdr->width, hdr->count);
+    }
+
+    g_stats.blocks++;
+
+    ch->window_us += (uint32_t)hdr->count * hdr->period_us;
+    if (ch->window_us >= (uint32_t)atomic_get(&g_window_us)) {
+        window_publish(hdr->channel);
+    }
+}
+
+/**
+ * @brief Change how often features are published
+ *
+ * Takes effect at the end of the current window.
+ *
+ * @param rate_hz Windows per second, 1 to 100
+ * @return 0 on success, -EINVAL on an out of range rate
+ */
+int dsp_stage_set_output_rate(uint32_t rate_hz) {
+
+    if (rate_hz == 0 || rate_hz > 100) {
+        return -EINVAL;
+    }
+
+    atomic_set(&g_window_us, USEC_PER_SEC / rate_hz);
+
+    return 0;
+}
+
+/**
+ * @brief Get the feature stage counters
+ *
+ * @param out Destination
+ */
+void dsp_stage_stats_get(struct dsp_stage_stats *out) {
+    *out = g_stats;
+}
+
+/**
+ * @brief DSP stage thread
+ *
+ * Consumes sampler blocks and publishes features. Runs below the controller and
+ * actuator so signal processing never delays button handling.
+ *
+ * Thread priority: 9
+ */
+static void dsp_thread(void) {
+
+    dsp_fir_design_lowpass(g_lp_coeffs, TAPS, DECIM);
+
+#if defined(CONFIG_APP_DSP_FFT)
+    if (dsp_fft_init(&g_fft, CONFIG_APP_DSP_FFT_LEN) != 0) {
+        LOG_ERR("FFT length %d not supported", CONFIG_APP_DSP_FFT_LEN);
+        return;
+    }
+#endif
+
+    int sub_rc = app_bus_subscribe(&dsp_sub);
+
+    if (sub_rc != 0) {
+        LOG_ERR("app_bus_subscribe failed: %d", sub_rc);
+        return;
+    }
+
+    APP_HEALTH_START(dsp_health);
+    LOG_INF("dsp stage start (%s kernels, decimation %d)",
+            IS_ENABLED(CONFIG_APP_DSP_CMSIS) ? "CMSIS-DSP" : "portable", DECIM);
+
+    while (1) {
+
+        struct app_msg msg;
+
+        if (app_bus_sub_get(&dsp_sub, &msg, K_FOREVER) != 0) {
+            continue;
+        }
+
+        APP_HEALTH_BEGIN(dsp_health);
+        block_process(msg.data.block.buf);
+        app_bus_msg_release(&msg);
+        APP_HEALTH_END(dsp_health);
+    }
+}
+
+// Create and start the DSP thread with priority 9 (below the actuator)
+K_THREAD_DEFINE(dsp_tid, CONFIG_APP_DSP_STACK_SIZE, dsp_thread, NULL, NULL, NULL, 9, 0, 0);
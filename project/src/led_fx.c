@@ -0,0 +1,393 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+#include <app/led_fx.h>
+#include <app/app_pm.h>
+
+/*
+Every effect is a sequence of (level, hold time) steps, repeated a number of times:
+pulse and blink use two steps stored in the slot, patterns point at caller-owned steps
+and breathe computes a triangle ramp. Active slots sit in one list sorted by deadline;
+a single delayable work item fires at the earliest deadline and advances every slot
+that is due, so effects on different LEDs overlap without any thread sleeping.
+*/
+enum fx_kind {
+    FX_STEPS,
+    FX_BREATHE,
+};
+
+struct fx_slot {
+    sys_snode_t node;
+    int64_t deadline;           // uptime (ms) of the next step
+    bool active;
+    uint8_t led;
+    uint8_t kind;
+    uint8_t step;               // next step index
+    uint8_t step_count;
+    uint8_t repeat;             // runs left, 0 = forever
+    const struct led_fx_step *steps;
+    struct led_fx_step own[2];  // storage for pulse/blink
+};
+
+static const struct led_fx_ops *g_ops;
+static uint8_t g_led_count;
+static struct fx_slot g_slots[LED_FX_MAX_LEDS];
+static sys_slist_t g_due;       // active slots, earliest deadline first
+static struct k_work_delayable g_fx_work;
+static K_MUTEX_DEFINE(g_fx_lock);
+
+/**
+ * @brief Insert a slot into the deadline list, keeping it sorted
+ *
+ * @param s Slot with its deadline set
+ */
+static void due_insert(struct fx_slot *s) {
+
+    struct fx_slot *cur;
+    struct fx_slot *prev = NULL;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&g_due, cur, node) {
+        if (cur->deadline > s->deadline) {
+            break;
+        }
+        prev = cur;
+    }
+
+    if (prev == NULL) {
+        sys_slist_prepend(&g_due, &s->node);
+    } else {
+        sys_slist_insert(&g_due, &prev->node, &s->node);
+    }
+}
+
+/**
+ * @brief Arm the work item for the earliest deadline, or stop it when idle
+ */
+static void reschedule(void) {
+
+    struct fx_slot *head = SYS_SLIST_PEEK_HEAD_CONTAINER(&g_due, head, node);
+
+    // Running effects keep PWM/timer clocks needed for smooth steps
+    APP_PM_BUSY(APP_PM_BUSY_LED_FX, head != NULL);
+
+    if (head == NULL) {
+        (void)k_work_cancel_delayable(&g_fx_work);
+        return;
+    }
+
+    (void)k_work_reschedule(&g_fx_work, K_TIMEOUT_ABS_MS(head->deadline));
+}
+
+/**
+ * @brief Compute the next step of an effect
+ *
+ * @param s Slot to advance
+ * @param level Output: brightness for the step
+ * @param hold_ms Output: how long to hold it
+ * @return false once the effect has run all its repeats
+ */
+static bool slot_next(struct fx_slot *s, uint8_t *level, uint16_t *hold_ms) {
+
+    if (s->step >= s->step_count) {
+        if (s->repeat != 0 && --s->repeat == 0) {
+            return false;
+        }
+        s->step = 0;
+    }
+
+    if (s->kind == FX_BREATHE) {
+        uint32_t half = s->step_count / 2;
+        uint32_t pos = (s->step < half) ? s->step : (s->step_count - s->step);
+
+        *level = (uint8_t)((LED_FX_LEVEL_FULL * pos) / half);
+        *hold_ms = LED_FX_BREATHE_STEP_MS;
+    } else {
+        *level = s->steps[s->step].level;
+        *hold_ms = s->steps[s->step].ms;
+    }
+
+    s->step++;
+    return true;
+}
+
+/**
+ * @brief Apply the next step of a slot and queue its following deadline
+ *
+ * Deadlines advance from the previous deadline, not from "now", so steps do not drift
+ * when the work item runs late. Finished slots are handed back to the owner.
+ *
+ * @param s Slot that is due (not in the deadline list)
+ * @param base Deadline the step was due at
+ */
+static void slot_run(struct fx_slot *s, int64_t base) {
+
+    uint8_t level;
+    uint16_t hold_ms;
+
+    if (!slot_next(s, &level, &hold_ms)) {
+        s->active = false;
+        g_ops->done(s->led);
+        return;
+    }
+
+    g_ops->set(s->led, level);
+    s->deadline = base + MAX(hold_ms, 1);
+    due_insert(s);
+}
+
+/**
+ * @brief Effects work handler: advance every slot whose deadline has passed
+ *
+ * @param work Work item (unused)
+ */
+static void fx_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    k_mutex_lock(&g_fx_lock, K_FOREVER);
+
+    int64_t now = k_uptime_get();
+    struct fx_slot *s;
+
+    while ((s = SYS_SLIST_PEEK_HEAD_CONTAINER(&g_due, s, node)) != NULL && s->deadline <= now) {
+        (void)sys_slist_get(&g_due);
+        slot_run(s, s->deadline);
+    }
+
+    reschedule();
+
+    k_mutex_unlock(&g_fx_lock);
+}
+
+/**
+ * @brief Replace the effect on an LED and run its first step immediately
+ *
+ * @param s Slot prepared by the caller (kind, steps, step_count, repeat)
+ * @return 0 on success
+ */
+static int slot_start(struct fx_slot *s) {
+
+    if (s->active) {
+        (void)sys_slist_find_and_remove(&g_due, &s->node);
+    }
+
+    s->active = true;
+    s->step = 0;
+    slot_run(s, k_uptime_get());
+    reschedule();
+
+    return 0;
+}
+
+/**
+ * @brief Look up and lock the slot of an LED
+ *
+ * @param led LED index
+ * @return Slot with the engine locked, or NULL (engine unlocked) if led is out of range
+ */
+static struct fx_slot *slot_lock(uint8_t led) {
+
+    if (g_ops == NULL || led >= g_led_count) {
+        return NULL;
+    }
+
+    k_mutex_lock(&g_fx_lock, K_FOREVER);
+    return &g_slots[led];
+}
+
+/**
+ * @brief Initialise the effects engine
+ *
+ * @param ops LED backend, must stay valid
+ * @param led_count Number of LEDs driven through ops (at most LED_FX_MAX_LEDS)
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int led_fx_init(const struct led_fx_ops *ops, uint8_t led_count) {
+
+    if (ops == NULL || ops->set == NULL || ops->done == NULL || led_count > LED_FX_MAX_LEDS) {
+        return -EINVAL;
+    }
+
+    sys_slist_init(&g_due);
+    k_work_init_delayable(&g_fx_work, fx_work_handler);
+
+    for (uint8_t i = 0; i < led_count; i++) {
+        g_slots[i].led = i;
+    }
+
+    g_led_count = led_count;
+    g_ops = ops;
+
+    return 0;
+}
+
+/**
+ * @brief Turn an LED fully on for a while, then restore its steady state
+ *
+ * @param led LED index
+ * @param on_ms Pulse length
+ * @return 0 on success, -EINVAL if led is out of range
+ */
+int led_fx_pulse(uint8_t led, uint16_t on_ms) {
+    return led_fx_blink(led, 1, on_ms, 0);
+}
+
+/**
+ * @brief Blink an LED a number of times, then restore its steady state
+ *
+ * @param led LED index
+ * @param count Number of blinks, 0 = until cancelled
+ * @param on_ms On time per blink
+ * @param off_ms Off time per blink (0 for a single pulse)
+ * @return 0 on success, -EINVAL if led is out of range
+ */
+int led_fx_blink(uint8_t led, uint8_t count, uint16_t on_ms, uint16_t off_ms) {
+
+    struct fx_slot *s = slot_lock(led);
+
+    if (s == NULL) {
+        return -EINVAL;
+    }
+
+    s->kind = FX_STEPS;
+    s->own[0] = (struct led_fx_step){ .level = LED_FX_LEVEL_FULL, .ms = on_ms };
+    s->own[1] = (struct led_fx_step){ .level = LED_FX_LEVEL_OFF, .ms = off_ms };
+    s->steps = s->own;
+    s->step_count = (off_ms != 0) ? 2 : 1;
+    s->repeat = count;
+
+    int rc = slot_start(s);
+
+    k_mutex_unlock(&g_fx_lock);
+    return rc;
+}
+
+/**
+ * @brief Ramp an LED up and down
+ *
+ * Smooth on PWM backends; on on/off LEDs this degrades to a blink with a 50% duty cycle.
+ *
+ * @param led LED index
+ * @param period_ms Length of one up/down cycle
+ * @param cycles Number of cycles, 0 = until cancelled
+ * @return 0 on success, -EINVAL if led is out of range or the period is too short
+ */
+int led_fx_breathe(uint8_t led, uint16_t period_ms, uint8_t cycles) {
+
+    uint32_t steps = period_ms / LED_FX_BREATHE_STEP_MS;
+
+    if (steps < 2 || steps > UINT8_MAX) {
+        return -EINVAL;
+    }
+
+    struct fx_slot *s = slot_lock(led);
+
+    if (s == NULL) {
+        return -EINVAL;
+    }
+
+    s->kind = FX_BREATHE;
+    s->steps = NULL;
+    s->step_count = (uint8_t)(steps & ~1U);
+    s->repeat = cycles;
+
+    int rc = slot_start(s);
+
+    k_mutex_unlock(&g_fx_lock);
+    return rc;
+}
+
+/**
+ * @brief Play a sequence of steps on an LED
+ *
+ * @param led LED index
+ * @param steps Step array, must stay valid while the effect runs
+ * @param count Number of steps
+ * @param repeat Number of runs through the sequence, 0 = until cancelled
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int led_fx_pattern(uint8_t led, const struct led_fx_step *steps, uint8_t count, uint8_t repeat) {
+
+    if (steps == NULL || count == 0) {
+        return -EINVAL;
+    }
+
+    struct fx_slot *s = slot_lock(led);
+
+    if (s == NULL) {
+        return -EINVAL;
+    }
+
+    s->kind = FX_STEPS;
+    s->steps = steps;
+    s->step_count = count;
+    s->repeat = repeat;
+
+    int rc = slot_start(s);
+
+    k_mutex_unlock(&g_fx_lock);
+    return rc;
+}
+
+/**
+ * @brief Stop the effect on an LED and restore its steady state
+ *
+ * @param led LED index
+ */
+void led_fx_cancel(uint8_t led) {
+
+    struct fx_slot *s = slot_lock(led);
+
+    if (s == NULL) {
+        return;
+    }
+
+    if (s->active) {
+        (void)sys_slist_find_and_remove(&g_due, &s->node);
+        s->active = false;
+        g_ops->done(led);
+        reschedule();
+    }
+
+    k_mutex_unlock(&g_fx_lock);
+}
+
+/**
+ * @brief Check whether an effect currently owns an LED
+ *
+ * @param led LED index
+ * @return true while an effect runs on the LED
+ */
+bool led_fx_active(uint8_t led) {
+
+    struct fx_slot *s = slot_lock(led);
+
+    if (s == NULL) {
+        return false;
+    }
+
+    bool active = s->active;
+
+    k_mutex_unlock(&g_fx_lock);
+    return active;
+}
+
+/**
+ * @brief Get the set of LEDs currently owned by an effect
+ *
+ * @return Bitmap with bit n set while an effect runs on LED n
+ */
+uint32_t led_fx_active_mask(void) {
+
+    uint32_t mask = 0;
+
+    k_mutex_lock(&g_fx_lock, K_FOREVER);
+
+    for (uint8_t i = 0; i < g_led_count; i++) {
+        if (g_slots[i].active) {
+            mask |= BIT(i);
+        }
+    }
+
+    k_mutex_unlock(&g_fx_lock);
+    return mask;
+}
@@ -8,9 +8,10 @@ LOG_MODULE_REGISTER(app, LOG_LEVEL_INF);
 /**
  * @brief Application entry point
  * 
- * Initializes the BLE communication subsystem and enters idle loop.
+ * Initializes the BLE communication subsystem and parks the main thread.
  * Other subsystems (controller, actuator, sensor) are started automatically
- * via K_THREAD_DEFINE.
+ * via K_THREAD_DEFINE. The main thread never wakes again, so it adds no
+ * timer wake-ups to an idle system.
  * 
  * @return Does not return
  */
@@ -20,6 +21,6 @@ int main(void) {
     comms_ble_start(); // Begin BLE controls
 
     while(1) {
-        k_sleep(K_SECONDS(10));
+        k_sleep(K_FOREVER);
     }
 }
\ No newline at end of file
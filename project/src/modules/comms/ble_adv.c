@@ -0,0 +1,364 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include <app/ble_adv.h>
+
+LOG_MODULE_REGISTER(ble_adv, LOG_LEVEL_INF); // Enable logging
+
+/*
+Advertising manager:
+Every phase change runs in one delayable work item, so the stack is only driven from the
+system workqueue. BT callbacks just record events and reschedule the work item.
+With CONFIG_BT_EXT_ADV one advertising set is created once and re-parameterised per
+phase (legacy PDUs, so every central can still see it); otherwise the legacy API is used.
+*/
+
+static const struct bt_data *g_ad;
+static size_t g_ad_len;
+static const struct bt_data *g_sd;
+static size_t g_sd_len;
+
+static struct k_work_delayable g_adv_work;
+static struct k_spinlock g_adv_lock;
+
+// Guarded by g_adv_lock
+static uint8_t g_phase = BLE_ADV_OFF;
+static bool g_restart;              // next work run starts over at the first phase
+static bool g_connected;            // at least one central connected (no directed phase)
+static bool g_peer_valid;
+static bt_addr_le_t g_peer;         // last bonded central
+static int64_t g_phase_since_ms;
+static int64_t g_disconnect_ms = -1;
+static struct ble_adv_stats g_stats;
+static uint64_t g_reconnect_sum_ms;
+
+#if defined(CONFIG_BT_EXT_ADV)
+static struct bt_le_ext_adv *g_adv_set;
+#endif
+
+/**
+ * @brief Close the accounting of the current phase
+ *
+ * Caller holds g_adv_lock.
+ *
+ * @param now Uptime in ms
+ */
+static void phase_account(int64_t now) {
+
+    if (g_phase == BLE_ADV_OFF) {
+        return;
+    }
+
+    uint32_t elapsed = (uint32_t)(now - g_phase_since_ms);
+
+    g_stats.adv_ms += elapsed;
+    if (g_phase != BLE_ADV_SLOW) {
+        g_stats.fast_ms += elapsed;
+    }
+    g_phase_since_ms = now;
+}
+
+/**
+ * @brief Switch the current phase and its accounting
+ *
+ * Caller holds g_adv_lock.
+ *
+ * @param phase New phase
+ */
+static void phase_set(enum ble_adv_phase phase) {
+
+    int64_t now = k_uptime_get();
+
+    phase_account(now);
+    g_phase = phase;
+    g_phase_since_ms = now;
+    if (phase != BLE_ADV_OFF) {
+        g_stats.starts++;
+    }
+}
+
+/**
+ * @brief Stop whatever is being advertised
+ */
+static void adv_stop(void) {
+
+#if defined(CONFIG_BT_EXT_ADV)
+    if (g_adv_set != NULL) {
+        (void)bt_le_ext_adv_stop(g_adv_set);
+    }
+#else
+    (void)bt_le_adv_stop();
+#endif
+}
+
+/**
+ * @brief Start advertising with the parameters of a phase
+ *
+ * @param phase Phase to advertise in (not BLE_ADV_OFF)
+ * @param peer Directed target (BLE_ADV_DIRECTED only)
+ * @return 0 on success, negative error code from the stack otherwise
+ */
+static int adv_run(enum ble_adv_phase phase, const bt_addr_le_t *peer) {
+
+    struct bt_le_adv_param param = BT_LE_ADV_PARAM_INIT(BT_LE_ADV_OPT_CONNECTABLE,
+                                                        BT_GAP_ADV_FAST_INT_MIN_1,
+                                                        BT_GAP_ADV_FAST_INT_MAX_1,
+                                                        NULL);
+    bool directed = (phase == BLE_ADV_DIRECTED);
+
+    if (directed) {
+        // Low-duty directed runs at the fast interval until the phase ends
+        param.options |= BT_LE_ADV_OPT_DIR_MODE_LOW_DUTY;
+        param.peer = peer;
+    } else if (phase == BLE_ADV_SLOW) {
+        param.interval_min = BT_GAP_ADV_SLOW_INT_MIN;
+        param.interval_max = BT_GAP_ADV_SLOW_INT_MAX;
+    }
+
+    adv_stop();
+
+#if defined(CONFIG_BT_EXT_ADV)
+    int rc;
+
+    if (g_adv_set == NULL) {
+        rc = bt_le_ext_adv_create(&param, NULL, &g_adv_set);
+    } else {
+        rc = bt_le_ext_adv_update_param(g_adv_set, &param);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Directed PDUs carry no payload
+    rc = directed ? bt_le_ext_adv_set_data(g_adv_set, NULL, 0, NULL, 0)
+                  : bt_le_ext_adv_set_data(g_adv_set, g_ad, g_ad_len, g_sd, g_sd_len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return bt_le_ext_adv_start(g_adv_set, BT_LE_EXT_ADV_START_DEFAULT);
+#else
+    if (directed) {
+        return bt_le_adv_start(&param, NULL, 0, NULL, 0);
+    }
+
+    return bt_le_adv_start(&param, g_ad, g_ad_len, g_sd, g_sd_len);
+#endif
+}
+
+/**
+ * @brief Advertising work handler: enter the next phase and schedule the one after
+ *
+ * @param work Work item (unused)
+ */
+static void adv_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+
+    enum ble_adv_phase next;
+    bt_addr_le_t peer = g_peer;
+
+    if (g_restart || g_phase == BLE_ADV_OFF) {
+        bool directed = (CONFIG_APP_BLE_ADV_DIRECTED_MS > 0) && g_peer_valid && !g_connected;
+
+        next = directed ? BLE_ADV_DIRECTED : BLE_ADV_FAST;
+        g_restart = false;
+    } else if (g_phase == BLE_ADV_DIRECTED) {
+        next = BLE_ADV_FAST;
+    } else {
+        next = BLE_ADV_SLOW;
+    }
+
+    k_spin_unlock(&g_adv_lock, key);
+
+    int rc = adv_run(next, &peer);
+
+    key = k_spin_lock(&g_adv_lock);
+    phase_set((rc == 0) ? next : BLE_ADV_OFF);
+    k_spin_unlock(&g_adv_lock, key);
+
+    if (rc != 0) {
+        // The stack may still hold the last connection object; recycled_cb restarts us
+        LOG_WRN("adv phase %d failed (%d)", next, rc);
+        return;
+    }
+
+    LOG_INF("adv phase %d", next);
+
+    if (next == BLE_ADV_DIRECTED) {
+        k_work_reschedule(&g_adv_work, K_MSEC(CONFIG_APP_BLE_ADV_DIRECTED_MS));
+    } else if (next == BLE_ADV_FAST) {
+        k_work_reschedule(&g_adv_work, K_MSEC(CONFIG_APP_BLE_ADV_FAST_MS));
+    }
+}
+
+#if defined(CONFIG_BT_SMP)
+/**
+ * @brief Bond iterator: remember one bonded central as the directed target
+ *
+ * @param info Bond
+ * @param user_data Unused
+ */
+static void bond_pick(const struct bt_bond_info *info, void *user_data) {
+
+    ARG_UNUSED(user_data);
+
+    if (!g_peer_valid) {
+        bt_addr_le_copy(&g_peer, &info->addr);
+        g_peer_valid = true;
+    }
+}
+#endif
+
+/**
+ * @brief Initialise the advertising manager
+ *
+ * Must be called after bt_enable() (and after settings are loaded, so a stored bond can
+ * be used as the first directed target).
+ *
+ * @param ad Advertising data, must stay valid
+ * @param ad_len Number of advertising data elements
+ * @param sd Scan response data, must stay valid
+ * @param sd_len Number of scan response elements
+ * @return 0 on success
+ */
+int ble_adv_init(const struct bt_data *ad, size_t ad_len, const struct bt_data *sd, size_t sd_len) {
+
+    g_ad = ad;
+    g_ad_len = ad_len;
+    g_sd = sd;
+    g_sd_len = sd_len;
+
+    k_work_init_delayable(&g_adv_work, adv_work_handler);
+
+#if defined(CONFIG_BT_SMP)
+    bt_foreach_bond(BT_ID_DEFAULT, bond_pick, NULL);
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief (Re)start advertising from the first phase
+ *
+ * Safe to call from any thread, including BT callbacks.
+ */
+void ble_adv_start(void) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+    g_restart = true;
+    k_spin_unlock(&g_adv_lock, key);
+
+    k_work_reschedule(&g_adv_work, K_NO_WAIT);
+}
+
+/**
+ * @brief Start advertising from the first phase unless a phase is already running
+ *
+ * Used when the stack frees a connection object: a burst started on disconnect may have
+ * failed for lack of one.
+ */
+void ble_adv_resume(void) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+    bool idle = (g_phase == BLE_ADV_OFF);
+    k_spin_unlock(&g_adv_lock, key);
+
+    if (idle) {
+        ble_adv_start();
+    }
+}
+
+/**
+ * @brief Report a new connection
+ *
+ * The stack has stopped connectable advertising. Records the time to reconnect and
+ * restarts advertising (without the directed phase) if more centrals can connect.
+ *
+ * @param conn New connection
+ * @param has_free true if another central could still connect
+ */
+void ble_adv_connected(struct bt_conn *conn, bool has_free) {
+
+    ARG_UNUSED(conn);
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+
+    phase_set(BLE_ADV_OFF);
+    g_connected = true;
+
+    if (g_disconnect_ms >= 0) {
+        uint32_t dt = (uint32_t)(k_uptime_get() - g_disconnect_ms);
+
+        g_stats.reconnects++;
+        g_stats.reconnect_last_ms = dt;
+        g_stats.reconnect_max_ms = MAX(g_stats.reconnect_max_ms, dt);
+        g_reconnect_sum_ms += dt;
+        g_stats.reconnect_avg_ms = (uint32_t)(g_reconnect_sum_ms / g_stats.reconnects);
+        g_disconnect_ms = -1;
+    }
+
+    k_spin_unlock(&g_adv_lock, key);
+
+    if (has_free) {
+        ble_adv_start();
+    } else {
+        (void)k_work_cancel_delayable(&g_adv_work);
+    }
+}
+
+/**
+ * @brief Report a disconnection and re-arm advertising
+ *
+ * A bonded central becomes the directed target of the next burst, unless other centrals
+ * are still connected.
+ *
+ * @param conn Connection that went away
+ * @param remaining Connections left in the connection table
+ */
+void ble_adv_disconnected(struct bt_conn *conn, size_t remaining) {
+
+    const bt_addr_le_t *dst = bt_conn_get_dst(conn);
+    bool bonded = false;
+
+#if defined(CONFIG_BT_SMP)
+    bonded = bt_le_bond_exists(BT_ID_DEFAULT, dst);
+#endif
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+
+    if (bonded) {
+        bt_addr_le_copy(&g_peer, dst);
+        g_peer_valid = true;
+    }
+    g_connected = (remaining > 0);
+    g_disconnect_ms = k_uptime_get();
+
+    k_spin_unlock(&g_adv_lock, key);
+
+    ble_adv_start();
+}
+
+/**
+ * @brief Get advertising metrics
+ *
+ * @param out Filled with a snapshot; the current phase is accounted up to now
+ */
+void ble_adv_stats_get(struct ble_adv_stats *out) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_adv_lock);
+
+    int64_t now = k_uptime_get();
+
+    phase_account(now);
+    *out = g_stats;
+    out->phase = g_phase;
+    out->duty_permille = (now > 0) ? (uint32_t)((uint64_t)g_stats.adv_ms * 1000 / now) : 0;
+
+    k_spin_unlock(&g_adv_lock, key);
+}
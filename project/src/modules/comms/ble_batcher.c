@@ -0,0 +1,172 @@
+#include <errno.h>
+#include <string.h>
+#include <app/ble_batcher.h>
+
+/**
+ * @brief Reset a batcher and set its frame capacity
+ *
+ * @param b Batcher to initialize
+ * @param capacity Usable notification length in bytes (ATT MTU - 3)
+ */
+void ble_batcher_init(struct ble_batcher *b, uint16_t capacity) {
+
+    b->len = BLE_BATCH_HDR_LEN;
+    b->count = 0;
+    b->first_ms = 0;
+    ble_batcher_set_capacity(b, capacity);
+}
+
+/**
+ * @brief Update the frame capacity after an MTU change
+ *
+ * Pending records are kept; if they no longer fit, the next add reports -ENOSPC
+ * and ble_batcher_take() splits them over several frames of the new capacity.
+ *
+ * @param b Batcher to update
+ * @param capacity Usable notification length in bytes (ATT MTU - 3)
+ */
+void ble_batcher_set_capacity(struct ble_batcher *b, uint16_t capacity) {
+    b->capacity = (capacity > BLE_BATCH_MAX_FRAME) ? BLE_BATCH_MAX_FRAME : capacity;
+}
+
+/**
+ * @brief Append one event record
+ *
+ * @param b Batcher
+ * @param rec BLE_BATCH_RECORD_LEN-byte single-event record
+ * @param now_ms Current uptime, starts the latency window for the first record
+ * @return 0 on success, -ENOSPC if the record does not fit (flush and retry)
+ */
+int ble_batcher_add(struct ble_batcher *b, const uint8_t *rec, uint32_t now_ms) {
+
+    // A lone record is sent without header, so it always fits a minimal 20-byte frame
+    uint16_t need = (b->count == 0) ? BLE_BATCH_HDR_LEN + BLE_BATCH_RECORD_LEN
+                                    : b->len + BLE_BATCH_RECORD_LEN;
+
+    if (need > b->capacity && b->count > 0) {
+        return -ENOSPC;
+    }
+
+    if (b->count == 0) {
+        b->first_ms = now_ms;
+    }
+
+    memcpy(&b->buf[b->len], rec, BLE_BATCH_RECORD_LEN);
+    b->len += BLE_BATCH_RECORD_LEN;
+    b->count++;
+
+    return 0;
+}
+
+/**
+ * @brief Check whether another record would overflow the frame
+ *
+ * @param b Batcher
+ * @return true if the pending frame should be flushed now
+ */
+bool ble_batcher_full(const struct ble_batcher *b) {
+    return (b->count == UINT8_MAX) || (b->len + BLE_BATCH_RECORD_LEN > b->capacity);
+}
+
+/**
+ * @brief Encode the oldest pending records into one frame
+ *
+ * Takes as many records as fit the current capacity: a single record is emitted as a
+ * legacy 7-byte frame, two or more are prefixed with the batch header. Records left over
+ * after a capacity shrink stay pending for the next call, so callers drain the batcher
+ * with repeated takes until it is empty.
+ *
+ * @param b Batcher
+ * @param out Destination buffer
+ * @param out_size Size of out (BLE_BATCH_MAX_FRAME always suffices)
+ * @return Encoded frame length, 0 if nothing was pending or out is too small
+ */
+uint16_t ble_batcher_take(struct ble_batcher *b, uint8_t *out, size_t out_size) {
+
+    uint16_t fit = (b->capacity > BLE_BATCH_HDR_LEN) ?
+                   (b->capacity - BLE_BATCH_HDR_LEN) / BLE_BATCH_RECORD_LEN : 0;
+    uint8_t n = (b->count < fit) ? b->count : (uint8_t)fit;
+    uint16_t len = 0;
+
+    // A lone record always fits a minimal frame, so every take makes progress
+    if (n < 2) {
+        n = (b->count > 0) ? 1 : 0;
+    }
+
+    if (n == 1 && out_size >= BLE_BATCH_RECORD_LEN) {
+        memcpy(out, &b->buf[BLE_BATCH_HDR_LEN], BLE_BATCH_RECORD_LEN);
+        len = BLE_BATCH_RECORD_LEN;
+    } else if (n > 1 && out_size >= BLE_BATCH_HDR_LEN + n * BLE_BATCH_RECORD_LEN) {
+        out[0] = BLE_FRAME_BATCH;
+        out[1] = n;
+        memcpy(&out[BLE_BATCH_HDR_LEN], &b->buf[BLE_BATCH_HDR_LEN], n * BLE_BATCH_RECORD_LEN);
+        len = BLE_BATCH_HDR_LEN + n * BLE_BATCH_RECORD_LEN;
+    } else {
+        // Nothing pending, or out cannot hold the frame: drop everything as before
+        n = b->count;
+    }
+
+    uint16_t rest = (uint16_t)((b->count - n) * BLE_BATCH_RECORD_LEN);
+
+    memmove(&b->buf[BLE_BATCH_HDR_LEN], &b->buf[BLE_BATCH_HDR_LEN + n * BLE_BATCH_RECORD_LEN],
+            rest);
+    b->len = BLE_BATCH_HDR_LEN + rest;
+    b->count -= n;
+
+    return len;
+}
+
+/**
+ * @brief Add one record and send the frames the flush policy calls for
+ *
+ * A record that does not fit is sent after the pending frame, and a frame that cannot
+ * take another record is sent at once rather than waiting for its deadline.
+ *
+ * @param b Batcher
+ * @param rec BLE_BATCH_RECORD_LEN-byte single-event record
+ * @param now_ms Current uptime
+ * @param flush Sends every pending record
+ * @param user_data Passed to flush
+ */
+void ble_batcher_push(struct ble_batcher *b, const uint8_t *rec, uint32_t now_ms,
+                      ble_batcher_flush_t flush, void *user_data) {
+
+    if (ble_batcher_add(b, rec, now_ms) == -ENOSPC) {
+        flush(b, user_data);
+        (void)ble_batcher_add(b, rec, now_ms);
+    }
+
+    if (ble_batcher_full(b)) {
+        flush(b, user_data);
+    }
+}
+
+/**
+ * @brief Time left before the pending records must be sent
+ *
+ * The deadline is the oldest record's arrival plus max_latency_ms, or plus the connection
+ * interval if that is shorter: waiting past the next connection event gains nothing.
+ *
+ * @param b Batcher
+ * @param max_latency_ms Longest time a record may wait
+ * @param interval_ms Shortest connection interval among subscribers, 0 if unknown
+ * @param now_ms Current uptime
+ * @return Milliseconds left (0 if due), BLE_BATCHER_WAIT_FOREVER if nothing is pending
+ */
+uint32_t ble_batcher_wait_ms(const struct ble_batcher *b, uint32_t max_latency_ms,
+                             uint32_t interval_ms, uint32_t now_ms) {
+
+    if (ble_batcher_empty(b)) {
+        return BLE_BATCHER_WAIT_FOREVER;
+    }
+
+    uint32_t budget = max_latency_ms;
+
+    if (interval_ms > 0 && interval_ms < budget) {
+        budget = interval_ms;
+    }
+
+    uint32_t waited = now_ms - b->first_ms;
+
+    return (waited >= budget) ? 0 : budget - waited;
+}
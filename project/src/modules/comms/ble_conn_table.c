@@ -0,0 +1,164 @@
+#include <errno.h>
+#include <string.h>
+#include <app/ble_conn_table.h>
+
+// Default LE ATT MTU until the client negotiates a larger one
+#define BLE_CONN_DEFAULT_MTU 23
+
+/**
+ * @brief Claim a slot for a new connection
+ *
+ * Returns the existing slot if the connection is already tracked.
+ *
+ * @param t Connection table
+ * @param conn Connection handle (the caller keeps a reference while it is in the table)
+ * @return Slot for the connection, NULL if the table is full
+ */
+struct ble_conn_slot *ble_conn_table_add(struct ble_conn_table *t, struct bt_conn *conn) {
+
+    struct ble_conn_slot *free_slot = NULL;
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        struct ble_conn_slot *slot = &t->slots[i];
+
+        if (slot->conn == conn) {
+            return slot;
+        }
+        if (slot->conn == NULL && free_slot == NULL) {
+            free_slot = slot;
+        }
+    }
+
+    if (free_slot != NULL) {
+        memset(free_slot, 0, sizeof(*free_slot));
+        free_slot->conn = conn;
+        free_slot->mtu = BLE_CONN_DEFAULT_MTU;
+    }
+
+    return free_slot;
+}
+
+/**
+ * @brief Look up the slot of a connection
+ *
+ * @param t Connection table
+ * @param conn Connection handle
+ * @return Slot, or NULL if the connection is not tracked
+ */
+struct ble_conn_slot *ble_conn_table_find(struct ble_conn_table *t, const struct bt_conn *conn) {
+
+    if (conn == NULL) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        if (t->slots[i].conn == conn) {
+            return &t->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Release the slot of a connection
+ *
+ * @param t Connection table
+ * @param conn Connection handle
+ * @return 0 on success, -ENOENT if the connection was not tracked
+ */
+int ble_conn_table_remove(struct ble_conn_table *t, const struct bt_conn *conn) {
+
+    struct ble_conn_slot *slot = ble_conn_table_find(t, conn);
+
+    if (slot == NULL) {
+        return -ENOENT;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+
+    return 0;
+}
+
+/**
+ * @brief Count tracked connections
+ *
+ * @param t Connection table
+ * @return Number of occupied slots
+ */
+size_t ble_conn_table_count(const struct ble_conn_table *t) {
+
+    size_t n = 0;
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        if (t->slots[i].conn != NULL) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief Count connections with notifications enabled
+ *
+ * @param t Connection table
+ * @return Number of subscribed connections
+ */
+size_t ble_conn_table_subscribed(const struct ble_conn_table *t) {
+
+    size_t n = 0;
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        if (t->slots[i].conn != NULL && t->slots[i].notify) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief Smallest ATT MTU among subscribed connections
+ *
+ * A frame sized to this MTU can be sent unchanged to every subscriber.
+ *
+ * @param t Connection table
+ * @return Minimum MTU, or the default LE MTU if nobody is subscribed
+ */
+uint16_t ble_conn_table_min_mtu(const struct ble_conn_table *t) {
+
+    uint16_t mtu = 0;
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        const struct ble_conn_slot *slot = &t->slots[i];
+
+        if (slot->conn != NULL && slot->notify && (mtu == 0 || slot->mtu < mtu)) {
+            mtu = slot->mtu;
+        }
+    }
+
+    return (mtu == 0) ? BLE_CONN_DEFAULT_MTU : mtu;
+}
+
+/**
+ * @brief Shortest connection interval among subscribed connections
+ *
+ * @param t Connection table
+ * @return Interval in milliseconds, 0 if unknown or nobody is subscribed
+ */
+uint16_t ble_conn_table_min_interval_ms(const struct ble_conn_table *t) {
+
+    uint16_t interval = 0;
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        const struct ble_conn_slot *slot = &t->slots[i];
+
+        if (slot->conn != NULL && slot->notify && slot->interval_ms > 0 &&
+            (interval == 0 || slot->interval_ms < interval)) {
+            interval = slot->interval_ms;
+        }
+    }
+
+    return interval;
+}
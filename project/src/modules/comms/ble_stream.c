@@ -0,0 +1,140 @@
+#include <errno.h>
+#include <string.h>
+#include <app/ble_stream.h>
+
+/**
+ * @brief Prepare to send one sampler block
+ *
+ * @param f Framer
+ * @param block Sampler block, header included; must stay valid until the last frame
+ * @param len Block length in bytes
+ * @param block_seq Sampler block sequence number (its low byte goes into each frame)
+ * @param frame_max Largest notification payload every subscriber can take (ATT MTU - 3)
+ * @return 0 on success, -EINVAL if the frames cannot carry the block within
+ *         BLE_STREAM_FRAG_MAX fragments
+ */
+int ble_stream_framer_init(struct ble_stream_framer *f, const uint8_t *block, uint16_t len,
+                           uint8_t block_seq, uint16_t frame_max) {
+
+    if (frame_max <= BLE_STREAM_FRAME_HDR) {
+        return -EINVAL;
+    }
+
+    uint16_t chunk = frame_max - BLE_STREAM_FRAME_HDR;
+
+    if ((len + chunk - 1) / chunk > BLE_STREAM_FRAG_MAX) {
+        return -EINVAL;
+    }
+
+    f->block = block;
+    f->len = len;
+    f->off = 0;
+    f->chunk = chunk;
+    f->block_seq = block_seq;
+    f->frag = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Encode the next frame of the block
+ *
+ * @param f Framer
+ * @param frame_seq Stream frame sequence number to stamp
+ * @param out Destination, at least frame_max bytes (see ble_stream_framer_init())
+ * @param last Set to true for the last frame of the block
+ * @return Frame length, 0 once the whole block was framed
+ */
+uint16_t ble_stream_framer_next(struct ble_stream_framer *f, uint16_t frame_seq, uint8_t *out,
+                                bool *last) {
+
+    if (ble_stream_framer_done(f)) {
+        return 0;
+    }
+
+    uint16_t n = (f->len - f->off < f->chunk) ? f->len - f->off : f->chunk;
+
+    *last = (f->off + n == f->len);
+
+    out[0] = (uint8_t)frame_seq;
+    out[1] = (uint8_t)(frame_seq >> 8);
+    out[2] = f->block_seq;
+    out[3] = f->frag | (*last ? BLE_STREAM_FRAG_LAST : 0);
+    memcpy(&out[BLE_STREAM_FRAME_HDR], &f->block[f->off], n);
+
+    f->off += n;
+    f->frag++;
+
+    return n + BLE_STREAM_FRAME_HDR;
+}
+
+/**
+ * @brief Clear the counters when streaming is entered
+ *
+ * @param c Counters
+ * @param now_ms Current uptime, start of the throughput window
+ */
+void ble_stream_counters_reset(struct ble_stream_counters *c, uint32_t now_ms) {
+
+    memset(c, 0, sizeof(*c));
+    c->start_ms = now_ms;
+}
+
+/**
+ * @brief Count one frame handed to the stack
+ *
+ * @param c Counters
+ * @param sent Number of connections the frame went out on
+ * @param len Frame length in bytes
+ */
+void ble_stream_count_frame(struct ble_stream_counters *c, uint32_t sent, uint16_t len) {
+
+    c->frames += sent;
+    c->bytes += sent * len;
+}
+
+/**
+ * @brief Count one block whose frames were all handed to the stack
+ *
+ * @param c Counters
+ */
+void ble_stream_count_block(struct ble_stream_counters *c) {
+    c->blocks++;
+}
+
+/**
+ * @brief Count the delivery latency of one block
+ *
+ * @param c Counters
+ * @param us End of the block's sampling window to its last frame being sent
+ */
+void ble_stream_count_latency(struct ble_stream_counters *c, uint32_t us) {
+
+    c->lat_sum_us += us;
+    c->lat_count++;
+    if (us > c->lat_max_us) {
+        c->lat_max_us = us;
+    }
+}
+
+/**
+ * @brief Derive the reported statistics from the counters
+ *
+ * `dropped` is left untouched: the send path charges it (see notify_fanout()).
+ *
+ * @param c Counters
+ * @param now_ms Current uptime, end of the throughput window
+ * @param out Statistics
+ */
+void ble_stream_counters_read(const struct ble_stream_counters *c, uint32_t now_ms,
+                              struct comms_ble_stream_stats *out) {
+
+    uint32_t elapsed_ms = now_ms - c->start_ms;
+
+    out->blocks = c->blocks;
+    out->frames = c->frames;
+    out->bytes = c->bytes;
+    out->bps = (elapsed_ms > 0) ? (uint32_t)((uint64_t)c->bytes * 8 * 1000 / elapsed_ms) : 0;
+    out->latency_avg_us = (c->lat_count > 0) ? c->lat_sum_us / c->lat_count : 0;
+    out->latency_max_us = c->lat_max_us;
+}
@@ -0,0 +1,62 @@
+#include <errno.h>
+#include <app/cmd_tlv.h>
+
+/**
+ * @brief Decode a packed sequence of TLV command records
+ *
+ * The whole buffer is validated before anything is reported: on any malformed record
+ * the return value is negative and `out` must be ignored, so callers can reject the
+ * batch atomically.
+ *
+ * @param buf Encoded records
+ * @param len Length of buf in bytes
+ * @param out Array receiving the decoded commands
+ * @param max_out Capacity of out
+ * @return Number of decoded commands (>= 1), -EINVAL if the buffer is empty, truncated,
+ *         has a value longer than 4 bytes or a zero command id, -E2BIG if it holds more
+ *         than max_out records
+ */
+int cmd_tlv_decode(const uint8_t *buf, size_t len,
+                   struct app_command_payload *out, size_t max_out) {
+
+    size_t pos = 0;
+    size_t count = 0;
+
+    if (buf == NULL || len == 0) {
+        return -EINVAL;
+    }
+
+    while (pos < len) {
+
+        // Header must be complete
+        if (len - pos < CMD_TLV_HDR_LEN) {
+            return -EINVAL;
+        }
+
+        uint8_t command_id = buf[pos];
+        uint8_t vlen = buf[pos + 1];
+
+        pos += CMD_TLV_HDR_LEN;
+
+        if (command_id == 0 || vlen > CMD_TLV_MAX_VALUE_LEN || vlen > len - pos) {
+            return -EINVAL;
+        }
+
+        if (count == max_out) {
+            return -E2BIG;
+        }
+
+        // Little-endian value of 0-4 bytes
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < vlen; i++) {
+            value |= (uint32_t)buf[pos + i] << (8 * i);
+        }
+        pos += vlen;
+
+        out[count].command_id = command_id;
+        out[count].value = value;
+        count++;
+    }
+
+    return (int)count;
+}
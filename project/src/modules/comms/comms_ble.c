@@ -1,3 +1,4 @@
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/byteorder.h>
@@ -7,9 +8,26 @@
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/gap.h>
+#if defined(CONFIG_BT_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
 
 #include <app/app_bus.h>
 #include <app/app_msg.h>
+#include <app/app_cmd.h>
+#include <app/app_pm.h>
+#include <app/ble_adv.h>
+#include <app/ble_batcher.h>
+#include <app/ble_stream.h>
+#include <app/comms_ble.h>
+#include <app/ble_conn_table.h>
+#include <app/cmd_tlv.h>
+#include <app/app_evlog.h>
+#include <app/app_trace.h>
+#include <app/app_journal.h>
+#if defined(CONFIG_APP_BLE_STREAM)
+#include <app/sampler.h>
+#endif
 
 LOG_MODULE_REGISTER(comms_ble, LOG_LEVEL_INF); // Enable logging
 
@@ -25,13 +43,51 @@ LOG_MODULE_REGISTER(comms_ble, LOG_LEVEL_INF); // Enable logging
 #define BT_UUID_ZBRAIN_CMD_VAL \
     BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890ad)
 
+// Batched command characteristic UUID for TLV write-without-response (shares base, ends ...90ae)
+#define BT_UUID_ZBRAIN_CMD_BATCH_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890ae)
+
 // UUID instances for the ZBrain service and its characteristics
 static struct bt_uuid_128 zb_service_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_SERVICE_VAL);
 static struct bt_uuid_128 zb_event_uuid   = BT_UUID_INIT_128(BT_UUID_ZBRAIN_EVENT_VAL);
 static struct bt_uuid_128 zb_cmd_uuid     = BT_UUID_INIT_128(BT_UUID_ZBRAIN_CMD_VAL);
+static struct bt_uuid_128 zb_cmd_batch_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_CMD_BATCH_VAL);
+
+// Command write diagnostics go to the deferred event log (BT RX context only)
+APP_EVLOG_RING_DEFINE(ble_evlog, 16);
+
+// Connected centrals with their notify state; guarded by g_conn_lock
+static struct ble_conn_table g_conns;
+static struct k_spinlock g_conn_lock;
+
+// Outgoing event records, filled by comms_ble_notify_button() and drained by the TX thread
+struct ble_tx_rec {
+    uint8_t data[BLE_BATCH_RECORD_LEN];
+};
+
+K_MSGQ_DEFINE(ble_tx_q, sizeof(struct ble_tx_rec), CONFIG_APP_BLE_TX_QUEUE_LEN, 1);
+
+// Signalled when a connection's notify backlog drops below CONFIG_APP_BLE_TX_MAX_INFLIGHT,
+// one per waiting thread (event TX, stream) so a wake-up is never absorbed by the other
+K_SEM_DEFINE(ble_tx_credit, 0, 1);
+K_SEM_DEFINE(ble_stream_credit, 0, 1);
+
+// Notification batcher: button events are packed into MTU-sized frames (TX thread only,
+// capacity is updated under g_conn_lock from BT callbacks)
+static struct ble_batcher g_batch;
 
-static struct bt_conn *g_conn;
-static bool g_notify_enabled;
+// TX pipeline counters (records for queued/dropped, notifications for in-flight/completed)
+static atomic_t g_tx_queued;
+static atomic_t g_tx_in_flight;
+static atomic_t g_tx_completed;
+static atomic_t g_tx_dropped;
+static atomic_t g_tx_queue_peak;
+
+#if defined(CONFIG_APP_BLE_STREAM)
+// Streaming mode flag and the work item that (re)applies link parameters to every connection
+static atomic_t g_stream_on;
+static struct k_work g_link_work;
+#endif
 
 /**
  * @brief BLE GATT write callback for command characteristic
@@ -52,24 +108,60 @@ static ssize_t cmd_write_cb(struct bt_conn *conn,
                             const void *buf, uint16_t len,
                             uint16_t offset, uint8_t flags);
 
+/**
+ * @brief BLE GATT write callback for the batched command characteristic
+ * 
+ * Called when a BLE client writes a packed sequence of TLV commands (see app/cmd_tlv.h).
+ * 
+ * @param conn BLE connection handle
+ * @param attr GATT attribute being written
+ * @param buf Buffer containing the written data
+ * @param len Length of the written data
+ * @param offset Write offset (must be 0)
+ * @param flags Write flags
+ * @return Number of bytes written on success, BT_GATT_ERR on error
+ */
+static ssize_t cmd_batch_write_cb(struct bt_conn *conn,
+                                  const struct bt_gatt_attr *attr,
+                                  const void *buf, uint16_t len,
+                                  uint16_t offset, uint8_t flags);
+
+static void refresh_subscriptions(void);
+static void tx_credit_broadcast(void);
+static void jrnl_disconnected(struct bt_conn *conn);
+
 /**
  * @brief GATT CCC (Client Characteristic Configuration) change callback
  * 
  * Called when a client enables or disables notifications on the event characteristic.
- * Updates the global notification state.
+ * The value is aggregated over all clients, so per-connection state is re-read.
  * 
  * @param attr GATT attribute that changed
- * @param value New CCC value (BT_GATT_CCC_NOTIFY = notifications enabled)
+ * @param value New aggregated CCC value
  */
 static void event_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value) {
-    g_notify_enabled = (value == BT_GATT_CCC_NOTIFY); // Track client-enabled notifications
-    LOG_INF("notify %s", g_notify_enabled ? "enabled" : "disabled");
+    ARG_UNUSED(attr);
+
+    refresh_subscriptions();
+    LOG_INF("notify %s", (value == BT_GATT_CCC_NOTIFY) ? "enabled" : "disabled");
+}
+
+/**
+ * @brief Size the batcher for the smallest MTU among subscribers
+ *
+ * One encoded frame is fanned out to every subscriber, so it must fit all of them.
+ * Caller holds g_conn_lock.
+ */
+static void refresh_batch_capacity(void) {
+    ble_batcher_set_capacity(&g_batch, ble_conn_table_min_mtu(&g_conns) - 3);
 }
 
 /**
  * @brief BLE connection established callback
  * 
- * Called when a client successfully connects. Stores the connection handle.
+ * Called when a client successfully connects. Claims a connection table slot and hands
+ * advertising back to the advertising manager, which keeps advertising while slots remain
+ * free so further centrals can attach.
  * 
  * @param conn BLE connection handle
  * @param err Connection error code (0 = success)
@@ -79,27 +171,156 @@ static void connected_cb(struct bt_conn *conn, uint8_t err) {
         LOG_WRN("connect failed (err %u)", err);
         return;
     }
-    // Hold a reference to the active connection to notify later
-    g_conn = bt_conn_ref(conn);
-    LOG_INF("connected");
+
+    struct bt_conn_info info;
+    int info_rc = bt_conn_get_info(conn, &info);
+    uint16_t mtu = bt_gatt_get_mtu(conn);
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    struct ble_conn_slot *slot = ble_conn_table_add(&g_conns, conn);
+
+    if (slot != NULL) {
+        // Hold a reference for as long as the connection is in the table
+        bt_conn_ref(conn);
+        slot->mtu = mtu;
+        if (info_rc == 0) {
+            slot->interval_ms = BT_CONN_INTERVAL_TO_MS(info.le.interval);
+        }
+    }
+
+    bool has_free = ble_conn_table_has_free(&g_conns);
+    size_t count = ble_conn_table_count(&g_conns);
+    k_spin_unlock(&g_conn_lock, key);
+
+    // The stack stopped advertising when this central connected
+    ble_adv_connected(conn, has_free);
+
+    if (slot == NULL) {
+        LOG_WRN("connection table full");
+        return;
+    }
+
+    // A bonded client may already have notifications enabled
+    refresh_subscriptions();
+
+    LOG_INF("connected (%u active)", (unsigned)count);
+
+    APP_PM_BUSY(APP_PM_BUSY_BLE_LINK, true);
+
+#if defined(CONFIG_APP_BLE_STREAM)
+    // A central joining mid-stream gets the streaming link parameters too
+    if (atomic_get(&g_stream_on)) {
+        k_work_submit(&g_link_work);
+    }
+#endif
+}
+
+/**
+ * @brief Connection parameters updated callback
+ *
+ * Tracks the connection interval used as the batch flush tick.
+ *
+ * @param conn BLE connection handle
+ * @param interval New connection interval (1.25 ms units)
+ * @param latency Peripheral latency (unused)
+ * @param timeout Supervision timeout (unused)
+ */
+static void le_param_updated_cb(struct bt_conn *conn, uint16_t interval,
+                                uint16_t latency, uint16_t timeout) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    struct ble_conn_slot *slot = ble_conn_table_find(&g_conns, conn);
+
+    if (slot != NULL) {
+        slot->interval_ms = BT_CONN_INTERVAL_TO_MS(interval);
+    }
+    k_spin_unlock(&g_conn_lock, key);
 }
 
+/**
+ * @brief ATT MTU updated callback
+ *
+ * Records the connection's MTU and resizes the notification batch to fit all subscribers.
+ *
+ * @param conn BLE connection handle
+ * @param tx Negotiated TX MTU
+ * @param rx Negotiated RX MTU
+ */
+static void mtu_updated_cb(struct bt_conn *conn, uint16_t tx, uint16_t rx) {
+
+    uint16_t mtu = bt_gatt_get_mtu(conn);
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    struct ble_conn_slot *slot = ble_conn_table_find(&g_conns, conn);
+
+    if (slot != NULL) {
+        slot->mtu = mtu;
+        refresh_batch_capacity();
+    }
+    k_spin_unlock(&g_conn_lock, key);
+
+    LOG_INF("mtu updated tx=%u rx=%u", tx, rx);
+}
+
+static struct bt_gatt_cb gatt_callbacks = {
+    .att_mtu_updated = mtu_updated_cb,
+};
+
 /**
  * @brief BLE disconnection callback
  * 
- * Called when a client disconnects. Cleans up connection resources and resets notification state.
+ * Called when a client disconnects. Frees its table slot (dropping its notify backlog),
+ * re-arms advertising and releases the connection reference.
  * 
  * @param conn BLE connection handle
  * @param reason Disconnection reason code
  */
 static void disconnected_cb(struct bt_conn *conn, uint8_t reason) {
     LOG_INF("disconnected (reason %u)", reason);
-    g_notify_enabled = false;
 
-    if (g_conn) {
-        // Drop reference to the connection on disconnect
-        bt_conn_unref(g_conn);
-        g_conn = NULL;
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    struct ble_conn_slot *slot = ble_conn_table_find(&g_conns, conn);
+    uint8_t backlog = (slot != NULL) ? slot->backlog : 0;
+    int rc = ble_conn_table_remove(&g_conns, conn);
+    size_t remaining = ble_conn_table_count(&g_conns);
+
+    refresh_batch_capacity();
+    k_spin_unlock(&g_conn_lock, key);
+
+    // A journal download on this connection is abandoned, its records stay on the device
+    jrnl_disconnected(conn);
+
+    if (rc != 0) {
+        return;
+    }
+
+    APP_PM_BUSY(APP_PM_BUSY_BLE_LINK, remaining > 0);
+
+    // Fast-reconnect burst (directed first if the central is bonded)
+    ble_adv_disconnected(conn, remaining);
+
+    // Completions for notifications still in the stack may never arrive
+    atomic_sub(&g_tx_in_flight, backlog);
+
+    // Drop reference to the connection on disconnect
+    bt_conn_unref(conn);
+
+    // Either thread may be waiting on this connection's backlog
+    tx_credit_broadcast();
+}
+
+/**
+ * @brief Connection object recycled callback
+ *
+ * The stack can accept a new connection again; resume advertising if it stopped.
+ */
+static void recycled_cb(void) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    bool has_free = ble_conn_table_has_free(&g_conns);
+    k_spin_unlock(&g_conn_lock, key);
+
+    if (has_free) {
+        ble_adv_resume();
     }
 }
 
@@ -107,10 +328,13 @@ static void disconnected_cb(struct bt_conn *conn, uint8_t reason) {
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected = connected_cb,
     .disconnected = disconnected_cb,
+    .le_param_updated = le_param_updated_cb,
+    .recycled = recycled_cb,
 };
 
 
-// Define ZBrain GATT service: one notify characteristic (event) + one write characteristic (command)
+// Define ZBrain GATT service: one notify characteristic (event) + two write characteristics
+// (single command, batched TLV commands)
 BT_GATT_SERVICE_DEFINE(zb_svc,
     BT_GATT_PRIMARY_SERVICE(&zb_service_uuid),
 
@@ -126,36 +350,256 @@ BT_GATT_SERVICE_DEFINE(zb_svc,
     BT_GATT_CHARACTERISTIC(&zb_cmd_uuid.uuid,
                            BT_GATT_CHRC_WRITE,
                            BT_GATT_PERM_WRITE,
-                           NULL, cmd_write_cb, NULL)
+                           NULL, cmd_write_cb, NULL),
+
+    // Batched command characteristic: write-without-response, handled by cmd_batch_write_cb
+    BT_GATT_CHARACTERISTIC(&zb_cmd_batch_uuid.uuid,
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP,
+                           BT_GATT_PERM_WRITE,
+                           NULL, cmd_batch_write_cb, NULL)
 );
 
+#if defined(CONFIG_APP_BLE_STREAM)
+
+// Stream service UUID (shares base, ends ...90c0) and sampler stream characteristic (...90c1)
+#define BT_UUID_ZBRAIN_STREAM_SVC_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890c0)
+#define BT_UUID_ZBRAIN_STREAM_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890c1)
+
+static struct bt_uuid_128 zb_stream_svc_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_STREAM_SVC_VAL);
+static struct bt_uuid_128 zb_stream_uuid     = BT_UUID_INIT_128(BT_UUID_ZBRAIN_STREAM_VAL);
+
 /**
- * @brief Send a BLE notification with event data
+ * @brief GATT CCC change callback for the stream characteristic
+ *
+ * @param attr GATT attribute that changed
+ * @param value New aggregated CCC value
+ */
+static void stream_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value) {
+    ARG_UNUSED(attr);
+
+    refresh_subscriptions();
+    LOG_INF("stream notify %s", (value == BT_GATT_CCC_NOTIFY) ? "enabled" : "disabled");
+}
+
+// Stream service: one notify characteristic carrying fragmented sampler blocks
+BT_GATT_SERVICE_DEFINE(zb_stream_svc,
+    BT_GATT_PRIMARY_SERVICE(&zb_stream_svc_uuid),
+
+    BT_GATT_CHARACTERISTIC(&zb_stream_uuid.uuid,
+                           BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           NULL, NULL, NULL),
+    BT_GATT_CCC(stream_ccc_changed,
+                BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)
+);
+
+#endif /* CONFIG_APP_BLE_STREAM */
+
+/**
+ * @brief Re-read per-connection CCC state
+ *
+ * The CCC callback only reports the value aggregated over all clients, so each
+ * connection's own subscription is queried from the stack.
+ */
+static void refresh_subscriptions(void) {
+
+    struct bt_conn *conns[BLE_CONN_TABLE_SIZE];
+    bool subscribed[BLE_CONN_TABLE_SIZE];
+    bool streaming[BLE_CONN_TABLE_SIZE] = {0};
+
+    // Snapshot the table so the stack is never called with the spinlock held
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        struct bt_conn *conn = g_conns.slots[i].conn;
+
+        conns[i] = (conn != NULL) ? bt_conn_ref(conn) : NULL;
+    }
+    k_spin_unlock(&g_conn_lock, key);
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        subscribed[i] = (conns[i] != NULL) &&
+                        bt_gatt_is_subscribed(conns[i], &zb_svc.attrs[1], BT_GATT_CCC_NOTIFY);
+#if defined(CONFIG_APP_BLE_STREAM)
+        streaming[i] = (conns[i] != NULL) &&
+                       bt_gatt_is_subscribed(conns[i], &zb_stream_svc.attrs[1], BT_GATT_CCC_NOTIFY);
+#endif
+    }
+
+    key = k_spin_lock(&g_conn_lock);
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        // Skip slots that changed owner while the lock was released
+        if (conns[i] != NULL && g_conns.slots[i].conn == conns[i]) {
+            g_conns.slots[i].notify = subscribed[i];
+            g_conns.slots[i].stream = streaming[i];
+        }
+    }
+    refresh_batch_capacity();
+    k_spin_unlock(&g_conn_lock, key);
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        if (conns[i] != NULL) {
+            bt_conn_unref(conns[i]);
+        }
+    }
+}
+
+/**
+ * @brief Wake every thread waiting for a notify backlog slot
+ *
+ * The backlog cap is per connection and shared by events and stream frames, so a freed
+ * slot may unblock either thread; each re-checks its own subscribers.
+ */
+static void tx_credit_broadcast(void) {
+    k_sem_give(&ble_tx_credit);
+    k_sem_give(&ble_stream_credit);
+}
+
+/**
+ * @brief Notification completion callback
+ *
+ * Called by the stack once a notification has been sent on one connection;
+ * shrinks that connection's backlog and wakes the waiting threads.
+ *
+ * @param conn BLE connection handle
+ * @param user_data Unused
+ */
+static void notify_sent_cb(struct bt_conn *conn, void *user_data) {
+
+    ARG_UNUSED(user_data);
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    struct ble_conn_slot *slot = ble_conn_table_find(&g_conns, conn);
+    bool counted = (slot != NULL && slot->backlog > 0);
+
+    if (counted) {
+        slot->backlog--;
+    }
+    k_spin_unlock(&g_conn_lock, key);
+
+    // Late completions after a disconnect were already written off
+    if (counted) {
+        atomic_dec(&g_tx_in_flight);
+    }
+    atomic_inc(&g_tx_completed);
+    tx_credit_broadcast();
+}
+
+/**
+ * @brief Fan one notification out to the subscribers of a characteristic
  * 
- * Internal helper that sends notification data to the connected client if notifications
- * are enabled. Non-blocking operation.
+ * Internal helper for the TX and stream threads. Sends one encoded frame to every
+ * connection subscribed to the characteristic whose backlog is below
+ * CONFIG_APP_BLE_TX_MAX_INFLIGHT. Connections at their cap skip this frame so one
+ * congested central cannot stall the others; only when every subscriber is at its cap does
+ * the thread wait for a completion. While it waits the TX queue absorbs new events and its
+ * drop policy applies, so callers never block.
  * 
+ * @param attr Characteristic to notify
+ * @param stream true for stream subscribers, false for event subscribers
+ * @param credit Calling thread's wake-up semaphore (see tx_credit_broadcast())
  * @param data Pointer to data buffer to send
  * @param len Length of data in bytes
+ * @param units Records (or frames) in the notification, counted in `dropped` on failure
+ * @param dropped Drop counter to charge
+ * @param func Completion callback (must release the backlog slot, see notify_sent_cb())
+ * @param user_data Passed to func
+ * @return Number of connections the frame was handed to
  */
-static void notify_event(const uint8_t *data, uint16_t len)
+static size_t notify_fanout(const struct bt_gatt_attr *attr, bool stream, struct k_sem *credit,
+                          const uint8_t *data, uint16_t len, uint8_t units,
+                          atomic_t *dropped, bt_gatt_complete_func_t func, void *user_data)
 {
-    if (!g_conn || !g_notify_enabled) {
-        return;
+    struct bt_conn *targets[BLE_CONN_TABLE_SIZE];
+    size_t n_targets;
+
+    while (1) {
+        size_t subscribed = 0;
+
+        n_targets = 0;
+
+        // Reserve a backlog slot and take a reference on every connection we will send to
+        k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+        for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+            struct ble_conn_slot *slot = &g_conns.slots[i];
+
+            if (slot->conn == NULL || !(stream ? slot->stream : slot->notify)) {
+                continue;
+            }
+
+            subscribed++;
+            if (slot->backlog < CONFIG_APP_BLE_TX_MAX_INFLIGHT) {
+                slot->backlog++;
+                targets[n_targets++] = bt_conn_ref(slot->conn);
+            }
+        }
+        k_spin_unlock(&g_conn_lock, key);
+
+        if (subscribed == 0) {
+            atomic_add(dropped, units);
+            return 0;
+        }
+
+        if (n_targets > 0) {
+            // Saturated connections miss this frame
+            atomic_add(dropped, (subscribed - n_targets) * units);
+            break;
+        }
+
+        // Backpressure: every subscriber is at its in-flight cap
+        (void)k_sem_take(credit, K_FOREVER);
     }
 
-    // Build notify parameters: attr points to event characteristic, data/len carry the payload
     struct bt_gatt_notify_params params = {
-        .attr = &zb_svc.attrs[1],
+        .attr = attr,
         .data = data,
         .len = len,
+        .func = func,
+        .user_data = user_data,
     };
 
-    // Dispatch a GATT notification to the current connection
-    int rc = bt_gatt_notify_cb(g_conn, &params);
-    if (rc) {
-        LOG_WRN("notify failed (%d)", rc);
+    size_t sent = 0;
+
+    for (size_t i = 0; i < n_targets; i++) {
+
+        atomic_inc(&g_tx_in_flight);
+
+        // Dispatch the same encoded frame to each subscribed connection
+        int rc = bt_gatt_notify_cb(targets[i], &params);
+        if (rc) {
+            k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+            struct ble_conn_slot *slot = ble_conn_table_find(&g_conns, targets[i]);
+
+            if (slot != NULL && slot->backlog > 0) {
+                slot->backlog--;
+            }
+            k_spin_unlock(&g_conn_lock, key);
+
+            atomic_dec(&g_tx_in_flight);
+            atomic_add(dropped, units);
+            LOG_WRN("notify failed (%d)", rc);
+        } else {
+            sent++;
+        }
+
+        bt_conn_unref(targets[i]);
     }
+
+    return sent;
+}
+
+/**
+ * @brief Send a BLE notification with event data
+ *
+ * @param data Pointer to data buffer to send
+ * @param len Length of data in bytes
+ * @param records Number of event records in the frame (counted as dropped on failure)
+ */
+static void notify_event(const uint8_t *data, uint16_t len, uint8_t records) {
+    // attr points to the event characteristic declaration
+    (void)notify_fanout(&zb_svc.attrs[1], false, &ble_tx_credit, data, len, records,
+                        &g_tx_dropped, notify_sent_cb, NULL);
 }
 
 /**
@@ -197,34 +641,163 @@ static ssize_t cmd_write_cb(struct bt_conn *conn,
     msg.timestamp_ms = (uint32_t)k_uptime_get();
     msg.data.command.command_id = command_id;
     msg.data.command.value = value;
+    APP_TRACE_MSG_STAMP(&msg, k_cycle_get_32());
 
     int rc = app_bus_publish(&msg);
-    LOG_INF("cmd write id=%u val=%u publish_rc=%d", command_id, value, rc);
+    APP_EVLOG_RATELIMITED(&ble_evlog, 1000, 8, APP_EV_BLE_CMD, command_id, value, rc);
+
+    // Unknown command, not allowed from BLE, or value rejected by the command's validator
+    if (rc == -ENOENT || rc == -EPERM || rc == -EINVAL) {
+        return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
 
     return len;
 }
 
 /**
- * @brief BLE transmission thread (currently disabled)
+ * @brief Batched command write callback implementation
+ * 
+ * Decodes and checks every TLV record against the command registry first and rejects the
+ * whole write if any record is malformed or not accepted, so either all commands or none
+ * reach the bus. Valid batches are published together.
+ * 
+ * @param conn BLE connection handle
+ * @param attr GATT attribute being written
+ * @param buf Buffer containing TLV-encoded commands
+ * @param len Length of data (up to the ATT MTU - 3)
+ * @param offset Write offset (must be 0)
+ * @param flags Write flags
+ * @return len on success, BT_GATT_ERR code on error
+ */
+static ssize_t cmd_batch_write_cb(struct bt_conn *conn,
+                                  const struct bt_gatt_attr *attr,
+                                  const void *buf, uint16_t len,
+                                  uint16_t offset, uint8_t flags)
+{
+    // Write callbacks run one at a time in the BT RX context, so static scratch is safe
+    static struct app_command_payload cmds[CONFIG_APP_BLE_CMD_BATCH_MAX];
+    static struct app_msg msgs[CONFIG_APP_BLE_CMD_BATCH_MAX];
+
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    int count = cmd_tlv_decode(buf, len, cmds, ARRAY_SIZE(cmds));
+
+    if (count < 0) {
+        LOG_WRN("cmd batch rejected (%d)", count);
+        return BT_GATT_ERR((count == -E2BIG) ? BT_ATT_ERR_INSUFFICIENT_RESOURCES
+                                             : BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
+
+    for (int i = 0; i < count; i++) {
+        int check_rc = app_cmd_check(app_cmd_find(cmds[i].command_id), APP_SRC_COMMS,
+                                     cmds[i].value);
+
+        if (check_rc != 0) {
+            LOG_WRN("cmd batch rejected: record %d id=%u (%d)", i, cmds[i].command_id, check_rc);
+            return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+        }
+    }
+
+    uint32_t now = k_uptime_get_32();
+
+    for (int i = 0; i < count; i++) {
+        msgs[i] = (struct app_msg){
+            .type = APP_MSG_COMMAND,
+            .source = APP_SRC_COMMS,
+            .timestamp_ms = now,
+            .data.command = cmds[i],
+        };
+        APP_TRACE_MSG_STAMP(&msgs[i], k_cycle_get_32());
+    }
+
+    int rc = app_bus_publish_batch(msgs, count);
+    APP_EVLOG_RATELIMITED(&ble_evlog, 1000, 8, APP_EV_BLE_CMD_BATCH, count, rc, 0);
+    if (rc < 0) {
+        LOG_WRN("cmd batch publish failed (%d)", rc);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Encode and send the pending batch (ble_batcher_flush_t)
+ *
+ * Records batched before the MTU shrank are split over as many frames as needed.
+ *
+ * @param b Batcher (g_batch)
+ * @param user_data Unused
+ */
+static void flush_batch(struct ble_batcher *b, void *user_data) {
+
+    ARG_UNUSED(user_data);
+
+    uint8_t frame[BLE_BATCH_MAX_FRAME];
+
+    while (!ble_batcher_empty(b)) {
+
+        k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+        uint8_t before = b->count;
+        uint16_t len = ble_batcher_take(b, frame, sizeof(frame));
+        uint8_t records = before - b->count;
+        k_spin_unlock(&g_conn_lock, key);
+
+        if (len > 0) {
+            notify_event(frame, len, records);
+        }
+    }
+}
+
+/**
+ * @brief Time left before the pending batch must be flushed
+ *
+ * @return K_FOREVER when nothing is pending, otherwise the remaining wait
+ */
+static k_timeout_t batch_timeout(void) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    uint16_t interval = ble_conn_table_min_interval_ms(&g_conns);
+    k_spin_unlock(&g_conn_lock, key);
+
+    uint32_t wait = ble_batcher_wait_ms(&g_batch, CONFIG_APP_BLE_BATCH_MAX_LATENCY_MS, interval,
+                                        k_uptime_get_32());
+
+    return (wait == BLE_BATCHER_WAIT_FOREVER) ? K_FOREVER : K_MSEC(wait);
+}
+
+/**
+ * @brief BLE transmission thread
  * 
- * Originally intended to consume messages from the bus and send as notifications.
- * Currently disabled to prevent message queue conflicts - notifications are sent
- * directly via comms_ble_notify_button() instead.
+ * Pipeline stage between the controller and the BT stack. Drains the TX queue into the
+ * notification batcher and sends a frame when it fills the MTU or its latency budget
+ * expires. Blocking on in-flight slots happens here, never in the controller.
  */
 static void ble_tx_thread(void *, void *, void *) {
-    /* Thread disabled to prevent message queue conflicts */
-    /* Button notifications via BLE are not currently supported */
+
     while (1) {
-        k_sleep(K_FOREVER);
+        struct ble_tx_rec rec;
+        int rc = k_msgq_get(&ble_tx_q, &rec, batch_timeout());
+
+        if (rc != 0) {
+            // Latency budget of the pending batch expired
+            flush_batch(&g_batch, NULL);
+            continue;
+        }
+
+        ble_batcher_push(&g_batch, rec.data, k_uptime_get_32(), flush_batch, NULL);
     }
 }
 
 /**
- * @brief Send button event notification via BLE
+ * @brief Queue a button event notification for BLE
  * 
  * Public interface for sending button press/release notifications to connected BLE clients.
- * Called directly from controller thread. Non-blocking - returns immediately if no client
- * is connected or notifications are disabled.
+ * Called directly from controller thread and never blocks: the record is queued for the
+ * BLE TX thread, which batches it into MTU-sized notifications for every subscribed
+ * connection. When the queue is full the
+ * CONFIG_APP_BLE_TX_DROP_OLDEST / CONFIG_APP_BLE_TX_DROP_NEWEST policy decides which record
+ * is lost. Returns immediately if no client is connected or notifications are disabled.
  * 
  * @param button_id Button identifier (0-3)
  * @param pressed Press state (0 = released, 1 = pressed)
@@ -233,33 +806,795 @@ static void ble_tx_thread(void *, void *, void *) {
 void comms_ble_notify_button(uint8_t button_id, uint8_t pressed, uint32_t timestamp_ms)
 {
     LOG_DBG("notify_button called: id=%u pressed=%u", button_id, pressed);
+    APP_TRACE_POINT(APP_TRACE_BLE_NOTIFY_ENTER);
     
-    if (!g_conn || !g_notify_enabled) {
-        LOG_DBG("notify skipped: conn=%p enabled=%d", g_conn, g_notify_enabled);
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    size_t subscribed = ble_conn_table_subscribed(&g_conns);
+    k_spin_unlock(&g_conn_lock, key);
+
+    if (subscribed == 0) {
+        LOG_DBG("notify skipped: no subscribed connection");
+        APP_TRACE_POINT(APP_TRACE_BLE_NOTIFY_EXIT);
         return;
     }
 
     // Pack button event: type, button id, state, timestamp (LE)
-    uint8_t out[1 + 1 + 1 + 4];
-    out[0] = (uint8_t)APP_MSG_BUTTON_EVENT;
-    out[1] = button_id;
-    out[2] = pressed;
-    sys_put_le32(timestamp_ms, &out[3]);
-    
-    LOG_DBG("calling notify_event");
-    notify_event(out, sizeof(out));
-    LOG_DBG("notify_event returned");
+    struct ble_tx_rec rec;
+    rec.data[0] = (uint8_t)APP_MSG_BUTTON_EVENT;
+    rec.data[1] = button_id;
+    rec.data[2] = pressed;
+    sys_put_le32(timestamp_ms, &rec.data[3]);
+
+    int rc = k_msgq_put(&ble_tx_q, &rec, K_NO_WAIT);
+
+#if defined(CONFIG_APP_BLE_TX_DROP_OLDEST)
+    if (rc != 0) {
+        // Make room by discarding the oldest queued record, then retry once
+        struct ble_tx_rec oldest;
+
+        if (k_msgq_get(&ble_tx_q, &oldest, K_NO_WAIT) == 0) {
+            atomic_inc(&g_tx_dropped);
+            APP_JOURNAL_DROP(APP_JOURNAL_DROP_BLE_TX);
+        }
+        rc = k_msgq_put(&ble_tx_q, &rec, K_NO_WAIT);
+    }
+#endif
+
+    if (rc != 0) {
+        atomic_inc(&g_tx_dropped);
+        APP_JOURNAL_DROP(APP_JOURNAL_DROP_BLE_TX);
+    } else {
+        atomic_inc(&g_tx_queued);
+#if defined(CONFIG_APP_FOOTPRINT)
+        // Only the controller queues records, so a plain compare-and-store is enough
+        uint32_t used = k_msgq_num_used_get(&ble_tx_q);
+
+        if (used > (uint32_t)atomic_get(&g_tx_queue_peak)) {
+            atomic_set(&g_tx_queue_peak, used);
+        }
+#endif
+    }
+
+    APP_TRACE_POINT(APP_TRACE_BLE_NOTIFY_EXIT);
+}
+
+/**
+ * @brief Get BLE TX pipeline counters
+ *
+ * @param out Filled with a snapshot of the counters
+ */
+void comms_ble_tx_stats_get(struct comms_ble_tx_stats *out) {
+
+    out->queued = (uint32_t)atomic_get(&g_tx_queued);
+    out->in_flight = (uint32_t)atomic_get(&g_tx_in_flight);
+    out->completed = (uint32_t)atomic_get(&g_tx_completed);
+    out->dropped = (uint32_t)atomic_get(&g_tx_dropped);
+    out->queue_peak = (uint32_t)atomic_get(&g_tx_queue_peak);
+}
+
+#if defined(CONFIG_APP_BLE_STREAM)
+
+// Streaming link: 7.5-15 ms interval, no peripheral latency, 4 s supervision timeout
+#define STREAM_CONN_PARAM BT_LE_CONN_PARAM(6, 12, 0, 400)
+
+// Low-power link outside streaming: 100-200 ms interval, up to 4 skipped events, 6 s timeout
+#define IDLE_CONN_PARAM BT_LE_CONN_PARAM(80, 160, 4, 600)
+
+// Sampler blocks; paused (no deliveries) while streaming is off
+APP_BUS_SUBSCRIBER_DEFINE(ble_stream_sub, CONFIG_APP_BLE_STREAM_QUEUE_LEN,
+                          APP_BUS_TYPE(APP_MSG_DATA),
+                          APP_BUS_SRC(APP_SRC_SAMPLER),
+                          0);
+
+// One MTU exchange in flight per connection
+static struct bt_gatt_exchange_params g_mtu_xchg[BLE_CONN_TABLE_SIZE];
+
+// Stream counters, reset when streaming starts; g_stream_cnt is guarded by g_stream_lock
+static uint16_t g_stream_seq;
+static struct k_spinlock g_stream_lock;
+static struct ble_stream_counters g_stream_cnt;
+static atomic_t g_stream_dropped;
+
+/**
+ * @brief MTU exchange completion callback
+ *
+ * @param conn BLE connection handle
+ * @param err ATT error (0 = success)
+ * @param params Exchange parameters (unused)
+ */
+static void mtu_xchg_cb(struct bt_conn *conn, uint8_t err, struct bt_gatt_exchange_params *params) {
+    ARG_UNUSED(params);
+
+    LOG_INF("mtu exchange %s (mtu %u)", err ? "failed" : "done", bt_gatt_get_mtu(conn));
 }
 
-// Stack buffer for the (currently disabled) BLE TX thread
-K_THREAD_STACK_DEFINE(ble_tx_stack, 1024);
+/**
+ * @brief Request streaming or low-power parameters on one connection
+ *
+ * Each request is independent; the central may refuse any of them, and the resulting
+ * values arrive through the usual update callbacks.
+ *
+ * @param conn BLE connection handle
+ * @param on true for streaming parameters
+ */
+static void link_apply(struct bt_conn *conn, bool on) {
+
+    int rc;
+
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+    rc = bt_conn_le_phy_update(conn, on ? BT_CONN_LE_PHY_PARAM_2M : BT_CONN_LE_PHY_PARAM_1M);
+    if (rc != 0) {
+        LOG_WRN("phy update failed (%d)", rc);
+    }
+#endif
+
+#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    rc = bt_conn_le_data_len_update(conn, on ? BT_LE_DATA_LEN_PARAM_MAX
+                                             : BT_LE_DATA_LEN_PARAM_DEFAULT);
+    if (rc != 0) {
+        LOG_WRN("data length update failed (%d)", rc);
+    }
+#endif
+
+    rc = bt_conn_le_param_update(conn, on ? STREAM_CONN_PARAM : IDLE_CONN_PARAM);
+    if (rc != 0 && rc != -EALREADY) {
+        LOG_WRN("conn param update failed (%d)", rc);
+    }
+
+#if defined(CONFIG_BT_GATT_CLIENT)
+    // The MTU can only be exchanged once per connection; later calls return -EALREADY
+    if (on) {
+        struct bt_gatt_exchange_params *xchg = &g_mtu_xchg[bt_conn_index(conn)];
+
+        xchg->func = mtu_xchg_cb;
+        rc = bt_gatt_exchange_mtu(conn, xchg);
+        if (rc != 0 && rc != -EALREADY) {
+            LOG_WRN("mtu exchange failed (%d)", rc);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Apply the current mode's link parameters to every connection (work item)
+ *
+ * @param work Work item (unused)
+ */
+static void link_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    struct bt_conn *conns[BLE_CONN_TABLE_SIZE];
+    bool on = atomic_get(&g_stream_on);
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        struct bt_conn *conn = g_conns.slots[i].conn;
+
+        conns[i] = (conn != NULL) ? bt_conn_ref(conn) : NULL;
+    }
+    k_spin_unlock(&g_conn_lock, key);
+
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        if (conns[i] != NULL) {
+            link_apply(conns[i], on);
+            bt_conn_unref(conns[i]);
+        }
+    }
+}
+
+/**
+ * @brief Completion callback for stream frames
+ *
+ * Releases the backlog slot; for the last frame of a block, records the latency from the
+ * end of the block's sampling window to the frame leaving the stack.
+ *
+ * @param conn BLE connection handle
+ * @param user_data Cycle stamp of the end of the block (last fragment only), else NULL
+ */
+static void stream_sent_cb(struct bt_conn *conn, void *user_data) {
+
+    notify_sent_cb(conn, NULL);
+
+    if (user_data == NULL) {
+        return;
+    }
+
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - (uint32_t)(uintptr_t)user_data);
+
+    k_spinlock_key_t key = k_spin_lock(&g_stream_lock);
+    ble_stream_count_latency(&g_stream_cnt, us);
+    k_spin_unlock(&g_stream_lock, key);
+}
+
+/**
+ * @brief Largest frame every stream subscriber can take
+ *
+ * @return Notification payload size in bytes
+ */
+static uint16_t stream_frame_max(void) {
+
+    uint16_t mtu = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&g_conn_lock);
+    for (size_t i = 0; i < BLE_CONN_TABLE_SIZE; i++) {
+        const struct ble_conn_slot *slot = &g_conns.slots[i];
+
+        if (slot->conn != NULL && slot->stream && (mtu == 0 || slot->mtu < mtu)) {
+            mtu = slot->mtu;
+        }
+    }
+    k_spin_unlock(&g_conn_lock, key);
+
+    return MIN(((mtu == 0) ? 23 : mtu) - 3, BLE_BATCH_MAX_FRAME);
+}
+
+/**
+ * @brief Send one sampler block as a sequence of stream frames
+ *
+ * @param buf Sampler block
+ */
+static void stream_block(const struct app_buf *buf) {
+
+    uint8_t frame[BLE_BATCH_MAX_FRAME];
+    const struct sampler_block_hdr *hdr = (const struct sampler_block_hdr *)buf->data;
+    uint32_t end = hdr->t0_cycles + k_us_to_cyc_floor32(hdr->count * hdr->period_us);
+    struct ble_stream_framer framer;
+    uint16_t len;
+    bool last;
+
+    if (ble_stream_framer_init(&framer, buf->data, buf->len, (uint8_t)hdr->seq,
+                               stream_frame_max()) != 0) {
+        atomic_inc(&g_stream_dropped);
+        return;
+    }
+
+    while ((len = ble_stream_framer_next(&framer, g_stream_seq++, frame, &last)) > 0) {
+
+        size_t sent = notify_fanout(&zb_stream_svc.attrs[1], true, &ble_stream_credit, frame,
+                                    len, 1, &g_stream_dropped, stream_sent_cb,
+                                    last ? (void *)(uintptr_t)end : NULL);
+
+        k_spinlock_key_t key = k_spin_lock(&g_stream_lock);
+        ble_stream_count_frame(&g_stream_cnt, sent, len);
+        k_spin_unlock(&g_stream_lock, key);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&g_stream_lock);
+    ble_stream_count_block(&g_stream_cnt);
+    k_spin_unlock(&g_stream_lock, key);
+}
+
+/**
+ * @brief BLE stream thread
+ *
+ * Forwards sampler blocks to stream subscribers while streaming is on. Shares the
+ * per-connection in-flight cap with the event TX thread.
+ */
+static void ble_stream_thread(void *, void *, void *) {
+
+    while (1) {
+        struct app_msg msg;
+
+        if (app_bus_sub_get(&ble_stream_sub, &msg, K_FOREVER) != 0) {
+            continue;
+        }
+
+        // Blocks queued just before streaming stopped are released unsent
+        if (atomic_get(&g_stream_on)) {
+            stream_block(msg.data.block.buf);
+        }
+
+        app_bus_msg_release(&msg);
+    }
+}
+
+/**
+ * @brief Enter or leave streaming mode
+ *
+ * Entering requests 2M PHY, maximum data length, a short connection interval and the
+ * maximum MTU on every connection, then forwards every sampler block to stream
+ * subscribers. Leaving stops the forwarding and requests low-power parameters.
+ *
+ * @param on true to start streaming
+ * @return 0 on success
+ */
+int comms_ble_stream_set(bool on) {
+
+    if ((atomic_set(&g_stream_on, on) != 0) == on) {
+        return 0;
+    }
+
+    if (on) {
+        k_spinlock_key_t key = k_spin_lock(&g_stream_lock);
+        ble_stream_counters_reset(&g_stream_cnt, k_uptime_get_32());
+        k_spin_unlock(&g_stream_lock, key);
+        atomic_clear(&g_stream_dropped);
+    }
+
+    app_bus_sub_pause(&ble_stream_sub, !on);
+    k_work_submit(&g_link_work);
+    APP_PM_BUSY(APP_PM_BUSY_BLE_STREAM, on);
+
+    LOG_INF("streaming %s", on ? "on" : "off");
+
+    return 0;
+}
+
+/**
+ * @brief Check whether streaming mode is on
+ *
+ * @return true while streaming
+ */
+bool comms_ble_streaming(void) {
+    return atomic_get(&g_stream_on) != 0;
+}
+
+/**
+ * @brief Get streaming counters
+ *
+ * @param out Filled with a snapshot of the counters since streaming was last entered
+ */
+void comms_ble_stream_stats_get(struct comms_ble_stream_stats *out) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_stream_lock);
+    ble_stream_counters_read(&g_stream_cnt, k_uptime_get_32(), out);
+    k_spin_unlock(&g_stream_lock, key);
+
+    out->dropped = (uint32_t)atomic_get(&g_stream_dropped);
+}
+
+#else /* CONFIG_APP_BLE_STREAM */
+
+int comms_ble_stream_set(bool on) {
+    ARG_UNUSED(on);
+    return -ENOTSUP;
+}
+
+bool comms_ble_streaming(void) {
+    return false;
+}
+
+void comms_ble_stream_stats_get(struct comms_ble_stream_stats *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+#endif /* CONFIG_APP_BLE_STREAM */
+
+#if defined(CONFIG_APP_TRACE)
+
+// Diagnostics service UUID (shares base, ends ...90b0) and latency histogram characteristic (...90b1)
+#define BT_UUID_ZBRAIN_DIAG_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890b0)
+#define BT_UUID_ZBRAIN_TRACE_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890b1)
+
+static struct bt_uuid_128 zb_diag_uuid  = BT_UUID_INIT_128(BT_UUID_ZBRAIN_DIAG_VAL);
+static struct bt_uuid_128 zb_trace_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_TRACE_VAL);
+
+/**
+ * @brief BLE GATT read callback for the latency histogram characteristic
+ *
+ * Returns APP_TRACE_STAGE_COUNT rows of APP_TRACE_BUCKETS little-endian uint32 counts.
+ * The value is longer than one ATT PDU, so clients use long reads (offsets).
+ *
+ * @param conn BLE connection handle
+ * @param attr GATT attribute being read
+ * @param buf Destination buffer
+ * @param len Space available in buf
+ * @param offset Read offset into the histogram blob
+ * @return Number of bytes read, or BT_GATT_ERR on error
+ */
+static ssize_t trace_read_cb(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                             void *buf, uint16_t len, uint16_t offset)
+{
+    static uint32_t snap[APP_TRACE_STAGE_COUNT][APP_TRACE_BUCKETS];
+    static uint8_t blob[sizeof(snap)];
+
+    // Take a fresh snapshot at the start of a (long) read, keep it for continuation reads
+    if (offset == 0) {
+        app_trace_snapshot(snap);
+        for (int s = 0; s < APP_TRACE_STAGE_COUNT; s++) {
+            for (int b = 0; b < APP_TRACE_BUCKETS; b++) {
+                sys_put_le32(snap[s][b], &blob[(s * APP_TRACE_BUCKETS + b) * 4]);
+            }
+        }
+    }
+
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, blob, sizeof(blob));
+}
+
+// Diagnostics service, only present when tracing is compiled in
+BT_GATT_SERVICE_DEFINE(zb_diag_svc,
+    BT_GATT_PRIMARY_SERVICE(&zb_diag_uuid),
+
+    BT_GATT_CHARACTERISTIC(&zb_trace_uuid.uuid,
+                           BT_GATT_CHRC_READ,
+                           BT_GATT_PERM_READ,
+                           trace_read_cb, NULL, NULL)
+);
+
+#endif /* CONFIG_APP_TRACE */
+
+#if defined(CONFIG_APP_JOURNAL_BLE)
+
+// Journal service UUID (shares base, ends ...90d0), data (...90d1) and control (...90d2)
+#define BT_UUID_ZBRAIN_JOURNAL_SVC_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890d0)
+#define BT_UUID_ZBRAIN_JOURNAL_DATA_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890d1)
+#define BT_UUID_ZBRAIN_JOURNAL_CTRL_VAL \
+    BT_UUID_128_ENCODE(0x1a2b3c4d, 0x1111, 0x2222, 0x3333, 0x1234567890d2)
+
+static struct bt_uuid_128 zb_journal_svc_uuid  = BT_UUID_INIT_128(BT_UUID_ZBRAIN_JOURNAL_SVC_VAL);
+static struct bt_uuid_128 zb_journal_data_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_JOURNAL_DATA_VAL);
+static struct bt_uuid_128 zb_journal_ctrl_uuid = BT_UUID_INIT_128(BT_UUID_ZBRAIN_JOURNAL_CTRL_VAL);
+
+/*
+Journal download:
+The client enables notifications on the data characteristic and writes START to the
+control characteristic, then grants credits; the device sends one data frame per credit,
+so the client paces the transfer to what it can store. After the frame flagged last the
+client writes CLEAR to discard what it received, or ABORT to keep it on the device.
+
+Control write: opcode (u8), then
+  JRNL_OP_START   credits (u8, optional)
+  JRNL_OP_CREDIT  credits (u8)
+  JRNL_OP_CLEAR, JRNL_OP_ABORT  no argument
+Data frame: seq (u16 LE, from 0), flags (u8: bit 0 = last frame), then the next bytes of
+the journal stream (see app/app_journal.h)
+*/
+#define JRNL_OP_START   0x01
+#define JRNL_OP_CREDIT  0x02
+#define JRNL_OP_CLEAR   0x03
+#define JRNL_OP_ABORT   0x04
+
+#define JRNL_FRAME_HDR  3
+#define JRNL_FRAME_LAST BIT(0)
+
+// Requests from the control characteristic, handled by the journal work item
+#define JRNL_REQ_START  0
+#define JRNL_REQ_CLEAR  1
+#define JRNL_REQ_ABORT  2
+
+// Retry delay when the stack is out of notification buffers
+#define JRNL_RETRY_MS   10
+
+static void jrnl_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(g_jrnl_work, jrnl_work_handler);
+
+static struct k_spinlock g_jrnl_lock;
+static struct bt_conn *g_jrnl_conn;         // downloading connection (reference held)
+static atomic_t g_jrnl_credits;
+static atomic_t g_jrnl_req;
+
+// Owned by the work item
+static struct app_journal_reader g_jrnl_rd;
+static bool g_jrnl_open;
+static bool g_jrnl_sending;
+static bool g_jrnl_pending;                 // frame built but not yet accepted by the stack
+static uint16_t g_jrnl_seq;
+static uint16_t g_jrnl_len;
+static uint8_t g_jrnl_frame[BLE_BATCH_MAX_FRAME];
+static int64_t g_jrnl_start_ms;
+
+static struct comms_ble_journal_stats g_jrnl_stats;
+
+/**
+ * @brief Journal control write callback
+ *
+ * Only records the request; the journal work item does the reading and sending.
+ *
+ * @param conn BLE connection handle
+ * @param attr GATT attribute being written
+ * @param buf Opcode and argument
+ * @param len Length of data
+ * @param offset Write offset (must be 0)
+ * @param flags Write flags
+ * @return len on success, BT_GATT_ERR code on error
+ */
+static ssize_t jrnl_ctrl_write_cb(struct bt_conn *conn,
+                                  const struct bt_gatt_attr *attr,
+                                  const void *buf, uint16_t len,
+                                  uint16_t offset, uint8_t flags)
+{
+    const uint8_t *b = (const uint8_t *)buf;
+
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+    if (len < 1 || len > 2 || (b[0] == JRNL_OP_CREDIT && len != 2)) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&g_jrnl_lock);
+    bool owner = (g_jrnl_conn == conn);
+
+    // One download at a time; the first START claims it
+    if (b[0] == JRNL_OP_START && g_jrnl_conn == NULL) {
+        g_jrnl_conn = bt_conn_ref(conn);
+        owner = true;
+    }
+    k_spin_unlock(&g_jrnl_lock, key);
+
+    if (!owner) {
+        return BT_GATT_ERR(BT_ATT_ERR_PROCEDURE_IN_PROGRESS);
+    }
+
+    switch (b[0]) {
+    case JRNL_OP_START:
+        atomic_set(&g_jrnl_credits, (len == 2) ? b[1] : 0);
+        atomic_set_bit(&g_jrnl_req, JRNL_REQ_START);
+        break;
+    case JRNL_OP_CREDIT:
+        atomic_add(&g_jrnl_credits, b[1]);
+        break;
+    case JRNL_OP_CLEAR:
+        atomic_set_bit(&g_jrnl_req, JRNL_REQ_CLEAR);
+        break;
+    case JRNL_OP_ABORT:
+        atomic_set_bit(&g_jrnl_req, JRNL_REQ_ABORT);
+        break;
+    default:
+        return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
+
+    (void)k_work_reschedule(&g_jrnl_work, K_NO_WAIT);
+
+    return len;
+}
+
+/**
+ * @brief GATT CCC change callback for the journal data characteristic
+ *
+ * @param attr GATT attribute that changed
+ * @param value New aggregated CCC value
+ */
+static void jrnl_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value) {
+    ARG_UNUSED(attr);
+
+    LOG_INF("journal notify %s", (value == BT_GATT_CCC_NOTIFY) ? "enabled" : "disabled");
+}
+
+// Journal service: notify characteristic for frames, write characteristic for control
+BT_GATT_SERVICE_DEFINE(zb_journal_svc,
+    BT_GATT_PRIMARY_SERVICE(&zb_journal_svc_uuid),
+
+    BT_GATT_CHARACTERISTIC(&zb_journal_data_uuid.uuid,
+                           BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           NULL, NULL, NULL),
+    BT_GATT_CCC(jrnl_ccc_changed,
+                BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    BT_GATT_CHARACTERISTIC(&zb_journal_ctrl_uuid.uuid,
+                           BT_GATT_CHRC_WRITE | BT_GATT_CHRC_WRITE_WITHOUT_RESP,
+                           BT_GATT_PERM_WRITE,
+                           NULL, jrnl_ctrl_write_cb, NULL)
+);
+
+/**
+ * @brief End the download: close the reader and release the connection
+ *
+ * @param commit true to discard the downloaded records from the device
+ */
+static void jrnl_finish(bool commit) {
+
+    if (g_jrnl_open) {
+        app_journal_close(&g_jrnl_rd, commit);
+        g_jrnl_open = false;
+    }
+    g_jrnl_sending = false;
+    g_jrnl_pending = false;
+    atomic_clear(&g_jrnl_req);
+
+    k_spinlock_key_t key = k_spin_lock(&g_jrnl_lock);
+    struct bt_conn *conn = g_jrnl_conn;
+
+    g_jrnl_conn = NULL;
+    k_spin_unlock(&g_jrnl_lock, key);
+
+    if (conn != NULL) {
+        bt_conn_unref(conn);
+    }
+}
+
+/**
+ * @brief Build the next data frame from the journal reader
+ *
+ * @param conn Downloading connection (sets the frame size)
+ * @return 0 on success, -ENOTCONN if the link is gone (MTU too small for a frame)
+ */
+static int jrnl_frame_build(struct bt_conn *conn) {
+
+    uint16_t mtu = bt_gatt_get_mtu(conn);
+
+    // 0 once the link is down
+    if (mtu <= 3 + JRNL_FRAME_HDR) {
+        return -ENOTCONN;
+    }
+
+    size_t max = MIN((size_t)(mtu - 3), sizeof(g_jrnl_frame)) - JRNL_FRAME_HDR;
+    size_t n = app_journal_read(&g_jrnl_rd, &g_jrnl_frame[JRNL_FRAME_HDR], max);
+
+    sys_put_le16(g_jrnl_seq, &g_jrnl_frame[0]);
+    g_jrnl_frame[2] = (n < max) ? JRNL_FRAME_LAST : 0;
+    g_jrnl_len = (uint16_t)(n + JRNL_FRAME_HDR);
+    g_jrnl_pending = true;
+
+    return 0;
+}
+
+/**
+ * @brief Journal download (work item)
+ *
+ * Handles control requests and sends one frame per credit. When the stack has no
+ * notification buffer left the frame is kept and retried after JRNL_RETRY_MS.
+ *
+ * @param work Work item (unused)
+ */
+static void jrnl_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    k_spinlock_key_t key = k_spin_lock(&g_jrnl_lock);
+    struct bt_conn *conn = (g_jrnl_conn != NULL) ? bt_conn_ref(g_jrnl_conn) : NULL;
+    k_spin_unlock(&g_jrnl_lock, key);
+
+    if (conn == NULL) {
+        return;
+    }
+
+    if (atomic_test_and_clear_bit(&g_jrnl_req, JRNL_REQ_ABORT)) {
+        jrnl_finish(false);
+        goto out;
+    }
+
+    if (atomic_test_and_clear_bit(&g_jrnl_req, JRNL_REQ_START)) {
+        // A restart keeps the records of the previous attempt on the device
+        if (g_jrnl_open) {
+            app_journal_close(&g_jrnl_rd, false);
+            g_jrnl_open = false;
+        }
+
+        int rc = app_journal_open(&g_jrnl_rd);
+
+        if (rc != 0) {
+            LOG_WRN("journal open failed (%d)", rc);
+            jrnl_finish(false);
+            goto out;
+        }
+
+        g_jrnl_open = true;
+        g_jrnl_sending = true;
+        g_jrnl_pending = false;
+        g_jrnl_seq = 0;
+        g_jrnl_start_ms = k_uptime_get();
+        g_jrnl_stats.last_bytes = 0;
+    }
+
+    // Only a fully sent download can be cleared
+    if (atomic_test_and_clear_bit(&g_jrnl_req, JRNL_REQ_CLEAR) && g_jrnl_open && !g_jrnl_sending) {
+        g_jrnl_stats.cleared++;
+        jrnl_finish(true);
+        goto out;
+    }
+
+    while (g_jrnl_sending && atomic_get(&g_jrnl_credits) > 0) {
+
+        if (!g_jrnl_pending && jrnl_frame_build(conn) != 0) {
+            // The disconnect callback aborts the download
+            break;
+        }
+
+        struct bt_gatt_notify_params params = {
+            .attr = &zb_journal_svc.attrs[1],
+            .data = g_jrnl_frame,
+            .len = g_jrnl_len,
+        };
+
+        int rc = bt_gatt_notify_cb(conn, &params);
+
+        if (rc == -ENOMEM) {
+            (void)k_work_reschedule(&g_jrnl_work, K_MSEC(JRNL_RETRY_MS));
+            break;
+        }
+        if (rc != 0) {
+            LOG_WRN("journal notify failed (%d)", rc);
+            jrnl_finish(false);
+            break;
+        }
+
+        g_jrnl_pending = false;
+        g_jrnl_seq++;
+        atomic_dec(&g_jrnl_credits);
+        g_jrnl_stats.frames++;
+        g_jrnl_stats.last_bytes += g_jrnl_len;
+
+        if (g_jrnl_frame[2] & JRNL_FRAME_LAST) {
+            int64_t elapsed_ms = k_uptime_get() - g_jrnl_start_ms;
+
+            g_jrnl_sending = false;
+            g_jrnl_stats.downloads++;
+            g_jrnl_stats.last_ms = (uint32_t)elapsed_ms;
+            g_jrnl_stats.last_bps = (elapsed_ms > 0) ?
+                (uint32_t)((uint64_t)g_jrnl_stats.last_bytes * 8 * 1000 / elapsed_ms) : 0;
+            LOG_INF("journal sent: %u bytes in %u frames, %u ms", g_jrnl_stats.last_bytes,
+                    g_jrnl_seq, g_jrnl_stats.last_ms);
+        }
+    }
+
+out:
+    bt_conn_unref(conn);
+}
+
+/**
+ * @brief Abort a download when its connection goes away
+ *
+ * @param conn Disconnected connection
+ */
+static void jrnl_disconnected(struct bt_conn *conn) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_jrnl_lock);
+    bool owner = (g_jrnl_conn == conn);
+    k_spin_unlock(&g_jrnl_lock, key);
+
+    if (owner) {
+        atomic_set_bit(&g_jrnl_req, JRNL_REQ_ABORT);
+        (void)k_work_reschedule(&g_jrnl_work, K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Get journal download counters
+ *
+ * @param out Destination
+ */
+void comms_ble_journal_stats_get(struct comms_ble_journal_stats *out) {
+    *out = g_jrnl_stats;
+}
+
+#else /* CONFIG_APP_JOURNAL_BLE */
+
+static void jrnl_disconnected(struct bt_conn *conn) {
+    ARG_UNUSED(conn);
+}
+
+void comms_ble_journal_stats_get(struct comms_ble_journal_stats *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+#endif /* CONFIG_APP_JOURNAL_BLE */
+
+// Stack buffer for the BLE TX thread
+K_THREAD_STACK_DEFINE(ble_tx_stack, CONFIG_APP_BLE_TX_STACK_SIZE);
 static struct k_thread ble_tx_thread_data;
 
+#if defined(CONFIG_APP_BLE_STREAM)
+// Stack buffer for the BLE stream thread (holds one frame)
+K_THREAD_STACK_DEFINE(ble_stream_stack, CONFIG_APP_BLE_STREAM_STACK_SIZE);
+static struct k_thread ble_stream_thread_data;
+#endif
+
+// Advertising payload: general discoverable, no BR/EDR, and include the custom service UUID
+static const struct bt_data ad[] = {
+    BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+    BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_ZBRAIN_SERVICE_VAL),
+};
+
+// Scan response payload: include full device name
+static const struct bt_data sd[] = {
+    BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME, sizeof(CONFIG_BT_DEVICE_NAME) - 1),
+};
+
 /**
  * @brief Initialize and start BLE subsystem
  * 
- * Enables the Bluetooth controller, configures advertising with device name and custom service UUID,
- * and starts advertising as a connectable peripheral. Creates the BLE TX thread (currently dormant).
+ * Enables the Bluetooth controller, hands the advertising payload (device name and custom
+ * service UUID) to the advertising manager and starts advertising as a connectable peripheral.
+ * Advertising resumes automatically while fewer than CONFIG_BT_MAX_CONN centrals are
+ * connected. Creates the BLE TX thread.
  * 
  * @return 0 on success, negative error code on failure
  */
@@ -271,42 +1606,53 @@ int comms_ble_start(void) {
     }
     LOG_INF("BLE enabled");
 
-    // Advertising payload: general discoverable, no BR/EDR, and include the custom service UUID
-    const struct bt_data ad[] = {
-        BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
-        BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_ZBRAIN_SERVICE_VAL),
-    };
+    (void)app_evlog_register(&ble_evlog);
 
-    // Scan response payload: include full device name
-    const struct bt_data sd[] = {
-        BT_DATA(BT_DATA_NAME_COMPLETE, CONFIG_BT_DEVICE_NAME, sizeof(CONFIG_BT_DEVICE_NAME) - 1),
-    };
+#if defined(CONFIG_BT_SETTINGS)
+    // Identity and bonds; the advertising manager picks its directed target from the bonds
+    (void)settings_load_subtree("bt");
+#endif
 
-    struct bt_le_adv_param adv_param = {
-        .id = BT_ID_DEFAULT,          // default identity; use BT_ID_RANDOM for a random static address
-        .sid = 0,                     // advertising set ID (0 when only one set is used)
-        .secondary_max_skip = 0,      // extended adv only; 0 = no skips of secondary channel PDUs
-        .options = 0x01,              // BT_LE_ADV_OPT_CONNECTABLE (legacy undirected). Examples: 0x00 non-connectable, 0x02 scannable, 0x05 connectable+use name
-        .interval_min = 0x0020,       // min interval (0.625ms units) ≈20ms; e.g., 0x00A0 ≈100ms
-        .interval_max = 0x4000,       // max interval ≈10.24s; lower to make discovery faster
-        .peer = NULL,                 // NULL = undirected advertising; set to a peer address for directed ads
-    };
+    ble_batcher_init(&g_batch, 23 - 3); // default LE ATT MTU until a connection negotiates more
+    bt_gatt_cb_register(&gatt_callbacks);
 
-    // Start legacy, undirected, connectable advertising with flags+service UUID in AD and name in SD.
-    rc = bt_le_adv_start(&adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+    rc = ble_adv_init(ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
     if (rc) {
-        LOG_ERR("adv start failed (%d)", rc);
+        LOG_ERR("adv init failed (%d)", rc);
         return rc;
     }
+    ble_adv_start();
     LOG_INF("Advertising started");
 
-    // Spawn the (currently idle) BLE TX thread with priority 9 and no delay
+    // Spawn the BLE TX thread with priority 9 and no delay
     k_thread_create(&ble_tx_thread_data,
                     ble_tx_stack,
                     K_THREAD_STACK_SIZEOF(ble_tx_stack),
                     ble_tx_thread,
                     NULL, NULL, NULL,
                     9, 0, K_NO_WAIT);
+    (void)k_thread_name_set(&ble_tx_thread_data, "ble_tx");
+
+#if defined(CONFIG_APP_BLE_STREAM)
+    k_work_init(&g_link_work, link_work_handler);
+
+    // Stream subscriber stays paused until streaming is entered
+    app_bus_sub_pause(&ble_stream_sub, true);
+    rc = app_bus_subscribe(&ble_stream_sub);
+    if (rc) {
+        LOG_ERR("stream subscribe failed (%d)", rc);
+        return rc;
+    }
+
+    // Spawn the BLE stream thread with priority 9 and no delay
+    k_thread_create(&ble_stream_thread_data,
+                    ble_stream_stack,
+                    K_THREAD_STACK_SIZEOF(ble_stream_stack),
+                    ble_stream_thread,
+                    NULL, NULL, NULL,
+                    9, 0, K_NO_WAIT);
+    (void)k_thread_name_set(&ble_stream_thread_data, "ble_stream");
+#endif
 
     return 0;
-}
\ No newline at end of file
+}
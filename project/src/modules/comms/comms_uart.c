@@ -1,16 +1,21 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <app/app_bus.h>
+#include <app/app_health.h>
 
 LOG_MODULE_REGISTER(comms, LOG_LEVEL_INF); // Enable logging
 
 static uint32_t last_button_log_ms;
 static uint8_t last_button_state;
 
+// Bound for the stack report only: the thread never iterates
+APP_HEALTH_DEFINE(comms_health, "comms", 500);
+
 static void comms_thread(void) {
 
     // Disabled to allow controller to process button events
-    
+    APP_HEALTH_START(comms_health);
+
     while (1) {
         k_sleep(K_FOREVER);
     }
@@ -45,4 +50,4 @@ static void comms_thread(void) {
     // }
 }
 
-K_THREAD_DEFINE(comms_tid, 1024, comms_thread, NULL, NULL, NULL, 6, 0, 0);
\ No newline at end of file
+K_THREAD_DEFINE(comms_tid, CONFIG_APP_COMMS_STACK_SIZE, comms_thread, NULL, NULL, NULL, 6, 0, 0);
\ No newline at end of file
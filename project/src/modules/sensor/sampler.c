@@ -0,0 +1,487 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#if defined(CONFIG_ADC)
+#include <zephyr/drivers/adc.h>
+#endif
+#if defined(CONFIG_SENSOR)
+#include <zephyr/drivers/sensor.h>
+#endif
+
+#include <app/app_bus.h>
+#include <app/app_health.h>
+#include <app/app_msg.h>
+#include <app/sampler.h>
+
+LOG_MODULE_REGISTER(sampler, LOG_LEVEL_INF); // Enable logging
+
+/*
+Sampling channels:
+- ADC group: every io-channels entry of the /zephyr,user node, sampled together in one
+  hardware sequence (all entries must share one ADC controller), values interleaved.
+- Accelerometer: the device behind the accel0 alias, x/y/z per sample.
+Each channel fills app_buf blocks and publishes them to the bus when full.
+*/
+#define ZEPHYR_USER_NODE DT_PATH(zephyr_user)
+
+#if defined(CONFIG_ADC) && DT_NODE_HAS_PROP(ZEPHYR_USER_NODE, io_channels)
+#define SAMPLER_HAS_ADC 1
+#define ADC_SPEC(node, prop, idx) ADC_DT_SPEC_GET_BY_IDX(node, idx),
+
+static const struct adc_dt_spec adc_specs[] = {
+    DT_FOREACH_PROP_ELEM(ZEPHYR_USER_NODE, io_channels, ADC_SPEC)
+};
+#endif
+
+#if defined(CONFIG_SENSOR) && DT_NODE_HAS_STATUS(DT_ALIAS(accel0), okay)
+#define SAMPLER_HAS_ACCEL 1
+static const struct device *const accel_dev = DEVICE_DT_GET(DT_ALIAS(accel0));
+#endif
+
+// Channel indices, in the order above
+enum {
+#if defined(SAMPLER_HAS_ADC)
+    CH_ADC,
+#endif
+#if defined(SAMPLER_HAS_ACCEL)
+    CH_ACCEL,
+#endif
+    CH_COUNT,
+};
+
+struct sampler_channel {
+    uint8_t fmt;
+    uint8_t width;              // int16 values per sample
+    uint16_t seq;
+    uint32_t rate_hz;
+    uint32_t period_us;         // sample period of the block being filled (latched at its start)
+    uint16_t per_block;         // samples per block
+    uint16_t filled;            // samples in `fill` (timer-driven channels)
+    uint32_t t0_cycles;
+    struct app_buf *fill;       // block being written by hardware or the thread
+    struct app_buf *spare;      // next block, swapped in as soon as `fill` completes
+    struct sampler_stats stats;
+};
+
+static struct sampler_channel g_ch[CH_COUNT];
+
+APP_HEALTH_DEFINE(sampler_health, "sampler", 200);
+
+/**
+ * @brief Make sure a channel has a spare block for the next swap
+ *
+ * @param ch Channel
+ */
+static void spare_refill(struct sampler_channel *ch) {
+
+    if (ch->spare == NULL) {
+        ch->spare = app_buf_alloc(K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Swap in the spare block and return the completed one
+ *
+ * @param ch Channel whose `fill` block is complete
+ * @return Completed block (owned by the caller)
+ */
+static struct app_buf *block_swap(struct sampler_channel *ch) {
+
+    struct app_buf *done = ch->fill;
+
+    ch->fill = ch->spare;
+    ch->spare = NULL;
+    ch->filled = 0;
+
+    return done;
+}
+
+/**
+ * @brief Finish a block's header and publish it to the bus
+ *
+ * @param idx Channel index
+ * @param buf Completed block (reference consumed)
+ * @param count Number of samples in the block
+ * @param t0_cycles Cycle stamp of the first sample
+ * @param period_us Sample period the block was taken at
+ */
+static void block_publish(uint8_t idx, struct app_buf *buf, uint16_t count, uint32_t t0_cycles,
+                          uint32_t period_us) {
+
+    struct sampler_channel *ch = &g_ch[idx];
+    struct sampler_block_hdr *hdr = (struct sampler_block_hdr *)buf->data;
+
+    hdr->channel = idx;
+    hdr->fmt = ch->fmt;
+    hdr->width = ch->width;
+    hdr->reserved = 0;
+    hdr->count = count;
+    hdr->seq = ch->seq++;
+    hdr->t0_cycles = t0_cycles;
+    hdr->period_us = period_us;
+    buf->len = sizeof(*hdr) + count * ch->width * sizeof(int16_t);
+
+    int rc = app_bus_publish_buf(APP_SRC_SAMPLER, buf);
+
+    ch->stats.samples += count;
+    ch->stats.blocks++;
+    if (rc != 0 && rc != -ENOENT) {
+        ch->stats.overruns++;
+    }
+}
+
+#if defined(SAMPLER_HAS_ADC)
+
+// Delay between attempts to re-arm the ADC after a failed start
+#define ADC_RETRY_MS 10
+
+static struct adc_sequence_options adc_opts;
+static struct adc_sequence adc_seq = { .options = &adc_opts };
+static struct k_poll_signal adc_sig;
+static bool adc_armed;                  // a sequence is running and will raise adc_sig
+
+/**
+ * @brief Configure every ADC channel and build the shared sequence
+ *
+ * @return 0 on success, negative error code from the ADC driver otherwise
+ */
+static int adc_setup(void) {
+
+    for (int i = 0; i < ARRAY_SIZE(adc_specs); i++) {
+
+        if (!adc_is_ready_dt(&adc_specs[i]) || adc_specs[i].dev != adc_specs[0].dev) {
+            LOG_ERR("ADC channel %d unusable", i);
+            return -ENODEV;
+        }
+
+        int rc = adc_channel_setup_dt(&adc_specs[i]);
+
+        if (rc != 0) {
+            LOG_ERR("ADC channel %d setup failed (%d)", i, rc);
+            return rc;
+        }
+    }
+
+    (void)adc_sequence_init_dt(&adc_specs[0], &adc_seq);
+    for (int i = 1; i < ARRAY_SIZE(adc_specs); i++) {
+        adc_seq.channels |= BIT(adc_specs[i].channel_id);
+    }
+
+    k_poll_signal_init(&adc_sig);
+
+    struct sampler_channel *ch = &g_ch[CH_ADC];
+
+    ch->fmt = SAMPLER_FMT_ADC_RAW;
+    ch->width = ARRAY_SIZE(adc_specs);
+    ch->rate_hz = CONFIG_APP_SAMPLER_ADC_RATE_HZ;
+
+    return 0;
+}
+
+/**
+ * @brief Start filling the channel's current block with one hardware sequence
+ *
+ * The driver takes `per_block` samplings at the channel rate and raises adc_sig when
+ * the block is complete; the CPU is not involved between samples.
+ *
+ * @return 0 on success, -ENOMEM if no block is available, or the driver error
+ */
+static int adc_start(void) {
+
+    struct sampler_channel *ch = &g_ch[CH_ADC];
+
+    adc_armed = false;
+
+    if (ch->fill == NULL) {
+        ch->fill = app_buf_alloc(K_NO_WAIT);
+        if (ch->fill == NULL) {
+            return -ENOMEM;
+        }
+    }
+
+    ch->per_block = SAMPLER_BLOCK_VALUES / ch->width;
+    ch->period_us = USEC_PER_SEC / ch->rate_hz;
+    adc_opts.interval_us = ch->period_us;
+    adc_opts.extra_samplings = ch->per_block - 1;
+    adc_seq.buffer = ch->fill->data + sizeof(struct sampler_block_hdr);
+    adc_seq.buffer_size = ch->per_block * ch->width * sizeof(int16_t);
+    ch->t0_cycles = k_cycle_get_32();
+
+    int rc = adc_read_async(adc_specs[0].dev, &adc_seq, &adc_sig);
+
+    adc_armed = (rc == 0);
+
+    return rc;
+}
+
+/**
+ * @brief Re-arm the ADC after a failed start
+ *
+ * Called every ADC_RETRY_MS while no sequence is running; the first failure was already
+ * counted as an overrun.
+ */
+static void adc_retry(void) {
+
+    if (adc_start() == 0) {
+        spare_refill(&g_ch[CH_ADC]);
+    }
+}
+
+/**
+ * @brief Shorter of two relative timeouts
+ *
+ * @param a Timeout
+ * @param b Timeout
+ * @return a or b, whichever expires first
+ */
+static k_timeout_t timeout_min(k_timeout_t a, k_timeout_t b) {
+
+    if (K_TIMEOUT_EQ(a, K_FOREVER)) {
+        return b;
+    }
+    if (K_TIMEOUT_EQ(b, K_FOREVER)) {
+        return a;
+    }
+
+    return (a.ticks < b.ticks) ? a : b;
+}
+
+/**
+ * @brief Handle a completed ADC block: restart on the spare block, then publish
+ */
+static void adc_block_done(void) {
+
+    struct sampler_channel *ch = &g_ch[CH_ADC];
+    uint32_t t0 = ch->t0_cycles;
+    uint32_t period_us = ch->period_us;
+    uint16_t count = ch->per_block;
+    struct app_buf *done = block_swap(ch);
+
+    // Re-arm first so the hardware keeps sampling while the finished block is handed off;
+    // on failure the thread retries every ADC_RETRY_MS
+    if (adc_start() != 0) {
+        ch->stats.overruns++;
+    }
+
+    block_publish(CH_ADC, done, count, t0, period_us);
+    spare_refill(ch);
+}
+
+#endif /* SAMPLER_HAS_ADC */
+
+#if defined(SAMPLER_HAS_ACCEL)
+
+/**
+ * @brief Prepare the accelerometer channel
+ *
+ * @return 0 on success, -ENODEV if the device is not ready
+ */
+static int accel_setup(void) {
+
+    if (!device_is_ready(accel_dev)) {
+        LOG_ERR("accelerometer not ready");
+        return -ENODEV;
+    }
+
+    struct sampler_channel *ch = &g_ch[CH_ACCEL];
+
+    ch->fmt = SAMPLER_FMT_ACCEL_MMS2_XYZ;
+    ch->width = 3;
+    ch->rate_hz = CONFIG_APP_SAMPLER_ACCEL_RATE_HZ;
+    ch->per_block = SAMPLER_BLOCK_VALUES / ch->width;
+
+    return 0;
+}
+
+/**
+ * @brief Convert a sensor value to a saturated int16 in thousandths
+ *
+ * @param v Sensor value
+ * @return Value * 1000, clamped to int16
+ */
+static int16_t to_milli_i16(const struct sensor_value *v) {
+    return (int16_t)CLAMP(sensor_value_to_milli(v), INT16_MIN, INT16_MAX);
+}
+
+/**
+ * @brief Take one accelerometer sample into the current block, publishing it when full
+ */
+static void accel_sample(void) {
+
+    struct sampler_channel *ch = &g_ch[CH_ACCEL];
+    struct sensor_value xyz[3];
+
+    if (ch->fill == NULL) {
+        ch->fill = app_buf_alloc(K_NO_WAIT);
+        if (ch->fill == NULL) {
+            ch->stats.overruns++;
+            return;
+        }
+    }
+
+    if (sensor_sample_fetch(accel_dev) != 0 ||
+        sensor_channel_get(accel_dev, SENSOR_CHAN_ACCEL_XYZ, xyz) != 0) {
+        return;
+    }
+
+    if (ch->filled == 0) {
+        ch->t0_cycles = k_cycle_get_32();
+        ch->period_us = USEC_PER_SEC / ch->rate_hz;
+    }
+
+    int16_t *out = (int16_t *)(ch->fill->data + sizeof(struct sampler_block_hdr));
+
+    for (int i = 0; i < 3; i++) {
+        out[ch->filled * 3 + i] = to_milli_i16(&xyz[i]);
+    }
+
+    if (++ch->filled == ch->per_block) {
+        uint32_t t0 = ch->t0_cycles;
+        uint16_t count = ch->filled;
+
+        block_publish(CH_ACCEL, block_swap(ch), count, t0, ch->period_us);
+        spare_refill(ch);
+    }
+}
+
+#endif /* SAMPLER_HAS_ACCEL */
+
+/**
+ * @brief Change the sampling rate of a channel
+ *
+ * Takes effect from the next block; the block in progress keeps the period it started with.
+ *
+ * @param channel Channel index (0 to sampler_channel_count() - 1)
+ * @param rate_hz New rate, 1 Hz to 1 MHz
+ * @return 0 on success, -EINVAL on a bad channel or rate
+ */
+int sampler_set_rate(uint8_t channel, uint32_t rate_hz) {
+
+    if (channel >= CH_COUNT || rate_hz == 0 || rate_hz > USEC_PER_SEC) {
+        return -EINVAL;
+    }
+
+    g_ch[channel].rate_hz = rate_hz;
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of sampling channels found in the devicetree
+ *
+ * @return Channel count
+ */
+uint8_t sampler_channel_count(void) {
+    return CH_COUNT;
+}
+
+/**
+ * @brief Get throughput counters of a channel
+ *
+ * @param channel Channel index
+ * @param out Destination
+ * @return 0 on success, -EINVAL on a bad channel
+ */
+int sampler_stats_get(uint8_t channel, struct sampler_stats *out) {
+
+    if (channel >= CH_COUNT) {
+        return -EINVAL;
+    }
+
+    *out = g_ch[channel].stats;
+
+    return 0;
+}
+
+/**
+ * @brief Sampler thread
+ *
+ * Waits for ADC block completion (hardware-timed sequences) and for the next
+ * accelerometer sample deadline, whichever comes first. Blocks are double-buffered:
+ * the spare block is armed before the finished one is published. If the ADC could not be
+ * re-armed (no free block, driver error) the thread retries every ADC_RETRY_MS.
+ *
+ * Thread priority: 6 (below the button sensor, above the controller)
+ */
+static void sampler_thread(void) {
+
+    if (CH_COUNT == 0) {
+        LOG_INF("no sampling channels in devicetree");
+        return;
+    }
+
+#if defined(SAMPLER_HAS_ADC)
+    struct k_poll_event events[] = {
+        K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &adc_sig),
+    };
+    bool adc_ok = (adc_setup() == 0);
+
+    if (adc_ok) {
+        spare_refill(&g_ch[CH_ADC]);
+        if (adc_start() != 0) {
+            LOG_WRN("ADC start failed, retrying");
+        }
+    }
+#endif
+
+#if defined(SAMPLER_HAS_ACCEL)
+    bool accel_ok = (accel_setup() == 0);
+    k_timepoint_t accel_next = sys_timepoint_calc(K_NO_WAIT);
+
+    if (accel_ok) {
+        spare_refill(&g_ch[CH_ACCEL]);
+    }
+#endif
+
+    APP_HEALTH_START(sampler_health);
+    LOG_INF("sampler start (%d channels)", CH_COUNT);
+
+    while (1) {
+
+        k_timeout_t wait = K_FOREVER;
+
+#if defined(SAMPLER_HAS_ACCEL)
+        if (accel_ok) {
+            wait = sys_timepoint_timeout(accel_next);
+        }
+#endif
+
+#if defined(SAMPLER_HAS_ADC)
+        if (adc_ok) {
+            if (!adc_armed) {
+                wait = timeout_min(wait, K_MSEC(ADC_RETRY_MS));
+            }
+
+            (void)k_poll(events, ARRAY_SIZE(events), wait);
+
+            APP_HEALTH_BEGIN(sampler_health);
+            if (events[0].state == K_POLL_STATE_SIGNALED) {
+                k_poll_signal_reset(&adc_sig);
+                events[0].state = K_POLL_STATE_NOT_READY;
+                adc_block_done();
+            } else if (!adc_armed) {
+                adc_retry();
+            }
+        } else {
+            k_sleep(wait);
+            APP_HEALTH_BEGIN(sampler_health);
+        }
+#else
+        k_sleep(wait);
+        APP_HEALTH_BEGIN(sampler_health);
+#endif
+
+#if defined(SAMPLER_HAS_ACCEL)
+        if (accel_ok && sys_timepoint_expired(accel_next)) {
+            accel_sample();
+            accel_next = sys_timepoint_calc(K_USEC(USEC_PER_SEC / g_ch[CH_ACCEL].rate_hz));
+        }
+#endif
+
+        APP_HEALTH_END(sampler_health);
+    }
+}
+
+// Create and start the sampler thread with priority 6
+K_THREAD_DEFINE(sampler_tid, CONFIG_APP_SAMPLER_STACK_SIZE,
+                sampler_thread, NULL, NULL, NULL, 6, 0, 0);
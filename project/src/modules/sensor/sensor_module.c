@@ -1,9 +1,14 @@
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/math_extras.h>
 #include <zephyr/logging/log.h>
 
 #include <app/app_bus.h>
+#include <app/app_health.h>
 #include <app/app_msg.h>
+#include <app/app_trace.h>
+#include <app/app_evlog.h>
 
 LOG_MODULE_REGISTER(sensor, LOG_LEVEL_INF); // Enables logging
 
@@ -35,18 +40,271 @@ static const struct gpio_dt_spec buttons[] = {
     GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios),
 };
 
+/*
+Buttons grouped by GPIO controller:
+Each scan reads a whole port once and finds every changed input with one XOR.
+Raw levels are XORed with `active_low` so all bits are logical levels like gpio_pin_get_dt().
+*/
+struct button_port {
+    const struct device *port;
+    gpio_port_pins_t mask;          // pins on this port used by buttons
+    gpio_port_pins_t active_low;    // pins flagged GPIO_ACTIVE_LOW in the devicetree
+    gpio_port_value_t last;         // last published logical levels (only `mask` bits valid)
+    atomic_t settled;               // pins whose debounce window expired (interrupt mode)
+    uint8_t button_of_pin[32];      // pin number -> index into buttons[]
+};
+
+static struct button_port ports[ARRAY_SIZE(buttons)];
+static int port_count;
+
+// Port slot of each button, filled by ports_init()
+static uint8_t port_of_button[ARRAY_SIZE(buttons)];
+
+// Edge diagnostics, written only by the single publishing context (see publish_button)
+APP_EVLOG_RING_DEFINE(sensor_evlog, 32);
+
+// In IRQ mode the thread only sleeps and is bound for the stack report
+APP_HEALTH_DEFINE(sensor_health, "sensor", 200);
+
+#if defined(CONFIG_APP_SENSOR_IRQ)
+static uint32_t edge_cycles[ARRAY_SIZE(buttons)];   // cycle stamp of the latest edge per pin
+#endif
+
+/**
+ * @brief Publish a button state change
+ *
+ * Called only from the single publishing context (the sensor thread when polling,
+ * the debounce work item in interrupt mode), as the controller's SPSC lane requires.
+ *
+ * @param id Button index into buttons[]
+ * @param cur Current logical pin level
+ * @param edge Cycle stamp of the input edge (interrupt mode) or of the scan (polling)
+ */
+static void publish_button(int id, int cur, uint32_t edge) {
+
+    struct app_msg msg = {0};
+
+    // Populate button event message
+    msg.type = APP_MSG_BUTTON_EVENT;
+    msg.source = APP_SRC_SENSOR;
+    msg.timestamp_ms = k_uptime_get_32(); // uptime (ms, 32-bit)
+    msg.data.button.button_id = id;
+    msg.data.button.pressed = (cur == 0) ? 1 : 0;
+    APP_TRACE_MSG_STAMP(&msg, k_cycle_get_32());
+
+    // Publish to app bus and log outcome
+    int send_rc = app_bus_publish(&msg);
+    APP_TRACE(APP_TRACE_SENSOR_PUBLISH, edge);
+    if (send_rc != 0) {
+        APP_EVLOG_RATELIMITED(&sensor_evlog, 1000, 4, APP_EV_SENSOR_BUS_FULL,
+                              app_bus_drop_count(), 0, 0);
+    } else {
+        APP_EVLOG_RATELIMITED(&sensor_evlog, 1000, 16, APP_EV_SENSOR_EDGE,
+                              id, msg.data.button.pressed, 0);
+    }
+}
+
+/**
+ * @brief Group buttons[] by GPIO port and take the initial snapshot
+ *
+ * @return 0 on success, negative error code if a port could not be read
+ */
+static int ports_init(void) {
+
+    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
+
+        int p;
+
+        // Find the slot for this button's controller, or open a new one
+        for (p = 0; p < port_count; p++) {
+            if (ports[p].port == buttons[i].port) {
+                break;
+            }
+        }
+
+        if (p == port_count) {
+            ports[p].port = buttons[i].port;
+            port_count++;
+        }
+
+        gpio_port_pins_t bit = BIT(buttons[i].pin);
+
+        ports[p].mask |= bit;
+        if (buttons[i].dt_flags & GPIO_ACTIVE_LOW) {
+            ports[p].active_low |= bit;
+        }
+        ports[p].button_of_pin[buttons[i].pin] = (uint8_t)i;
+        port_of_button[i] = (uint8_t)p;
+    }
+
+    for (int p = 0; p < port_count; p++) {
+
+        gpio_port_value_t raw;
+        int rc = gpio_port_get_raw(ports[p].port, &raw);
+
+        if (rc != 0) {
+            LOG_ERR("port %s read failed (%d)", ports[p].port->name, rc);
+            return rc;
+        }
+
+        ports[p].last = (raw ^ ports[p].active_low) & ports[p].mask;
+    }
+
+    return 0;
+}
+
 /**
- * @brief Sensor polling thread
+ * @brief Read one port and publish changes on the selected pins
+ *
+ * One driver call per port regardless of how many buttons it hosts; changed pins are
+ * found with a single XOR against the previous snapshot and walked bit by bit.
+ *
+ * @param bp Port group to scan
+ * @param pins Pins eligible for publishing (the full mask when polling, settled pins otherwise)
+ */
+static void scan_port(struct button_port *bp, gpio_port_pins_t pins) {
+
+    gpio_port_value_t raw;
+#if !defined(CONFIG_APP_SENSOR_IRQ)
+    uint32_t scan_cycles = k_cycle_get_32();
+#endif
+
+    if (gpio_port_get_raw(bp->port, &raw) != 0) {
+        return;
+    }
+
+    gpio_port_value_t cur = (raw ^ bp->active_low) & bp->mask;
+    gpio_port_pins_t changed = (cur ^ bp->last) & pins;
+
+    // Only the eligible bits advance; still-bouncing pins keep their old snapshot
+    bp->last ^= changed;
+
+    while (changed != 0) {
+
+        int pin = u32_count_trailing_zeros(changed);
+        int id = bp->button_of_pin[pin];
+
+        changed &= changed - 1;
+
+#if defined(CONFIG_APP_SENSOR_IRQ)
+        publish_button(id, (cur >> pin) & 1, edge_cycles[id]);
+        LOG_DBG("btn %d edge->publish %u us", id,
+                k_cyc_to_us_floor32(k_cycle_get_32() - edge_cycles[id]));
+#else
+        publish_button(id, (cur >> pin) & 1, scan_cycles);
+#endif
+    }
+}
+
+#if defined(CONFIG_APP_SENSOR_IRQ)
+
+static struct gpio_callback button_cb[ARRAY_SIZE(buttons)];
+static struct k_timer debounce_timer[ARRAY_SIZE(buttons)];
+static struct k_work scan_work;
+
+/**
+ * @brief Publish settled button states (work item)
+ *
+ * Scans each port that has pins whose debounce timer expired and publishes those that changed.
+ *
+ * @param work Work item (unused)
+ */
+static void scan_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    for (int p = 0; p < port_count; p++) {
+
+        gpio_port_pins_t settled = (gpio_port_pins_t)atomic_clear(&ports[p].settled);
+
+        if (settled != 0) {
+            scan_port(&ports[p], settled);
+        }
+    }
+}
+
+/**
+ * @brief Debounce timer expiry (ISR context)
+ *
+ * The pin saw no edge for the whole debounce window; hand it to the work item.
+ *
+ * @param timer Expired debounce timer of one button
+ */
+static void debounce_expired(struct k_timer *timer) {
+
+    int id = (int)(timer - debounce_timer);
+
+    atomic_or(&ports[port_of_button[id]].settled, BIT(buttons[id].pin));
+    k_work_submit(&scan_work);
+}
+
+/**
+ * @brief GPIO edge interrupt handler
+ *
+ * Restarts the button's debounce timer on every edge so bursts collapse into one sample.
+ *
+ * @param port GPIO controller that raised the interrupt
+ * @param cb Callback registered for one button
+ * @param pins Pins that triggered (unused, one pin per callback)
+ */
+static void button_isr(const struct device *port, struct gpio_callback *cb,
+                       gpio_port_pins_t pins) {
+
+    ARG_UNUSED(port);
+    ARG_UNUSED(pins);
+
+    int id = (int)(cb - button_cb);
+
+    edge_cycles[id] = k_cycle_get_32();
+    k_timer_start(&debounce_timer[id], K_MSEC(CONFIG_APP_SENSOR_DEBOUNCE_MS), K_NO_WAIT);
+}
+
+/**
+ * @brief Arm edge interrupts and debounce timers for every button
+ *
+ * @return 0 on success, negative error code from the GPIO driver otherwise
+ */
+static int buttons_irq_init(void) {
+
+    k_work_init(&scan_work, scan_work_handler);
+
+    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
+
+        k_timer_init(&debounce_timer[i], debounce_expired, NULL);
+        gpio_init_callback(&button_cb[i], button_isr, BIT(buttons[i].pin));
+
+        int rc = gpio_add_callback(buttons[i].port, &button_cb[i]);
+        if (rc == 0) {
+            rc = gpio_pin_interrupt_configure_dt(&buttons[i], GPIO_INT_EDGE_BOTH);
+        }
+
+        if (rc != 0) {
+            LOG_ERR("button %d irq setup failed (%d)", i, rc);
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+#endif /* CONFIG_APP_SENSOR_IRQ */
+
+/**
+ * @brief Sensor thread
  * 
- * Continuously polls button GPIO states and publishes button press/release events
- * to the application message bus. Detects state changes by comparing current state
- * with previous state. Logs warnings if message bus is full.
+ * Configures the button GPIOs and publishes button press/release events to the
+ * application message bus. Buttons are grouped by GPIO port so every scan costs one
+ * gpio_port_get_raw() per port. In interrupt mode (CONFIG_APP_SENSOR_IRQ) edges are
+ * debounced by per-pin timers and published from a work item, and the thread sleeps
+ * indefinitely. In polling mode (CONFIG_APP_SENSOR_POLL) the thread scans all ports each
+ * CONFIG_APP_SENSOR_POLL_INTERVAL_MS.
  * 
  * Thread priority: 5 (highest priority - ensures button events are captured)
- * Polling interval: 10ms
  */
 static void sensor_thread(void) {
 
+    (void)app_evlog_register(&sensor_evlog);
+
     for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
         // Quits if the GPIO controller for this button isn't ready
         if (!device_is_ready(buttons[i].port)) return;
@@ -55,44 +313,35 @@ static void sensor_thread(void) {
         gpio_pin_configure_dt(&buttons[i], GPIO_INPUT);
     }
 
-    uint8_t last[ARRAY_SIZE(buttons)];
-    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
-        // Set last[] with current button state at startup
-        last[i] = gpio_pin_get_dt(&buttons[i]);
+    // Group pins by port and snapshot the current levels
+    if (ports_init() != 0) {
+        return;
     }
 
+    APP_HEALTH_START(sensor_health);
+
+#if defined(CONFIG_APP_SENSOR_IRQ)
+    if (buttons_irq_init() != 0) {
+        return;
+    }
+
+    // Nothing to do until an edge arrives; all work happens in ISR/work context
+    while (1) {
+        k_sleep(K_FOREVER);
+    }
+#else
     while(1) {
 
-        for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
-            // Read current button state
-            int cur = gpio_pin_get_dt(&buttons[i]);
-
-            if (cur != last[i]) {
-                // State changed, update last-seen value
-                last[i] = cur;
-
-                struct app_msg msg = {0};
-
-                // Populate button event message
-                msg.type = APP_MSG_BUTTON_EVENT;
-                msg.source = APP_SRC_SENSOR;
-                msg.timestamp_ms = k_uptime_get_32(); // uptime (ms, 32-bit)
-                msg.data.button.button_id = i;
-                msg.data.button.pressed = (cur == 0) ? 1 : 0;
-
-                // Publish to app bus and log outcome
-                int send_rc = app_bus_publish(&msg);
-                if (send_rc != 0) {
-                    LOG_WRN("bus full (drops=%u)", app_bus_drop_count());
-                } else {
-                    LOG_INF("button event: pressed=%d", msg.data.button.pressed);
-                }
-            }
+        APP_HEALTH_BEGIN(sensor_health);
+        for (int p = 0; p < port_count; p++) {
+            scan_port(&ports[p], ports[p].mask);
         }
+        APP_HEALTH_END(sensor_health);
 
-        k_sleep(K_MSEC(10)); // Poll interval, sleep 10 ms between scans
+        k_sleep(K_MSEC(CONFIG_APP_SENSOR_POLL_INTERVAL_MS)); // Poll interval between scans
     }
+#endif
 }
 
-// Start sensor polling thread (stack 1024 bytes, priority 5)
-K_THREAD_DEFINE(sensor_tid, 1024, sensor_thread, NULL, NULL, NULL, 5, 0, 0);
\ No newline at end of file
+// Start sensor thread (priority 5)
+K_THREAD_DEFINE(sensor_tid, CONFIG_APP_SENSOR_STACK_SIZE, sensor_thread, NULL, NULL, NULL, 5, 0, 0);
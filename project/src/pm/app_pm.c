@@ -0,0 +1,405 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#if defined(CONFIG_PM)
+#include <zephyr/pm/pm.h>
+#include <zephyr/pm/policy.h>
+#endif
+#if defined(CONFIG_PM_DEVICE_RUNTIME)
+#include <zephyr/pm/device_runtime.h>
+#endif
+#if defined(CONFIG_APP_PM_WAKE_STATS)
+#include <tracing_user.h>
+#endif
+
+#include <app/app_pm.h>
+#include <app/app_store.h>
+
+LOG_MODULE_REGISTER(app_pm, LOG_LEVEL_INF); // Enable logging
+
+/*
+Power manager:
+Inputs (mode, busy sources, activity stamp) are atomics that any context may update; each
+update only kicks one delayable work item. The work item is the single owner of the PM
+policy locks and device runtime references, and re-arms itself only while the activity
+timeout is pending, so an idle system with no inputs never wakes for power management.
+*/
+
+static void pm_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(g_pm_work, pm_work_handler);
+
+static atomic_t g_mode = ATOMIC_INIT(APP_MODE_IDLE);
+static atomic_t g_busy;
+static atomic_t g_last_activity;    // uptime (ms, 32-bit) of the latest user-facing message
+static atomic_t g_recent;           // bit 0: activity timeout pending
+
+// Owned by pm_work_handler
+static uint8_t g_budget = APP_PM_BUDGET_DEEP;
+static bool g_devices_held;
+
+// Budget of each mode while nothing else holds the system awake
+static const uint8_t mode_budget[APP_MODE_MAX] = {
+    [APP_MODE_IDLE] = APP_PM_BUDGET_DEEP,
+    [APP_MODE_ACTIVE] = APP_PM_BUDGET_LIGHT,
+    [APP_MODE_DIAG] = APP_PM_BUDGET_RUN,    // console and timing must stay undisturbed
+};
+
+// Shallowest budget allowed while a busy source is set
+static const uint8_t busy_budget[APP_PM_BUSY_COUNT] = {
+    [APP_PM_BUSY_BLE_LINK] = APP_PM_BUDGET_LIGHT,
+    [APP_PM_BUSY_BLE_STREAM] = APP_PM_BUDGET_RUN,
+    [APP_PM_BUSY_LED_FX] = APP_PM_BUDGET_LIGHT,
+};
+
+// Counters, updated from the idle thread and ISRs
+static struct k_spinlock g_stats_lock;
+static struct app_pm_stats g_stats;
+static uint32_t g_prev_entries;
+static int64_t g_prev_ms;
+
+#if defined(CONFIG_PM)
+// PM states and the budget from which each one is locked out
+static const struct {
+    enum pm_state state;
+    uint8_t locked_from;
+} lockable[] = {
+    { PM_STATE_RUNTIME_IDLE, APP_PM_BUDGET_RUN },
+    { PM_STATE_SUSPEND_TO_IDLE, APP_PM_BUDGET_RUN },
+    { PM_STATE_STANDBY, APP_PM_BUDGET_LIGHT },
+    { PM_STATE_SUSPEND_TO_RAM, APP_PM_BUDGET_LIGHT },
+    { PM_STATE_SUSPEND_TO_DISK, APP_PM_BUDGET_LIGHT },
+};
+
+BUILD_ASSERT(PM_STATE_SOFT_OFF < APP_PM_STATES, "APP_PM_STATES too small for enum pm_state");
+
+static uint32_t g_state_since;
+static uint64_t g_state_cycles[APP_PM_STATES];
+#endif
+
+#if defined(CONFIG_PM_DEVICE_RUNTIME)
+/*
+Devices released while the budget is DEEP. GPIO ports stay with their drivers: they hold
+LED levels and the button interrupts that wake the system. The ADC belongs to the sampler,
+whose hardware sequence runs continuously.
+*/
+static const struct device *const gated[] = {
+#if DT_HAS_CHOSEN(zephyr_console)
+    DEVICE_DT_GET(DT_CHOSEN(zephyr_console)),
+#endif
+};
+#endif
+
+#if defined(CONFIG_APP_PM_WAKE_STATS)
+// Single-core: both hooks run with interrupts locked or in an ISR
+static bool g_in_idle;
+static uint32_t g_idle_since;
+static uint64_t g_idle_cycles;
+#endif
+
+/**
+ * @brief Take or drop the policy locks for a budget change
+ *
+ * @param from Previous budget
+ * @param to New budget
+ */
+static void locks_update(uint8_t from, uint8_t to) {
+
+#if defined(CONFIG_PM)
+    for (size_t i = 0; i < ARRAY_SIZE(lockable); i++) {
+
+        bool was = (from >= lockable[i].locked_from);
+        bool now = (to >= lockable[i].locked_from);
+
+        if (now && !was) {
+            pm_policy_state_lock_get(lockable[i].state, PM_ALL_SUBSTATES);
+        } else if (was && !now) {
+            pm_policy_state_lock_put(lockable[i].state, PM_ALL_SUBSTATES);
+        }
+    }
+#else
+    ARG_UNUSED(from);
+    ARG_UNUSED(to);
+#endif
+}
+
+/**
+ * @brief Hold or release the runtime PM references of the gated devices
+ *
+ * @param hold true to keep the devices resumed
+ */
+static void devices_update(bool hold) {
+
+    if (hold == g_devices_held) {
+        return;
+    }
+    g_devices_held = hold;
+
+#if defined(CONFIG_PM_DEVICE_RUNTIME)
+    for (size_t i = 0; i < ARRAY_SIZE(gated); i++) {
+
+        if (!pm_device_runtime_is_enabled(gated[i])) {
+            continue;
+        }
+
+        int rc = hold ? pm_device_runtime_get(gated[i]) : pm_device_runtime_put(gated[i]);
+
+        if (rc != 0) {
+            LOG_WRN("%s runtime %s failed (%d)", gated[i]->name, hold ? "get" : "put", rc);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Work handler: recompute the budget and apply it
+ *
+ * @param work Work item (unused)
+ */
+static void pm_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    // Clear first: activity noted after this point kicks the work item again
+    atomic_clear_bit(&g_recent, 0);
+
+    uint32_t since = k_uptime_get_32() - (uint32_t)atomic_get(&g_last_activity);
+    bool recent = (since < CONFIG_APP_PM_IDLE_TIMEOUT_MS) && (atomic_get(&g_last_activity) != 0);
+
+    if (recent) {
+        atomic_set_bit(&g_recent, 0);
+        k_work_reschedule(&g_pm_work, K_MSEC(CONFIG_APP_PM_IDLE_TIMEOUT_MS - since));
+    }
+
+    uint8_t budget = mode_budget[atomic_get(&g_mode)];
+    uint32_t busy = (uint32_t)atomic_get(&g_busy);
+
+    if (recent) {
+        budget = MAX(budget, APP_PM_BUDGET_LIGHT);
+    }
+
+    for (uint8_t i = 0; i < APP_PM_BUSY_COUNT; i++) {
+        if (busy & BIT(i)) {
+            budget = MAX(budget, busy_budget[i]);
+        }
+    }
+
+    devices_update(budget != APP_PM_BUDGET_DEEP);
+
+    if (budget == g_budget) {
+        return;
+    }
+
+    // Deep states may lose power: persist pending state before they are allowed
+    if (budget == APP_PM_BUDGET_DEEP) {
+        APP_STORE_FLUSH();
+    }
+
+    locks_update(g_budget, budget);
+
+    LOG_DBG("budget %u -> %u (busy 0x%x)", g_budget, budget, busy);
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+    g_budget = budget;
+    g_stats.budget_changes++;
+    k_spin_unlock(&g_stats_lock, key);
+}
+
+/**
+ * @brief Set or clear a busy source
+ *
+ * Safe from any context, including ISRs and BT callbacks.
+ *
+ * @param src Source
+ * @param busy true while the source needs the system awake
+ */
+void app_pm_busy_set(enum app_pm_busy src, bool busy) {
+
+    if (src >= APP_PM_BUSY_COUNT) {
+        return;
+    }
+
+    bool was = busy ? atomic_test_and_set_bit(&g_busy, src)
+                    : atomic_test_and_clear_bit(&g_busy, src);
+
+    if (was != busy) {
+        k_work_reschedule(&g_pm_work, K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Switch to the power budget of an application mode
+ *
+ * @param mode New mode
+ */
+void app_pm_mode_set(enum app_mode mode) {
+
+    if (mode >= APP_MODE_MAX) {
+        return;
+    }
+
+    if (atomic_set(&g_mode, mode) != mode) {
+        k_work_reschedule(&g_pm_work, K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Note user-facing activity
+ *
+ * Keeps the budget at LIGHT or shallower for CONFIG_APP_PM_IDLE_TIMEOUT_MS. Only the
+ * first call after a quiet period touches the work item; later ones just move the stamp.
+ */
+void app_pm_activity(void) {
+
+    // 0 means "never": skip it when the 32-bit uptime wraps onto it
+    uint32_t now = k_uptime_get_32();
+
+    atomic_set(&g_last_activity, (now != 0) ? now : 1);
+
+    if (!atomic_test_and_set_bit(&g_recent, 0)) {
+        k_work_reschedule(&g_pm_work, K_NO_WAIT);
+    }
+}
+
+/**
+ * @brief Get the power manager counters
+ *
+ * @param out Filled with a snapshot; wakeups_per_s covers the time since the previous call
+ */
+void app_pm_stats_get(struct app_pm_stats *out) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+
+    int64_t now = k_uptime_get();
+
+    *out = g_stats;
+    out->budget = g_budget;
+    out->mode = (uint8_t)atomic_get(&g_mode);
+    out->busy = (uint32_t)atomic_get(&g_busy);
+
+#if defined(CONFIG_APP_PM_WAKE_STATS)
+    out->idle_ms = (uint32_t)k_cyc_to_ms_floor64(g_idle_cycles);
+#endif
+#if defined(CONFIG_PM)
+    for (size_t s = 0; s < APP_PM_STATES; s++) {
+        out->state_ms[s] = (uint32_t)k_cyc_to_ms_floor64(g_state_cycles[s]);
+    }
+#endif
+
+    if (now > g_prev_ms) {
+        out->wakeups_per_s = (uint32_t)((uint64_t)(g_stats.idle_entries - g_prev_entries) *
+                                        MSEC_PER_SEC / (uint64_t)(now - g_prev_ms));
+    }
+    g_prev_entries = g_stats.idle_entries;
+    g_prev_ms = now;
+
+    k_spin_unlock(&g_stats_lock, key);
+}
+
+#if defined(CONFIG_PM)
+/**
+ * @brief PM notifier: a low-power state is being entered (idle thread, interrupts locked)
+ *
+ * @param state Entered state
+ */
+static void pm_state_entry(enum pm_state state) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+
+    if (state < APP_PM_STATES) {
+        g_stats.state_entries[state]++;
+    }
+    g_state_since = k_cycle_get_32();
+
+    k_spin_unlock(&g_stats_lock, key);
+}
+
+/**
+ * @brief PM notifier: a low-power state was left
+ *
+ * @param state Left state
+ */
+static void pm_state_exit(enum pm_state state) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+
+    if (state < APP_PM_STATES) {
+        g_state_cycles[state] += k_cycle_get_32() - g_state_since;
+    }
+
+    k_spin_unlock(&g_stats_lock, key);
+}
+
+static struct pm_notifier g_notifier = {
+    .state_entry = pm_state_entry,
+    .state_exit = pm_state_exit,
+};
+#endif /* CONFIG_PM */
+
+#if defined(CONFIG_APP_PM_WAKE_STATS)
+/**
+ * @brief Tracing hook: the CPU is about to idle
+ *
+ * Every entry after the first follows a wake-up, so entries per second is the wake rate.
+ */
+void sys_trace_idle_user(void) {
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+
+    g_stats.idle_entries++;
+    g_in_idle = true;
+    g_idle_since = k_cycle_get_32();
+
+    k_spin_unlock(&g_stats_lock, key);
+}
+
+/**
+ * @brief Tracing hook: interrupt entry, ends an idle period
+ *
+ * @param nested_interrupts Nesting level (unused)
+ */
+void sys_trace_isr_enter_user(int nested_interrupts) {
+
+    ARG_UNUSED(nested_interrupts);
+
+    k_spinlock_key_t key = k_spin_lock(&g_stats_lock);
+
+    if (g_in_idle) {
+        g_in_idle = false;
+        g_idle_cycles += k_cycle_get_32() - g_idle_since;
+    }
+
+    k_spin_unlock(&g_stats_lock, key);
+}
+#endif /* CONFIG_APP_PM_WAKE_STATS */
+
+/**
+ * @brief Register the PM notifier and apply the boot mode's budget
+ *
+ * @return 0
+ */
+static int app_pm_init(void) {
+
+#if defined(CONFIG_PM)
+    pm_notifier_register(&g_notifier);
+#endif
+
+    // Devices start resumed; the first evaluation releases them if the budget allows
+    g_devices_held = true;
+#if defined(CONFIG_PM_DEVICE_RUNTIME)
+    for (size_t i = 0; i < ARRAY_SIZE(gated); i++) {
+        if (pm_device_runtime_is_enabled(gated[i])) {
+            (void)pm_device_runtime_get(gated[i]);
+        }
+    }
+#endif
+
+    g_prev_ms = k_uptime_get();
+    k_work_reschedule(&g_pm_work, K_NO_WAIT);
+
+    return 0;
+}
+
+SYS_INIT(app_pm_init, APPLICATION, 1);
@@ -0,0 +1,210 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+
+#include <app/app_store.h>
+
+LOG_MODULE_REGISTER(app_store, LOG_LEVEL_INF); // Enable logging
+
+#define STORE_SUBTREE "app"
+
+// Longest "app/<key>" name passed to settings_save_one()
+#define STORE_NAME_MAX 32
+
+static void flush_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(g_flush_work, flush_work_handler);
+
+// Marked items, by index in the app_store_item section
+static ATOMIC_DEFINE(g_dirty, CONFIG_APP_STORE_MAX_ITEMS);
+static K_MUTEX_DEFINE(g_flush_lock);
+static struct app_store_stats g_stats;
+
+STRUCT_SECTION_START_EXTERN(app_store_item);
+
+/**
+ * @brief Mark an item as changed
+ *
+ * The first mark after a flush starts the flush timer; further marks before it expires
+ * only set the item's bit. Safe from threads and work items.
+ *
+ * @param item Item registered with APP_STORE_ITEM_DEFINE()
+ */
+void app_store_mark(const struct app_store_item *item) {
+
+    size_t idx = item - STRUCT_SECTION_START(app_store_item);
+
+    // app_store_init() reports the overflow; such items are never written
+    if (idx >= CONFIG_APP_STORE_MAX_ITEMS) {
+        return;
+    }
+
+    atomic_set_bit(g_dirty, idx);
+    g_stats.marks++;
+
+    // Does not move a deadline that is already pending
+    (void)k_work_schedule(&g_flush_work, K_SECONDS(CONFIG_APP_STORE_FLUSH_INTERVAL_S));
+}
+
+/**
+ * @brief Write every marked item now
+ *
+ * Call before a reboot or power-off so no change is lost. Must not be called from an ISR.
+ *
+ * @return 0 on success, or the last settings_save_one() error
+ */
+int app_store_flush(void) {
+
+    int rc = 0;
+    bool wrote = false;
+
+    (void)k_work_cancel_delayable(&g_flush_work);
+    k_mutex_lock(&g_flush_lock, K_FOREVER);
+
+    STRUCT_SECTION_FOREACH(app_store_item, item) {
+
+        size_t idx = item - STRUCT_SECTION_START(app_store_item);
+
+        if (!atomic_test_and_clear_bit(g_dirty, idx)) {
+            continue;
+        }
+
+        char name[STORE_NAME_MAX];
+
+        snprintk(name, sizeof(name), STORE_SUBTREE "/%s", item->key);
+
+        int save_rc = settings_save_one(name, item->data, item->len);
+
+        g_stats.writes++;
+        wrote = true;
+
+        if (save_rc != 0) {
+            // Keep it marked so the next flush retries
+            atomic_set_bit(g_dirty, idx);
+            g_stats.errors++;
+            rc = save_rc;
+            LOG_WRN("save %s failed (%d)", name, save_rc);
+        }
+    }
+
+    if (wrote) {
+        g_stats.flushes++;
+    }
+
+    k_mutex_unlock(&g_flush_lock);
+
+    return rc;
+}
+
+/**
+ * @brief Write every marked item soon, from the system workqueue
+ *
+ * For threads that must not block on flash. Safe from threads and work items.
+ */
+void app_store_flush_async(void) {
+    (void)k_work_reschedule(&g_flush_work, K_NO_WAIT);
+}
+
+/**
+ * @brief Flush timer expiry (work item)
+ *
+ * @param work Work item (unused)
+ */
+static void flush_work_handler(struct k_work *work) {
+
+    ARG_UNUSED(work);
+
+    if (app_store_flush() != 0) {
+        // Retry later instead of spinning on a failing backend
+        (void)k_work_schedule(&g_flush_work, K_SECONDS(CONFIG_APP_STORE_FLUSH_INTERVAL_S));
+    }
+}
+
+/**
+ * @brief Get the store counters
+ *
+ * @param out Destination
+ */
+void app_store_stats_get(struct app_store_stats *out) {
+    *out = g_stats;
+}
+
+/**
+ * @brief Settings handler: restore one "app/<key>" value into its item
+ *
+ * @param name Key below the subtree
+ * @param len Stored value length
+ * @param read_cb Reads the stored value
+ * @param cb_arg Argument for read_cb
+ * @return 0 on success or for unknown keys, negative error code otherwise
+ */
+static int store_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg) {
+
+    STRUCT_SECTION_FOREACH(app_store_item, item) {
+
+        const char *next;
+
+        if (!settings_name_steq(name, item->key, &next) || next != NULL) {
+            continue;
+        }
+
+        // A layout change between firmware versions leaves the default in place
+        if (len != item->len) {
+            LOG_WRN("%s: stored %u bytes, expected %u", item->key, (unsigned)len,
+                    (unsigned)item->len);
+            g_stats.errors++;
+            return 0;
+        }
+
+        ssize_t rd = read_cb(cb_arg, item->data, len);
+
+        if (rd < 0) {
+            g_stats.errors++;
+            return (int)rd;
+        }
+
+        g_stats.restored++;
+        return 0;
+    }
+
+    // Keys of removed items are ignored
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(app_store, STORE_SUBTREE, NULL, store_set, NULL, NULL);
+
+/**
+ * @brief Restore every item before the application threads start
+ *
+ * @return 0 (a missing or empty store leaves the defaults in place)
+ */
+static int app_store_init(void) {
+
+    size_t count;
+
+    STRUCT_SECTION_COUNT(app_store_item, &count);
+    if (count > CONFIG_APP_STORE_MAX_ITEMS) {
+        LOG_ERR("%u items registered, CONFIG_APP_STORE_MAX_ITEMS is %d", (unsigned)count,
+                CONFIG_APP_STORE_MAX_ITEMS);
+        return -ENOMEM;
+    }
+
+    int rc = settings_subsys_init();
+
+    if (rc == 0) {
+        rc = settings_load_subtree(STORE_SUBTREE);
+    }
+
+    if (rc != 0) {
+        LOG_ERR("settings load failed (%d)", rc);
+    } else {
+        LOG_INF("restored %u of %u items", g_stats.restored, (unsigned)count);
+    }
+
+    return 0;
+}
+
+// Application threads start after this level has run
+SYS_INIT(app_store_init, APPLICATION, 1);
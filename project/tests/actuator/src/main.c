@@ -0,0 +1,564 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/sys/math_extras.h>
+#include <app/app_bus.h>
+#include <app/app_msg.h>
+#include <app/actuator.h>
+#include <app/led_fx.h>
+
+/*
+LED effects on native_sim:
+The LED pins are emulated GPIOs configured as outputs and inputs, so gpio_emul loops
+every write back to the input side and runs the test's edge callback in the writer's
+context. Each callback records when the LEDs changed and their logical state; the test
+compares those records with the effect timings and with the commands sent meanwhile.
+A write that changes several LEDs of one controller raises one callback, so a multi-LED
+update must show up as exactly one record per controller.
+*/
+
+#define LEDS_NODE DT_PARENT(DT_ALIAS(led0))
+#define LED_SPEC(node) GPIO_DT_SPEC_GET(node, gpios),
+
+static const struct gpio_dt_spec leds[] = {
+    DT_FOREACH_CHILD_STATUS_OKAY(LEDS_NODE, LED_SPEC)
+};
+
+#define LED_COUNT ARRAY_SIZE(leds)
+#define LEDS_ALL  BIT_MASK(LED_COUNT)
+
+// Allowed distance between an effect edge and its nominal time (timer tick + work item)
+#define EDGE_SLACK_MS 2
+
+// Longest delay from publishing a command to its LED edge, effects running or not
+#define CMD_LATENCY_MS 5
+
+// Edges kept by the longest collection in a test
+#define MAX_EDGES 64
+
+// One write that changed at least one LED
+struct led_edge {
+    uint32_t ms;        // uptime of the write
+    uint32_t changed;   // LEDs the write changed
+    uint32_t state;     // logical state of every LED after the write
+};
+
+K_MSGQ_DEFINE(edge_q, sizeof(struct led_edge), MAX_EDGES, 4);
+
+static struct gpio_callback edge_cbs[LED_COUNT];
+static atomic_t edges_lost;
+
+/**
+ * @brief gpio_emul loopback callback: record one LED write
+ *
+ * @param port Controller that was written
+ * @param cb Callback (unused)
+ * @param pins Pins whose level changed
+ */
+static void led_edge_handler(const struct device *port, struct gpio_callback *cb,
+                             gpio_port_pins_t pins) {
+
+    ARG_UNUSED(cb);
+
+    struct led_edge e = { .ms = k_uptime_get_32() };
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (leds[i].port == port && (pins & BIT(leds[i].pin))) {
+            e.changed |= BIT(i);
+        }
+        if (gpio_pin_get_dt(&leds[i]) > 0) {
+            e.state |= BIT(i);
+        }
+    }
+
+    if (k_msgq_put(&edge_q, &e, K_NO_WAIT) != 0) {
+        atomic_inc(&edges_lost);
+    }
+}
+
+/**
+ * @brief Publish a command as the controller does
+ *
+ * @param id Command id
+ * @param value Command value
+ */
+static void command_send(uint8_t id, uint32_t value) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_COMMAND;
+    msg.source = APP_SRC_CONTROLLER;
+    msg.timestamp_ms = k_uptime_get_32();
+    msg.data.command.command_id = id;
+    msg.data.command.value = value;
+
+    zassert_ok(app_bus_publish(&msg), "command %u 0x%08x not delivered", id, value);
+}
+
+/**
+ * @brief Build an APP_CMD_LED_FX value
+ *
+ * @param led LED index
+ * @param fx Effect
+ * @param count Repeats, 0 = until stopped
+ * @param ms Effect time, a multiple of 10 ms
+ * @return Command value
+ */
+static uint32_t fx_value(uint8_t led, enum app_led_fx fx, uint8_t count, uint16_t ms) {
+    return led | ((uint32_t)fx << 8) | ((uint32_t)count << 16) | ((uint32_t)(ms / 10) << 24);
+}
+
+/**
+ * @brief Wait for the next write that changes one of the given LEDs
+ *
+ * Writes to other LEDs (effects running meanwhile) are skipped.
+ *
+ * @param mask LEDs of interest
+ * @param timeout_ms How long to wait
+ * @param out Received edge
+ * @return 0 on success, -EAGAIN on timeout
+ */
+static int edge_next(uint32_t mask, int timeout_ms, struct led_edge *out) {
+
+    int64_t end = k_uptime_get() + timeout_ms;
+
+    while (k_msgq_get(&edge_q, out, K_TIMEOUT_ABS_MS(end)) == 0) {
+        if (out->changed & mask) {
+            return 0;
+        }
+    }
+
+    return -EAGAIN;
+}
+
+/**
+ * @brief Wait for the next write to the given LEDs and check which LEDs it changed
+ *
+ * @param changed Expected set of changed LEDs
+ * @param timeout_ms How long to wait
+ * @return The edge
+ */
+static struct led_edge edge_expect(uint32_t changed, int timeout_ms) {
+
+    struct led_edge e;
+
+    zassert_ok(edge_next(changed, timeout_ms, &e), "no edge on LEDs 0x%x", changed);
+    zassert_equal(e.changed, changed, "edge on LEDs 0x%x, expected 0x%x", e.changed, changed);
+
+    return e;
+}
+
+/**
+ * @brief Collect every edge for a while
+ *
+ * @param out Edges, in write order
+ * @param max Capacity of out
+ * @param window_ms How long to collect
+ * @return Number of edges
+ */
+static size_t edges_collect(struct led_edge *out, size_t max, uint32_t window_ms) {
+
+    int64_t end = k_uptime_get() + window_ms;
+    size_t n = 0;
+
+    while (n < max && k_msgq_get(&edge_q, &out[n], K_TIMEOUT_ABS_MS(end)) == 0) {
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Check that one LED's edges follow a fixed period
+ *
+ * Every edge is measured from the LED's first edge: effect deadlines advance from the
+ * previous deadline, so the error must not grow with the edge number.
+ *
+ * @param e Collected edges
+ * @param n Number of edges
+ * @param led LED index
+ * @param period_ms Expected time between two edges of the LED
+ * @return Number of edges of the LED
+ */
+static uint32_t assert_periodic(const struct led_edge *e, size_t n, int led,
+                                uint32_t period_ms) {
+
+    uint32_t first = 0;
+    uint32_t k = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!(e[i].changed & BIT(led))) {
+            continue;
+        }
+        if (k == 0) {
+            first = e[i].ms;
+        }
+        zassert_within(e[i].ms - first, k * period_ms, EDGE_SLACK_MS,
+                       "LED%d edge %u at +%u ms, expected +%u", led, k, e[i].ms - first,
+                       k * period_ms);
+        k++;
+    }
+
+    return k;
+}
+
+/**
+ * @brief Get the LEDs that share a GPIO controller with an LED
+ *
+ * @param led LED index
+ * @return Bitmap of the LEDs on the same controller
+ */
+static uint32_t port_leds(int led) {
+
+    uint32_t mask = 0;
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (leds[i].port == leds[led].port) {
+            mask |= BIT(i);
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Read the logical state of every LED from the pins
+ *
+ * @return Bitmap, bit n set if LED n is lit
+ */
+static uint32_t leds_read(void) {
+
+    uint32_t state = 0;
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (gpio_pin_get_dt(&leds[i]) > 0) {
+            state |= BIT(i);
+        }
+    }
+
+    return state;
+}
+
+/**
+ * @brief Check the writes of one LED update against the state change it makes
+ *
+ * Every controller with a changed LED must be written once, with all of its changes:
+ * an LED changing in two writes, or a write changing only part of a controller's
+ * LEDs, would be visible as an intermediate state.
+ *
+ * @param before Logical LED state before the update
+ * @param after Expected state after it
+ * @param window_ms How long to wait for the writes (0 for synchronous updates)
+ * @return Number of writes that changed an LED
+ */
+static uint32_t assert_one_write_per_port(uint32_t before, uint32_t after, uint32_t window_ms) {
+
+    static struct led_edge e[MAX_EDGES];
+    uint32_t diff = before ^ after;
+    uint32_t seen = 0;
+    size_t n = edges_collect(e, ARRAY_SIZE(e), window_ms);
+
+    for (size_t i = 0; i < n; i++) {
+        int led = u32_count_trailing_zeros(e[i].changed);
+
+        zassert_equal(e[i].changed & seen, 0, "LEDs 0x%x changed twice",
+                      e[i].changed & seen);
+        zassert_equal(e[i].changed, diff & port_leds(led),
+                      "write changed LEDs 0x%x, expected 0x%x", e[i].changed,
+                      diff & port_leds(led));
+        seen |= e[i].changed;
+    }
+
+    zassert_equal(seen, diff, "LEDs 0x%x never changed", diff & ~seen);
+    zassert_equal(leds_read(), after);
+
+    return n;
+}
+
+static void *actuator_setup(void) {
+
+    // Let the actuator thread configure the LEDs and subscribe
+    k_msleep(10);
+
+    zassert_equal(actuator_led_count(), LED_COUNT);
+
+    // Input side on: gpio_emul loops every output write back and raises the callback
+    for (int i = 0; i < LED_COUNT; i++) {
+        zassert_true(device_is_ready(leds[i].port));
+        zassert_ok(gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE | GPIO_INPUT));
+        zassert_ok(gpio_pin_interrupt_configure_dt(&leds[i], GPIO_INT_EDGE_BOTH));
+    }
+
+    // One callback per controller, covering its LED pins
+    for (int i = 0; i < LED_COUNT; i++) {
+        gpio_port_pins_t pins = 0;
+        bool first = true;
+
+        for (int j = 0; j < LED_COUNT; j++) {
+            if (leds[j].port == leds[i].port) {
+                first = first && (j >= i);
+                pins |= BIT(leds[j].pin);
+            }
+        }
+
+        if (first) {
+            gpio_init_callback(&edge_cbs[i], led_edge_handler, pins);
+            zassert_ok(gpio_add_callback(leds[i].port, &edge_cbs[i]));
+        }
+    }
+
+    return NULL;
+}
+
+// Every test starts with no effect running, every LED off and no edge pending
+static void actuator_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    for (int i = 0; i < LED_COUNT; i++) {
+        led_fx_cancel(i);
+    }
+    zassert_ok(actuator_leds_set(LEDS_ALL, 0));
+
+    k_msgq_purge(&edge_q);
+    atomic_set(&edges_lost, 0);
+}
+
+static void actuator_after(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    zassert_equal(atomic_get(&edges_lost), 0, "edge queue overflowed");
+}
+
+ZTEST(actuator_fx, test_pulse_timing) {
+
+    command_send(APP_CMD_LED_FX, fx_value(1, APP_LED_FX_PULSE, 0, 100));
+
+    struct led_edge on = edge_expect(BIT(1), CMD_LATENCY_MS);
+
+    zassert_equal(on.state, BIT(1));
+    zassert_true(led_fx_active(1));
+
+    struct led_edge off = edge_expect(BIT(1), 100 + CMD_LATENCY_MS);
+
+    zassert_equal(off.state, 0);
+    zassert_within(off.ms - on.ms, 100, EDGE_SLACK_MS, "pulse lasted %u ms", off.ms - on.ms);
+    zassert_false(led_fx_active(1));
+}
+
+ZTEST(actuator_fx, test_blink_edges_do_not_drift) {
+
+    static struct led_edge e[MAX_EDGES];
+
+    // Ten blinks of 30 ms on / 30 ms off: twenty edges over 600 ms
+    command_send(APP_CMD_LED_FX, fx_value(2, APP_LED_FX_BLINK, 10, 30));
+
+    size_t n = edges_collect(e, ARRAY_SIZE(e), 600 + 50);
+
+    zassert_equal(assert_periodic(e, n, 2, 30), 20);
+    zassert_equal(e[n - 1].state, 0, "LED2 left on after the last blink");
+    zassert_false(led_fx_active(2));
+}
+
+ZTEST(actuator_fx, test_breathe_on_gpio_is_half_duty_blink) {
+
+    static struct led_edge e[MAX_EDGES];
+
+    // 200 ms period: the ramp crosses half level 60 ms in and falls below it 100 ms later
+    command_send(APP_CMD_LED_FX, fx_value(0, APP_LED_FX_BREATHE, 2, 200));
+
+    size_t n = edges_collect(e, ARRAY_SIZE(e), 400 + 50);
+
+    zassert_equal(assert_periodic(e, n, 0, 100), 4);
+    zassert_equal(e[0].state, BIT(0));
+    zassert_equal(e[n - 1].state, 0);
+    zassert_false(led_fx_active(0));
+}
+
+ZTEST(actuator_fx, test_effects_overlap) {
+
+    static struct led_edge e[MAX_EDGES];
+
+    // Two blinks with unrelated periods run side by side in one work item
+    command_send(APP_CMD_LED_FX, fx_value(0, APP_LED_FX_BLINK, 4, 100));
+    command_send(APP_CMD_LED_FX, fx_value(3, APP_LED_FX_BLINK, 10, 40));
+
+    // Edges stay queued while the test checks that both effects started
+    k_msleep(CMD_LATENCY_MS);
+    zassert_equal(led_fx_active_mask(), BIT(0) | BIT(3));
+
+    size_t n = edges_collect(e, ARRAY_SIZE(e), 800 + 50);
+
+    zassert_equal(assert_periodic(e, n, 0, 100), 8);
+    zassert_equal(assert_periodic(e, n, 3, 40), 20);
+
+    // Every write changed exactly one LED
+    for (size_t i = 0; i < n; i++) {
+        zassert_true(e[i].changed == BIT(0) || e[i].changed == BIT(3),
+                     "write %zu changed LEDs 0x%x", i, e[i].changed);
+    }
+
+    zassert_equal(led_fx_active_mask(), 0);
+}
+
+ZTEST(actuator_fx, test_commands_not_delayed_by_effects) {
+
+    // RESET_STATS flashes LED3 for 80 ms; the LED_SET queued behind it must not wait
+    command_send(APP_CMD_RESET_STATS, 0);
+    command_send(APP_CMD_LED_SET, (2 << 8) | 1);
+
+    uint32_t sent = k_uptime_get_32();
+    struct led_edge flash = edge_expect(BIT(3), CMD_LATENCY_MS);
+    struct led_edge set = edge_expect(BIT(2), CMD_LATENCY_MS);
+
+    zassert_true(set.ms - sent <= CMD_LATENCY_MS, "LED_SET applied after %u ms", set.ms - sent);
+    zassert_equal(set.state, BIT(2) | BIT(3), "LED3 flash no longer running");
+
+    struct led_edge end = edge_expect(BIT(3), 80 + CMD_LATENCY_MS);
+
+    zassert_within(end.ms - flash.ms, 80, EDGE_SLACK_MS);
+
+    // A heartbeat runs until stopped; toggles in between are applied right away
+    command_send(APP_CMD_LED_FX, fx_value(0, APP_LED_FX_HEARTBEAT, 0, 0));
+
+    for (int n = 0; n < 10; n++) {
+        struct led_edge e;
+
+        k_msleep(37);
+        sent = k_uptime_get_32();
+        command_send(APP_CMD_LED_TOGGLE, 1);
+
+        zassert_ok(edge_next(BIT(1), CMD_LATENCY_MS, &e), "toggle %d not applied", n);
+        zassert_true(e.ms - sent <= CMD_LATENCY_MS, "toggle %d applied after %u ms", n,
+                     e.ms - sent);
+        zassert_equal(!!(e.state & BIT(1)), !(n & 1));
+    }
+
+    zassert_true(led_fx_active(0), "heartbeat ended on its own");
+
+    command_send(APP_CMD_LED_FX, fx_value(0, APP_LED_FX_STOP, 0, 0));
+    k_msleep(CMD_LATENCY_MS);
+    zassert_false(led_fx_active(0));
+    zassert_equal(gpio_pin_get_dt(&leds[0]), 0);
+}
+
+ZTEST(actuator_fx, test_effect_restores_steady_state) {
+
+    command_send(APP_CMD_LED_FX, fx_value(2, APP_LED_FX_BLINK, 0, 50));
+    (void)edge_expect(BIT(2), CMD_LATENCY_MS);
+
+    // A steady-state change during the effect is recorded, not shown
+    command_send(APP_CMD_LED_SET, (2 << 8) | 1);
+    k_msleep(CMD_LATENCY_MS);
+    zassert_equal(actuator_leds_get(), BIT(2));
+    zassert_true(led_fx_active(2));
+
+    // Stopping the effect shows the new steady state
+    command_send(APP_CMD_LED_FX, fx_value(2, APP_LED_FX_STOP, 0, 0));
+    k_msleep(CMD_LATENCY_MS);
+    zassert_false(led_fx_active(2));
+    zassert_equal(gpio_pin_get_dt(&leds[2]), 1);
+}
+
+ZTEST(actuator_fx, test_invalid_effects_rejected) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_COMMAND;
+    msg.source = APP_SRC_CONTROLLER;
+    msg.data.command.command_id = APP_CMD_LED_FX;
+
+    // Unknown LED or effect: refused by the validator, nothing reaches the actuator
+    msg.data.command.value = fx_value(LED_COUNT, APP_LED_FX_PULSE, 0, 100);
+    zassert_equal(app_bus_publish(&msg), -EINVAL);
+    msg.data.command.value = fx_value(0, APP_LED_FX_HEARTBEAT + 1, 0, 100);
+    zassert_equal(app_bus_publish(&msg), -EINVAL);
+
+    // A breathe period under two ramp steps is rejected by the engine
+    command_send(APP_CMD_LED_FX, fx_value(0, APP_LED_FX_BREATHE, 1, 30));
+
+    struct led_edge e;
+
+    zassert_not_ok(edge_next(LEDS_ALL, 2 * CMD_LATENCY_MS, &e));
+    zassert_equal(led_fx_active_mask(), 0);
+}
+
+ZTEST_SUITE(actuator_fx, NULL, actuator_setup, actuator_before, actuator_after, NULL);
+
+ZTEST(actuator_leds, test_polarity) {
+
+    // The LED array follows the gpio-leds node, past the former four LEDs
+    zassert_equal(actuator_led_count(), 5);
+
+    zassert_ok(actuator_leds_set(LEDS_ALL, LEDS_ALL));
+
+    // Lit LEDs drive active-high pins high and active-low pins low
+    for (int i = 0; i < LED_COUNT; i++) {
+        int raw = gpio_emul_output_get(leds[i].port, leds[i].pin);
+
+        zassert_equal(raw, (leds[i].dt_flags & GPIO_ACTIVE_LOW) ? 0 : 1, "LED%d level", i);
+    }
+
+    zassert_equal(assert_one_write_per_port(0, LEDS_ALL, 0), 2);
+
+    // Mask bits past the last LED are ignored
+    zassert_ok(actuator_leds_set(UINT32_MAX, 0));
+    zassert_equal(actuator_leds_get(), 0);
+    zassert_equal(assert_one_write_per_port(LEDS_ALL, 0, 0), 2);
+}
+
+ZTEST(actuator_leds, test_random_updates) {
+
+    uint32_t state = 0;
+    uint32_t rng = 0x2468ACE1u;
+
+    for (int n = 0; n < 500; n++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+
+        uint32_t mask = rng & LEDS_ALL;
+        uint32_t next = (state & ~mask) | ((rng >> 8) & mask);
+
+        zassert_ok(actuator_leds_set(mask, rng >> 8));
+        zassert_equal(actuator_leds_get(), next);
+        (void)assert_one_write_per_port(state, next, 0);
+        state = next;
+    }
+}
+
+ZTEST(actuator_leds, test_mode_change_is_one_update) {
+
+    uint32_t before = BIT(0) | BIT(3) | BIT(4);
+
+    zassert_ok(actuator_leds_set(LEDS_ALL, before));
+    k_msgq_purge(&edge_q);
+
+    // ACTIVE lights LED1 alone: one write per controller, no LED blinking through
+    command_send(APP_CMD_MODE_INDICATOR, APP_MODE_ACTIVE);
+
+    zassert_equal(assert_one_write_per_port(before, BIT(1), 2 * CMD_LATENCY_MS), 2);
+    zassert_equal(actuator_leds_get(), BIT(1));
+}
+
+ZTEST(actuator_leds, test_toggle_skips_effect_owned_leds) {
+
+    struct led_edge e;
+
+    zassert_ok(led_fx_blink(2, 0, 50, 50));
+    zassert_ok(edge_next(BIT(2), CMD_LATENCY_MS, &e));
+
+    // Synchronous update: the blink cannot step in before the writes are collected
+    uint32_t before = leds_read();
+
+    zassert_ok(actuator_leds_toggle(LEDS_ALL));
+    (void)assert_one_write_per_port(before, before ^ (LEDS_ALL & ~BIT(2)), 0);
+
+    // The effect ends on the toggled steady state
+    led_fx_cancel(2);
+    zassert_equal(gpio_pin_get_dt(&leds[2]), 1);
+}
+
+ZTEST_SUITE(actuator_leds, NULL, actuator_setup, actuator_before, actuator_after, NULL);
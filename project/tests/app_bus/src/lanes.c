@@ -0,0 +1,283 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_bus.h>
+#include <app/app_msg.h>
+
+/*
+Priority lanes under a button flood:
+A producer publishes button events far faster than the consumer processes them, while
+the test thread sends a numbered command every few milliseconds. Commands have their own
+lane, so none is dropped and each one waits at most for the message being processed
+(strict drain) or for one weighted round (weighted drain), however deep the flood.
+*/
+
+// Flood length, and nominal time between two published button events (50 kHz)
+#define FLOOD_MS     500
+#define FLOOD_GAP_US 20
+
+// Consumer time per message: ten button events are due while one is processed
+#define PROCESS_US 200
+
+// Commands sent during the flood, one every CMD_PERIOD_MS
+#define FLOOD_CMDS    40
+#define CMD_PERIOD_MS 10
+
+BUILD_ASSERT(FLOOD_CMDS * CMD_PERIOD_MS < FLOOD_MS, "commands must be sent during the flood");
+
+// Scheduling margin on top of the messages a command may wait for
+#define LATENCY_SLACK_US 100
+
+// Unregistered command id: delivered by filter, like any unowned command
+#define FLOOD_CMD_ID 21
+
+#define FLOOD_STACK_SIZE 2048
+
+APP_BUS_LANES_DEFINE(strict_lanes, APP_BUS_DRAIN_STRICT,
+                     8, APP_BUS_REJECT_NEW,
+                     16, APP_BUS_OVERWRITE_OLDEST,
+                     4, APP_BUS_OVERWRITE_OLDEST);
+APP_BUS_LANES_DEFINE(weighted_lanes, APP_BUS_DRAIN_WEIGHTED,
+                     8, APP_BUS_REJECT_NEW,
+                     16, APP_BUS_OVERWRITE_OLDEST,
+                     4, APP_BUS_OVERWRITE_OLDEST);
+
+#define FLOOD_TYPES                                                             \
+    (APP_BUS_TYPE(APP_MSG_BUTTON_EVENT) | APP_BUS_TYPE(APP_MSG_COMMAND) |      \
+     APP_BUS_TYPE(APP_MSG_STATUS))
+
+APP_BUS_SUBSCRIBER_DEFINE_LANES(sub_strict, FLOOD_TYPES, APP_BUS_ANY, APP_BUS_CMD(FLOOD_CMD_ID),
+                                strict_lanes);
+APP_BUS_SUBSCRIBER_DEFINE_LANES(sub_weighted, FLOOD_TYPES, APP_BUS_ANY,
+                                APP_BUS_CMD(FLOOD_CMD_ID), weighted_lanes);
+
+static struct app_bus_sub *const lane_subs[] = { &sub_strict, &sub_weighted };
+
+K_THREAD_STACK_DEFINE(flood_producer_stack, FLOOD_STACK_SIZE);
+K_THREAD_STACK_DEFINE(flood_consumer_stack, FLOOD_STACK_SIZE);
+static struct k_thread flood_producer_thread;
+static struct k_thread flood_consumer_thread;
+
+// What the consumer saw during one flood
+struct flood_result {
+    struct app_bus_sub *sub;
+    uint32_t commands;          // next expected command number
+    uint32_t out_of_order;      // lost, duplicated or reordered commands
+    uint32_t max_cmd_us;        // longest publish -> dequeue time of a command
+    uint32_t buttons;
+    uint32_t telemetry;         // status messages dequeued while the flood ran
+};
+
+static struct flood_result result;
+static uint32_t cmd_sent_cyc[FLOOD_CMDS];
+static atomic_t flood_running;
+static atomic_t flood_done;
+
+/**
+ * @brief Flood producer: one button event per FLOOD_GAP_US for FLOOD_MS
+ *
+ * Wakes every tick and publishes the events due since the last wake-up, so the nominal
+ * rate holds whatever the tick rate; the consumer runs while it sleeps.
+ *
+ * @param p1 Non-zero to publish a status report every fourth event as well
+ */
+static void flood_producer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    bool telemetry = (uintptr_t)p1 != 0;
+    int64_t end = k_uptime_get() + FLOOD_MS;
+    uint32_t start = k_cycle_get_32();
+    uint32_t n = 0;
+
+    while (k_uptime_get() < end) {
+        uint32_t due = k_cyc_to_us_floor32(k_cycle_get_32() - start) / FLOOD_GAP_US;
+
+        for (; n < due; n++) {
+            struct app_msg msg = {0};
+
+            msg.type = APP_MSG_BUTTON_EVENT;
+            msg.source = APP_SRC_SENSOR;
+            msg.data.button.button_id = n & 3;
+            msg.data.button.pressed = n & 1;
+            (void)app_bus_publish(&msg);
+
+            if (telemetry && (n % 4) == 0) {
+                msg = (struct app_msg){0};
+                msg.type = APP_MSG_STATUS;
+                msg.source = APP_SRC_SYSTEM;
+                msg.data.status.index = (uint8_t)n;
+                (void)app_bus_publish(&msg);
+            }
+        }
+
+        k_sleep(K_TICKS(1));
+    }
+
+    atomic_set(&flood_running, 0);
+}
+
+/**
+ * @brief Flood consumer: dequeues and "processes" every message for PROCESS_US
+ *
+ * @param p1 Result to fill
+ */
+static void flood_consumer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    struct flood_result *r = p1;
+    struct app_msg msg;
+
+    while (1) {
+        if (app_bus_sub_get(r->sub, &msg, K_MSEC(20)) != 0) {
+            if (atomic_get(&flood_done)) {
+                return;
+            }
+            continue;
+        }
+
+        uint32_t now = k_cycle_get_32();
+
+        switch (msg.type) {
+            case APP_MSG_COMMAND: {
+                uint32_t n = msg.data.command.value;
+
+                if (n != r->commands || n >= FLOOD_CMDS) {
+                    r->out_of_order++;
+                    break;
+                }
+                r->max_cmd_us = MAX(r->max_cmd_us, k_cyc_to_us_ceil32(now - cmd_sent_cyc[n]));
+                r->commands++;
+                break;
+            }
+
+            case APP_MSG_BUTTON_EVENT:
+                r->buttons++;
+                break;
+
+            default:
+                if (atomic_get(&flood_running)) {
+                    r->telemetry++;
+                }
+                break;
+        }
+
+        k_busy_wait(PROCESS_US);
+    }
+}
+
+/**
+ * @brief Run one flood against a subscriber, sending FLOOD_CMDS commands meanwhile
+ *
+ * @param sub Subscriber with lanes
+ * @param telemetry true to add status reports to the flood
+ */
+static void flood_run(struct app_bus_sub *sub, bool telemetry) {
+
+    memset(&result, 0, sizeof(result));
+    result.sub = sub;
+    atomic_set(&flood_running, 1);
+    atomic_set(&flood_done, 0);
+
+    // Producer above the consumer, as button interrupts preempt the controller
+    k_thread_create(&flood_consumer_thread, flood_consumer_stack, FLOOD_STACK_SIZE,
+                    flood_consumer, &result, NULL, NULL, K_PRIO_PREEMPT(6), 0, K_NO_WAIT);
+    k_thread_create(&flood_producer_thread, flood_producer_stack, FLOOD_STACK_SIZE,
+                    flood_producer, (void *)(uintptr_t)telemetry, NULL, NULL,
+                    K_PRIO_PREEMPT(4), 0, K_NO_WAIT);
+
+    for (uint32_t i = 0; i < FLOOD_CMDS; i++) {
+        struct app_msg msg = {0};
+
+        k_msleep(CMD_PERIOD_MS);
+
+        msg.type = APP_MSG_COMMAND;
+        msg.source = APP_SRC_COMMS;
+        msg.data.command.command_id = FLOOD_CMD_ID;
+        msg.data.command.value = i;
+
+        cmd_sent_cyc[i] = k_cycle_get_32();
+        zassert_ok(app_bus_publish(&msg), "command %u dropped", i);
+    }
+
+    zassert_ok(k_thread_join(&flood_producer_thread, K_SECONDS(5)));
+    atomic_set(&flood_done, 1);
+    zassert_ok(k_thread_join(&flood_consumer_thread, K_SECONDS(5)));
+
+    TC_PRINT("%s: %u buttons, %u telemetry during the flood, command latency max %u us\n",
+             sub->name, result.buttons, result.telemetry, result.max_cmd_us);
+}
+
+/**
+ * @brief Check the lane counters after a flood
+ *
+ * @param sub Subscriber
+ */
+static void assert_lanes_after_flood(struct app_bus_sub *sub) {
+
+    struct app_bus_lane_stats st;
+
+    zassert_equal(result.commands, FLOOD_CMDS, "only %u commands received", result.commands);
+    zassert_equal(result.out_of_order, 0);
+
+    // Commands kept their reserved lane; the flood overflowed its own
+    zassert_ok(app_bus_lane_stats_get(sub, APP_BUS_CLASS_CRITICAL, &st));
+    zassert_equal(st.drops + st.overwritten, 0, "commands dropped");
+    zassert_ok(app_bus_lane_stats_get(sub, APP_BUS_CLASS_NORMAL, &st));
+    zassert_true(st.overwritten > 0, "the flood never filled the button lane");
+    zassert_equal(st.depth, 0);
+    zassert_equal(st.peak, sub->lanes->lane[APP_BUS_CLASS_NORMAL].cap, "full lane not recorded");
+}
+
+static void *lanes_setup(void) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(lane_subs); i++) {
+        zassert_ok(app_bus_subscribe(lane_subs[i]));
+        app_bus_sub_pause(lane_subs[i], true);
+    }
+
+    return NULL;
+}
+
+// Each test resumes the subscriber it floods; the other suites never see the flood
+static void lanes_after(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    for (size_t i = 0; i < ARRAY_SIZE(lane_subs); i++) {
+        app_bus_sub_pause(lane_subs[i], true);
+    }
+}
+
+ZTEST(app_bus_lanes, test_strict_commands_bypass_flood) {
+
+    app_bus_sub_pause(&sub_strict, false);
+    flood_run(&sub_strict, false);
+    assert_lanes_after_flood(&sub_strict);
+
+    // A command waits at most for the message being processed
+    zassert_true(result.max_cmd_us <= PROCESS_US + LATENCY_SLACK_US,
+                 "command waited %u us", result.max_cmd_us);
+}
+
+ZTEST(app_bus_lanes, test_weighted_commands_bounded_telemetry_served) {
+
+    app_bus_sub_pause(&sub_weighted, false);
+    flood_run(&sub_weighted, true);
+    assert_lanes_after_flood(&sub_weighted);
+
+    // At worst a command waits for one weighted round of the lower classes
+    uint32_t bound = (1 + APP_BUS_WEIGHT_NORMAL + APP_BUS_WEIGHT_TELEMETRY) * PROCESS_US +
+                     LATENCY_SLACK_US;
+
+    zassert_true(result.max_cmd_us <= bound, "command waited %u us, bound %u us",
+                 result.max_cmd_us, bound);
+
+    // Weighted drain keeps the lowest class moving while buttons flood the consumer
+    zassert_true(result.telemetry > 0, "telemetry starved by the flood");
+}
+
+ZTEST_SUITE(app_bus_lanes, NULL, lanes_setup, NULL, lanes_after, NULL);
@@ -0,0 +1,268 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_bus.h>
+#include <app/app_msg.h>
+
+/*
+Latest-value tables:
+A 10 kHz publisher cycles button events over a few buttons while the consumer takes a
+millisecond per message. With a latest-value table the subscriber never holds more than
+one pending event per button, and every event it dequeues carries the newest state of
+that button. The eviction test covers lanes that overwrite their oldest entry: the
+evicted message's key must be released, or the next event for it would vanish.
+*/
+
+// Synthetic publisher: one event per PUB_GAP_US (10 kHz) for PUB_MS
+#define PUB_MS     500
+#define PUB_GAP_US 100
+
+// Consumer time per message: ten events are due while one is processed
+#define PROCESS_US 1000
+
+// Buttons the events cycle over, i.e. distinct keys
+#define LATEST_KEYS 4
+
+#define LATEST_STACK_SIZE 2048
+
+APP_BUS_SUBSCRIBER_DEFINE(sub_latest, 16, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT),
+                          APP_BUS_SRC(APP_SRC_BUTTONS), 0);
+APP_BUS_LATEST_DEFINE(latest_buttons, 8, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT));
+
+APP_BUS_LANES_DEFINE(evict_lanes, APP_BUS_DRAIN_STRICT,
+                     1, APP_BUS_REJECT_NEW,
+                     2, APP_BUS_OVERWRITE_OLDEST,
+                     1, APP_BUS_OVERWRITE_OLDEST);
+APP_BUS_SUBSCRIBER_DEFINE_LANES(sub_evict, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT),
+                                APP_BUS_SRC(APP_SRC_BUTTONS), 0, evict_lanes);
+APP_BUS_LATEST_DEFINE(latest_evict, 4, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT));
+
+static struct app_bus_sub *const latest_subs[] = { &sub_latest, &sub_evict };
+
+K_THREAD_STACK_DEFINE(latest_producer_stack, LATEST_STACK_SIZE);
+K_THREAD_STACK_DEFINE(latest_consumer_stack, LATEST_STACK_SIZE);
+static struct k_thread latest_producer_thread;
+static struct k_thread latest_consumer_thread;
+
+// Publisher and consumer view of one run
+struct latest_result {
+    uint32_t published;
+    uint32_t max_depth;                     // deepest queue seen right after a publish
+    uint32_t last_sent[LATEST_KEYS];        // sequence number of each button's last event
+    uint32_t delivered;
+    uint32_t stale;                         // events older than one already delivered
+    uint32_t last_seen[LATEST_KEYS];        // sequence number + 1 of the last delivery
+};
+
+static struct latest_result lr;
+static atomic_t latest_done;
+
+/**
+ * @brief Build a button event for the latest-value tests
+ *
+ * @param id Button id (the coalescing key)
+ * @param seq Sequence number, carried in the timestamp field
+ * @return Message
+ */
+static struct app_msg latest_msg(uint8_t id, uint32_t seq) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_BUTTON_EVENT;
+    msg.source = APP_SRC_BUTTONS;
+    msg.timestamp_ms = seq;
+    msg.data.button.button_id = id;
+    msg.data.button.pressed = seq & 1;
+
+    return msg;
+}
+
+/**
+ * @brief 10 kHz publisher: wakes every tick and publishes the events due since
+ *
+ * @param p1 Result to fill
+ */
+static void latest_producer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    struct latest_result *r = p1;
+    int64_t end = k_uptime_get() + PUB_MS;
+    uint32_t start = k_cycle_get_32();
+    uint32_t n = 0;
+
+    while (k_uptime_get() < end) {
+        uint32_t due = k_cyc_to_us_floor32(k_cycle_get_32() - start) / PUB_GAP_US;
+
+        for (; n < due; n++) {
+            struct app_msg msg = latest_msg(n % LATEST_KEYS, n);
+
+            (void)app_bus_publish(&msg);
+            r->last_sent[n % LATEST_KEYS] = n;
+            r->max_depth = MAX(r->max_depth, k_msgq_num_used_get(sub_latest.q));
+        }
+
+        k_sleep(K_TICKS(1));
+    }
+
+    r->published = n;
+}
+
+/**
+ * @brief Slow consumer: PROCESS_US per event, checks each event is the newest so far
+ *
+ * @param p1 Result to fill
+ */
+static void latest_consumer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    struct latest_result *r = p1;
+    struct app_msg msg;
+
+    while (1) {
+        if (app_bus_sub_get(&sub_latest, &msg, K_MSEC(20)) != 0) {
+            if (atomic_get(&latest_done)) {
+                return;
+            }
+            continue;
+        }
+
+        uint8_t id = msg.data.button.button_id;
+
+        if (id >= LATEST_KEYS || msg.timestamp_ms + 1 <= r->last_seen[id]) {
+            r->stale++;
+        } else {
+            r->last_seen[id] = msg.timestamp_ms + 1;
+        }
+        r->delivered++;
+
+        k_busy_wait(PROCESS_US);
+    }
+}
+
+/**
+ * @brief Pop the next event of the eviction subscriber
+ *
+ * @return The event
+ */
+static struct app_msg evict_get(void) {
+
+    struct app_msg out;
+
+    zassert_ok(app_bus_sub_get(&sub_evict, &out, K_NO_WAIT), "event missing");
+
+    return out;
+}
+
+static void *latest_setup(void) {
+
+    // Tables are attached before subscribing, as the controller does
+    zassert_ok(app_bus_latest_attach(&sub_latest, &latest_buttons));
+    zassert_ok(app_bus_latest_attach(&sub_evict, &latest_evict));
+
+    for (size_t i = 0; i < ARRAY_SIZE(latest_subs); i++) {
+        zassert_ok(app_bus_subscribe(latest_subs[i]));
+        app_bus_sub_pause(latest_subs[i], true);
+    }
+
+    return NULL;
+}
+
+// Each test resumes the subscriber it uses
+static void latest_after(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    for (size_t i = 0; i < ARRAY_SIZE(latest_subs); i++) {
+        app_bus_sub_pause(latest_subs[i], true);
+    }
+}
+
+ZTEST(app_bus_latest, test_depth_bounded_under_10khz_publisher) {
+
+    uint32_t drops = app_bus_sub_drop_count(&sub_latest);
+    uint32_t coalesced = app_bus_sub_coalesced_count(&sub_latest);
+
+    memset(&lr, 0, sizeof(lr));
+    atomic_set(&latest_done, 0);
+    app_bus_sub_pause(&sub_latest, false);
+
+    // Publisher above the consumer, as the sensor runs above the controller
+    k_thread_create(&latest_consumer_thread, latest_consumer_stack, LATEST_STACK_SIZE,
+                    latest_consumer, &lr, NULL, NULL, K_PRIO_PREEMPT(6), 0, K_NO_WAIT);
+    k_thread_create(&latest_producer_thread, latest_producer_stack, LATEST_STACK_SIZE,
+                    latest_producer, &lr, NULL, NULL, K_PRIO_PREEMPT(4), 0, K_NO_WAIT);
+
+    zassert_ok(k_thread_join(&latest_producer_thread, K_SECONDS(5)));
+    atomic_set(&latest_done, 1);
+    zassert_ok(k_thread_join(&latest_consumer_thread, K_SECONDS(5)));
+
+    coalesced = app_bus_sub_coalesced_count(&sub_latest) - coalesced;
+
+    TC_PRINT("%u events published, %u delivered, %u coalesced, max depth %u\n",
+             lr.published, lr.delivered, coalesced, lr.max_depth);
+
+    // At most one pending event per button, however far the consumer falls behind
+    zassert_true(lr.max_depth <= LATEST_KEYS, "queue reached %u", lr.max_depth);
+    zassert_equal(app_bus_sub_drop_count(&sub_latest), drops);
+
+    // Every event was either delivered or folded into a newer one
+    zassert_equal(lr.delivered + coalesced, lr.published);
+    zassert_true(lr.delivered < lr.published / 4, "consumer woken %u times for %u events",
+                 lr.delivered, lr.published);
+
+    // Deliveries only move forward, and each button ends on its last published state
+    zassert_equal(lr.stale, 0, "%u stale events delivered", lr.stale);
+    for (int id = 0; id < LATEST_KEYS; id++) {
+        zassert_equal(lr.last_seen[id], lr.last_sent[id] + 1, "button %d ends on a stale event",
+                      id);
+    }
+}
+
+ZTEST(app_bus_latest, test_overwrite_oldest_releases_evicted_key) {
+
+    struct app_bus_lane_stats st;
+    struct app_msg msg;
+
+    app_bus_sub_pause(&sub_evict, false);
+
+    // Two-slot lane: the third key evicts button 0's pending event
+    for (uint8_t id = 0; id < 3; id++) {
+        msg = latest_msg(id, id);
+        zassert_ok(app_bus_publish(&msg));
+    }
+
+    // Button 0 has nothing pending any more: its next event is queued, not coalesced
+    // into the evicted one (which would lose it), and evicts button 1 in turn
+    msg = latest_msg(0, 3);
+    zassert_ok(app_bus_publish(&msg));
+
+    zassert_ok(app_bus_lane_stats_get(&sub_evict, APP_BUS_CLASS_NORMAL, &st));
+    zassert_equal(st.overwritten, 2);
+
+    msg = evict_get();
+    zassert_equal(msg.data.button.button_id, 2);
+    msg = evict_get();
+    zassert_equal(msg.data.button.button_id, 0);
+    zassert_equal(msg.timestamp_ms, 3);
+    zassert_not_ok(app_bus_sub_get(&sub_evict, &msg, K_NO_WAIT));
+
+    // Button 1 was evicted too: its next events queue and coalesce normally
+    uint32_t coalesced = app_bus_sub_coalesced_count(&sub_evict);
+
+    msg = latest_msg(1, 4);
+    zassert_ok(app_bus_publish(&msg));
+    msg = latest_msg(1, 5);
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(app_bus_sub_coalesced_count(&sub_evict), coalesced + 1);
+
+    msg = evict_get();
+    zassert_equal(msg.data.button.button_id, 1);
+    zassert_equal(msg.timestamp_ms, 5);
+    zassert_not_ok(app_bus_sub_get(&sub_evict, &msg, K_NO_WAIT));
+}
+
+ZTEST_SUITE(app_bus_latest, NULL, latest_setup, NULL, latest_after, NULL);
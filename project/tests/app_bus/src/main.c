@@ -0,0 +1,380 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_bus.h>
+#include <app/app_cmd.h>
+#include <app/app_msg.h>
+
+/*
+Fan-out: every subscriber gets its own copy of each matching message, exactly once,
+and nothing is ever published again by a consumer.
+*/
+
+// Messages published by each producer in the load test
+#define LOAD_MSGS 2000
+#define PRODUCERS 2
+
+// Producer 1 publishes in batches of this many messages (scheduler locked per batch)
+#define LOAD_BATCH 16
+
+// Internal command range (16 and up), registered by this test only
+#define TEST_CMD_ID 20
+
+#define STACK_SIZE 2048
+
+APP_BUS_SUBSCRIBER_DEFINE(sub_sensor, APP_BUS_LEN, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT),
+                          APP_BUS_SRC(APP_SRC_SENSOR), 0);
+APP_BUS_SUBSCRIBER_DEFINE(sub_any, APP_BUS_LEN, APP_BUS_ANY, APP_BUS_ANY, APP_BUS_ANY);
+APP_BUS_SUBSCRIBER_DEFINE(sub_status, 4, APP_BUS_TYPE(APP_MSG_STATUS), APP_BUS_ANY, 0);
+APP_BUS_SUBSCRIBER_DEFINE(sub_owner, 8, 0, 0, 0);
+
+static struct app_bus_sub *const fanout_subs[] = { &sub_sensor, &sub_any, &sub_status };
+
+static bool test_cmd_valid(uint32_t value) {
+    return value < 100;
+}
+
+APP_CMD_DEFINE(cmd_test, TEST_CMD_ID, &sub_owner, NULL, test_cmd_valid,
+               APP_BUS_SRC(APP_SRC_COMMS));
+
+K_THREAD_STACK_ARRAY_DEFINE(producer_stacks, PRODUCERS, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(consumer_stacks, 2, STACK_SIZE);
+static struct k_thread producer_threads[PRODUCERS];
+static struct k_thread consumer_threads[2];
+
+// What one consumer saw during the load test
+struct consumer_result {
+    struct app_bus_sub *sub;
+    uint32_t received;
+    uint32_t next_seq[PRODUCERS];   // next expected sequence number per producer
+    uint32_t out_of_order;          // duplicates, gaps or reordering
+    uint32_t foreign;               // messages the subscriber's filter should have rejected
+};
+
+static struct consumer_result results[2];
+
+/**
+ * @brief Build a button event
+ *
+ * @param source Publishing module
+ * @param id Button id
+ * @param seq Sequence number, carried in the timestamp field
+ * @return Message
+ */
+static struct app_msg button_msg(enum app_msg_source source, uint8_t id, uint32_t seq) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_BUTTON_EVENT;
+    msg.source = source;
+    msg.timestamp_ms = seq;
+    msg.data.button.button_id = id;
+    msg.data.button.pressed = seq & 1;
+
+    return msg;
+}
+
+/**
+ * @brief Build a command
+ *
+ * @param source Publishing module
+ * @param id Command id
+ * @param value Command value
+ * @return Message
+ */
+static struct app_msg command_msg(enum app_msg_source source, uint8_t id, uint32_t value) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_COMMAND;
+    msg.source = source;
+    msg.data.command.command_id = id;
+    msg.data.command.value = value;
+
+    return msg;
+}
+
+/**
+ * @brief Build a status report
+ *
+ * @param index Report index
+ * @return Message
+ */
+static struct app_msg status_msg(uint8_t index) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_STATUS;
+    msg.source = APP_SRC_SYSTEM;
+    msg.data.status.index = index;
+
+    return msg;
+}
+
+/**
+ * @brief Discard everything pending for a subscriber
+ *
+ * @param sub Subscriber
+ * @return Number of messages discarded
+ */
+static uint32_t drain(struct app_bus_sub *sub) {
+
+    struct app_msg msg;
+    uint32_t n = 0;
+
+    while (app_bus_sub_get(sub, &msg, K_NO_WAIT) == 0) {
+        app_bus_msg_release(&msg);
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Load-test producer: publishes LOAD_MSGS numbered button events
+ *
+ * Producer 0 publishes one message at a time; producer 1 publishes batches, so queues
+ * actually fill up while the consumers are locked out.
+ *
+ * @param p1 Producer index
+ */
+static void producer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    uint8_t id = (uint8_t)(uintptr_t)p1;
+    struct app_msg batch[LOAD_BATCH];
+
+    for (uint32_t seq = 0; seq < LOAD_MSGS; ) {
+
+        if (id == 0) {
+            struct app_msg msg = button_msg(APP_SRC_SENSOR, id, seq++);
+
+            zassert_ok(app_bus_publish(&msg));
+        } else {
+            size_t n = MIN(LOAD_BATCH, LOAD_MSGS - seq);
+
+            for (size_t i = 0; i < n; i++) {
+                batch[i] = button_msg(APP_SRC_SENSOR, id, seq++);
+            }
+            zassert_ok(app_bus_publish_batch(batch, n));
+        }
+
+        k_yield();
+    }
+}
+
+/**
+ * @brief Load-test consumer: checks per-producer order until every message arrived
+ *
+ * Stops early once nothing arrives for a while, so a lost message fails the test
+ * instead of hanging it.
+ *
+ * @param p1 struct consumer_result of the subscriber to read
+ */
+static void consumer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    struct consumer_result *res = p1;
+    struct app_msg msg;
+
+    while (res->received < PRODUCERS * LOAD_MSGS &&
+           app_bus_sub_get(res->sub, &msg, K_MSEC(500)) == 0) {
+
+        uint8_t id = msg.data.button.button_id;
+
+        res->received++;
+
+        if (msg.type != APP_MSG_BUTTON_EVENT || msg.source != APP_SRC_SENSOR ||
+            id >= PRODUCERS) {
+            res->foreign++;
+            continue;
+        }
+
+        if (msg.timestamp_ms != res->next_seq[id]) {
+            res->out_of_order++;
+        }
+        res->next_seq[id] = msg.timestamp_ms + 1;
+    }
+}
+
+static void *fanout_setup(void) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(fanout_subs); i++) {
+        zassert_ok(app_bus_subscribe(fanout_subs[i]));
+    }
+
+    return NULL;
+}
+
+static void fanout_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    for (size_t i = 0; i < ARRAY_SIZE(fanout_subs); i++) {
+        app_bus_sub_pause(fanout_subs[i], false);
+        (void)drain(fanout_subs[i]);
+    }
+    (void)drain(&sub_owner);
+}
+
+// Other suites in this binary publish too: keep these subscribers out of their way
+static void fanout_after(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    for (size_t i = 0; i < ARRAY_SIZE(fanout_subs); i++) {
+        app_bus_sub_pause(fanout_subs[i], true);
+    }
+}
+
+ZTEST(app_bus_fanout, test_exactly_once_under_load) {
+
+    uint32_t drops_before = app_bus_drop_count();
+
+    memset(results, 0, sizeof(results));
+    results[0].sub = &sub_sensor;
+    results[1].sub = &sub_any;
+
+    // Consumers run above the producers, as the controller and actuator do above the sensor
+    for (int i = 0; i < 2; i++) {
+        k_thread_create(&consumer_threads[i], consumer_stacks[i], STACK_SIZE, consumer,
+                        &results[i], NULL, NULL, K_PRIO_PREEMPT(4), 0, K_NO_WAIT);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        k_thread_create(&producer_threads[i], producer_stacks[i], STACK_SIZE, producer,
+                        (void *)(uintptr_t)i, NULL, NULL, K_PRIO_PREEMPT(6), 0, K_NO_WAIT);
+    }
+
+    for (int i = 0; i < PRODUCERS; i++) {
+        zassert_ok(k_thread_join(&producer_threads[i], K_SECONDS(10)));
+    }
+    for (int i = 0; i < 2; i++) {
+        zassert_ok(k_thread_join(&consumer_threads[i], K_SECONDS(10)));
+    }
+
+    for (int i = 0; i < 2; i++) {
+        zassert_equal(results[i].received, PRODUCERS * LOAD_MSGS, "%s lost or gained messages",
+                      results[i].sub->name);
+        zassert_equal(results[i].out_of_order, 0, "%s saw duplicates or reordering",
+                      results[i].sub->name);
+        zassert_equal(results[i].foreign, 0, "%s got messages outside its filter",
+                      results[i].sub->name);
+        for (int p = 0; p < PRODUCERS; p++) {
+            zassert_equal(results[i].next_seq[p], LOAD_MSGS);
+        }
+    }
+
+    zassert_equal(app_bus_drop_count(), drops_before, "deliveries dropped under load");
+
+    // No consumer re-publishes: once drained, the bus stays quiet
+    k_msleep(50);
+    for (size_t i = 0; i < ARRAY_SIZE(fanout_subs); i++) {
+        zassert_equal(drain(fanout_subs[i]), 0, "%s received a re-published message",
+                      fanout_subs[i]->name);
+    }
+}
+
+ZTEST(app_bus_fanout, test_filter_selects_subscribers) {
+
+    struct app_msg msg = button_msg(APP_SRC_BUTTONS, 1, 0);
+
+    // Wrong source for sub_sensor: only the catch-all subscriber gets it
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(drain(&sub_sensor), 0);
+    zassert_equal(drain(&sub_any), 1);
+
+    msg = button_msg(APP_SRC_SENSOR, 1, 0);
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(drain(&sub_sensor), 1);
+    zassert_equal(drain(&sub_any), 1);
+    zassert_equal(drain(&sub_status), 0);
+
+    msg = status_msg(0);
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(drain(&sub_status), 1);
+    zassert_equal(drain(&sub_any), 1);
+    zassert_equal(drain(&sub_sensor), 0);
+}
+
+ZTEST(app_bus_fanout, test_no_match) {
+
+    struct app_msg msg = { .type = APP_MSG_FEATURE, .source = APP_SRC_DSP };
+
+    app_bus_sub_pause(&sub_any, true);
+    zassert_equal(app_bus_publish(&msg), -ENOENT);
+    app_bus_sub_pause(&sub_any, false);
+
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(drain(&sub_any), 1);
+}
+
+ZTEST(app_bus_fanout, test_command_id_out_of_range) {
+
+    // Unregistered ids below APP_CMD_ID_MAX are broadcast to matching filters
+    struct app_msg msg = command_msg(APP_SRC_COMMS, APP_CMD_ID_MAX - 1, 0);
+
+    zassert_ok(app_bus_publish(&msg));
+    zassert_equal(drain(&sub_any), 1);
+
+    // Ids past the 32-bit command mask match no filter, not even APP_BUS_ANY
+    static const uint8_t ids[] = { APP_CMD_ID_MAX, APP_CMD_ID_MAX + 8, 63, 64, 255 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(ids); i++) {
+        msg = command_msg(APP_SRC_COMMS, ids[i], 0);
+        zassert_equal(app_bus_publish(&msg), -ENOENT, "id %u was delivered", ids[i]);
+        zassert_equal(drain(&sub_any), 0);
+    }
+}
+
+ZTEST(app_bus_fanout, test_registered_command_goes_to_owner) {
+
+    struct app_msg msg = command_msg(APP_SRC_COMMS, TEST_CMD_ID, 5);
+    struct app_msg out;
+
+    // Only the owner sees it, although sub_any accepts every command
+    zassert_ok(app_bus_publish(&msg));
+    zassert_ok(app_bus_sub_get(&sub_owner, &out, K_NO_WAIT));
+    zassert_equal(out.data.command.value, 5);
+    zassert_equal(drain(&sub_any), 0);
+
+    // Rejected at publish time: bad value, then a source that may not send it
+    msg.data.command.value = 100;
+    zassert_equal(app_bus_publish(&msg), -EINVAL);
+
+    msg = command_msg(APP_SRC_SENSOR, TEST_CMD_ID, 5);
+    zassert_equal(app_bus_publish(&msg), -EPERM);
+
+    zassert_equal(drain(&sub_owner), 0);
+    zassert_equal(drain(&sub_any), 0);
+}
+
+ZTEST(app_bus_fanout, test_full_queue_only_affects_its_subscriber) {
+
+    uint32_t drops = app_bus_sub_drop_count(&sub_status);
+    uint32_t any_drops = app_bus_sub_drop_count(&sub_any);
+
+    for (uint8_t i = 0; i < 6; i++) {
+        struct app_msg msg = status_msg(i);
+        int rc = app_bus_publish(&msg);
+
+        // The 4-deep queue overflows on the fifth publish; the error is reported
+        zassert_equal(rc, (i < 4) ? 0 : -ENOMSG, "publish %u", i);
+    }
+
+    zassert_equal(app_bus_sub_drop_count(&sub_status), drops + 2);
+    zassert_equal(app_bus_sub_drop_count(&sub_any), any_drops);
+
+    // The oldest messages were kept, the full queue rejected the newest
+    struct app_msg out;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        zassert_ok(app_bus_sub_get(&sub_status, &out, K_NO_WAIT));
+        zassert_equal(out.data.status.index, i);
+    }
+    zassert_equal(drain(&sub_any), 6);
+}
+
+ZTEST_SUITE(app_bus_fanout, NULL, fanout_setup, fanout_before, fanout_after, NULL);
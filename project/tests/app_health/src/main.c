@@ -0,0 +1,305 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_bus.h>
+#include <app/app_health.h>
+#include <app/app_msg.h>
+
+/*
+Health monitor with injected stalls:
+A worker thread is registered like the application threads and runs one iteration per
+work item the test queues. An item either stays within the budget or injects a stall:
+spinning without yielding, or blocked on a semaphore the test holds. The test reads the
+monitor's APP_MSG_STATUS reports off the bus and checks that a stall is reported once,
+within one check period of the budget running out, and that waiting between iterations
+or short iterations are never reported. CONFIG_APP_HEALTH_RESET is off, as the watchdog
+reset would end the run.
+*/
+
+#define BUDGET_MS 100
+#define CHECK_MS  CONFIG_APP_HEALTH_CHECK_MS
+
+// Latest a stall report may arrive after the iteration started: the budget, up to one check
+// period until the next check, and a millisecond each for exceeding the budget and rounding
+#define STALL_DEADLINE_MS (BUDGET_MS + CHECK_MS + 2)
+
+// Length of an injected stall
+#define STALL_MS (3 * BUDGET_MS)
+
+// Allowed distance between a timed iteration and its nominal length
+#define ITER_SLACK_US 1000
+
+#define WORKER_STACK_SIZE 1024
+#define WORKER_PRIORITY   K_PRIO_PREEMPT(5)
+
+enum work_kind {
+    WORK_SLEEP,                 // sleeps, the thread yields as on a normal iteration
+    WORK_SPIN,                  // busy loop, the thread never yields
+    WORK_BLOCK,                 // waits on a resource the test releases
+};
+
+struct work_item {
+    enum work_kind kind;
+    uint32_t ms;
+};
+
+APP_HEALTH_DEFINE(test_health, "worker", BUDGET_MS);
+
+APP_BUS_SUBSCRIBER_DEFINE(status_sub, 16, APP_BUS_TYPE(APP_MSG_STATUS),
+                          APP_BUS_SRC(APP_SRC_SYSTEM), 0);
+
+K_MSGQ_DEFINE(work_q, sizeof(struct work_item), 4, 4);
+K_SEM_DEFINE(done_sem, 0, 1);
+K_SEM_DEFINE(resource_sem, 0, 1);
+
+K_THREAD_STACK_DEFINE(worker_stack, WORKER_STACK_SIZE);
+static struct k_thread worker_thread;
+
+// Index of the worker's channel in the status reports
+static size_t g_idx;
+
+/**
+ * @brief Worker thread: one health-bracketed iteration per queued work item
+ */
+static void worker(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    APP_HEALTH_START(test_health);
+
+    while (true) {
+        struct work_item item;
+
+        // Waiting here is healthy, however long it takes
+        k_msgq_get(&work_q, &item, K_FOREVER);
+
+        APP_HEALTH_BEGIN(test_health);
+
+        switch (item.kind) {
+        case WORK_SLEEP:
+            k_msleep(item.ms);
+            break;
+        case WORK_SPIN:
+            k_busy_wait(item.ms * USEC_PER_MSEC);
+            break;
+        case WORK_BLOCK:
+            k_sem_take(&resource_sem, K_FOREVER);
+            break;
+        }
+
+        APP_HEALTH_END(test_health);
+
+        k_sem_give(&done_sem);
+    }
+}
+
+/**
+ * @brief Queue one iteration for the worker
+ *
+ * @param kind What the iteration does
+ * @param ms Its length (WORK_SLEEP, WORK_SPIN)
+ * @return k_uptime_get_32() when it was queued, the start of the iteration
+ */
+static uint32_t work_start(enum work_kind kind, uint32_t ms) {
+
+    struct work_item item = { .kind = kind, .ms = ms };
+    uint32_t now = k_uptime_get_32();
+
+    zassert_ok(k_msgq_put(&work_q, &item, K_NO_WAIT));
+
+    return now;
+}
+
+/**
+ * @brief Wait for the next status report of the worker's channel
+ *
+ * Reports of another kind are skipped.
+ *
+ * @param kind Report kind
+ * @param timeout_ms Longest wait
+ * @param out Report received
+ * @return 0 on success, -EAGAIN if none arrived in time
+ */
+static int status_wait(enum app_status_kind kind, uint32_t timeout_ms, struct app_msg *out) {
+
+    int64_t deadline = k_uptime_get() + timeout_ms;
+
+    while (true) {
+        int64_t left = deadline - k_uptime_get();
+
+        if (left < 0 || app_bus_sub_get(&status_sub, out, K_MSEC(left)) != 0) {
+            return -EAGAIN;
+        }
+
+        if (out->data.status.kind == kind && out->data.status.index == g_idx) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Get the worker's channel counters
+ *
+ * @return Counters
+ */
+static struct app_health_stats health_stats(void) {
+
+    struct app_health_stats st;
+
+    zassert_ok(app_health_stats_get(g_idx, &st));
+
+    return st;
+}
+
+static void *health_setup(void) {
+
+    struct app_health_stats st;
+
+    zassert_ok(app_bus_subscribe(&status_sub));
+
+    k_thread_create(&worker_thread, worker_stack, WORKER_STACK_SIZE, worker, NULL, NULL, NULL,
+                    WORKER_PRIORITY, 0, K_NO_WAIT);
+
+    // Find the worker's channel by its name, as a host tool reading the reports would
+    for (g_idx = 0; app_health_stats_get(g_idx, &st) == 0; g_idx++) {
+        if (strcmp(st.name, "worker") == 0) {
+            break;
+        }
+    }
+    zassert_equal(app_health_stats_get(g_idx, &st), 0, "no channel for the worker");
+    zassert_equal(st.budget_ms, BUDGET_MS);
+
+    // Let the worker bind itself
+    k_msleep(1);
+
+    return NULL;
+}
+
+// No report left over from the previous test
+static void health_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    k_msgq_purge(&status_sub_q);
+}
+
+ZTEST(app_health, test_waiting_and_short_iterations_not_reported) {
+
+    struct app_health_stats before = health_stats();
+    struct app_msg msg;
+
+    // Idle for several budgets, blocked on the work queue
+    zassert_equal(status_wait(APP_STATUS_STALL, 3 * BUDGET_MS, &msg), -EAGAIN,
+                  "idle thread reported as stalled");
+
+    // Iterations just within the budget, sleeping and spinning
+    for (int n = 0; n < 4; n++) {
+        work_start((n % 2) ? WORK_SPIN : WORK_SLEEP, BUDGET_MS - CHECK_MS);
+        zassert_equal(status_wait(APP_STATUS_STALL, BUDGET_MS, &msg), -EAGAIN,
+                      "iteration %d within the budget reported as stalled", n);
+        zassert_ok(k_sem_take(&done_sem, K_MSEC(BUDGET_MS)));
+    }
+
+    struct app_health_stats after = health_stats();
+
+    zassert_equal(after.loops - before.loops, 4);
+    zassert_equal(after.stalls, before.stalls);
+    zassert_false(after.stalled);
+    zassert_within(after.last_us, (BUDGET_MS - CHECK_MS) * USEC_PER_MSEC, ITER_SLACK_US,
+                   "last iteration %u us", after.last_us);
+    zassert_true(after.max_us >= after.last_us);
+}
+
+ZTEST(app_health, test_spinning_stall_reported_once) {
+
+    struct app_health_stats before = health_stats();
+    struct app_msg msg;
+
+    uint32_t start = work_start(WORK_SPIN, STALL_MS);
+
+    zassert_ok(status_wait(APP_STATUS_STALL, STALL_MS, &msg), "stall not reported");
+
+    uint32_t latency = msg.timestamp_ms - start;
+
+    TC_PRINT("stall reported %u ms into the iteration (budget %u ms)\n", latency, BUDGET_MS);
+
+    zassert_true(latency > BUDGET_MS && latency <= STALL_DEADLINE_MS, "reported after %u ms",
+                 latency);
+    zassert_true(msg.data.status.value > BUDGET_MS &&
+                 msg.data.status.value <= STALL_DEADLINE_MS, "value %u ms",
+                 msg.data.status.value);
+    zassert_true(health_stats().stalled);
+
+    // The checks for the rest of the stall report nothing more
+    zassert_equal(status_wait(APP_STATUS_STALL, STALL_MS, &msg), -EAGAIN,
+                  "stall reported twice");
+    zassert_ok(k_sem_take(&done_sem, K_NO_WAIT));
+
+    struct app_health_stats after = health_stats();
+
+    zassert_equal(after.stalls - before.stalls, 1);
+    zassert_equal(after.loops - before.loops, 1);
+    zassert_within(after.last_us, STALL_MS * USEC_PER_MSEC, ITER_SLACK_US,
+                   "stalled iteration %u us", after.last_us);
+    zassert_true(after.max_us >= after.last_us);
+
+    // The next iteration clears the flag
+    work_start(WORK_SLEEP, 1);
+    zassert_ok(k_sem_take(&done_sem, K_MSEC(BUDGET_MS)));
+    zassert_false(health_stats().stalled);
+}
+
+ZTEST(app_health, test_blocked_stall_reported_once) {
+
+    struct app_health_stats before = health_stats();
+    struct app_msg msg;
+
+    // The worker waits inside its iteration on a resource nobody releases
+    uint32_t start = work_start(WORK_BLOCK, 0);
+
+    zassert_ok(status_wait(APP_STATUS_STALL, STALL_MS, &msg), "stall not reported");
+    zassert_true(msg.timestamp_ms - start <= STALL_DEADLINE_MS, "reported after %u ms",
+                 msg.timestamp_ms - start);
+
+    zassert_equal(status_wait(APP_STATUS_STALL, STALL_MS, &msg), -EAGAIN,
+                  "stall reported twice");
+
+    k_sem_give(&resource_sem);
+    zassert_ok(k_sem_take(&done_sem, K_MSEC(BUDGET_MS)));
+
+    struct app_health_stats after = health_stats();
+
+    zassert_equal(after.stalls - before.stalls, 1);
+    // Blocked past the budget and then for the whole time the test held the resource
+    zassert_true(after.last_us >= (BUDGET_MS + STALL_MS) * USEC_PER_MSEC,
+                 "blocked iteration %u us", after.last_us);
+}
+
+ZTEST(app_health, test_periodic_report) {
+
+    struct app_msg msg;
+
+    zassert_ok(status_wait(APP_STATUS_HEALTH,
+                           CONFIG_APP_HEALTH_REPORT_INTERVAL_S * MSEC_PER_SEC + 2 * CHECK_MS,
+                           &msg),
+               "no periodic report");
+
+    struct app_health_stats st = health_stats();
+
+    TC_PRINT("stack %u bytes, %u unused; longest iteration %u us\n", st.stack_size,
+             msg.data.status.arg, msg.data.status.value);
+
+    // No iteration ran meanwhile, so the report carries the current maximum
+    zassert_equal(msg.data.status.value, st.max_us);
+
+    zassert_true(st.stack_size >= WORKER_STACK_SIZE, "stack size %u", st.stack_size);
+    zassert_true(msg.data.status.arg > 0 && msg.data.status.arg < st.stack_size,
+                 "unused stack %u bytes", msg.data.status.arg);
+    zassert_true(st.stack_unused > 0 && st.stack_unused < st.stack_size);
+
+    zassert_equal(app_health_stats_get(UINT16_MAX, &st), -ENOENT);
+}
+
+ZTEST_SUITE(app_health, NULL, health_setup, health_before, NULL, NULL);
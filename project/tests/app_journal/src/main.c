@@ -0,0 +1,427 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <app/app_journal.h>
+#include <app/app_msg.h>
+
+/*
+Journal encoding through the public reader:
+Every test reads the journal back as the BLE download does, in small odd-sized chunks,
+and decodes the stream with a decoder written from the format description in
+app_journal.h. Records must come back with their kind, argument, payload and absolute
+uptime, including the varint edge cases, after the RAM ring overwrote its oldest records,
+and after a download released only what its snapshot covered.
+*/
+
+// Stream bytes read per app_journal_read() call: odd, so reads straddle records
+#define READ_CHUNK 7
+
+// Records remembered by a test; the overflow test writes this many
+#define MAX_RECORDS 256
+
+#define RING_SIZE CONFIG_APP_JOURNAL_RAM_SIZE
+
+// One decoded (or expected) record
+struct jrec {
+    uint8_t kind;
+    uint8_t arg;
+    uint32_t payload;
+    uint32_t ms;        // absolute uptime
+};
+
+// One RAM segment at most, plus room for the last, short read
+static uint8_t stream[sizeof(uint16_t) + 4 + RING_SIZE + READ_CHUNK];
+static struct jrec got[MAX_RECORDS];
+static struct jrec want[MAX_RECORDS];
+static size_t want_n;
+static uint32_t last_ms;    // time of the newest record before the test's first one
+
+/**
+ * @brief Decode one varint of the stream
+ *
+ * @param buf Stream
+ * @param pos In: offset of the varint, out: offset after it
+ * @param end End of the segment
+ * @return Value
+ */
+static uint32_t varint_get(const uint8_t *buf, size_t *pos, size_t end) {
+
+    uint32_t v = 0;
+    uint8_t b;
+
+    for (int shift = 0;; shift += 7) {
+        zassert_true(*pos < end && shift < 35, "varint runs past its segment");
+        b = buf[(*pos)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            return v;
+        }
+    }
+}
+
+/**
+ * @brief Decode a journal stream into records with absolute times
+ *
+ * @param buf Stream: segments, each a u16 LE length, a u32 LE base time and records
+ * @param len Stream length
+ * @param out Decoded records
+ * @param max Capacity of out
+ * @return Number of records
+ */
+static size_t journal_decode(const uint8_t *buf, size_t len, struct jrec *out, size_t max) {
+
+    size_t pos = 0;
+    size_t n = 0;
+
+    while (pos < len) {
+        zassert_true(pos + sizeof(uint16_t) <= len, "truncated segment length");
+
+        size_t end = pos + sizeof(uint16_t) + sys_get_le16(&buf[pos]);
+
+        pos += sizeof(uint16_t);
+        zassert_true(end <= len && end - pos >= 4, "segment runs past the stream");
+
+        uint32_t ms = sys_get_le32(&buf[pos]);
+
+        pos += 4;
+
+        while (pos < end) {
+            uint8_t hdr = buf[pos++];
+            uint8_t kind = hdr >> 5;
+
+            if (kind == APP_JOURNAL_PAD) {
+                continue;
+            }
+
+            zassert_true(n < max, "more than %zu records", max);
+
+            ms += varint_get(buf, &pos, end);
+            out[n].kind = kind;
+            out[n].arg = hdr & 0x1F;
+            out[n].ms = ms;
+            out[n].payload = (kind == APP_JOURNAL_COMMAND || kind == APP_JOURNAL_DROP) ?
+                             varint_get(buf, &pos, end) : 0;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief Read the whole journal in READ_CHUNK pieces
+ *
+ * @param commit true to release what was read, as after a complete download
+ * @return Stream length
+ */
+static size_t journal_dump(bool commit) {
+
+    struct app_journal_reader rd;
+    size_t len = 0;
+    size_t n;
+
+    zassert_ok(app_journal_open(&rd));
+
+    do {
+        zassert_true(sizeof(stream) - len >= READ_CHUNK, "stream longer than %zu bytes",
+                     sizeof(stream) - READ_CHUNK);
+        n = app_journal_read(&rd, &stream[len], READ_CHUNK);
+        len += n;
+    } while (n == READ_CHUNK);
+
+    app_journal_close(&rd, commit);
+
+    return len;
+}
+
+/**
+ * @brief Read the journal and decode it
+ *
+ * @param commit true to release what was read
+ * @return Number of records, in got[]
+ */
+static size_t journal_records(bool commit) {
+    return journal_decode(stream, journal_dump(commit), got, ARRAY_SIZE(got));
+}
+
+/**
+ * @brief Encoded size of an unsigned LEB128 varint
+ *
+ * @param v Value
+ * @return Bytes
+ */
+static uint32_t varint_len(uint32_t v) {
+
+    uint32_t n = 1;
+
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Remember a record the journal should now hold, stamped with the current uptime
+ *
+ * @param kind Record kind
+ * @param arg Kind argument
+ * @param payload Payload (COMMAND and DROP)
+ */
+static void expect(uint8_t kind, uint8_t arg, uint32_t payload) {
+
+    zassert_true(want_n < ARRAY_SIZE(want));
+    want[want_n++] = (struct jrec){ kind, arg, payload, k_uptime_get_32() };
+}
+
+/**
+ * @brief Encoded size of the expected records from one on
+ *
+ * @param first Index of the first record counted
+ * @return Bytes
+ */
+static uint32_t want_bytes(size_t first) {
+
+    uint32_t prev_ms = (first == 0) ? last_ms : want[first - 1].ms;
+    uint32_t bytes = 0;
+
+    for (size_t i = first; i < want_n; i++) {
+        bool payload = (want[i].kind == APP_JOURNAL_COMMAND || want[i].kind == APP_JOURNAL_DROP);
+
+        bytes += 1 + varint_len(want[i].ms - prev_ms) + (payload ? varint_len(want[i].payload) : 0);
+        prev_ms = want[i].ms;
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Check decoded records against the last expected ones
+ *
+ * @param n Number of decoded records
+ */
+static void assert_records(size_t n) {
+
+    zassert_true(n <= want_n, "%zu records read, %zu written", n, want_n);
+
+    const struct jrec *w = &want[want_n - n];
+
+    for (size_t i = 0; i < n; i++) {
+        zassert_equal(got[i].kind, w[i].kind, "record %zu kind", i);
+        zassert_equal(got[i].arg, w[i].arg, "record %zu argument", i);
+        zassert_equal(got[i].payload, w[i].payload, "record %zu payload", i);
+        zassert_equal(got[i].ms, w[i].ms, "record %zu at %u ms, written at %u ms", i,
+                      got[i].ms, w[i].ms);
+    }
+}
+
+/**
+ * @brief Journal a button event as the bus does
+ *
+ * @param id Button id
+ * @param pressed Button level
+ */
+static void button(uint8_t id, bool pressed) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_BUTTON_EVENT;
+    msg.source = APP_SRC_SENSOR;
+    msg.data.button.button_id = id;
+    msg.data.button.pressed = pressed;
+
+    expect(APP_JOURNAL_BUTTON, (id << 1) | pressed, 0);
+    app_journal_bus(&msg);
+}
+
+/**
+ * @brief Journal a command as the bus does
+ *
+ * @param source Publisher
+ * @param id Command id
+ * @param value Command value
+ */
+static void command(enum app_msg_source source, uint8_t id, uint32_t value) {
+
+    struct app_msg msg = {0};
+
+    msg.type = APP_MSG_COMMAND;
+    msg.source = source;
+    msg.data.command.command_id = id;
+    msg.data.command.value = value;
+
+    if (source != APP_SRC_CONTROLLER) {
+        expect(APP_JOURNAL_COMMAND, id, value);
+    }
+    app_journal_bus(&msg);
+}
+
+static void *journal_setup(void) {
+
+    // The first record since boot marks the reset
+    size_t n = journal_records(true);
+
+    zassert_true(n >= 1);
+    zassert_equal(got[0].kind, APP_JOURNAL_BOOT);
+
+    return NULL;
+}
+
+// Every test starts on an empty journal, one known record time after the last record
+static void journal_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    app_journal_mode(APP_MODE_IDLE);
+    last_ms = k_uptime_get_32();
+    (void)journal_dump(true);
+    want_n = 0;
+}
+
+ZTEST(app_journal, test_round_trip) {
+
+    struct app_journal_stats before;
+    struct app_journal_stats after;
+    app_journal_stats_get(&before);
+
+    // Deltas and payloads on both sides of every varint length step
+    button(3, true);
+    k_msleep(127);
+    button(3, false);
+    k_msleep(128);
+    command(APP_SRC_COMMS, 5, 0);
+    command(APP_SRC_CONTROLLER, 1, 3);     // derived by the controller: not journaled
+    command(APP_SRC_COMMS, 6, 127);
+    command(APP_SRC_COMMS, 6, 128);
+    command(APP_SRC_COMMS, 31, UINT32_MAX);
+
+    // Lost deliveries are folded into one DROP record per source, before the next record
+    for (int i = 0; i < 3; i++) {
+        app_journal_drop(APP_JOURNAL_DROP_BUS);
+    }
+    app_journal_drop(APP_JOURNAL_DROP_BLE_TX);
+    app_journal_drop(APP_JOURNAL_DROP_SRC_COUNT);     // unknown source: ignored
+
+    k_msleep(20000);
+    expect(APP_JOURNAL_DROP, APP_JOURNAL_DROP_BUS, 3);
+    expect(APP_JOURNAL_DROP, APP_JOURNAL_DROP_BLE_TX, 1);
+    expect(APP_JOURNAL_MODE, 2, 0);
+    app_journal_mode(2);
+
+    button(15, true);
+
+    app_journal_stats_get(&after);
+    zassert_equal(after.records - before.records, want_n);
+    zassert_equal(after.bytes - before.bytes, want_bytes(0));
+    zassert_equal(after.ram_used, want_bytes(0));
+
+    // One RAM segment: length, base time, records
+    size_t len = journal_dump(false);
+
+    zassert_equal(len, sizeof(uint16_t) + 4 + want_bytes(0));
+    zassert_equal(journal_decode(stream, len, got, ARRAY_SIZE(got)), want_n);
+    assert_records(want_n);
+}
+
+ZTEST(app_journal, test_overflow_keeps_absolute_times) {
+
+    struct app_journal_stats before;
+    struct app_journal_stats after;
+
+    app_journal_stats_get(&before);
+
+    // Well over the ring size, with one- and two-byte deltas
+    for (int i = 0; i < MAX_RECORDS; i++) {
+        k_msleep(1 + (i * 37) % 300);
+        button(i % 16, i & 1);
+    }
+
+    app_journal_stats_get(&after);
+
+    uint32_t overwritten = after.overwritten - before.overwritten;
+
+    zassert_true(overwritten > 0, "the ring never overflowed");
+    zassert_true(after.ram_used <= RING_SIZE);
+
+    // The newest records survive, still at the uptimes they were written
+    size_t n = journal_records(false);
+
+    TC_PRINT("%u records written, %zu kept in %u bytes, %u overwritten\n", MAX_RECORDS, n,
+             after.ram_used, overwritten);
+
+    zassert_equal(n + overwritten, MAX_RECORDS);
+    assert_records(n);
+}
+
+ZTEST(app_journal, test_commit_releases_only_the_snapshot) {
+
+    struct app_journal_reader rd;
+    struct app_journal_stats st;
+    uint8_t tmp[16];
+
+    button(1, true);
+    k_msleep(10);
+    button(1, false);
+
+    zassert_ok(app_journal_open(&rd));
+    zassert_equal(app_journal_open(&rd), -EBUSY, "second reader opened");
+    zassert_true(app_journal_read(&rd, tmp, sizeof(tmp)) > 0);
+
+    // Written while the download runs: not in the snapshot, kept by the commit
+    k_msleep(300);
+    button(2, true);
+    k_msleep(5);
+    command(APP_SRC_COMMS, 4, 1000);
+
+    app_journal_close(&rd, true);
+
+    app_journal_stats_get(&st);
+    zassert_equal(st.ram_used, want_bytes(2));
+
+    // The released records' deltas moved into the base time
+    zassert_equal(journal_records(false), 2);
+    assert_records(2);
+}
+
+ZTEST(app_journal, test_abort_keeps_records) {
+
+    struct app_journal_reader rd;
+
+    button(0, true);
+    command(APP_SRC_COMMS, 2, 0x0101);
+
+    zassert_ok(app_journal_open(&rd));
+    app_journal_close(&rd, false);
+
+    zassert_equal(journal_records(false), 2);
+    assert_records(2);
+}
+
+ZTEST(app_journal, test_bytes_per_button_event) {
+
+    struct app_journal_stats before;
+    struct app_journal_stats after;
+
+    app_journal_stats_get(&before);
+
+    // Button edges 10 ms apart: a header and a one-byte delta each
+    for (int i = 0; i < 1000; i++) {
+        k_msleep(10);
+        button(i % 4, i & 1);
+        want_n = 0;
+    }
+
+    app_journal_stats_get(&after);
+
+    uint32_t records = after.records - before.records;
+    uint32_t x100 = (after.bytes - before.bytes) * 100 / records;
+
+    TC_PRINT("%u button events: %u.%02u bytes per event\n", records, x100 / 100, x100 % 100);
+
+    zassert_equal(records, 1000);
+    zassert_equal(x100, 200);
+}
+
+ZTEST_SUITE(app_journal, NULL, journal_setup, journal_before, NULL, NULL);
@@ -0,0 +1,173 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_msg.h>
+#include <app/app_pm.h>
+
+/*
+Power manager wake statistics and budgets:
+The idle and interrupt tracing hooks (CONFIG_APP_PM_WAKE_STATS) count CPU idle entries
+and idle time. With no inputs the manager must not wake the system: over a quiet window
+the wake rate stays near zero and the CPU spends nearly all of it idle. The budget follows
+the mode, the busy sources and the activity timeout. native_sim has no PM states, so
+per-state residency (state_ms) stays empty here and idle time is the residency checked.
+*/
+
+// Quiet window of the wake-rate tests; a single sleep of the test thread
+#define QUIET_MS 2000
+
+// Idle entries accepted over the quiet window: the sleep itself, and one spare
+#define QUIET_ENTRIES_MAX 2
+
+// Idle time accepted over the quiet window, percent
+#define IDLE_PCT_MIN 95
+
+// Longest time the work item may take to apply an input
+#define SETTLE_MS 100
+
+/**
+ * @brief Wait for the work item to apply pending inputs and read the counters
+ *
+ * @param st Counters
+ * @param budget Budget the inputs lead to
+ */
+static void stats_settled(struct app_pm_stats *st, uint8_t budget) {
+
+    for (int ms = 0; ms < SETTLE_MS; ms++) {
+        k_msleep(1);
+        app_pm_stats_get(st);
+        if (st->budget == budget) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Sleep through a quiet window and check the wake rate and idle time over it
+ *
+ * @param extra_entries Idle entries expected on top of the quiet ones (pending timers)
+ */
+static void assert_quiet_window(uint32_t extra_entries) {
+
+    struct app_pm_stats before, after;
+
+    app_pm_stats_get(&before);
+    k_msleep(QUIET_MS);
+    app_pm_stats_get(&after);
+
+    uint32_t entries = after.idle_entries - before.idle_entries;
+    uint32_t idle_ms = after.idle_ms - before.idle_ms;
+
+    TC_PRINT("%u idle entries, %u wake-ups/s, %u of %u ms idle\n", entries,
+             after.wakeups_per_s, idle_ms, QUIET_MS);
+
+    zassert_true(entries <= QUIET_ENTRIES_MAX + extra_entries, "%u idle entries", entries);
+    zassert_true(after.wakeups_per_s <= 1, "%u wake-ups/s", after.wakeups_per_s);
+    zassert_true(idle_ms * 100 >= QUIET_MS * IDLE_PCT_MIN, "%u ms idle", idle_ms);
+}
+
+// Start each test in IDLE mode, with no busy source and the activity timeout expired
+static void pm_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    app_pm_mode_set(APP_MODE_IDLE);
+    for (int i = 0; i < APP_PM_BUSY_COUNT; i++) {
+        app_pm_busy_set(i, false);
+    }
+    k_msleep(CONFIG_APP_PM_IDLE_TIMEOUT_MS + SETTLE_MS);
+}
+
+ZTEST(app_pm, test_idle_wake_rate_near_zero) {
+
+    struct app_pm_stats st;
+
+    stats_settled(&st, APP_PM_BUDGET_DEEP);
+    zassert_equal(st.budget, APP_PM_BUDGET_DEEP);
+
+    assert_quiet_window(0);
+}
+
+ZTEST(app_pm, test_activity_timeout_wakes_once) {
+
+    struct app_pm_stats st;
+
+    app_pm_activity();
+    stats_settled(&st, APP_PM_BUDGET_LIGHT);
+    zassert_equal(st.budget, APP_PM_BUDGET_LIGHT);
+
+    // The timeout expiring is the only extra wake-up; nothing re-arms afterwards
+    assert_quiet_window(1);
+
+    app_pm_stats_get(&st);
+    zassert_equal(st.budget, APP_PM_BUDGET_DEEP);
+}
+
+ZTEST(app_pm, test_budget_follows_mode) {
+
+    struct app_pm_stats st;
+
+    app_pm_mode_set(APP_MODE_ACTIVE);
+    stats_settled(&st, APP_PM_BUDGET_LIGHT);
+    zassert_equal(st.mode, APP_MODE_ACTIVE);
+    zassert_equal(st.budget, APP_PM_BUDGET_LIGHT);
+
+    app_pm_mode_set(APP_MODE_DIAG);
+    stats_settled(&st, APP_PM_BUDGET_RUN);
+    zassert_equal(st.budget, APP_PM_BUDGET_RUN);
+
+    app_pm_mode_set(APP_MODE_IDLE);
+    stats_settled(&st, APP_PM_BUDGET_DEEP);
+    zassert_equal(st.budget, APP_PM_BUDGET_DEEP);
+
+    // Out of range: ignored
+    app_pm_mode_set(APP_MODE_MAX);
+    stats_settled(&st, APP_PM_BUDGET_DEEP);
+    zassert_equal(st.mode, APP_MODE_IDLE);
+}
+
+ZTEST(app_pm, test_busy_sources_cap_budget) {
+
+    struct app_pm_stats st;
+
+    app_pm_busy_set(APP_PM_BUSY_BLE_LINK, true);
+    stats_settled(&st, APP_PM_BUDGET_LIGHT);
+    zassert_equal(st.busy, BIT(APP_PM_BUSY_BLE_LINK));
+    zassert_equal(st.budget, APP_PM_BUDGET_LIGHT);
+
+    // The shallowest budget of the set sources wins
+    app_pm_busy_set(APP_PM_BUSY_BLE_STREAM, true);
+    stats_settled(&st, APP_PM_BUDGET_RUN);
+    zassert_equal(st.budget, APP_PM_BUDGET_RUN);
+
+    app_pm_busy_set(APP_PM_BUSY_BLE_STREAM, false);
+    stats_settled(&st, APP_PM_BUDGET_LIGHT);
+    zassert_equal(st.budget, APP_PM_BUDGET_LIGHT);
+
+    app_pm_busy_set(APP_PM_BUSY_BLE_LINK, false);
+    stats_settled(&st, APP_PM_BUDGET_DEEP);
+    zassert_equal(st.busy, 0);
+    zassert_equal(st.budget, APP_PM_BUDGET_DEEP);
+}
+
+ZTEST(app_pm, test_budget_changes_counted_once) {
+
+    struct app_pm_stats before, after;
+
+    app_pm_stats_get(&before);
+
+    // Repeated inputs that leave the budget where it is count nothing
+    app_pm_busy_set(APP_PM_BUSY_LED_FX, true);
+    app_pm_busy_set(APP_PM_BUSY_LED_FX, true);
+    app_pm_mode_set(APP_MODE_ACTIVE);
+    stats_settled(&after, APP_PM_BUDGET_LIGHT);
+    zassert_equal(after.budget, APP_PM_BUDGET_LIGHT);
+    zassert_equal(after.budget_changes - before.budget_changes, 1);
+
+    app_pm_busy_set(APP_PM_BUSY_LED_FX, false);
+    app_pm_mode_set(APP_MODE_IDLE);
+    stats_settled(&after, APP_PM_BUDGET_DEEP);
+    zassert_equal(after.budget, APP_PM_BUDGET_DEEP);
+    zassert_equal(after.budget_changes - before.budget_changes, 2);
+}
+
+ZTEST_SUITE(app_pm, NULL, NULL, pm_before, NULL, NULL);
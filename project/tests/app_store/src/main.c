@@ -0,0 +1,231 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/stats/stats.h>
+#include <app/app_store.h>
+
+/*
+Persisted state on the native_sim flash simulator:
+The test registers the controller's two items and updates them as the controller does,
+with a one-second flush interval. The flash simulator's statistics count the flash
+writes settings/NVS really makes, so the press test can bound them for 10000 presses;
+the other tests check that marks coalesce and that values survive a reload.
+*/
+
+// Presses in the wear test, spread over PRESS_RUN_MS of simulated time
+#define PRESSES      10000
+#define PRESS_RUN_MS 5000
+
+#define FLUSH_MS (CONFIG_APP_STORE_FLUSH_INTERVAL_S * 1000)
+
+// Settings writes of the press counters: one per elapsed interval, plus the final flush
+#define SAVES_MAX (PRESS_RUN_MS / FLUSH_MS + 1)
+
+// Flash writes allowed for the whole run: the value and its NVS entry per save, plus one
+// sector change that copies the few live entries
+#define FLASH_WRITE_BUDGET (2 * SAVES_MAX + 16)
+
+BUILD_ASSERT(PRESS_RUN_MS >= 2 * FLUSH_MS, "the run must span several flush intervals");
+
+// Same items as the controller
+static uint32_t g_mode;
+static uint32_t g_presses[16];
+
+APP_STORE_ITEM_DEFINE(test_store_mode, "mode", g_mode);
+APP_STORE_ITEM_DEFINE(test_store_presses, "presses", g_presses);
+
+// One flash simulator counter, looked up by name
+struct flash_stat {
+    const char *name;
+    uint32_t value;
+    bool found;
+};
+
+/**
+ * @brief stats_walk() callback: copy the counter named in the lookup
+ *
+ * @param hdr Statistics group
+ * @param arg Lookup
+ * @param name Counter name
+ * @param off Counter offset in the group
+ * @return 0 to continue the walk
+ */
+static int flash_stat_cb(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off) {
+
+    struct flash_stat *st = arg;
+
+    if (strcmp(name, st->name) == 0) {
+        st->value = *(uint32_t *)((uint8_t *)hdr + off);
+        st->found = true;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Read a flash simulator counter
+ *
+ * @param name Counter name, e.g. "flash_write_calls"
+ * @return Counter value
+ */
+static uint32_t flash_stat(const char *name) {
+
+    struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+    struct flash_stat st = { .name = name };
+
+    zassert_not_null(hdr, "flash simulator statistics not registered");
+    zassert_ok(stats_walk(hdr, flash_stat_cb, &st));
+    zassert_true(st.found, "no flash simulator counter %s", name);
+
+    return st.value;
+}
+
+/**
+ * @brief Get the store counters
+ *
+ * @return Counters
+ */
+static struct app_store_stats store_stats(void) {
+
+    struct app_store_stats st;
+
+    app_store_stats_get(&st);
+
+    return st;
+}
+
+// Nothing marked and no flush pending at the start of a test
+static void store_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    zassert_ok(app_store_flush());
+}
+
+ZTEST(app_store, test_flash_writes_per_10k_presses) {
+
+    struct app_store_stats before = store_stats();
+    uint32_t writes = flash_stat("flash_write_calls");
+    uint32_t erases = flash_stat("flash_erase_calls");
+    uint32_t pressed = 0;
+
+    // Presses at a steady rate, each one counted and marked as the controller does
+    for (uint32_t ms = 1; ms <= PRESS_RUN_MS; ms++) {
+        for (; pressed < (uint64_t)PRESSES * ms / PRESS_RUN_MS; pressed++) {
+            g_presses[pressed % ARRAY_SIZE(g_presses)]++;
+            APP_STORE_MARK(test_store_presses);
+        }
+        k_msleep(1);
+    }
+
+    // Last changes reach flash one interval after they were made
+    k_msleep(FLUSH_MS + 100);
+
+    struct app_store_stats after = store_stats();
+
+    writes = flash_stat("flash_write_calls") - writes;
+    erases = flash_stat("flash_erase_calls") - erases;
+
+    TC_PRINT("%u presses: %u flushes, %u settings writes, %u flash writes, %u erases\n",
+             PRESSES, after.flushes - before.flushes, after.writes - before.writes, writes, erases);
+
+    zassert_equal(after.marks - before.marks, PRESSES);
+    zassert_equal(after.errors, before.errors);
+
+    // The counters were written once per interval while the presses went on, not held back
+    uint32_t saves = after.writes - before.writes;
+
+    zassert_true(saves >= PRESS_RUN_MS / FLUSH_MS && saves <= SAVES_MAX, "%u settings writes",
+                 saves);
+    zassert_true(writes <= FLASH_WRITE_BUDGET, "%u flash writes for %u presses", writes,
+                 PRESSES);
+}
+
+ZTEST(app_store, test_marks_coalesce_until_the_interval) {
+
+    struct app_store_stats before = store_stats();
+
+    // A mark every 100 ms: later marks must not push the first deadline back
+    for (int n = 0; n < 15; n++) {
+        g_presses[0]++;
+        APP_STORE_MARK(test_store_presses);
+
+        if (n == 9) {
+            // Just before the deadline of the first mark: nothing written yet
+            zassert_equal(store_stats().writes, before.writes, "written before the interval");
+        }
+        k_msleep(100);
+    }
+
+    zassert_equal(store_stats().writes - before.writes, 1, "deadline moved by later marks");
+
+    // The marks after that flush are written one interval after the first of them
+    k_msleep(FLUSH_MS);
+    zassert_equal(store_stats().writes - before.writes, 2);
+    zassert_equal(store_stats().flushes - before.flushes, 2);
+}
+
+ZTEST(app_store, test_values_survive_reload) {
+
+    uint32_t expected[ARRAY_SIZE(g_presses)];
+    struct app_store_stats before = store_stats();
+
+    for (int i = 0; i < ARRAY_SIZE(g_presses); i++) {
+        g_presses[i] = 1000 + 7 * i;
+    }
+    g_mode = 2;
+    memcpy(expected, g_presses, sizeof(expected));
+
+    APP_STORE_MARK(test_store_mode);
+    APP_STORE_MARK(test_store_presses);
+    zassert_ok(app_store_flush());
+    zassert_equal(store_stats().writes - before.writes, 2);
+
+    // With nothing marked, a flush touches neither settings nor flash
+    uint32_t writes = flash_stat("flash_write_calls");
+
+    zassert_ok(app_store_flush());
+    zassert_equal(store_stats().writes - before.writes, 2);
+    zassert_equal(flash_stat("flash_write_calls"), writes);
+
+    // Load as app_store_init() does at boot
+    memset(g_presses, 0, sizeof(g_presses));
+    g_mode = 0;
+
+    zassert_ok(settings_load_subtree("app"));
+    zassert_equal(store_stats().restored - before.restored, 2);
+    zassert_equal(g_mode, 2);
+    zassert_mem_equal(g_presses, expected, sizeof(expected));
+}
+
+ZTEST(app_store, test_stored_size_mismatch_keeps_default) {
+
+    uint32_t defaults[ARRAY_SIZE(g_presses)];
+    uint16_t old_layout = 5;
+
+    // Counters saved by a firmware with another layout
+    zassert_ok(settings_save_one("app/presses", &old_layout, sizeof(old_layout)));
+
+    for (int i = 0; i < ARRAY_SIZE(g_presses); i++) {
+        g_presses[i] = i;
+    }
+    memcpy(defaults, g_presses, sizeof(defaults));
+
+    struct app_store_stats before = store_stats();
+
+    zassert_ok(settings_load_subtree("app"));
+    zassert_equal(store_stats().errors - before.errors, 1);
+    zassert_mem_equal(g_presses, defaults, sizeof(defaults));
+
+    // The next flush replaces the stale value
+    APP_STORE_MARK(test_store_presses);
+    zassert_ok(app_store_flush());
+
+    before = store_stats();
+    zassert_ok(settings_load_subtree("app"));
+    zassert_equal(store_stats().errors, before.errors);
+    zassert_mem_equal(g_presses, defaults, sizeof(defaults));
+}
+
+ZTEST_SUITE(app_store, NULL, NULL, store_before, NULL, NULL);
@@ -0,0 +1,170 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_buf.h>
+#include <app/app_bus.h>
+
+#include "host_clock.h"
+
+/*
+Copy vs zero-copy payloads:
+The copy path moves each payload through a k_msgq item of the same size, as a bus queue
+carrying the payload inline would (one memcpy in, one out). The zero-copy path fills an
+app_buf in place and publishes only its pointer on the bus. Both paths fill the payload
+and read it back, so the difference is the cost of moving it.
+*/
+
+// Messages per payload size
+#define BENCH_MSGS 20000
+
+// Messages queued before they are read back; stays below the buffer pool size
+#define BENCH_DEPTH 8
+
+BUILD_ASSERT(BENCH_DEPTH <= APP_BUF_COUNT, "benchmark depth exceeds the buffer pool");
+
+static const uint16_t sizes[] = { 8, 16, 32, 64, 128, 256 };
+
+APP_BUS_SUBSCRIBER_DEFINE(sub_data, BENCH_DEPTH, APP_BUS_TYPE(APP_MSG_DATA),
+                          APP_BUS_SRC(APP_SRC_SAMPLER), 0);
+
+static struct k_msgq copy_q;
+static char __aligned(4) copy_q_buf[BENCH_DEPTH * APP_BUF_SIZE];
+
+/**
+ * @brief Fill a payload with a pattern derived from its sequence number
+ *
+ * @param dst Payload
+ * @param len Payload length
+ * @param seq Sequence number
+ */
+static void fill(uint8_t *dst, uint16_t len, uint32_t seq) {
+    memset(dst, (uint8_t)seq, len);
+}
+
+/**
+ * @brief Read a payload back, as a consumer would
+ *
+ * @param src Payload
+ * @param len Payload length
+ * @return Sum of the payload bytes
+ */
+static uint32_t consume(const uint8_t *src, uint16_t len) {
+
+    uint32_t sum = 0;
+
+    for (uint16_t i = 0; i < len; i++) {
+        sum += src[i];
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Move BENCH_MSGS payloads through a copying message queue
+ *
+ * @param len Payload length (the queue item size)
+ * @param sum Incremented by every byte read back
+ * @return Nanoseconds per message
+ */
+static uint32_t run_copy(uint16_t len, uint64_t *sum) {
+
+    uint8_t in[APP_BUF_SIZE];
+    uint8_t out[APP_BUF_SIZE];
+
+    k_msgq_init(&copy_q, copy_q_buf, len, BENCH_DEPTH);
+
+    uint64_t start = host_clock_ns();
+
+    for (uint32_t seq = 0; seq < BENCH_MSGS; seq += BENCH_DEPTH) {
+        for (uint32_t i = 0; i < BENCH_DEPTH; i++) {
+            fill(in, len, seq + i);
+            zassert_ok(k_msgq_put(&copy_q, in, K_NO_WAIT));
+        }
+        for (uint32_t i = 0; i < BENCH_DEPTH; i++) {
+            zassert_ok(k_msgq_get(&copy_q, out, K_NO_WAIT));
+            *sum += consume(out, len);
+        }
+    }
+
+    return (uint32_t)((host_clock_ns() - start) / BENCH_MSGS);
+}
+
+/**
+ * @brief Move BENCH_MSGS payloads through the bus as app_buf pointers
+ *
+ * @param len Payload length
+ * @param sum Incremented by every byte read back
+ * @return Nanoseconds per message
+ */
+static uint32_t run_zero_copy(uint16_t len, uint64_t *sum) {
+
+    struct app_msg msg;
+
+    uint64_t start = host_clock_ns();
+
+    for (uint32_t seq = 0; seq < BENCH_MSGS; seq += BENCH_DEPTH) {
+        for (uint32_t i = 0; i < BENCH_DEPTH; i++) {
+            struct app_buf *buf = app_buf_alloc(K_NO_WAIT);
+
+            zassert_not_null(buf, "pool exhausted at message %u", seq + i);
+            fill(buf->data, len, seq + i);
+            buf->len = len;
+            zassert_ok(app_bus_publish_buf(APP_SRC_SAMPLER, buf));
+        }
+        for (uint32_t i = 0; i < BENCH_DEPTH; i++) {
+            zassert_ok(app_bus_sub_get(&sub_data, &msg, K_NO_WAIT));
+            *sum += consume(msg.data.block.buf->data, msg.data.block.buf->len);
+            app_bus_msg_release(&msg);
+        }
+    }
+
+    return (uint32_t)((host_clock_ns() - start) / BENCH_MSGS);
+}
+
+/**
+ * @brief Expected byte sum of BENCH_MSGS payloads of one size
+ *
+ * @param len Payload length
+ * @return Sum of all bytes filled
+ */
+static uint64_t expected_sum(uint16_t len) {
+
+    uint64_t sum = 0;
+
+    for (uint32_t seq = 0; seq < BENCH_MSGS; seq++) {
+        sum += (uint64_t)(uint8_t)seq * len;
+    }
+
+    return sum;
+}
+
+static void *bus_payload_setup(void) {
+
+    zassert_ok(app_bus_subscribe(&sub_data));
+
+    return NULL;
+}
+
+ZTEST(bus_payload, test_copy_vs_zero_copy) {
+
+    TC_PRINT("payload  copy ns/msg  zero-copy ns/msg\n");
+
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+        uint64_t copy_sum = 0;
+        uint64_t zc_sum = 0;
+
+        uint32_t copy_ns = run_copy(sizes[i], &copy_sum);
+        uint32_t zc_ns = run_zero_copy(sizes[i], &zc_sum);
+
+        TC_PRINT("%7u  %11u  %16u\n", sizes[i], copy_ns, zc_ns);
+
+        // Both paths delivered every payload intact
+        zassert_equal(copy_sum, expected_sum(sizes[i]));
+        zassert_equal(zc_sum, expected_sum(sizes[i]));
+
+        // Every reference was released: the whole pool is back
+        zassert_equal(app_buf_free_count(), APP_BUF_COUNT, "buffers leaked at %u bytes",
+                      sizes[i]);
+    }
+}
+
+ZTEST_SUITE(bus_payload, NULL, bus_payload_setup, NULL, NULL, NULL);
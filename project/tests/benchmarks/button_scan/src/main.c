@@ -0,0 +1,179 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "host_clock.h"
+
+/*
+Per-pin vs port-wide button scans:
+The per-pin loop is the sensor module's former polling scan: one gpio_pin_get_dt() per
+button compared with its last level. The port scan is what it does now: one
+gpio_port_get_raw() per port, active-low pins flipped with a precomputed mask and every
+change found with one XOR. Inputs are the emulated GPIO controller's pins, changed
+between scans with gpio_emul.
+*/
+
+#define GPIO_NODE DT_NODELABEL(gpio0)
+
+// Scans per measurement
+#define BENCH_SCANS 20000
+
+// Largest input count measured: a full 32-pin port
+#define MAX_INPUTS 32
+
+static const struct device *const gpio_dev = DEVICE_DT_GET(GPIO_NODE);
+
+static struct gpio_dt_spec specs[MAX_INPUTS];
+
+static const int input_counts[] = { 4, 8, 16, 32 };
+
+/**
+ * @brief Next pseudo-random input pattern (xorshift32)
+ *
+ * @param state Generator state
+ * @return Pattern
+ */
+static uint32_t next_pattern(uint32_t *state) {
+
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+/**
+ * @brief Pin mask of the first `n` inputs
+ *
+ * @param n Input count
+ * @return Mask
+ */
+static gpio_port_pins_t inputs_mask(int n) {
+    return (n >= 32) ? UINT32_MAX : (BIT(n) - 1);
+}
+
+/**
+ * @brief Scan `n` inputs one pin at a time
+ *
+ * @param n Input count
+ * @param last Last logical level per input, updated
+ * @return Number of inputs that changed
+ */
+static uint32_t scan_per_pin(int n, int *last) {
+
+    uint32_t changes = 0;
+
+    for (int i = 0; i < n; i++) {
+        int cur = gpio_pin_get_dt(&specs[i]);
+
+        if (cur != last[i]) {
+            last[i] = cur;
+            changes++;
+        }
+    }
+
+    return changes;
+}
+
+/**
+ * @brief Scan `n` inputs with one port read
+ *
+ * @param mask Pins used as inputs
+ * @param active_low Pins flagged active-low
+ * @param last Last logical levels, updated
+ * @return Number of inputs that changed
+ */
+static uint32_t scan_port(gpio_port_pins_t mask, gpio_port_pins_t active_low,
+                          gpio_port_value_t *last) {
+
+    gpio_port_value_t raw;
+
+    if (gpio_port_get_raw(gpio_dev, &raw) != 0) {
+        return 0;
+    }
+
+    gpio_port_value_t cur = (raw ^ active_low) & mask;
+    gpio_port_pins_t changed = cur ^ *last;
+
+    *last = cur;
+
+    return popcount(changed);
+}
+
+static void *button_scan_setup(void) {
+
+    zassert_true(device_is_ready(gpio_dev));
+
+    // Alternate active-low and active-high inputs so both flag paths are exercised
+    for (int i = 0; i < MAX_INPUTS; i++) {
+        specs[i].port = gpio_dev;
+        specs[i].pin = i;
+        specs[i].dt_flags = (i & 1) ? GPIO_ACTIVE_LOW : GPIO_ACTIVE_HIGH;
+        zassert_ok(gpio_pin_configure_dt(&specs[i], GPIO_INPUT));
+    }
+
+    return NULL;
+}
+
+ZTEST(button_scan, test_per_pin_vs_port) {
+
+    TC_PRINT("inputs  per-pin ns/scan  port ns/scan\n");
+
+    for (size_t c = 0; c < ARRAY_SIZE(input_counts); c++) {
+        int n = input_counts[c];
+        gpio_port_pins_t mask = inputs_mask(n);
+        gpio_port_pins_t active_low = 0xAAAAAAAAu & mask;
+
+        int last_pin[MAX_INPUTS];
+        gpio_port_value_t last_port;
+        uint64_t pin_ns = 0;
+        uint64_t port_ns = 0;
+        uint32_t pin_changes = 0;
+        uint32_t port_changes = 0;
+        uint32_t rng = 0x12345678u;
+
+        // Same starting snapshot for both scanners
+        zassert_ok(gpio_emul_input_set_masked(gpio_dev, mask, 0));
+        for (int i = 0; i < n; i++) {
+            last_pin[i] = gpio_pin_get_dt(&specs[i]);
+        }
+        last_port = active_low;
+
+        for (uint32_t s = 0; s < BENCH_SCANS; s++) {
+
+            // Flip a few inputs between scans, as real buttons do
+            uint32_t flips = next_pattern(&rng) & next_pattern(&rng) & mask;
+            gpio_port_value_t raw;
+
+            zassert_ok(gpio_port_get_raw(gpio_dev, &raw));
+            zassert_ok(gpio_emul_input_set_masked(gpio_dev, mask, raw ^ flips));
+
+            uint64_t t0 = host_clock_ns();
+
+            pin_changes += scan_per_pin(n, last_pin);
+
+            uint64_t t1 = host_clock_ns();
+
+            port_changes += scan_port(mask, active_low, &last_port);
+
+            uint64_t t2 = host_clock_ns();
+
+            pin_ns += t1 - t0;
+            port_ns += t2 - t1;
+        }
+
+        TC_PRINT("%6d  %15u  %12u\n", n, (uint32_t)(pin_ns / BENCH_SCANS),
+                 (uint32_t)(port_ns / BENCH_SCANS));
+
+        // Both scanners saw exactly the same edges
+        zassert_equal(pin_changes, port_changes, "%d inputs: per-pin %u, port %u changes",
+                      n, pin_changes, port_changes);
+        zassert_true(pin_changes > 0);
+    }
+}
+
+ZTEST_SUITE(button_scan, NULL, button_scan_setup, NULL, NULL, NULL);
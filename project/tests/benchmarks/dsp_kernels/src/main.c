@@ -0,0 +1,179 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/dsp.h>
+
+#include "host_clock.h"
+
+/*
+DSP kernel cost per sampler block:
+Each kernel runs BENCH_BLOCKS times over a block of noise, as the feature stage calls it:
+the FIR/decimator for the configurable tap counts, the DC-blocking biquad, the window
+statistics, and the band energy transform for each supported length. "chain" is one
+block through the whole per-axis path (high-pass, low-pass/decimation, statistics).
+On native_sim this times the portable C kernels.
+*/
+
+// Blocks per measurement
+#define BENCH_BLOCKS 2000
+
+// Samples per block, about one sampler block
+#define BENCH_BLOCK 128
+
+#define BENCH_FACTOR 4
+#define MAX_TAPS     64
+
+static const uint16_t tap_counts[] = { 8, 16, 32, 64 };
+static const uint16_t fft_lens[] = { 32, 64, 128 };
+
+static int16_t in[BENCH_BLOCK];
+static int16_t work[BENCH_BLOCK];
+static int16_t fir_coeffs[MAX_TAPS];
+static int16_t fir_state[DSP_FIR_STATE_LEN(MAX_TAPS, BENCH_BLOCK)];
+static int16_t hp_coeffs[DSP_BIQUAD_COEFFS];
+static int16_t hp_state[DSP_BIQUAD_STATE_LEN(1)];
+
+// Folds every result in, so no kernel call is optimised away
+static volatile int64_t sink;
+
+/**
+ * @brief Print one result line
+ *
+ * @param label Kernel
+ * @param ns Nanoseconds per block
+ */
+static void report(const char *label, uint64_t ns) {
+    TC_PRINT("%-18s %8u ns/block %6u ns/sample\n", label, (uint32_t)ns,
+             (uint32_t)(ns / BENCH_BLOCK));
+}
+
+static void *dsp_bench_setup(void) {
+
+    uint32_t rng = 0x13579BDFu;
+
+    // Noise around a DC offset, as raw accelerometer samples
+    for (int i = 0; i < BENCH_BLOCK; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        in[i] = 4000 + (int16_t)(rng % 16001) - 8000;
+    }
+
+    dsp_biquad_design_highpass(hp_coeffs, 1000, 10);
+
+    return NULL;
+}
+
+ZTEST(dsp_bench, test_fir_decimate) {
+
+    struct dsp_fir f;
+
+    for (size_t i = 0; i < ARRAY_SIZE(tap_counts); i++) {
+        char label[24];
+
+        dsp_fir_design_lowpass(fir_coeffs, tap_counts[i], BENCH_FACTOR);
+        zassert_ok(dsp_fir_init(&f, fir_coeffs, tap_counts[i], BENCH_FACTOR, fir_state,
+                                BENCH_BLOCK));
+
+        uint64_t start = host_clock_ns();
+
+        for (int n = 0; n < BENCH_BLOCKS; n++) {
+            zassert_equal(dsp_fir_run(&f, in, work, BENCH_BLOCK), BENCH_BLOCK / BENCH_FACTOR);
+            sink += work[0];
+        }
+
+        snprintk(label, sizeof(label), "fir %u taps /%u", tap_counts[i], BENCH_FACTOR);
+        report(label, (host_clock_ns() - start) / BENCH_BLOCKS);
+    }
+}
+
+ZTEST(dsp_bench, test_biquad_and_statistics) {
+
+    struct dsp_biquad b;
+    uint64_t start;
+    int16_t prev = 0;
+
+    zassert_ok(dsp_biquad_init(&b, hp_coeffs, 1, 1, hp_state));
+
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_BLOCKS; n++) {
+        dsp_biquad_run(&b, in, work, BENCH_BLOCK);
+        sink += work[0];
+    }
+    report("biquad highpass", (host_clock_ns() - start) / BENCH_BLOCKS);
+
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_BLOCKS; n++) {
+        sink += dsp_power(in, BENCH_BLOCK);
+    }
+    report("power", (host_clock_ns() - start) / BENCH_BLOCKS);
+
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_BLOCKS; n++) {
+        sink += dsp_peak(in, BENCH_BLOCK);
+    }
+    report("peak", (host_clock_ns() - start) / BENCH_BLOCKS);
+
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_BLOCKS; n++) {
+        sink += dsp_zero_crossings(in, BENCH_BLOCK, &prev);
+    }
+    report("zero crossings", (host_clock_ns() - start) / BENCH_BLOCKS);
+}
+
+ZTEST(dsp_bench, test_band_energy) {
+
+    Z_TEST_SKIP_IFNDEF(CONFIG_APP_DSP_FFT);
+
+    struct dsp_fft f;
+    uint32_t bands[4];
+
+    for (size_t i = 0; i < ARRAY_SIZE(fft_lens); i++) {
+        char label[24];
+
+        if (dsp_fft_init(&f, fft_lens[i]) != 0) {
+            continue;
+        }
+
+        uint64_t start = host_clock_ns();
+
+        for (int n = 0; n < BENCH_BLOCKS; n++) {
+            // The CMSIS transform overwrites its input
+            memcpy(work, in, fft_lens[i] * sizeof(int16_t));
+            zassert_ok(dsp_band_energy(&f, work, bands, ARRAY_SIZE(bands)));
+            sink += bands[0];
+        }
+
+        snprintk(label, sizeof(label), "band energy %u", fft_lens[i]);
+        report(label, (host_clock_ns() - start) / BENCH_BLOCKS);
+    }
+}
+
+ZTEST(dsp_bench, test_chain) {
+
+    struct dsp_biquad b;
+    struct dsp_fir f;
+    int16_t prev = 0;
+    int64_t power = 0;
+
+    dsp_fir_design_lowpass(fir_coeffs, 16, BENCH_FACTOR);
+    zassert_ok(dsp_biquad_init(&b, hp_coeffs, 1, 1, hp_state));
+    zassert_ok(dsp_fir_init(&f, fir_coeffs, 16, BENCH_FACTOR, fir_state, BENCH_BLOCK));
+
+    uint64_t start = host_clock_ns();
+
+    for (int n = 0; n < BENCH_BLOCKS; n++) {
+        uint16_t out_n;
+
+        dsp_biquad_run(&b, in, work, BENCH_BLOCK);
+        out_n = dsp_fir_run(&f, work, work, BENCH_BLOCK);
+        power += dsp_power(work, out_n);
+        sink += dsp_peak(work, out_n) + dsp_zero_crossings(work, out_n, &prev);
+    }
+
+    report("chain", (host_clock_ns() - start) / BENCH_BLOCKS);
+
+    zassert_true(power > 0, "filtered signal is silent");
+}
+
+ZTEST_SUITE(dsp_bench, NULL, dsp_bench_setup, NULL, NULL, NULL);
@@ -0,0 +1,146 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/logging/log.h>
+#include <app/app_evlog.h>
+
+#include "host_clock.h"
+
+LOG_MODULE_REGISTER(evlog_bench, LOG_LEVEL_INF);
+
+/*
+Per-message diagnostics cost in the controller's hot path:
+"log" replays the six LOG_INF calls the controller used to make for every button event.
+"evlog" writes the records the controller writes now, unconditionally, and "evlog
+limited" goes through the per-call-site rate limiters as the controller does. Only the
+producer side is timed; formatting happens later in the drain thread.
+*/
+
+// Messages per measurement (a multiple of DRAIN_EVERY)
+#define BENCH_MSGS 2048
+
+// Messages between drain pauses, so the evlog ring never overflows
+#define DRAIN_EVERY 64
+
+// Records written per message by the evlog runs
+#define RECS_PER_MSG 3
+
+APP_EVLOG_RING_DEFINE(bench_evlog, 256);
+
+BUILD_ASSERT(DRAIN_EVERY * RECS_PER_MSG <= 256, "evlog ring too small for a drain batch");
+BUILD_ASSERT(BENCH_MSGS % DRAIN_EVERY == 0, "runs end on a drain pause");
+
+/**
+ * @brief One button event handled with the former per-message logging
+ *
+ * @param n Message number
+ */
+static void handle_log(uint32_t n) {
+
+    uint8_t id = n & 3;
+    uint8_t pressed = n & 1;
+
+    LOG_INF("controller waiting for message");
+    LOG_INF("controller got msg type=%d", 0);
+    LOG_INF("handle_button_event: id=%u pressed=%u", id, pressed);
+    LOG_INF("BLE notify returned %d", 0);
+    LOG_INF("publish_cmd: id=%u val=%u", 1, id);
+    LOG_INF("publish_cmd succeeded");
+}
+
+/**
+ * @brief One button event handled with binary event records
+ *
+ * @param n Message number
+ */
+static void handle_evlog(uint32_t n) {
+
+    uint8_t id = n & 3;
+    uint8_t pressed = n & 1;
+
+    APP_EVLOG(&bench_evlog, APP_EV_CTRL_MSG, 0, 0, 0);
+    APP_EVLOG(&bench_evlog, APP_EV_CTRL_BUTTON, id, pressed, 0);
+    APP_EVLOG(&bench_evlog, APP_EV_CTRL_PUBLISH_CMD, 1, id, 0);
+}
+
+/**
+ * @brief One button event handled with rate-limited records, as in the controller
+ *
+ * @param n Message number
+ */
+static void handle_evlog_limited(uint32_t n) {
+
+    uint8_t id = n & 3;
+    uint8_t pressed = n & 1;
+
+    APP_EVLOG_RATELIMITED(&bench_evlog, 1000, 16, APP_EV_CTRL_MSG, 0, 0, 0);
+    APP_EVLOG_RATELIMITED(&bench_evlog, 1000, 16, APP_EV_CTRL_BUTTON, id, pressed, 0);
+    APP_EVLOG_RATELIMITED(&bench_evlog, 1000, 8, APP_EV_CTRL_PUBLISH_CMD, 1, id, 0);
+}
+
+/**
+ * @brief Time BENCH_MSGS messages through one handler
+ *
+ * Pauses every DRAIN_EVERY messages (not timed) so the log and evlog threads can catch up.
+ *
+ * @param handle Message handler
+ * @return Nanoseconds per message spent in the handler
+ */
+static uint32_t run(void (*handle)(uint32_t)) {
+
+    uint64_t ns = 0;
+
+    for (uint32_t n = 0; n < BENCH_MSGS; n += DRAIN_EVERY) {
+        uint64_t start = host_clock_ns();
+
+        for (uint32_t i = 0; i < DRAIN_EVERY; i++) {
+            handle(n + i);
+        }
+
+        ns += host_clock_ns() - start;
+        k_msleep(5);
+    }
+
+    return (uint32_t)(ns / BENCH_MSGS);
+}
+
+/**
+ * @brief Print one result line
+ *
+ * @param label Backend
+ * @param ns Nanoseconds per message
+ */
+static void report(const char *label, uint32_t ns) {
+    TC_PRINT("%-14s %8u ns/msg %10u msg/s\n", label, ns, (ns > 0) ? 1000000000u / ns : 0);
+}
+
+static void *evlog_setup(void) {
+
+    zassert_ok(app_evlog_register(&bench_evlog));
+
+    return NULL;
+}
+
+ZTEST(evlog_bench, test_log_vs_evlog) {
+
+    uint32_t log_ns = run(handle_log);
+    uint32_t ev_ns = run(handle_evlog);
+    uint32_t dropped = (uint32_t)atomic_get(&bench_evlog.dropped);
+    uint32_t limited_before = (uint32_t)atomic_get(&bench_evlog.limited);
+    uint32_t ev_rl_ns = run(handle_evlog_limited);
+    uint32_t limited = (uint32_t)atomic_get(&bench_evlog.limited) - limited_before;
+
+    TC_PRINT("%s logging, %u button events per run\n",
+             IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE) ? "immediate" : "deferred", BENCH_MSGS);
+    report("log", log_ns);
+    report("evlog", ev_ns);
+    report("evlog limited", ev_rl_ns);
+
+    // The drain thread kept up: every unconditional record reached the drain
+    zassert_equal(dropped, 0, "%u records lost", dropped);
+
+    // The rate limiters let at most one burst per call site and window through
+    zassert_true(limited >= BENCH_MSGS * RECS_PER_MSG - 2 * (16 + 16 + 8),
+                 "only %u records rate-limited", limited);
+}
+
+ZTEST_SUITE(evlog_bench, NULL, evlog_setup, NULL, NULL, NULL);
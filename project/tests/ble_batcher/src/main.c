@@ -0,0 +1,340 @@
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+#include <app/ble_batcher.h>
+
+// Default LE ATT MTU minus the 3-byte notify header
+#define MIN_CAPACITY 20
+
+// Records that fit one frame of the largest capacity
+#define MAX_RECORDS ((BLE_BATCH_MAX_FRAME - BLE_BATCH_HDR_LEN) / BLE_BATCH_RECORD_LEN)
+
+static struct ble_batcher batch;
+static uint8_t frame[BLE_BATCH_MAX_FRAME];
+
+/**
+ * @brief Build the single-event record of event number `n`
+ *
+ * @param rec Destination, BLE_BATCH_RECORD_LEN bytes
+ * @param n Event number, stored in the button id and timestamp bytes
+ */
+static void record(uint8_t *rec, uint32_t n) {
+
+    rec[0] = 0;     // APP_MSG_BUTTON_EVENT
+    rec[1] = (uint8_t)n;
+    rec[2] = n & 1;
+    rec[3] = (uint8_t)n;
+    rec[4] = (uint8_t)(n >> 8);
+    rec[5] = (uint8_t)(n >> 16);
+    rec[6] = (uint8_t)(n >> 24);
+}
+
+/**
+ * @brief Add event `n` to the batcher
+ *
+ * @param n Event number
+ * @param now_ms Current time
+ * @return ble_batcher_add() result
+ */
+static int add(uint32_t n, uint32_t now_ms) {
+
+    uint8_t rec[BLE_BATCH_RECORD_LEN];
+
+    record(rec, n);
+
+    return ble_batcher_add(&batch, rec, now_ms);
+}
+
+/**
+ * @brief Check the records of a frame against consecutive event numbers
+ *
+ * @param f Frame
+ * @param len Frame length
+ * @param first Event number of the first record
+ * @return Number of records in the frame
+ */
+static uint32_t check_frame(const uint8_t *f, uint16_t len, uint32_t first) {
+
+    uint8_t rec[BLE_BATCH_RECORD_LEN];
+
+    // Single-event frames start with a message type, batches with the marker bit
+    if (len == BLE_BATCH_RECORD_LEN) {
+        zassert_false(f[0] & BLE_FRAME_BATCH);
+        record(rec, first);
+        zassert_mem_equal(f, rec, BLE_BATCH_RECORD_LEN);
+        return 1;
+    }
+
+    zassert_equal(f[0], BLE_FRAME_BATCH);
+    zassert_equal(len, BLE_BATCH_HDR_LEN + f[1] * BLE_BATCH_RECORD_LEN);
+    zassert_true(f[1] >= 2, "batch frame with fewer than two records");
+
+    for (uint32_t i = 0; i < f[1]; i++) {
+        record(rec, first + i);
+        zassert_mem_equal(&f[BLE_BATCH_HDR_LEN + i * BLE_BATCH_RECORD_LEN], rec,
+                          BLE_BATCH_RECORD_LEN, "record %u", i);
+    }
+
+    return f[1];
+}
+
+static void batcher_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    ble_batcher_init(&batch, MIN_CAPACITY);
+}
+
+ZTEST(ble_batcher, test_single_record_is_legacy_frame) {
+
+    zassert_true(ble_batcher_empty(&batch));
+    zassert_ok(add(7, 100));
+    zassert_false(ble_batcher_empty(&batch));
+
+    uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+    zassert_equal(len, BLE_BATCH_RECORD_LEN);
+    zassert_equal(check_frame(frame, len, 7), 1);
+    zassert_true(ble_batcher_empty(&batch));
+
+    // Nothing pending: nothing to send
+    zassert_equal(ble_batcher_take(&batch, frame, sizeof(frame)), 0);
+}
+
+ZTEST(ble_batcher, test_records_packed_into_one_frame) {
+
+    ble_batcher_set_capacity(&batch, 100);
+
+    for (uint32_t n = 0; n < 5; n++) {
+        zassert_ok(add(n, 0));
+    }
+
+    uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+    zassert_equal(len, BLE_BATCH_HDR_LEN + 5 * BLE_BATCH_RECORD_LEN);
+    zassert_equal(check_frame(frame, len, 0), 5);
+    zassert_true(ble_batcher_empty(&batch));
+}
+
+ZTEST(ble_batcher, test_minimal_mtu) {
+
+    // 20 bytes hold the header and two records
+    zassert_ok(add(0, 0));
+    zassert_false(ble_batcher_full(&batch));
+    zassert_ok(add(1, 0));
+    zassert_true(ble_batcher_full(&batch));
+    zassert_equal(add(2, 0), -ENOSPC);
+
+    uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+    zassert_equal(len, BLE_BATCH_HDR_LEN + 2 * BLE_BATCH_RECORD_LEN);
+    zassert_true(len <= MIN_CAPACITY);
+    zassert_equal(check_frame(frame, len, 0), 2);
+}
+
+ZTEST(ble_batcher, test_capacity_clamped_to_buffer) {
+
+    ble_batcher_set_capacity(&batch, 512);
+    zassert_equal(batch.capacity, BLE_BATCH_MAX_FRAME);
+
+    for (uint32_t n = 0; n < MAX_RECORDS; n++) {
+        zassert_ok(add(n, 0), "record %u rejected", n);
+    }
+    zassert_true(ble_batcher_full(&batch));
+    zassert_equal(add(MAX_RECORDS, 0), -ENOSPC);
+
+    uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+    zassert_true(len <= BLE_BATCH_MAX_FRAME);
+    zassert_equal(check_frame(frame, len, 0), MAX_RECORDS);
+}
+
+ZTEST(ble_batcher, test_latency_window_starts_at_first_record) {
+
+    zassert_ok(add(0, 1000));
+    zassert_ok(add(1, 1015));
+    zassert_equal(batch.first_ms, 1000);
+
+    (void)ble_batcher_take(&batch, frame, sizeof(frame));
+
+    // The next batch opens its own window
+    zassert_ok(add(2, 2000));
+    zassert_equal(batch.first_ms, 2000);
+}
+
+ZTEST(ble_batcher, test_output_too_small_drops_batch) {
+
+    zassert_ok(add(0, 0));
+    zassert_ok(add(1, 0));
+
+    zassert_equal(ble_batcher_take(&batch, frame, BLE_BATCH_RECORD_LEN), 0);
+    zassert_true(ble_batcher_empty(&batch));
+}
+
+ZTEST(ble_batcher, test_mtu_shrink_splits_pending_batch) {
+
+    uint32_t sent = 0;
+    uint32_t frames = 0;
+
+    ble_batcher_set_capacity(&batch, BLE_BATCH_MAX_FRAME);
+    for (uint32_t n = 0; n < 20; n++) {
+        zassert_ok(add(n, 0));
+    }
+
+    // A subscriber with the minimal MTU joined while 20 records were pending
+    ble_batcher_set_capacity(&batch, MIN_CAPACITY);
+    zassert_true(ble_batcher_full(&batch));
+    zassert_equal(add(20, 0), -ENOSPC);
+
+    // Drained as flush_batch() does: every frame fits, nothing is lost or reordered
+    while (!ble_batcher_empty(&batch)) {
+        uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+        zassert_true(len > 0 && len <= MIN_CAPACITY, "frame of %u bytes", len);
+        sent += check_frame(frame, len, sent);
+        frames++;
+    }
+
+    zassert_equal(sent, 20);
+    zassert_equal(frames, 10);
+
+    // The batcher is usable again at the new capacity
+    zassert_ok(add(20, 0));
+}
+
+ZTEST(ble_batcher, test_capacity_below_batch_sends_single_records) {
+
+    ble_batcher_set_capacity(&batch, 100);
+    zassert_ok(add(0, 0));
+    zassert_ok(add(1, 0));
+    zassert_ok(add(2, 0));
+
+    // Too small for a batch header plus two records: still one record per take
+    ble_batcher_set_capacity(&batch, BLE_BATCH_RECORD_LEN);
+
+    for (uint32_t n = 0; n < 3; n++) {
+        uint16_t len = ble_batcher_take(&batch, frame, sizeof(frame));
+
+        zassert_equal(len, BLE_BATCH_RECORD_LEN);
+        zassert_equal(check_frame(frame, len, n), 1);
+    }
+    zassert_true(ble_batcher_empty(&batch));
+}
+
+// Frames sent by flush_frames() and the records they carried
+struct flush_log {
+    uint16_t capacity;
+    uint32_t frames;
+    uint32_t sent;
+};
+
+/**
+ * @brief Drain the batcher and check every frame (ble_batcher_flush_t)
+ *
+ * @param b Batcher
+ * @param user_data struct flush_log
+ */
+static void flush_frames(struct ble_batcher *b, void *user_data) {
+
+    struct flush_log *log = user_data;
+
+    while (!ble_batcher_empty(b)) {
+        uint16_t len = ble_batcher_take(b, frame, sizeof(frame));
+
+        zassert_true(len <= log->capacity, "frame of %u bytes over %u", len, log->capacity);
+        log->sent += check_frame(frame, len, log->sent);
+        log->frames++;
+    }
+}
+
+/**
+ * @brief Push a stream of events through the flush policy used by the TX thread
+ *
+ * @param events Number of events
+ * @param capacity Usable frame length
+ * @param frames Number of frames sent
+ * @return Number of records sent
+ */
+static uint32_t run_policy(uint32_t events, uint16_t capacity, uint32_t *frames) {
+
+    struct flush_log log = { .capacity = capacity };
+    uint8_t rec[BLE_BATCH_RECORD_LEN];
+
+    ble_batcher_set_capacity(&batch, capacity);
+
+    for (uint32_t n = 0; n < events; n++) {
+        record(rec, n);
+        ble_batcher_push(&batch, rec, n, flush_frames, &log);
+    }
+
+    // Latency timer expiry
+    flush_frames(&batch, &log);
+
+    *frames = log.frames;
+
+    return log.sent;
+}
+
+ZTEST(ble_batcher, test_flush_policy_fills_frames) {
+
+    static const uint16_t capacities[] = { MIN_CAPACITY, 64, 182, 244 };
+    uint32_t frames;
+
+    for (size_t i = 0; i < ARRAY_SIZE(capacities); i++) {
+        uint16_t cap = capacities[i];
+        uint32_t per_frame = (cap - BLE_BATCH_HDR_LEN) / BLE_BATCH_RECORD_LEN;
+
+        // Every event is sent once, in order, and every frame but the last is full
+        zassert_equal(run_policy(1000, cap, &frames), 1000);
+        zassert_equal(frames, DIV_ROUND_UP(1000, per_frame), "capacity %u", cap);
+    }
+}
+
+ZTEST(ble_batcher, test_push_sends_full_frame_at_once) {
+
+    struct flush_log log = { .capacity = 100 };
+    uint8_t rec[BLE_BATCH_RECORD_LEN];
+
+    // 100 bytes hold 14 records: the 14th push sends them without waiting for a deadline
+    ble_batcher_set_capacity(&batch, 100);
+    for (uint32_t n = 0; n < 14; n++) {
+        zassert_equal(log.frames, 0, "sent early at record %u", n);
+        record(rec, n);
+        ble_batcher_push(&batch, rec, 0, flush_frames, &log);
+    }
+
+    zassert_equal(log.frames, 1);
+    zassert_equal(log.sent, 14);
+    zassert_true(ble_batcher_empty(&batch));
+}
+
+ZTEST(ble_batcher, test_deadline_is_latency_or_interval) {
+
+    // Nothing pending: no deadline
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 0, 0), BLE_BATCHER_WAIT_FOREVER);
+
+    zassert_ok(add(0, 1000));
+    zassert_ok(add(1, 1005));
+
+    // Counted from the oldest record; no connection interval known yet
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 0, 1005), 15);
+
+    // A shorter connection interval brings the deadline forward, a longer one does not
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 8, 1005), 3);
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 50, 1005), 15);
+
+    // Due, and past due
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 0, 1020), 0);
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 8, 1100), 0);
+
+    // Over an uptime wrap
+    ble_batcher_init(&batch, MIN_CAPACITY);
+    zassert_ok(add(0, UINT32_MAX - 4));
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 0, 5), 10);
+
+    // The deadline goes once the records are sent
+    ble_batcher_take(&batch, frame, sizeof(frame));
+    zassert_equal(ble_batcher_wait_ms(&batch, 20, 0, 5), BLE_BATCHER_WAIT_FOREVER);
+}
+
+ZTEST_SUITE(ble_batcher, NULL, NULL, batcher_before, NULL, NULL);
@@ -0,0 +1,136 @@
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+#include <app/ble_conn_table.h>
+
+BUILD_ASSERT(BLE_CONN_TABLE_SIZE == 3, "suite expects a three-connection table");
+
+// Stub connection handles: the table only stores and compares the pointers
+struct bt_conn {
+    int id;
+};
+
+static struct bt_conn phone = { 1 };
+static struct bt_conn gateway = { 2 };
+static struct bt_conn tablet = { 3 };
+static struct bt_conn extra = { 4 };
+
+static struct ble_conn_table table;
+
+static void conn_table_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    memset(&table, 0, sizeof(table));
+}
+
+ZTEST(ble_conn_table, test_add_find_remove) {
+
+    struct ble_conn_slot *slot = ble_conn_table_add(&table, &phone);
+
+    zassert_not_null(slot);
+    zassert_equal_ptr(slot->conn, &phone);
+    zassert_equal(slot->mtu, 23, "new connections start at the default LE MTU");
+    zassert_false(slot->notify);
+    zassert_equal(ble_conn_table_count(&table), 1);
+
+    zassert_equal_ptr(ble_conn_table_find(&table, &phone), slot);
+    zassert_is_null(ble_conn_table_find(&table, &gateway));
+    zassert_is_null(ble_conn_table_find(&table, NULL));
+
+    zassert_ok(ble_conn_table_remove(&table, &phone));
+    zassert_equal(ble_conn_table_remove(&table, &phone), -ENOENT);
+    zassert_equal(ble_conn_table_count(&table), 0);
+    zassert_is_null(ble_conn_table_find(&table, &phone));
+}
+
+ZTEST(ble_conn_table, test_add_twice_keeps_one_slot) {
+
+    struct ble_conn_slot *slot = ble_conn_table_add(&table, &phone);
+
+    slot->notify = true;
+    slot->mtu = 247;
+
+    // A repeated connected callback must not claim a second slot or reset its state
+    zassert_equal_ptr(ble_conn_table_add(&table, &phone), slot);
+    zassert_equal(ble_conn_table_count(&table), 1);
+    zassert_true(slot->notify);
+    zassert_equal(slot->mtu, 247);
+}
+
+ZTEST(ble_conn_table, test_full_table) {
+
+    zassert_not_null(ble_conn_table_add(&table, &phone));
+    zassert_not_null(ble_conn_table_add(&table, &gateway));
+    zassert_true(ble_conn_table_has_free(&table));
+    zassert_not_null(ble_conn_table_add(&table, &tablet));
+
+    // No free slot: advertising stays off and a further connection is refused
+    zassert_false(ble_conn_table_has_free(&table));
+    zassert_is_null(ble_conn_table_add(&table, &extra));
+    zassert_equal(ble_conn_table_count(&table), 3);
+
+    // A disconnect frees a slot for the next central, with fresh state
+    struct ble_conn_slot *old = ble_conn_table_find(&table, &gateway);
+
+    old->notify = true;
+    old->backlog = 4;
+    zassert_ok(ble_conn_table_remove(&table, &gateway));
+    zassert_true(ble_conn_table_has_free(&table));
+
+    struct ble_conn_slot *slot = ble_conn_table_add(&table, &extra);
+
+    zassert_equal_ptr(slot, old, "freed slot not reused");
+    zassert_false(slot->notify);
+    zassert_equal(slot->backlog, 0);
+    zassert_is_null(ble_conn_table_find(&table, &gateway));
+}
+
+ZTEST(ble_conn_table, test_subscribed_and_min_mtu) {
+
+    struct ble_conn_slot *p = ble_conn_table_add(&table, &phone);
+    struct ble_conn_slot *g = ble_conn_table_add(&table, &gateway);
+
+    // Nobody subscribed: frames are sized for the default MTU
+    zassert_equal(ble_conn_table_subscribed(&table), 0);
+    zassert_equal(ble_conn_table_min_mtu(&table), 23);
+
+    p->mtu = 247;
+    p->notify = true;
+    g->mtu = 65;
+
+    // Only subscribers count towards the frame size
+    zassert_equal(ble_conn_table_subscribed(&table), 1);
+    zassert_equal(ble_conn_table_min_mtu(&table), 247);
+
+    g->notify = true;
+    zassert_equal(ble_conn_table_subscribed(&table), 2);
+    zassert_equal(ble_conn_table_min_mtu(&table), 65);
+
+    // The gateway leaves: frames grow back to the phone's MTU
+    zassert_ok(ble_conn_table_remove(&table, &gateway));
+    zassert_equal(ble_conn_table_min_mtu(&table), 247);
+}
+
+ZTEST(ble_conn_table, test_min_interval) {
+
+    struct ble_conn_slot *p = ble_conn_table_add(&table, &phone);
+    struct ble_conn_slot *g = ble_conn_table_add(&table, &gateway);
+
+    zassert_equal(ble_conn_table_min_interval_ms(&table), 0);
+
+    p->notify = true;
+    p->interval_ms = 30;
+    g->interval_ms = 7;
+
+    // Unsubscribed connections and unknown intervals are ignored
+    zassert_equal(ble_conn_table_min_interval_ms(&table), 30);
+
+    g->notify = true;
+    zassert_equal(ble_conn_table_min_interval_ms(&table), 7);
+
+    g->interval_ms = 0;
+    zassert_equal(ble_conn_table_min_interval_ms(&table), 30);
+}
+
+ZTEST_SUITE(ble_conn_table, NULL, NULL, conn_table_before, NULL, NULL);
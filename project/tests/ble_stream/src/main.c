@@ -0,0 +1,181 @@
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+#include <app/ble_stream.h>
+
+// Default LE ATT MTU minus the 3-byte notify header
+#define MIN_FRAME 20
+
+// Largest frame: 247-byte ATT MTU minus the notify header
+#define MAX_FRAME 244
+
+// A full sampler block: one app_buf payload
+#define BLOCK_LEN 256
+
+static struct ble_stream_framer framer;
+static uint8_t block[BLOCK_LEN];
+static uint8_t frame[MAX_FRAME];
+static uint8_t rebuilt[BLOCK_LEN];
+
+/**
+ * @brief Frame a block and check every frame
+ *
+ * Checks the frame header (frame sequence LE, block sequence, fragment index and last
+ * flag), that every frame but the last is full and that the payloads rebuild the block.
+ *
+ * @param len Block length
+ * @param block_seq Block sequence number
+ * @param frame_max Largest frame
+ * @param first_seq Frame sequence number of the first frame
+ * @return Number of frames
+ */
+static uint32_t frame_block(uint16_t len, uint8_t block_seq, uint16_t frame_max,
+                            uint16_t first_seq) {
+
+    uint16_t chunk = frame_max - BLE_STREAM_FRAME_HDR;
+    uint16_t frame_seq = first_seq;
+    uint16_t off = 0;
+    uint32_t frames = 0;
+    uint16_t n;
+    bool last = false;
+
+    memset(rebuilt, 0, sizeof(rebuilt));
+    zassert_ok(ble_stream_framer_init(&framer, block, len, block_seq, frame_max));
+
+    while ((n = ble_stream_framer_next(&framer, frame_seq, frame, &last)) > 0) {
+        uint16_t payload = n - BLE_STREAM_FRAME_HDR;
+
+        zassert_true(n <= frame_max, "frame of %u bytes over %u", n, frame_max);
+        zassert_equal(frame[0] | (frame[1] << 8), frame_seq);
+        zassert_equal(frame[2], block_seq);
+        zassert_equal(frame[3] & ~BLE_STREAM_FRAG_LAST, frames, "fragment index");
+        zassert_equal(!!(frame[3] & BLE_STREAM_FRAG_LAST), last);
+        zassert_equal(last, off + payload == len);
+        if (!last) {
+            zassert_equal(payload, chunk, "short frame %u", frames);
+        }
+
+        memcpy(&rebuilt[off], &frame[BLE_STREAM_FRAME_HDR], payload);
+        off += payload;
+        frame_seq++;
+        frames++;
+    }
+
+    zassert_true(last, "no last fragment");
+    zassert_true(ble_stream_framer_done(&framer));
+    zassert_equal(off, len);
+    zassert_mem_equal(rebuilt, block, len);
+
+    // Nothing left once the last fragment went out
+    zassert_equal(ble_stream_framer_next(&framer, frame_seq, frame, &last), 0);
+
+    return frames;
+}
+
+static void *stream_setup(void) {
+
+    for (size_t i = 0; i < sizeof(block); i++) {
+        block[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    return NULL;
+}
+
+ZTEST(ble_stream, test_small_block_single_frame) {
+
+    zassert_equal(frame_block(16, 9, MAX_FRAME, 100), 1);
+    zassert_equal(frame[3], BLE_STREAM_FRAG_LAST);
+}
+
+ZTEST(ble_stream, test_full_block_minimal_mtu) {
+
+    // 16 payload bytes per frame: a full block takes 16 fragments
+    zassert_equal(frame_block(BLOCK_LEN, 0x34, MIN_FRAME, 0), 16);
+}
+
+ZTEST(ble_stream, test_fragment_count_per_mtu) {
+
+    static const uint16_t frame_max[] = { MIN_FRAME, 64, 182, MAX_FRAME };
+
+    for (size_t i = 0; i < ARRAY_SIZE(frame_max); i++) {
+        uint16_t chunk = frame_max[i] - BLE_STREAM_FRAME_HDR;
+
+        zassert_equal(frame_block(BLOCK_LEN, (uint8_t)i, frame_max[i], 0),
+                      DIV_ROUND_UP(BLOCK_LEN, chunk), "frame max %u", frame_max[i]);
+    }
+}
+
+ZTEST(ble_stream, test_frame_seq_wraps) {
+
+    uint16_t n;
+    bool last;
+
+    // Three frames starting two below the wrap: 0xfffe, 0xffff, 0x0000
+    zassert_equal(frame_block(3 * (MIN_FRAME - BLE_STREAM_FRAME_HDR), 1, MIN_FRAME, 0xfffe), 3);
+    zassert_equal(frame[0], 0x00);
+    zassert_equal(frame[1], 0x00);
+
+    zassert_ok(ble_stream_framer_init(&framer, block, BLOCK_LEN, 1, MIN_FRAME));
+    n = ble_stream_framer_next(&framer, 0x1234, frame, &last);
+    zassert_equal(n, MIN_FRAME);
+    zassert_equal(frame[0], 0x34);
+    zassert_equal(frame[1], 0x12);
+    zassert_false(last);
+}
+
+ZTEST(ble_stream, test_unusable_frame_size) {
+
+    // No room for a payload
+    zassert_equal(ble_stream_framer_init(&framer, block, BLOCK_LEN, 0, BLE_STREAM_FRAME_HDR),
+                  -EINVAL);
+
+    // One payload byte per frame needs more fragments than the 7-bit index holds
+    zassert_equal(ble_stream_framer_init(&framer, block, BLOCK_LEN, 0,
+                                         BLE_STREAM_FRAME_HDR + 1), -EINVAL);
+    zassert_ok(ble_stream_framer_init(&framer, block, BLE_STREAM_FRAG_MAX, 0,
+                                      BLE_STREAM_FRAME_HDR + 1));
+}
+
+ZTEST(ble_stream, test_counters) {
+
+    struct ble_stream_counters c;
+    struct comms_ble_stream_stats st = { .dropped = 77 };
+
+    ble_stream_counters_reset(&c, 1000);
+
+    // One block of three frames, each sent on two connections
+    for (int i = 0; i < 3; i++) {
+        ble_stream_count_frame(&c, 2, 100);
+    }
+    ble_stream_count_block(&c);
+
+    ble_stream_count_latency(&c, 100);
+    ble_stream_count_latency(&c, 300);
+    ble_stream_count_latency(&c, 200);
+
+    ble_stream_counters_read(&c, 2000, &st);
+
+    zassert_equal(st.blocks, 1);
+    zassert_equal(st.frames, 6);
+    zassert_equal(st.bytes, 600);
+    zassert_equal(st.bps, 600 * 8);
+    zassert_equal(st.latency_avg_us, 200);
+    zassert_equal(st.latency_max_us, 300);
+
+    // Charged by the send path, not by the counters
+    zassert_equal(st.dropped, 77);
+
+    // Throughput over an uptime wrap
+    ble_stream_counters_reset(&c, UINT32_MAX - 499);
+    ble_stream_count_frame(&c, 1, 250);
+    ble_stream_counters_read(&c, 500, &st);
+    zassert_equal(st.bps, 250 * 8);
+
+    // Reset clears everything; no time elapsed means no throughput yet
+    ble_stream_counters_reset(&c, 5000);
+    ble_stream_counters_read(&c, 5000, &st);
+    zassert_equal(st.blocks + st.frames + st.bytes + st.bps, 0);
+    zassert_equal(st.latency_avg_us + st.latency_max_us, 0);
+}
+
+ZTEST_SUITE(ble_stream, NULL, stream_setup, NULL, NULL, NULL);
@@ -0,0 +1,292 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+#include <app/cmd_tlv.h>
+
+// Random inputs checked by the fuzz test
+#define FUZZ_ROUNDS 100000
+
+// Longest fuzzed write: a 247-byte ATT MTU minus the 3-byte write header
+#define FUZZ_MAX_LEN 244
+
+// Output capacity given to the decoder, plus untouched canary entries after it
+#define OUT_MAX   16
+#define OUT_GUARD 4
+
+#define CANARY_ID    0xA5
+#define CANARY_VALUE 0xDEADBEEF
+
+static struct app_command_payload out[OUT_MAX + OUT_GUARD];
+static struct app_command_payload ref[OUT_MAX];
+
+/**
+ * @brief Fill the decoder output, guard entries included, with canaries
+ */
+static void canaries_set(void) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(out); i++) {
+        out[i].command_id = CANARY_ID;
+        out[i].value = CANARY_VALUE;
+    }
+}
+
+/**
+ * @brief Check that nothing was written past the output capacity
+ *
+ * @param max_out Capacity passed to the decoder
+ */
+static void canaries_check(size_t max_out) {
+
+    for (size_t i = max_out; i < ARRAY_SIZE(out); i++) {
+        zassert_equal(out[i].command_id, CANARY_ID, "write past max_out at %zu", i);
+        zassert_equal(out[i].value, CANARY_VALUE, "write past max_out at %zu", i);
+    }
+}
+
+/**
+ * @brief Reference decoder, written straight from the format description
+ *
+ * Records are checked in order; the first problem found decides the error.
+ *
+ * @return Same contract as cmd_tlv_decode()
+ */
+static int ref_decode(const uint8_t *buf, size_t len, struct app_command_payload *dst,
+                      size_t max_out) {
+
+    size_t n = 0;
+    size_t i = 0;
+
+    if (len == 0) {
+        return -EINVAL;
+    }
+
+    while (i < len) {
+        if (i + 2 > len) {
+            return -EINVAL;
+        }
+
+        uint8_t id = buf[i];
+        uint8_t vlen = buf[i + 1];
+
+        if (id == 0 || vlen > 4 || i + 2 + vlen > len) {
+            return -EINVAL;
+        }
+        if (n == max_out) {
+            return -E2BIG;
+        }
+
+        uint8_t le[4] = {0};
+
+        memcpy(le, &buf[i + 2], vlen);
+        dst[n].command_id = id;
+        dst[n].value = le[0] | (le[1] << 8) | (le[2] << 16) | ((uint32_t)le[3] << 24);
+        n++;
+        i += 2 + vlen;
+    }
+
+    return (int)n;
+}
+
+/**
+ * @brief Encode one command with the shortest value length
+ *
+ * @param dst Destination, at least CMD_TLV_HDR_LEN + CMD_TLV_MAX_VALUE_LEN bytes
+ * @param id Command id
+ * @param value Command value
+ * @return Encoded length
+ */
+static size_t encode(uint8_t *dst, uint8_t id, uint32_t value) {
+
+    uint8_t vlen = 0;
+
+    while (vlen < CMD_TLV_MAX_VALUE_LEN && (value >> (8 * vlen)) != 0) {
+        vlen++;
+    }
+
+    dst[0] = id;
+    dst[1] = vlen;
+    for (uint8_t i = 0; i < vlen; i++) {
+        dst[CMD_TLV_HDR_LEN + i] = (uint8_t)(value >> (8 * i));
+    }
+
+    return CMD_TLV_HDR_LEN + vlen;
+}
+
+/**
+ * @brief Next pseudo-random number (xorshift32)
+ *
+ * @param state Generator state
+ * @return Random value
+ */
+static uint32_t rnd(uint32_t *state) {
+
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+ZTEST(cmd_tlv, test_valid_records) {
+
+    static const uint8_t buf[] = {
+        0x01, 0x00,                         // LED_TOGGLE, no value
+        0x02, 0x02, 0x01, 0x01,             // LED_SET 0x0101
+        0x03, 0x01, 0x02,                   // SET_MODE 2
+        0x05, 0x04, 0x01, 0x02, 0x03, 0x04, // LED_FX 0x04030201
+    };
+
+    canaries_set();
+    zassert_equal(cmd_tlv_decode(buf, sizeof(buf), out, OUT_MAX), 4);
+
+    zassert_equal(out[0].command_id, 1);
+    zassert_equal(out[0].value, 0);
+    zassert_equal(out[1].command_id, 2);
+    zassert_equal(out[1].value, 0x0101);
+    zassert_equal(out[2].command_id, 3);
+    zassert_equal(out[2].value, 2);
+    zassert_equal(out[3].command_id, 5);
+    zassert_equal(out[3].value, 0x04030201);
+    canaries_check(4);
+}
+
+ZTEST(cmd_tlv, test_malformed_rejected) {
+
+    static const struct {
+        uint8_t buf[8];
+        size_t len;
+        const char *what;
+    } cases[] = {
+        { { 0 }, 0, "empty" },
+        { { 0x01 }, 1, "truncated header" },
+        { { 0x01, 0x02, 0xFF }, 3, "truncated value" },
+        { { 0x01, 0x05, 1, 2, 3, 4, 5 }, 7, "value longer than 4 bytes" },
+        { { 0x00, 0x00 }, 2, "zero command id" },
+        { { 0x01, 0x00, 0x02 }, 3, "valid record then truncated header" },
+        { { 0x01, 0x00, 0x00, 0x01, 0x07 }, 5, "valid record then zero id" },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        canaries_set();
+        zassert_equal(cmd_tlv_decode(cases[i].buf, cases[i].len, out, OUT_MAX), -EINVAL,
+                      "%s accepted", cases[i].what);
+        canaries_check(OUT_MAX);
+    }
+
+    zassert_equal(cmd_tlv_decode(NULL, 4, out, OUT_MAX), -EINVAL);
+}
+
+ZTEST(cmd_tlv, test_too_many_records) {
+
+    uint8_t buf[(OUT_MAX + 1) * CMD_TLV_HDR_LEN];
+
+    for (size_t i = 0; i < OUT_MAX + 1; i++) {
+        buf[2 * i] = 1;
+        buf[2 * i + 1] = 0;
+    }
+
+    canaries_set();
+    zassert_equal(cmd_tlv_decode(buf, sizeof(buf) - CMD_TLV_HDR_LEN, out, OUT_MAX), OUT_MAX);
+    zassert_equal(cmd_tlv_decode(buf, sizeof(buf), out, OUT_MAX), -E2BIG);
+    canaries_check(OUT_MAX);
+
+    // A smaller capacity is honoured too
+    canaries_set();
+    zassert_equal(cmd_tlv_decode(buf, 3 * CMD_TLV_HDR_LEN, out, 2), -E2BIG);
+    canaries_check(2);
+}
+
+ZTEST(cmd_tlv, test_round_trip) {
+
+    uint8_t buf[OUT_MAX * (CMD_TLV_HDR_LEN + CMD_TLV_MAX_VALUE_LEN)];
+    struct app_command_payload in[OUT_MAX];
+    uint32_t seed = 0xC0FFEE;
+
+    for (int round = 0; round < 1000; round++) {
+        size_t n = 1 + rnd(&seed) % OUT_MAX;
+        size_t len = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            in[i].command_id = 1 + rnd(&seed) % 255;
+            // Mix of value widths: 0 to 4 significant bytes
+            uint32_t width = rnd(&seed) % 5;
+
+            in[i].value = (width == 0) ? 0 : rnd(&seed) >> (8 * (4 - width));
+            len += encode(&buf[len], in[i].command_id, in[i].value);
+        }
+
+        canaries_set();
+        zassert_equal(cmd_tlv_decode(buf, len, out, OUT_MAX), n);
+        for (size_t i = 0; i < n; i++) {
+            zassert_equal(out[i].command_id, in[i].command_id);
+            zassert_equal(out[i].value, in[i].value);
+        }
+        canaries_check(OUT_MAX);
+    }
+}
+
+ZTEST(cmd_tlv, test_fuzz_against_reference) {
+
+    uint8_t buf[FUZZ_MAX_LEN];
+    uint32_t seed = 0x5EED1234;
+    uint32_t accepted = 0;
+
+    for (uint32_t round = 0; round < FUZZ_ROUNDS; round++) {
+        size_t len = 0;
+        size_t max_out = 1 + rnd(&seed) % OUT_MAX;
+
+        if (rnd(&seed) & 1) {
+            // Pure noise
+            len = rnd(&seed) % (FUZZ_MAX_LEN + 1);
+            for (size_t i = 0; i < len; i++) {
+                buf[i] = (uint8_t)rnd(&seed);
+            }
+        } else {
+            // Well-formed records, then at most one corruption
+            size_t records = rnd(&seed) % (OUT_MAX + 3);
+
+            for (size_t i = 0; i < records; i++) {
+                len += encode(&buf[len], 1 + rnd(&seed) % 255, rnd(&seed));
+            }
+
+            switch (rnd(&seed) % 4) {
+            case 0:     // truncated
+                len -= (len > 0) ? 1 + rnd(&seed) % len : 0;
+                break;
+            case 1:     // one byte overwritten
+                if (len > 0) {
+                    buf[rnd(&seed) % len] = (uint8_t)rnd(&seed);
+                }
+                break;
+            default:    // left valid
+                break;
+            }
+        }
+
+        int ref_rc = ref_decode(buf, len, ref, max_out);
+
+        canaries_set();
+
+        int rc = cmd_tlv_decode(buf, len, out, max_out);
+
+        zassert_equal(rc, ref_rc, "round %u: len %zu max_out %zu", round, len, max_out);
+        canaries_check(max_out);
+
+        if (rc > 0) {
+            accepted++;
+            for (int i = 0; i < rc; i++) {
+                zassert_equal(out[i].command_id, ref[i].command_id, "round %u", round);
+                zassert_equal(out[i].value, ref[i].value, "round %u", round);
+            }
+        }
+    }
+
+    // The generator must reach the accepting path, not only error paths
+    zassert_true(accepted > FUZZ_ROUNDS / 10, "only %u inputs accepted", accepted);
+}
+
+ZTEST_SUITE(cmd_tlv, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,13 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include <stdint.h>
+
+/*
+Host wall clock for benchmarks on native_sim:
+Simulated time does not advance while code runs, so k_cycle_get_32() cannot time a loop.
+This reads the host's monotonic clock instead (see host_clock_bottom.c).
+*/
+uint64_t host_clock_ns(void);
+
+#endif /* HOST_CLOCK_H */
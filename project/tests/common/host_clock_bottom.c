@@ -0,0 +1,22 @@
+/*
+Runner side of host_clock.h: built against the host C library, not Zephyr
+(native_simulator "bottom" file).
+*/
+#include <stdint.h>
+#include <time.h>
+
+#include "host_clock.h"
+
+/**
+ * @brief Read the host monotonic clock
+ *
+ * @return Nanoseconds since an arbitrary host epoch
+ */
+uint64_t host_clock_ns(void) {
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Generate src/golden.h for the dsp_kernels suite.
+
+The expected outputs come from a straight model of the documented fixed-point
+arithmetic (the CMSIS-DSP q15 definitions the portable kernels follow) and from
+double-precision designs, not from the kernels under test. Run from this directory:
+
+    python3 gen_golden.py > src/golden.h
+"""
+
+import math
+
+FS_HZ = 1000
+
+FIR_TAPS = 16
+FIR_FACTOR = 4
+FIR_BLOCK = 128
+FIR_LEN = 2 * FIR_BLOCK
+
+HP_FC_HZ = 10
+HP_STAGES = 2
+BIQUAD_LEN = 256
+
+STATS_LEN = 64
+
+FFT_LEN = 128
+FFT_BANDS = 4
+FFT_TONES = ((10, 16000), (45, 4000))
+
+
+def xorshift32(state):
+    while True:
+        state ^= (state << 13) & 0xFFFFFFFF
+        state ^= state >> 17
+        state ^= (state << 5) & 0xFFFFFFFF
+        yield state
+
+
+def sat_q15(v):
+    return max(-32768, min(32767, v))
+
+
+def to_q15(v):
+    return sat_q15(int(math.floor(v * 32768.0 + 0.5)) if v >= 0 else
+                   int(math.ceil(v * 32768.0 - 0.5)))
+
+
+def noise(seed, count, amp):
+    rng = xorshift32(seed)
+    return [(next(rng) % (2 * amp + 1)) - amp for _ in range(count)]
+
+
+def tone(n, hz, amp):
+    return amp * math.sin(2 * math.pi * hz * n / FS_HZ)
+
+
+def fir_design_lowpass(taps, factor):
+    # Windowed sinc (Hamming), cut-off at the output Nyquist rate, unity DC gain
+    fc = 0.5 / factor
+    h = []
+    for n in range(taps):
+        t = n - (taps - 1) / 2
+        sinc = 2 * fc if t == 0 else math.sin(2 * math.pi * fc * t) / (math.pi * t)
+        h.append(sinc * (0.54 - 0.46 * math.cos(2 * math.pi * n / (taps - 1))))
+    total = sum(h)
+    half = [to_q15(v / total) for v in h[:(taps + 1) // 2]]
+    return half + half[:taps // 2][::-1]
+
+
+def biquad_design_highpass(fs, fc):
+    # RBJ Butterworth high-pass, halved for post_shift 1, a1/a2 negated
+    w0 = 2 * math.pi * fc / fs
+    alpha = math.sin(w0) / math.sqrt(2)
+    a0 = 1 + alpha
+    b0 = to_q15((1 + math.cos(w0)) / 2 / a0 / 2)
+    return [b0, 0, -2 * b0, b0, to_q15(2 * math.cos(w0) / a0 / 2),
+            to_q15(-(1 - alpha) / a0 / 2)]
+
+
+def fir_decimate(coeffs, factor, x):
+    # y[m] = sat((sum_k b[k] x[(m + 1) factor - 1 - k]) >> 15), zero history
+    out = []
+    for m in range(len(x) // factor):
+        last = (m + 1) * factor - 1
+        acc = sum(coeffs[k] * x[last - k] for k in range(len(coeffs)) if last - k >= 0)
+        out.append(sat_q15(acc >> 15))
+    return out
+
+
+def biquad_df1(coeffs, stages, post_shift, x):
+    for s in range(stages):
+        b0, _, b1, b2, a1, a2 = coeffs[6 * s:6 * s + 6]
+        x1 = x2 = y1 = y2 = 0
+        y = []
+        for v in x:
+            acc = b0 * v + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2
+            out = sat_q15(acc >> (15 - post_shift))
+            x2, x1, y2, y1 = x1, v, y1, out
+            y.append(out)
+        x = y
+    return x
+
+
+def zero_crossings(x, prev):
+    neg = prev < 0
+    count = 0
+    for v in x:
+        count += (v < 0) != neg
+        neg = v < 0
+    return count
+
+
+def band_energy(x, bands):
+    # Exact DFT scaled by 1/len, squared magnitude in 3.13 (>> 17), per equal-width band
+    n = len(x)
+    mag = []
+    for k in range(n // 2):
+        re = sum(x[i] * math.cos(2 * math.pi * k * i / n) for i in range(n)) / n
+        im = -sum(x[i] * math.sin(2 * math.pi * k * i / n) for i in range(n)) / n
+        mag.append((re * re + im * im) / (1 << 17))
+    bins = n // 2 - 1
+    per_band = bins // bands
+    out = []
+    for b in range(bands):
+        first = 1 + b * per_band
+        last = bins if b == bands - 1 else first + per_band - 1
+        out.append(int(round(sum(mag[first:last + 1]))))
+    return out
+
+
+def emit(ctype, name, values, per_line=10):
+    print(f"static const {ctype} {name}[{len(values)}] = {{")
+    for i in range(0, len(values), per_line):
+        print("    " + " ".join(f"{v}," for v in values[i:i + per_line]))
+    print("};\n")
+
+
+def main():
+    # FIR: a pass-band tone, a tone above the output Nyquist rate and noise, then a
+    # full-scale step that saturates the accumulator
+    fir_in = [sat_q15(int(round(tone(n, 50, 12000) + tone(n, 300, 6000)))) + v
+              for n, v in enumerate(noise(0x1234567, FIR_LEN, 512))]
+    fir_in[192:] = [32767] * (FIR_LEN - 192)
+    fir_coeffs = fir_design_lowpass(FIR_TAPS, FIR_FACTOR)
+    fir_out = fir_decimate(fir_coeffs, FIR_FACTOR, fir_in)
+
+    # Biquad: DC offset plus a 100 Hz tone through two DC-blocking stages
+    hp = biquad_design_highpass(FS_HZ, HP_FC_HZ)
+    biquad_in = [sat_q15(8000 + int(round(tone(n, 100, 8000)))) + v
+                 for n, v in enumerate(noise(0x89ABCDE, BIQUAD_LEN, 256))]
+    biquad_out = biquad_df1(hp * HP_STAGES, HP_STAGES, 1, biquad_in)
+
+    # Statistics: noise with one -32768 sample, whose magnitude saturates
+    stats_in = noise(0xF00D, STATS_LEN, 20000)
+    stats_in[37] = -32768
+    half = STATS_LEN // 2
+
+    isqrt_in = [0, 1, 2, 3, 4, 15, 16, 17, 1000000, 65535 * 65535 - 1, 65535 * 65535,
+                0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF]
+
+    fft_in = [sat_q15(int(round(sum(amp * math.sin(2 * math.pi * k * n / FFT_LEN)
+                                    for k, amp in FFT_TONES))))
+              for n in range(FFT_LEN)]
+
+    print("/* Generated by gen_golden.py, do not edit */\n")
+    print("#ifndef GOLDEN_H\n#define GOLDEN_H\n")
+    print("#include <stdint.h>\n")
+    print(f"#define GOLDEN_FS_HZ      {FS_HZ}")
+    print(f"#define GOLDEN_FIR_TAPS   {FIR_TAPS}")
+    print(f"#define GOLDEN_FIR_FACTOR {FIR_FACTOR}")
+    print(f"#define GOLDEN_FIR_BLOCK  {FIR_BLOCK}")
+    print(f"#define GOLDEN_HP_FC_HZ   {HP_FC_HZ}")
+    print(f"#define GOLDEN_HP_STAGES  {HP_STAGES}")
+    print(f"#define GOLDEN_FFT_LEN    {FFT_LEN}")
+    print(f"#define GOLDEN_FFT_BANDS  {FFT_BANDS}\n")
+
+    emit("int16_t", "golden_fir_coeffs", fir_coeffs, 8)
+    emit("int16_t", "golden_fir_in", fir_in)
+    emit("int16_t", "golden_fir_out", fir_out)
+    emit("int16_t", "golden_hp_coeffs", hp, 6)
+    emit("int16_t", "golden_biquad_in", biquad_in)
+    emit("int16_t", "golden_biquad_out", biquad_out)
+    emit("int16_t", "golden_stats_in", stats_in)
+
+    print(f"#define GOLDEN_STATS_POWER   {sum(v * v for v in stats_in)}LL")
+    print(f"#define GOLDEN_STATS_PEAK    {min(32767, max(abs(v) for v in stats_in))}")
+    print(f"#define GOLDEN_STATS_ZC_HEAD {zero_crossings(stats_in[:half], 0)}")
+    print(f"#define GOLDEN_STATS_ZC_TAIL {zero_crossings(stats_in[half:], stats_in[half - 1])}\n")
+
+    emit("uint32_t", "golden_isqrt_in", [f"0x{v:08X}u" for v in isqrt_in], 5)
+    emit("uint16_t", "golden_isqrt_out", [math.isqrt(v) for v in isqrt_in], 8)
+    emit("int16_t", "golden_fft_in", fft_in)
+    emit("uint32_t", "golden_fft_bands", band_energy(fft_in, FFT_BANDS), 4)
+
+    print("#endif /* GOLDEN_H */")
+
+
+if __name__ == "__main__":
+    main()
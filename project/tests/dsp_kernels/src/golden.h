@@ -0,0 +1,169 @@
+/* Generated by gen_golden.py, do not edit */
+
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <stdint.h>
+
+#define GOLDEN_FS_HZ      1000
+#define GOLDEN_FIR_TAPS   16
+#define GOLDEN_FIR_FACTOR 4
+#define GOLDEN_FIR_BLOCK  128
+#define GOLDEN_HP_FC_HZ   10
+#define GOLDEN_HP_STAGES  2
+#define GOLDEN_FFT_LEN    128
+#define GOLDEN_FFT_BANDS  4
+
+static const int16_t golden_fir_coeffs[16] = {
+    -42, -177, -406, -352, 669, 2961, 5846, 7885,
+    7885, 5846, 2961, 669, -352, -406, -177, -42,
+};
+
+static const int16_t golden_fir_in[256] = {
+    446, 9342, 3998, 6651, 17182, 12216, 5971, 13236, 11062, -2493,
+    348, 2412, -10315, -13164, -5672, -11868, -16871, -6339, -3768, -9196,
+    248, 9400, 4031, 6368, 17215, 12433, 5234, 12805, 10261, -1983,
+    -281, 1500, -10416, -13461, -5672, -12281, -17260, -6107, -3275, -9538,
+    384, 9496, 3917, 6536, 17329, 11615, 5537, 13051, 10438, -2396,
+    -460, 1950, -10639, -13140, -6003, -11916, -16704, -6080, -3966, -9050,
+    223, 9073, 3910, 5844, 16997, 12470, 5677, 13375, 10652, -2424,
+    -233, 2381, -10964, -13008, -5692, -11616, -17447, -6350, -3118, -9311,
+    309, 9767, 3456, 6356, 16861, 11521, 5705, 13107, 10479, -2326,
+    225, 2357, -10457, -13172, -5754, -12014, -17586, -5710, -3116, -9487,
+    409, 8911, 3703, 5885, 16841, 12040, 6131, 13685, 10603, -2306,
+    -223, 2163, -10450, -13226, -6019, -11680, -17198, -5893, -4028, -9212,
+    -389, 9749, 3677, 6123, 17223, 11611, 5781, 13421, 10450, -1589,
+    -4, 2096, -10987, -13511, -5439, -11922, -16764, -6655, -3388, -9285,
+    -490, 9043, 3133, 6065, 17037, 11750, 5959, 13712, 10388, -2371,
+    -3, 2315, -10763, -12742, -5939, -12476, -17000, -6012, -3950, -9431,
+    253, 9855, 3837, 6505, 16747, 12393, 5903, 13719, 10809, -1955,
+    350, 1864, -11064, -13248, -6133, -11727, -17506, -6536, -3760, -9279,
+    -426, 9403, 3265, 5698, 16731, 12191, 5572, 13205, 10608, -1779,
+    174, 1910, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767,
+};
+
+static const int16_t golden_fir_out[64] = {
+    -151, 1885, 10197, 8150, -4955, -11167, -1673, 10316, 7766, -5331,
+    -11297, -1599, 10262, 7768, -5313, -11150, -1729, 10143, 8027, -5189,
+    -11188, -1560, 10038, 7889, -5028, -11219, -1667, 10031, 8148, -5187,
+    -11201, -1809, 10122, 8101, -5224, -11161, -1976, 9953, 8065, -5117,
+    -11325, -1659, 10308, 8298, -5273, -11412, -1956, 9877, 6775, 16631,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767,
+};
+
+static const int16_t golden_hp_coeffs[6] = {
+    15672, 0, -31344, 15672, 31313, -14991,
+};
+
+static const int16_t golden_biquad_in[256] = {
+    7925, 12813, 15663, 15556, 12836, 7812, 3380, 358, 586, 3128,
+    7800, 12804, 15619, 15520, 12447, 7754, 3450, 382, 231, 3051,
+    7984, 12537, 15613, 15576, 12634, 8105, 3355, 540, 284, 3363,
+    8072, 12710, 15816, 15546, 12603, 7851, 3184, 141, 324, 3113,
+    8039, 12621, 15457, 15821, 12573, 8060, 3313, 447, 577, 3425,
+    7827, 12815, 15430, 15836, 12469, 8201, 3265, 366, 440, 3054,
+    8188, 12474, 15564, 15483, 12882, 8101, 3206, 484, 330, 3083,
+    7932, 12449, 15760, 15420, 12876, 8199, 3225, 173, 531, 3446,
+    7972, 12939, 15460, 15395, 12702, 7939, 3344, 399, 482, 3447,
+    8089, 12858, 15630, 15609, 12496, 7750, 3291, 587, 567, 3443,
+    7879, 12863, 15588, 15800, 12636, 7900, 3314, 612, 299, 3049,
+    8066, 12612, 15726, 15718, 12793, 8227, 3227, 410, 617, 3058,
+    8013, 12952, 15657, 15644, 12492, 8219, 3492, 234, 173, 3414,
+    7744, 12564, 15840, 15685, 12900, 7813, 3096, 259, 566, 3378,
+    8229, 12815, 15662, 15376, 12780, 8212, 3543, 423, 412, 3404,
+    7968, 12847, 15766, 15513, 12746, 8225, 3495, 592, 428, 3434,
+    8251, 12533, 15831, 15507, 12804, 8190, 3374, 425, 137, 3501,
+    7746, 12465, 15584, 15817, 12842, 7835, 3207, 525, 193, 3464,
+    8223, 12601, 15362, 15818, 12697, 8030, 3405, 161, 361, 3044,
+    8026, 12878, 15445, 15790, 12862, 7771, 3541, 310, 522, 3253,
+    7928, 12824, 15796, 15444, 12718, 7769, 3530, 194, 207, 3065,
+    8138, 12629, 15416, 15842, 12546, 8237, 3500, 563, 328, 3219,
+    8194, 12793, 15818, 15517, 12954, 8097, 3171, 466, 493, 3276,
+    8082, 12480, 15512, 15581, 12915, 8027, 3286, 508, 338, 3134,
+    8249, 12923, 15386, 15403, 12893, 7779, 3182, 185, 643, 3366,
+    7794, 12691, 15558, 15762, 12869, 7927,
+};
+
+static const int16_t golden_biquad_out[256] = {
+    7250, 10432, 11071, 8724, 4219, -1749, -6208, -8588, -7505, -4391,
+    213, 4354, 5739, 4130, -20, -5001, -8766, -10679, -9470, -5609,
+    -364, 3685, 5669, 4396, 602, -4044, -8085, -9585, -8359, -4153,
+    932, 5124, 7169, 5696, 1939, -2888, -6807, -8498, -6828, -2931,
+    2349, 6441, 8194, 7295, 3140, -1536, -5638, -7262, -5764, -1923,
+    2761, 7197, 8651, 7733, 3406, -1088, -5445, -7146, -5739, -2142,
+    3220, 6901, 8800, 7367, 3756, -1319, -5657, -7221, -6074, -2359,
+    2712, 6624, 8706, 6984, 3421, -1570, -6006, -7880, -6216, -2391,
+    2325, 6649, 7938, 6534, 2852, -2176, -6211, -7998, -6612, -2718,
+    2119, 6258, 7807, 6432, 2350, -2607, -6468, -8010, -6734, -2919,
+    1747, 6133, 7650, 6506, 2356, -2602, -6590, -8119, -7100, -3341,
+    1932, 5891, 7811, 6445, 2531, -2295, -6711, -8323, -6789, -3362,
+    1860, 6194, 7691, 6343, 2243, -2258, -6420, -8476, -7153, -2919,
+    1669, 5939, 8018, 6501, 2723, -2596, -6683, -8295, -6650, -2883,
+    2183, 6155, 7803, 6202, 2652, -2173, -6284, -8225, -6889, -2922,
+    1885, 6176, 7889, 6305, 2582, -2186, -6347, -8074, -6900, -2914,
+    2128, 5835, 7957, 6303, 2645, -2213, -6443, -8190, -7102, -2745,
+    1755, 5937, 7892, 6773, 2798, -2438, -6448, -7938, -6923, -2673,
+    2291, 6071, 7671, 6790, 2676, -2230, -6276, -8315, -6753, -3073,
+    2162, 6401, 7770, 6770, 2834, -2490, -6133, -8187, -6640, -2942,
+    1981, 6282, 8034, 6341, 2653, -2516, -6167, -8315, -6931, -3067,
+    2244, 6131, 7740, 6813, 2527, -2034, -6224, -8002, -6905, -3025,
+    2178, 6164, 7975, 6331, 2787, -2329, -6652, -8150, -6789, -3028,
+    2021, 5851, 7726, 6471, 2818, -2323, -6469, -8058, -6888, -3093,
+    2256, 6303, 7580, 6300, 2819, -2528, -6505, -8283, -6493, -2826,
+    1850, 6173, 7849, 6701, 2803, -2386,
+};
+
+static const int16_t golden_stats_in[64] = {
+    -9904, -8221, 13502, -2512, 16720, 18125, -15376, -7344, 19094, -14075,
+    3487, -13734, 15970, 13667, -3173, 13288, 15255, 1643, 16888, -923,
+    19233, -16399, 6101, 6361, 9027, 2611, -18847, 9418, 7387, -9649,
+    -3273, -232, 3336, 4457, -3141, 7546, 11566, -32768, 5232, -5185,
+    12928, 10549, -7176, -18234, -17256, 12017, -17327, -5595, 9877, 6606,
+    -17647, 9798, -801, -14996, 18130, -11289, -10970, -10211, 18804, 2419,
+    3348, 1173, -1192, 13237,
+};
+
+#define GOLDEN_STATS_POWER   9372505802LL
+#define GOLDEN_STATS_PEAK    32767
+#define GOLDEN_STATS_ZC_HEAD 19
+#define GOLDEN_STATS_ZC_TAIL 19
+
+static const uint32_t golden_isqrt_in[15] = {
+    0x00000000u, 0x00000001u, 0x00000002u, 0x00000003u, 0x00000004u,
+    0x0000000Fu, 0x00000010u, 0x00000011u, 0x000F4240u, 0xFFFE0000u,
+    0xFFFE0001u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFEu, 0xFFFFFFFFu,
+};
+
+static const uint16_t golden_isqrt_out[15] = {
+    0, 1, 1, 1, 2, 3, 4, 4,
+    1000, 65534, 65535, 46340, 46340, 65535, 65535,
+};
+
+static const int16_t golden_fft_in[128] = {
+    0, 10755, 9476, 17271, 17004, 6155, 5659, -3673, -15009, -11880,
+    -16085, -15332, -2200, -142, 7004, 18067, 13172, 13524, 12417, -2048,
+    -5343, -9682, -19673, -13255, -9783, -8525, 6213, 10347, 11456, 19689,
+    12142, 5160, 4000, -9925, -14465, -12157, -18108, -9954, -29, 764,
+    12844, 17367, 11712, 15054, 6903, -5184, -5361, -14698, -18828, -10154,
+    -10775, -3278, 10046, 9404, 15300, 18742, 7618, 5616, -584, -14145,
+    -12560, -14575, -17131, -4330, 0, 4330, 17131, 14575, 12560, 14145,
+    584, -5616, -7618, -18742, -15300, -9404, -10046, 3278, 10775, 10154,
+    18828, 14698, 5361, 5184, -6903, -15054, -11712, -17367, -12844, -764,
+    29, 9954, 18108, 12157, 14465, 9925, -4000, -5160, -12142, -19689,
+    -11456, -10347, -6213, 8525, 9783, 13255, 19673, 9682, 5343, 2048,
+    -12417, -13524, -13172, -18067, -7004, 142, 2200, 15332, 16085, 11880,
+    15009, 3673, -5659, -6155, -17004, -17271, -9476, -10755,
+};
+
+static const uint32_t golden_fft_bands[4] = {
+    488, 0, 31, 0,
+};
+
+#endif /* GOLDEN_H */
@@ -0,0 +1,219 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/dsp.h>
+
+#include "golden.h"
+
+/*
+DSP kernels against golden vectors:
+golden.h is generated by gen_golden.py from a model of the documented q15 arithmetic and
+from double-precision designs, independently of the kernels. Filter and statistics
+outputs must match it bit for bit, which holds for the CMSIS-DSP build as well; designed
+coefficients may differ by one rounding step from the double-precision reference. Band
+energies are compared with an exact DFT within the transform's rounding error.
+*/
+
+// Allowed distance between a designed coefficient and the double-precision reference
+#define COEFF_SLACK 1
+
+// Band energies: relative error in percent, plus an absolute floor for weak bands
+#define BAND_SLACK_PCT 2
+#define BAND_SLACK_ABS 2
+
+#define FIR_LEN    ARRAY_SIZE(golden_fir_in)
+#define BIQUAD_LEN ARRAY_SIZE(golden_biquad_in)
+#define STATS_LEN  ARRAY_SIZE(golden_stats_in)
+
+static int16_t fir_state[DSP_FIR_STATE_LEN(GOLDEN_FIR_TAPS, GOLDEN_FIR_BLOCK)];
+static int16_t biquad_state[DSP_BIQUAD_STATE_LEN(GOLDEN_HP_STAGES)];
+static int16_t biquad_coeffs[GOLDEN_HP_STAGES * DSP_BIQUAD_COEFFS];
+static int16_t buf[FIR_LEN];
+
+/**
+ * @brief Check a block of samples against its golden vector, naming the first mismatch
+ *
+ * @param out Computed samples
+ * @param golden Expected samples
+ * @param count Number of samples
+ * @param what Kernel under test
+ */
+static void assert_samples(const int16_t *out, const int16_t *golden, size_t count,
+                           const char *what) {
+
+    for (size_t i = 0; i < count; i++) {
+        zassert_equal(out[i], golden[i], "%s: sample %zu is %d, expected %d", what, i,
+                      out[i], golden[i]);
+    }
+}
+
+/**
+ * @brief Run the golden FIR input through a decimator in two blocks
+ *
+ * @param out Output, FIR_LEN / GOLDEN_FIR_FACTOR samples (may be buf itself)
+ */
+static void fir_run_golden(int16_t *out) {
+
+    struct dsp_fir f;
+
+    zassert_ok(dsp_fir_init(&f, golden_fir_coeffs, GOLDEN_FIR_TAPS, GOLDEN_FIR_FACTOR,
+                            fir_state, GOLDEN_FIR_BLOCK));
+
+    // The second block only matches if the history carries over
+    for (size_t i = 0; i < FIR_LEN; i += GOLDEN_FIR_BLOCK) {
+        zassert_equal(dsp_fir_run(&f, &buf[i], &out[i / GOLDEN_FIR_FACTOR],
+                                  GOLDEN_FIR_BLOCK),
+                      GOLDEN_FIR_BLOCK / GOLDEN_FIR_FACTOR);
+    }
+}
+
+ZTEST(dsp_kernels, test_fir_design_matches_reference) {
+
+    int16_t coeffs[GOLDEN_FIR_TAPS];
+    int32_t sum = 0;
+
+    dsp_fir_design_lowpass(coeffs, GOLDEN_FIR_TAPS, GOLDEN_FIR_FACTOR);
+
+    for (int i = 0; i < GOLDEN_FIR_TAPS; i++) {
+        zassert_within(coeffs[i], golden_fir_coeffs[i], COEFF_SLACK, "tap %d is %d, expected %d",
+                       i, coeffs[i], golden_fir_coeffs[i]);
+        sum += coeffs[i];
+    }
+
+    // Unity DC gain, up to one rounding step per tap
+    zassert_within(sum, 32768, GOLDEN_FIR_TAPS, "DC gain %d / 32768", sum);
+}
+
+ZTEST(dsp_kernels, test_fir_decimate_golden) {
+
+    static int16_t out[FIR_LEN / GOLDEN_FIR_FACTOR];
+
+    memcpy(buf, golden_fir_in, sizeof(buf));
+    fir_run_golden(out);
+    assert_samples(out, golden_fir_out, ARRAY_SIZE(out), "fir");
+
+    // Output written over the input, as the feature stage does
+    fir_run_golden(buf);
+    assert_samples(buf, golden_fir_out, ARRAY_SIZE(out), "fir in place");
+}
+
+ZTEST(dsp_kernels, test_fir_rejects_bad_blocks) {
+
+    struct dsp_fir f;
+
+    zassert_equal(dsp_fir_init(&f, golden_fir_coeffs, GOLDEN_FIR_TAPS, GOLDEN_FIR_FACTOR,
+                               fir_state, GOLDEN_FIR_BLOCK + 1), -EINVAL);
+    zassert_equal(dsp_fir_init(&f, golden_fir_coeffs, GOLDEN_FIR_TAPS, 0, fir_state,
+                               GOLDEN_FIR_BLOCK), -EINVAL);
+    zassert_ok(dsp_fir_init(&f, golden_fir_coeffs, GOLDEN_FIR_TAPS, GOLDEN_FIR_FACTOR,
+                            fir_state, GOLDEN_FIR_BLOCK));
+
+    // Nothing is written for a count that is not a multiple of the factor or too long
+    zassert_equal(dsp_fir_run(&f, golden_fir_in, buf, GOLDEN_FIR_FACTOR + 1), 0);
+    zassert_equal(dsp_fir_run(&f, golden_fir_in, buf, GOLDEN_FIR_BLOCK + GOLDEN_FIR_FACTOR),
+                  0);
+    zassert_equal(dsp_fir_run(&f, golden_fir_in, buf, 0), 0);
+}
+
+ZTEST(dsp_kernels, test_biquad_design_matches_reference) {
+
+    int16_t coeffs[DSP_BIQUAD_COEFFS];
+
+    dsp_biquad_design_highpass(coeffs, GOLDEN_FS_HZ, GOLDEN_HP_FC_HZ);
+
+    for (int i = 0; i < DSP_BIQUAD_COEFFS; i++) {
+        zassert_within(coeffs[i], golden_hp_coeffs[i], COEFF_SLACK,
+                       "coefficient %d is %d, expected %d", i, coeffs[i], golden_hp_coeffs[i]);
+    }
+
+    // Exact zero at DC: b0 + b1 + b2 == 0 whatever the rounding
+    zassert_equal(coeffs[0] + coeffs[2] + coeffs[3], 0);
+    zassert_equal(coeffs[1], 0);
+}
+
+ZTEST(dsp_kernels, test_biquad_cascade_golden) {
+
+    struct dsp_biquad b;
+
+    for (int s = 0; s < GOLDEN_HP_STAGES; s++) {
+        memcpy(&biquad_coeffs[s * DSP_BIQUAD_COEFFS], golden_hp_coeffs, sizeof(golden_hp_coeffs));
+    }
+
+    zassert_ok(dsp_biquad_init(&b, biquad_coeffs, GOLDEN_HP_STAGES, 1, biquad_state));
+
+    // In place, in two uneven blocks: both stages must carry their state over
+    memcpy(buf, golden_biquad_in, sizeof(golden_biquad_in));
+    dsp_biquad_run(&b, buf, buf, 100);
+    dsp_biquad_run(&b, &buf[100], &buf[100], BIQUAD_LEN - 100);
+
+    assert_samples(buf, golden_biquad_out, BIQUAD_LEN, "biquad");
+
+    zassert_equal(dsp_biquad_init(&b, biquad_coeffs, GOLDEN_HP_STAGES, 16, biquad_state),
+                  -EINVAL);
+    zassert_equal(dsp_biquad_init(&b, biquad_coeffs, 0, 1, biquad_state), -EINVAL);
+}
+
+ZTEST(dsp_kernels, test_statistics_golden) {
+
+    int16_t prev = 0;
+
+    zassert_equal(dsp_power(golden_stats_in, STATS_LEN), GOLDEN_STATS_POWER);
+
+    // The -32768 sample saturates to INT16_MAX instead of wrapping
+    zassert_equal(dsp_peak(golden_stats_in, STATS_LEN), GOLDEN_STATS_PEAK);
+
+    // Zero crossings continue across blocks through the carried last sample
+    zassert_equal(dsp_zero_crossings(golden_stats_in, STATS_LEN / 2, &prev),
+                  GOLDEN_STATS_ZC_HEAD);
+    zassert_equal(prev, golden_stats_in[STATS_LEN / 2 - 1]);
+    zassert_equal(dsp_zero_crossings(&golden_stats_in[STATS_LEN / 2], STATS_LEN / 2, &prev),
+                  GOLDEN_STATS_ZC_TAIL);
+    zassert_equal(prev, golden_stats_in[STATS_LEN - 1]);
+
+    // An empty block counts nothing and keeps the carried sample
+    zassert_equal(dsp_zero_crossings(golden_stats_in, 0, &prev), 0);
+    zassert_equal(prev, golden_stats_in[STATS_LEN - 1]);
+}
+
+ZTEST(dsp_kernels, test_isqrt_golden) {
+
+    for (size_t i = 0; i < ARRAY_SIZE(golden_isqrt_in); i++) {
+        zassert_equal(dsp_isqrt(golden_isqrt_in[i]), golden_isqrt_out[i], "isqrt(%u) is %u",
+                      golden_isqrt_in[i], dsp_isqrt(golden_isqrt_in[i]));
+    }
+}
+
+ZTEST(dsp_kernels, test_band_energy_against_dft) {
+
+    struct dsp_fft f;
+    uint32_t bands[GOLDEN_FFT_BANDS];
+
+    if (!IS_ENABLED(CONFIG_APP_DSP_FFT)) {
+        zassert_equal(dsp_fft_init(&f, GOLDEN_FFT_LEN), -ENOTSUP);
+        zassert_equal(dsp_band_energy(&f, buf, bands, GOLDEN_FFT_BANDS), -ENOTSUP);
+        return;
+    }
+
+    // The CMSIS transform scales differently: its energies are only comparable to its own
+    Z_TEST_SKIP_IFDEF(CONFIG_APP_DSP_CMSIS);
+
+    zassert_equal(dsp_fft_init(&f, 16), -EINVAL);
+    zassert_equal(dsp_fft_init(&f, GOLDEN_FFT_LEN + 1), -EINVAL);
+    zassert_ok(dsp_fft_init(&f, GOLDEN_FFT_LEN));
+
+    memcpy(buf, golden_fft_in, sizeof(golden_fft_in));
+    zassert_ok(dsp_band_energy(&f, buf, bands, GOLDEN_FFT_BANDS));
+
+    for (int b = 0; b < GOLDEN_FFT_BANDS; b++) {
+        int32_t slack = golden_fft_bands[b] * BAND_SLACK_PCT / 100 + BAND_SLACK_ABS;
+
+        // Signed, so that the lower bound of an empty band does not wrap
+        zassert_within((int32_t)bands[b], (int32_t)golden_fft_bands[b], slack,
+                       "band %d is %u, expected %u", b, bands[b], golden_fft_bands[b]);
+    }
+
+    zassert_equal(dsp_band_energy(&f, buf, bands, 0), -EINVAL);
+    zassert_equal(dsp_band_energy(&f, buf, bands, GOLDEN_FFT_LEN / 2), -EINVAL);
+}
+
+ZTEST_SUITE(dsp_kernels, NULL, NULL, NULL, NULL, NULL);
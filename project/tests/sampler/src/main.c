@@ -0,0 +1,245 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/adc.h>
+#include <zephyr/drivers/adc/adc_emul.h>
+#include <app/app_buf.h>
+#include <app/app_bus.h>
+#include <app/app_msg.h>
+#include <app/sampler.h>
+
+/*
+Block sampling on the emulated ADC:
+Both channels of adc0 (app.overlay) are held at constant voltages with adc_emul, and the
+test reads the blocks the sampler publishes. It checks the block header and values, that
+blocks follow each other at the sequence length with consecutive sequence numbers, that
+a rate change applies from the next block, and the sampler_stats counters. It prints the
+sample rate achieved and the CPU load while sampling; on native_sim code runs in zero
+simulated time, so the load figure is only meaningful on hardware.
+*/
+
+#define RATE_HZ CONFIG_APP_SAMPLER_ADC_RATE_HZ
+
+// ADC group channel index (no accelerometer in the overlay)
+#define CH 0
+
+// Channel voltages driven on the emulated inputs
+#define CH0_MV 1000
+#define CH1_MV 2000
+
+// Blocks read by the cadence test
+#define CADENCE_BLOCKS 10
+
+// Highest CPU load accepted while sampling, percent
+#define CPU_LOAD_MAX_PCT 5
+
+static const struct adc_dt_spec adc_chans[] = {
+    ADC_DT_SPEC_GET_BY_IDX(DT_PATH(zephyr_user), 0),
+    ADC_DT_SPEC_GET_BY_IDX(DT_PATH(zephyr_user), 1),
+};
+
+// Samples of one block: the sequence fills the payload of an app_buf
+#define WIDTH     ((uint8_t)ARRAY_SIZE(adc_chans))
+#define PER_BLOCK (SAMPLER_BLOCK_VALUES / WIDTH)
+
+APP_BUS_SUBSCRIBER_DEFINE(sub_blocks, 8, APP_BUS_TYPE(APP_MSG_DATA),
+                          APP_BUS_SRC(APP_SRC_SAMPLER), 0);
+
+/**
+ * @brief Wait for the next block
+ *
+ * @param out Received message, released by the caller with app_bus_msg_release()
+ * @param hdr Copy of the block header
+ */
+static void block_get(struct app_msg *out, struct sampler_block_hdr *hdr) {
+
+    // Twice the longest block: PER_BLOCK periods of the slowest rate used here
+    k_timeout_t timeout = K_MSEC(2 * PER_BLOCK * MSEC_PER_SEC / RATE_HZ);
+
+    zassert_ok(app_bus_sub_get(&sub_blocks, out, timeout), "no block published");
+    zassert_equal(out->source, APP_SRC_SAMPLER);
+
+    memcpy(hdr, out->data.block.buf->data, sizeof(*hdr));
+}
+
+/**
+ * @brief Release every block waiting in the subscriber queue
+ */
+static void blocks_flush(void) {
+
+    struct app_msg msg;
+
+    while (app_bus_sub_get(&sub_blocks, &msg, K_NO_WAIT) == 0) {
+        app_bus_msg_release(&msg);
+    }
+}
+
+/**
+ * @brief Check the distance between the first samples of two consecutive blocks
+ *
+ * The driver takes the first sampling of a sequence at once, so a sequence lasts one
+ * period less than its length; the re-arm after it adds the thread's wake-up latency.
+ *
+ * @param prev Header of the earlier block
+ * @param next Header of the later block
+ */
+static void assert_block_spacing(const struct sampler_block_hdr *prev,
+                                 const struct sampler_block_hdr *next) {
+
+    uint32_t us = k_cyc_to_us_floor32(next->t0_cycles - prev->t0_cycles);
+
+    zassert_between_inclusive(us, (prev->count - 1) * prev->period_us,
+                              (prev->count + 1) * prev->period_us,
+                              "blocks %u -> %u %u us apart", prev->seq, next->seq, us);
+}
+
+static void *sampler_setup(void) {
+
+    zassert_equal(sampler_channel_count(), 1);
+
+    zassert_ok(adc_emul_const_value_set(adc_chans[0].dev, adc_chans[0].channel_id, CH0_MV));
+    zassert_ok(adc_emul_const_value_set(adc_chans[1].dev, adc_chans[1].channel_id, CH1_MV));
+
+    zassert_ok(app_bus_subscribe(&sub_blocks));
+
+    return NULL;
+}
+
+// Start each test on a fresh block at the default rate
+static void sampler_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    struct app_msg msg;
+    struct sampler_block_hdr hdr;
+
+    zassert_ok(sampler_set_rate(CH, RATE_HZ));
+    blocks_flush();
+
+    // Blocks armed before the inputs were set or the rate restored
+    for (int i = 0; i < 2; i++) {
+        block_get(&msg, &hdr);
+        app_bus_msg_release(&msg);
+    }
+}
+
+static void sampler_after(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    blocks_flush();
+}
+
+ZTEST(sampler, test_block_header_and_values) {
+
+    struct app_msg msg;
+    struct sampler_block_hdr hdr;
+
+    block_get(&msg, &hdr);
+
+    zassert_equal(hdr.channel, CH);
+    zassert_equal(hdr.fmt, SAMPLER_FMT_ADC_RAW);
+    zassert_equal(hdr.width, WIDTH);
+    zassert_equal(hdr.count, PER_BLOCK);
+    zassert_equal(hdr.period_us, USEC_PER_SEC / RATE_HZ);
+    zassert_equal(msg.data.block.buf->len, sizeof(hdr) + PER_BLOCK * WIDTH * sizeof(int16_t));
+
+    // Samples are interleaved, one value per channel of the sequence
+    const int16_t *data = sampler_block_data(msg.data.block.buf);
+    static const int32_t expect_mv[] = { CH0_MV, CH1_MV };
+
+    for (uint16_t n = 0; n < hdr.count; n++) {
+        for (uint8_t c = 0; c < WIDTH; c++) {
+            int32_t mv = data[n * WIDTH + c];
+
+            zassert_ok(adc_raw_to_millivolts_dt(&adc_chans[c], &mv));
+            zassert_within(mv, expect_mv[c], 2, "sample %u channel %u: %d mV", n, c, mv);
+        }
+    }
+
+    app_bus_msg_release(&msg);
+}
+
+ZTEST(sampler, test_block_cadence_and_stats) {
+
+    struct sampler_stats before, after;
+    struct app_msg msg;
+    struct sampler_block_hdr prev, hdr;
+    k_thread_runtime_stats_t cpu_before, cpu_after;
+
+    block_get(&msg, &prev);
+    app_bus_msg_release(&msg);
+
+    zassert_ok(sampler_stats_get(CH, &before));
+    zassert_ok(k_thread_runtime_stats_all_get(&cpu_before));
+    int64_t start_ms = k_uptime_get();
+
+    for (int i = 0; i < CADENCE_BLOCKS; i++) {
+        block_get(&msg, &hdr);
+        app_bus_msg_release(&msg);
+
+        zassert_equal(hdr.seq, (uint16_t)(prev.seq + 1), "block %u follows %u", hdr.seq,
+                      prev.seq);
+        assert_block_spacing(&prev, &hdr);
+        prev = hdr;
+    }
+
+    int64_t elapsed_ms = k_uptime_get() - start_ms;
+
+    zassert_ok(k_thread_runtime_stats_all_get(&cpu_after));
+    zassert_ok(sampler_stats_get(CH, &after));
+
+    zassert_equal(after.blocks - before.blocks, CADENCE_BLOCKS);
+    zassert_equal(after.samples - before.samples, CADENCE_BLOCKS * PER_BLOCK);
+    zassert_equal(after.overruns, before.overruns, "blocks lost while sampling");
+
+    uint32_t rate = (uint32_t)((after.samples - before.samples) * MSEC_PER_SEC / elapsed_ms);
+    uint64_t busy = cpu_after.total_cycles - cpu_before.total_cycles;
+    uint64_t all = cpu_after.execution_cycles - cpu_before.execution_cycles;
+    uint32_t load_pct = (all > 0) ? (uint32_t)(busy * 100 / all) : 0;
+
+    TC_PRINT("%u samples/s per channel (%u channels), CPU load %u%%\n", rate, WIDTH, load_pct);
+
+    // A sequence runs one period short of its length (see assert_block_spacing())
+    zassert_within(rate, RATE_HZ, RATE_HZ / 20, "%u samples/s", rate);
+    zassert_true(load_pct <= CPU_LOAD_MAX_PCT, "CPU load %u%%", load_pct);
+}
+
+ZTEST(sampler, test_rate_change_applies_from_next_block) {
+
+    struct app_msg msg;
+    struct sampler_block_hdr prev, hdr;
+    uint32_t fast_us = USEC_PER_SEC / (2 * RATE_HZ);
+
+    zassert_ok(sampler_set_rate(CH, 2 * RATE_HZ));
+
+    // The block in progress, and at most one already queued, keep the old period
+    block_get(&msg, &prev);
+    app_bus_msg_release(&msg);
+    for (int i = 0; i < 2 && prev.period_us != fast_us; i++) {
+        zassert_equal(prev.period_us, USEC_PER_SEC / RATE_HZ);
+        block_get(&msg, &prev);
+        app_bus_msg_release(&msg);
+    }
+    zassert_equal(prev.period_us, fast_us, "rate change never applied");
+
+    block_get(&msg, &hdr);
+    app_bus_msg_release(&msg);
+
+    zassert_equal(hdr.period_us, fast_us);
+    zassert_equal(hdr.count, PER_BLOCK);
+    zassert_equal(hdr.seq, (uint16_t)(prev.seq + 1));
+    assert_block_spacing(&prev, &hdr);
+}
+
+ZTEST(sampler, test_bad_arguments) {
+
+    struct sampler_stats st;
+
+    zassert_equal(sampler_set_rate(CH, 0), -EINVAL);
+    zassert_equal(sampler_set_rate(CH, USEC_PER_SEC + 1), -EINVAL);
+    zassert_equal(sampler_set_rate(sampler_channel_count(), RATE_HZ), -EINVAL);
+    zassert_equal(sampler_stats_get(sampler_channel_count(), &st), -EINVAL);
+}
+
+ZTEST_SUITE(sampler, NULL, sampler_setup, sampler_before, sampler_after, NULL);
@@ -0,0 +1,179 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <app/app_bus.h>
+#include <app/app_msg.h>
+
+/*
+Interrupt-driven button input on native_sim:
+The test drives the emulated button pins with gpio_emul and checks what the sensor
+module publishes: one event per settled change, none for bounces or glitches, and a
+publish delay of one debounce window after the last edge.
+*/
+
+#define DEBOUNCE_MS CONFIG_APP_SENSOR_DEBOUNCE_MS
+
+// Allowed publish delay past the debounce window (timer tick + work item)
+#define LATENCY_SLACK_MS 2
+
+static const struct gpio_dt_spec buttons[] = {
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios),
+    GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios),
+};
+
+APP_BUS_SUBSCRIBER_DEFINE(sub_buttons, 16, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT),
+                          APP_BUS_SRC(APP_SRC_SENSOR), 0);
+
+/**
+ * @brief Drive the physical level of a button pin
+ *
+ * Buttons are active-low: raw 0 is pressed, raw 1 released.
+ *
+ * @param id Button index
+ * @param raw Physical pin level
+ */
+static void pin_set(int id, int raw) {
+    zassert_ok(gpio_emul_input_set(buttons[id].port, buttons[id].pin, raw));
+}
+
+/**
+ * @brief Wait for the next button event
+ *
+ * @param out Received event
+ * @param timeout_ms How long to wait
+ * @return 0 on success, negative error code on timeout
+ */
+static int event_get(struct app_msg *out, int timeout_ms) {
+    return app_bus_sub_get(&sub_buttons, out, K_MSEC(timeout_ms));
+}
+
+/**
+ * @brief Check that nothing else is published for two debounce windows
+ */
+static void assert_quiet(void) {
+
+    struct app_msg msg;
+
+    zassert_not_ok(event_get(&msg, 2 * DEBOUNCE_MS), "unexpected event from button %u",
+                   msg.data.button.button_id);
+}
+
+/**
+ * @brief Wait for one event from a button and check its publish delay
+ *
+ * @param id Expected button
+ * @param last_edge_ms Uptime of the button's last edge
+ * @return The event
+ */
+static struct app_msg expect_event(int id, uint32_t last_edge_ms) {
+
+    struct app_msg msg;
+
+    zassert_ok(event_get(&msg, DEBOUNCE_MS + 50), "no event from button %d", id);
+    zassert_equal(msg.data.button.button_id, id);
+    zassert_between_inclusive(msg.timestamp_ms - last_edge_ms, DEBOUNCE_MS,
+                              DEBOUNCE_MS + LATENCY_SLACK_MS,
+                              "edge -> publish delay out of range");
+
+    return msg;
+}
+
+static void *sensor_setup(void) {
+
+    zassert_ok(app_bus_subscribe(&sub_buttons));
+
+    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
+        zassert_true(device_is_ready(buttons[i].port));
+    }
+
+    // Let the sensor thread configure the pins and arm the interrupts
+    k_msleep(10);
+
+    return NULL;
+}
+
+// Every test starts with all buttons released and nothing pending
+static void sensor_before(void *fixture) {
+
+    ARG_UNUSED(fixture);
+
+    struct app_msg msg;
+
+    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
+        pin_set(i, 1);
+    }
+
+    k_msleep(2 * DEBOUNCE_MS);
+
+    while (event_get(&msg, 0) == 0) {
+    }
+}
+
+ZTEST(sensor_gpio, test_press_release) {
+
+    for (int i = 0; i < ARRAY_SIZE(buttons); i++) {
+        uint32_t edge = k_uptime_get_32();
+
+        pin_set(i, 0);
+        struct app_msg press = expect_event(i, edge);
+
+        edge = k_uptime_get_32();
+        pin_set(i, 1);
+        struct app_msg release = expect_event(i, edge);
+
+        zassert_not_equal(press.data.button.pressed, release.data.button.pressed,
+                          "button %d: press and release report the same state", i);
+    }
+
+    assert_quiet();
+}
+
+ZTEST(sensor_gpio, test_bounce_collapses_to_one_event) {
+
+    // Contact bounce: edges 2 ms apart, ending pressed
+    for (int n = 0; n < 6; n++) {
+        pin_set(1, n & 1);
+        k_msleep(2);
+    }
+    pin_set(1, 0);
+
+    // The debounce window restarts on every edge: the delay counts from the last one
+    uint32_t edge = k_uptime_get_32();
+
+    (void)expect_event(1, edge);
+    assert_quiet();
+}
+
+ZTEST(sensor_gpio, test_glitch_is_ignored) {
+
+    // A pulse shorter than the debounce window that returns to the old level
+    pin_set(2, 0);
+    k_msleep(DEBOUNCE_MS / 4);
+    pin_set(2, 1);
+
+    assert_quiet();
+}
+
+ZTEST(sensor_gpio, test_simultaneous_buttons) {
+
+    struct app_msg msg;
+    uint32_t seen = 0;
+
+    pin_set(0, 0);
+    pin_set(3, 0);
+
+    // One event per button, whichever order the work item publishes them in
+    for (int n = 0; n < 2; n++) {
+        zassert_ok(event_get(&msg, DEBOUNCE_MS + 50));
+        zassert_false(seen & BIT(msg.data.button.button_id), "duplicate event");
+        seen |= BIT(msg.data.button.button_id);
+    }
+
+    zassert_equal(seen, BIT(0) | BIT(3));
+    assert_quiet();
+}
+
+ZTEST_SUITE(sensor_gpio, NULL, sensor_setup, sensor_before, NULL, NULL);
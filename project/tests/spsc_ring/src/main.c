@@ -0,0 +1,237 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <app/app_bus.h>
+#include <app/spsc_ring.h>
+
+#include "host_clock.h"
+
+// Elements moved by the stress test
+#define STRESS_MSGS 200000
+
+#define STACK_SIZE 2048
+
+SPSC_RING_DEFINE(ring4, sizeof(uint32_t), 4);
+SPSC_RING_DEFINE(stress_ring, sizeof(uint32_t), 64);
+K_SEM_DEFINE(stress_sem, 0, 1);
+
+// Bus subscriber whose SENSOR messages take the ring, everything else the queue
+APP_BUS_SUBSCRIBER_DEFINE_SPSC(sub_fast, 16, APP_BUS_TYPE(APP_MSG_BUTTON_EVENT), APP_BUS_ANY,
+                               0, APP_SRC_SENSOR, 16);
+
+K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(consumer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+static struct k_thread consumer_thread;
+
+// What the stress consumer saw
+static struct {
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t wakeups;
+    uint32_t full;
+} stress;
+
+/**
+ * @brief Empty a ring and restart its free-running counters at a given value
+ *
+ * @param ring Ring to reset
+ * @param start Initial head/tail value
+ */
+static void ring_reset(struct spsc_ring *ring, uint32_t start) {
+    atomic_set(&ring->head, (atomic_val_t)start);
+    atomic_set(&ring->tail, (atomic_val_t)start);
+}
+
+ZTEST(spsc_ring, test_put_get_order) {
+
+    uint32_t v;
+    bool was_empty;
+
+    ring_reset(&ring4, 0);
+
+    zassert_equal(spsc_ring_get(&ring4, &v), -EAGAIN);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        zassert_ok(spsc_ring_put(&ring4, &i, &was_empty));
+        // Only the first put makes the ring non-empty
+        zassert_equal(was_empty, i == 0);
+        zassert_equal(spsc_ring_count(&ring4), i + 1);
+    }
+
+    // Full: the new element is rejected, the queued ones are untouched
+    v = 99;
+    zassert_equal(spsc_ring_put(&ring4, &v, NULL), -ENOMSG);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        zassert_ok(spsc_ring_get(&ring4, &v));
+        zassert_equal(v, i);
+    }
+
+    zassert_equal(spsc_ring_get(&ring4, &v), -EAGAIN);
+    zassert_equal(spsc_ring_count(&ring4), 0);
+}
+
+ZTEST(spsc_ring, test_was_empty_after_drain) {
+
+    uint32_t v = 1;
+    bool was_empty;
+
+    ring_reset(&ring4, 0);
+
+    zassert_ok(spsc_ring_put(&ring4, &v, &was_empty));
+    zassert_true(was_empty);
+    zassert_ok(spsc_ring_put(&ring4, &v, &was_empty));
+    zassert_false(was_empty);
+
+    // Drained by the consumer: the next put needs a wake-up again
+    zassert_ok(spsc_ring_get(&ring4, &v));
+    zassert_ok(spsc_ring_get(&ring4, &v));
+    zassert_ok(spsc_ring_put(&ring4, &v, &was_empty));
+    zassert_true(was_empty);
+}
+
+ZTEST(spsc_ring, test_counter_wrap) {
+
+    uint32_t v = 0;
+
+    // Free-running counters cross 2^32 in the middle of the ring
+    ring_reset(&ring4, UINT32_MAX - 1);
+
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            uint32_t in = round * 4 + i;
+
+            zassert_ok(spsc_ring_put(&ring4, &in, NULL));
+        }
+        zassert_equal(spsc_ring_count(&ring4), 4);
+        zassert_equal(spsc_ring_put(&ring4, &v, NULL), -ENOMSG);
+
+        for (uint32_t i = 0; i < 4; i++) {
+            zassert_ok(spsc_ring_get(&ring4, &v));
+            zassert_equal(v, round * 4 + i);
+        }
+        zassert_equal(spsc_ring_count(&ring4), 0);
+    }
+}
+
+/**
+ * @brief Stress producer: sends STRESS_MSGS sequence numbers, waking the consumer on
+ *        every empty -> non-empty transition as the bus does
+ */
+static void stress_producer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    for (uint32_t seq = 0; seq < STRESS_MSGS; ) {
+        bool was_empty;
+
+        if (spsc_ring_put(&stress_ring, &seq, &was_empty) != 0) {
+            stress.full++;
+            k_yield();
+            continue;
+        }
+
+        if (was_empty) {
+            k_sem_give(&stress_sem);
+        }
+        seq++;
+    }
+}
+
+/**
+ * @brief Stress consumer: drains the ring and sleeps on the semaphore when it is empty
+ *
+ * A missed wake-up leaves the consumer asleep with data pending; the timeout turns that
+ * into a failed test instead of a hang.
+ */
+static void stress_consumer(void *p1, void *p2, void *p3) {
+
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    uint32_t v;
+
+    while (stress.received < STRESS_MSGS) {
+        if (spsc_ring_get(&stress_ring, &v) != 0) {
+            if (k_sem_take(&stress_sem, K_MSEC(500)) != 0) {
+                return;
+            }
+            stress.wakeups++;
+            continue;
+        }
+
+        if (v != stress.received) {
+            stress.out_of_order++;
+        }
+        stress.received++;
+    }
+}
+
+ZTEST(spsc_ring, test_stress_fifo) {
+
+    memset(&stress, 0, sizeof(stress));
+    ring_reset(&stress_ring, 0);
+    k_sem_reset(&stress_sem);
+
+    uint64_t start = host_clock_ns();
+
+    k_thread_create(&consumer_thread, consumer_stack, STACK_SIZE, stress_consumer,
+                    NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+    k_thread_create(&producer_thread, producer_stack, STACK_SIZE, stress_producer,
+                    NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+
+    zassert_ok(k_thread_join(&producer_thread, K_SECONDS(30)));
+    zassert_ok(k_thread_join(&consumer_thread, K_SECONDS(30)));
+
+    uint64_t elapsed = host_clock_ns() - start;
+
+    TC_PRINT("%u elements in %u us (%u ns/element), %u wake-ups, %u full retries\n",
+             STRESS_MSGS, (uint32_t)(elapsed / 1000), (uint32_t)(elapsed / STRESS_MSGS),
+             stress.wakeups, stress.full);
+
+    zassert_equal(stress.received, STRESS_MSGS, "consumer stalled (missed wake-up?)");
+    zassert_equal(stress.out_of_order, 0);
+    zassert_equal(spsc_ring_count(&stress_ring), 0);
+
+    // The consumer is only woken on empty -> non-empty, never once per element
+    zassert_true(stress.wakeups < STRESS_MSGS);
+}
+
+ZTEST(spsc_ring, test_bus_fast_path) {
+
+    struct app_msg msg = {0};
+    struct app_msg out;
+
+    zassert_ok(app_bus_subscribe(&sub_fast));
+
+    msg.type = APP_MSG_BUTTON_EVENT;
+
+    // Interleave ring (SENSOR) and queue (BUTTONS) sources
+    for (uint8_t i = 0; i < 8; i++) {
+        msg.source = (i & 1) ? APP_SRC_BUTTONS : APP_SRC_SENSOR;
+        msg.data.button.button_id = i;
+        zassert_ok(app_bus_publish(&msg));
+    }
+
+    zassert_equal(spsc_ring_count(sub_fast.ring), 4);
+    zassert_equal(k_msgq_num_used_get(sub_fast.q), 4);
+
+    // FIFO per source; the ring is drained first
+    uint8_t next[2] = { 0, 1 };
+
+    for (int i = 0; i < 8; i++) {
+        zassert_ok(app_bus_sub_get(&sub_fast, &out, K_NO_WAIT));
+
+        int lane = (out.source == APP_SRC_SENSOR) ? 0 : 1;
+
+        zassert_equal(out.data.button.button_id, next[lane]);
+        next[lane] += 2;
+    }
+
+    zassert_not_ok(app_bus_sub_get(&sub_fast, &out, K_MSEC(10)));
+}
+
+ZTEST_SUITE(spsc_ring, NULL, NULL, NULL, NULL, NULL);